@@ -0,0 +1,735 @@
+; ===============================================================================
+; DSFS - Disk Server Filing System (PYNQ-Z2)
+; ===============================================================================
+;
+; The filing system itself (SSD/DSD/MMB images, the DFS catalogue, open
+; files, * commands) runs on the Zynq ARM (see diskserv.c in BeebFpgaApp).
+; This ROM just forwards each filing system call to the ARM through a
+; mailbox in JIM RAM, and then carries out whatever the ARM asks for:
+;
+;   DONE  - return to the caller with A, X, Y and C from the mailbox
+;   ERROR - generate an error (number in A, message at MB_TEXT)
+;   PRINT - print MB_LEN characters from the text pages
+;   READ  - copy MB_LEN bytes from the data pages to MB_ADDR
+;   WRITE - copy MB_LEN bytes from MB_ADDR to the data pages
+;   EXEC  - execute code at MB_ADDR (*RUN)
+;
+; After PRINT, READ and WRITE the ROM sends OP_CONTINUE, and the ARM replies
+; with the next action. Transfers to and from I/O processor memory below
+; &8000 are done directly by the ARM, so the ROM only copies data for
+; sideways RAM and the Tube. The ARM reads control blocks and filenames
+; directly too, so these must be in main memory.
+;
+; The JIM RAM is paged through &FCFF, and the MOS copy at &EE is kept up to
+; date so an interrupt handler that uses JIM (e.g. the Music 5000) restores
+; the right page.
+
+    OSASCI                  = &FFE3
+    OSNEWL                  = &FFE7
+    OSWRCH                  = &FFEE
+    OSBYTE                  = &FFF4
+    OSCLI                   = &FFF7
+
+    FILEV                   = &0212
+    FSCV                    = &021E
+    TUBE_ENTRY              = &0406
+    TUBE_PRESENT            = &027A
+    TUBE_R3                 = &FEE5
+
+    jim_copy                = &EE
+    jim_page_reg            = &FCFF
+    jim_base                = &FD00
+
+    FS_NUMBER               = &15
+    TUBE_ID                 = &0B
+
+;; Internal key number of the key that selects DSFS on BREAK (S)
+    BOOT_KEY                = &51
+
+;; Mailbox (JIM page &00)
+
+    MB_STATUS               = jim_base + &00
+    MB_OP                   = jim_base + &01
+    MB_A                    = jim_base + &02
+    MB_X                    = jim_base + &03
+    MB_Y                    = jim_base + &04
+    MB_FLAGS                = jim_base + &05
+    MB_ADDR                 = jim_base + &06
+    MB_LEN                  = jim_base + &0A
+    MB_TEXT                 = jim_base + &40
+
+    DATA_PAGE               = &01
+    TEXT_PAGE               = &21
+
+    STATUS_REQUEST          = &01
+
+    FLAG_CARRY              = &01
+    FLAG_TUBE               = &80
+
+    OP_CONTINUE             = &00
+    OP_FILE                 = &01
+    OP_ARGS                 = &02
+    OP_BGET                 = &03
+    OP_BPUT                 = &04
+    OP_GBPB                 = &05
+    OP_FIND                 = &06
+    OP_FSC                  = &07
+    OP_BOOT                 = &08
+
+    ACT_DONE                = &00
+    ACT_ERROR               = &01
+    ACT_PRINT               = &02
+    ACT_READ                = &03
+    ACT_WRITE               = &04
+    ACT_EXEC                = &05
+
+;; Filing system scratch space
+
+    zp_op                   = &B0
+    zp_a                    = &B1
+    zp_x                    = &B2
+    zp_y                    = &B3
+    zp_tmp                  = &B4
+    zp_page                 = &B5
+    zp_cnt                  = &B6
+    zp_ptr                  = &B8
+    zp_addr                 = &BA
+
+;; Transient command space (used during service calls)
+
+    zp_str                  = &A8
+
+org &8000
+.start
+
+; ===============================================================================
+; ROM Header
+; ===============================================================================
+
+    EQUB 0, 0, 0
+    JMP service
+    EQUB &82
+    EQUB copyright - start
+    EQUB &01
+.title
+    EQUS "DSFS"
+    EQUB 0
+    EQUS "1.00"
+.copyright
+    EQUB 0
+    EQUS "(C)BeebFpga"
+    EQUB 0
+
+; ===============================================================================
+; Service Calls
+; ===============================================================================
+
+.service
+{
+    CMP #&03
+    BEQ service_boot
+    CMP #&04
+    BEQ service_command
+    CMP #&09
+    BEQ service_help
+    CMP #&12
+    BEQ service_select
+    RTS
+}
+
+; Service &12 - select filing system Y
+
+.service_select
+{
+    CPY #FS_NUMBER
+    BNE exit
+    JSR select_fs
+    LDA #&00
+.exit
+    RTS
+}
+
+; Service &03 - auto boot, selected by S+BREAK
+
+.service_boot
+{
+    PHA
+    TYA
+    PHA
+    TXA
+    PHA
+    LDA #&79
+    LDX #BOOT_KEY EOR &80
+    JSR OSBYTE
+    TXA
+    BMI boot
+    PLA
+    TAX
+    PLA
+    TAY
+    PLA
+    RTS
+.boot
+    JSR print_string
+    EQUS "DSFS"
+    EQUB 13, 13
+    NOP
+    JSR select_fs
+    PLA
+    TAX
+    PLA
+    TAY
+    JSR boot_request
+    TAY
+    BEQ done
+    ; The command is copied to RAM, as the ARM can only see main memory
+    LDA boot_cmd_lo - 1, Y
+    STA zp_str
+    LDA boot_cmd_hi - 1, Y
+    STA zp_str + 1
+    LDY #&00
+.copy
+    LDA (zp_str), Y
+    STA &100, Y
+    INY
+    CMP #13
+    BNE copy
+    LDX #&00
+    LDY #&01
+    JSR OSCLI
+.done
+    PLA
+    LDA #&00
+    RTS
+}
+
+.boot_cmd_lo
+    EQUB LO(boot_load), LO(boot_run), LO(boot_exec)
+
+.boot_cmd_hi
+    EQUB HI(boot_load), HI(boot_run), HI(boot_exec)
+
+.boot_load
+    EQUS "L.!BOOT", 13
+.boot_run
+    EQUS "!BOOT", 13
+.boot_exec
+    EQUS "E.!BOOT", 13
+
+; Service &04 - unrecognised command, *DSFS selects the filing system
+
+.service_command
+{
+    PHA
+    TYA
+    PHA
+    LDX #&00
+.loop
+    LDA (&F2), Y
+    CPX #&04
+    BEQ end
+    AND #&DF
+    CMP title, X
+    BNE no_match
+    INY
+    INX
+    BNE loop
+.end
+    CMP #&21
+    BCS no_match
+    JSR select_fs
+    PLA
+    PLA
+    LDX &F4
+    LDA #&00
+    RTS
+.no_match
+    PLA
+    TAY
+    LDX &F4
+    PLA
+    RTS
+}
+
+; Service &09 - *HELP
+
+.service_help
+{
+    PHA
+    TYA
+    PHA
+    LDA (&F2), Y
+    CMP #13
+    BNE exit
+    JSR print_string
+    EQUB 13
+    EQUS "DSFS 1.00"
+    EQUB 13
+    NOP
+.exit
+    PLA
+    TAY
+    LDX &F4
+    PLA
+    RTS
+}
+
+; ===============================================================================
+; Filing System Selection
+; ===============================================================================
+
+.select_fs
+{
+    ; Tell the current filing system it's being replaced
+    LDA #&06
+    JSR call_fscv
+
+    LDX #&00
+.vec_loop
+    LDA vector_table, X
+    STA FILEV, X
+    INX
+    CPX #14
+    BNE vec_loop
+
+    ; Point the extended vectors at this ROM
+    LDA #&A8
+    LDX #&00
+    LDY #&FF
+    JSR OSBYTE
+    STX zp_ptr
+    STY zp_ptr + 1
+    LDY #&1B
+    LDX #&00
+.ext_loop
+    LDA ext_table, X
+    STA (zp_ptr), Y
+    INX
+    INY
+    LDA ext_table, X
+    STA (zp_ptr), Y
+    INX
+    INY
+    LDA &F4
+    STA (zp_ptr), Y
+    INY
+    CPX #14
+    BNE ext_loop
+
+    ; Service call &0F - vectors changed
+    LDA #&8F
+    LDX #&0F
+    LDY #&FF
+    JMP OSBYTE
+}
+
+.call_fscv
+    JMP (FSCV)
+
+.vector_table
+    EQUW &FF1B, &FF1E, &FF21, &FF24, &FF27, &FF2A, &FF2D
+
+.ext_table
+    EQUW file_entry, args_entry, bget_entry, bput_entry
+    EQUW gbpb_entry, find_entry, fsc_entry
+
+; ===============================================================================
+; Vector Entry Points
+; ===============================================================================
+
+.file_entry
+    PHA
+    LDA #OP_FILE
+    BNE request
+
+.args_entry
+    PHA
+    LDA #OP_ARGS
+    BNE request
+
+.bget_entry
+    PHA
+    LDA #OP_BGET
+    BNE request
+
+.bput_entry
+    PHA
+    LDA #OP_BPUT
+    BNE request
+
+.gbpb_entry
+    PHA
+    LDA #OP_GBPB
+    BNE request
+
+.find_entry
+    PHA
+    LDA #OP_FIND
+    BNE request
+
+.fsc_entry
+    PHA
+    LDA #OP_FSC
+    BNE request
+
+; Returns the boot option to use (Y=0 for SHIFT+BREAK)
+
+.boot_request
+    PHA
+    LDA #OP_BOOT
+
+; ===============================================================================
+; Mailbox Request
+; ===============================================================================
+;
+; Entered with the operation in A and the caller's A on the stack. The
+; caller's JIM page is kept on the stack (not in zero page), as printing
+; can re-enter the filing system (e.g. a *SPOOL BPUT from OSASCI). The
+; print loop also keeps its own state on the stack around OSASCI (see
+; print_char), and the ARM saves the reply being printed until the nested
+; request is complete.
+
+.request
+{
+    STA zp_op
+    PLA
+    STA zp_a
+    STX zp_x
+    STY zp_y
+    LDA jim_copy
+    PHA
+    LDA zp_op
+}
+
+.send
+{
+    LDX #&00
+    STX jim_copy
+    STX jim_page_reg
+    STA MB_OP
+    LDA zp_a
+    STA MB_A
+    LDA zp_x
+    STA MB_X
+    LDA zp_y
+    STA MB_Y
+    LDA TUBE_PRESENT
+    AND #FLAG_TUBE
+    STA MB_FLAGS
+    ; The status byte is written last, and the ARM only clears it once
+    ; the reply is complete
+    LDA #STATUS_REQUEST
+    STA MB_STATUS
+.wait
+    LDA MB_STATUS
+    BNE wait
+    LDA MB_OP
+    BEQ done
+    CMP #ACT_ERROR
+    BEQ error
+    CMP #ACT_PRINT
+    BNE not_print
+    JMP print
+.not_print
+    CMP #ACT_READ
+    BNE not_read
+    JMP read
+.not_read
+    CMP #ACT_WRITE
+    BNE not_write
+    JMP write
+.not_write
+    CMP #ACT_EXEC
+    BNE done
+    JMP exec
+
+.done
+    LDA MB_FLAGS
+    STA zp_tmp
+    LDA MB_A
+    STA zp_a
+    LDX MB_X
+    LDY MB_Y
+    PLA
+    STA jim_copy
+    STA jim_page_reg
+    LDA zp_tmp
+    LSR A
+    LDA zp_a
+    RTS
+
+.error
+    LDA #&00
+    STA &100
+    LDA MB_A
+    STA &101
+    LDX #&00
+.error_loop
+    LDA MB_TEXT, X
+    STA &102, X
+    BEQ error_done
+    INX
+    BNE error_loop
+.error_done
+    PLA
+    STA jim_copy
+    STA jim_page_reg
+    JMP &100
+}
+
+.continue
+    LDA #OP_CONTINUE
+    JMP send
+
+; ===============================================================================
+; Actions
+; ===============================================================================
+
+.print
+{
+    LDA #TEXT_PAGE
+    JSR start_copy
+    LDY #&00
+.loop
+    LDA zp_cnt
+    ORA zp_cnt + 1
+    BEQ continue
+    LDA zp_page
+    STA jim_copy
+    STA jim_page_reg
+    LDA jim_base, Y
+    JSR print_char
+    JSR dec_count
+    INY
+    BNE loop
+    INC zp_page
+    BNE loop
+}
+
+; Print A, preserving Y, zp_page and zp_cnt, which a request made from
+; within OSASCI would otherwise overwrite
+
+.print_char
+{
+    TAX
+    TYA
+    PHA
+    LDA zp_page
+    PHA
+    LDA zp_cnt
+    PHA
+    LDA zp_cnt + 1
+    PHA
+    TXA
+    JSR OSASCI
+    PLA
+    STA zp_cnt + 1
+    PLA
+    STA zp_cnt
+    PLA
+    STA zp_page
+    PLA
+    TAY
+    RTS
+}
+
+; Copy from the data pages to memory
+
+.read
+{
+    LDA #DATA_PAGE
+    JSR start_copy
+    BCS read_tube
+    LDX #&00
+.loop
+    LDA zp_cnt
+    ORA zp_cnt + 1
+    BEQ continue
+    LDA jim_base, X
+    LDY #&00
+    STA (zp_ptr), Y
+    JSR next_byte
+    JMP loop
+}
+
+.read_tube
+{
+    LDA #&01
+    JSR tube_start
+.loop
+    LDA zp_cnt
+    ORA zp_cnt + 1
+    BEQ tube_done
+    LDA jim_base, X
+    STA TUBE_R3
+    JSR tube_delay
+    JSR next_byte
+    JMP loop
+}
+
+; Copy from memory to the data pages
+
+.write
+{
+    LDA #DATA_PAGE
+    JSR start_copy
+    BCS write_tube
+    LDX #&00
+.loop
+    LDA zp_cnt
+    ORA zp_cnt + 1
+    BEQ continue
+    LDY #&00
+    LDA (zp_ptr), Y
+    STA jim_base, X
+    JSR next_byte
+    JMP loop
+}
+
+.write_tube
+{
+    LDA #&00
+    JSR tube_start
+.loop
+    LDA zp_cnt
+    ORA zp_cnt + 1
+    BEQ tube_done
+    JSR tube_delay
+    LDA TUBE_R3
+    STA jim_base, X
+    JSR next_byte
+    JMP loop
+}
+
+.tube_done
+    LDA #&80 + TUBE_ID
+    JSR TUBE_ENTRY
+    JMP continue
+
+.exec
+{
+    JSR start_copy
+    PLA
+    STA jim_copy
+    STA jim_page_reg
+    BCS exec_tube
+    LDA #&01
+    JMP (zp_addr)
+.exec_tube
+    LDA #&04
+    JMP tube_start
+}
+
+; Start a copy from JIM page A, reading MB_ADDR and MB_LEN. Returns with
+; C set if the address is in the Tube processor.
+
+.start_copy
+{
+    STA zp_page
+    LDX #&03
+.loop
+    LDA MB_ADDR, X
+    STA zp_addr, X
+    DEX
+    BPL loop
+    LDA MB_LEN
+    STA zp_cnt
+    LDA MB_LEN + 1
+    STA zp_cnt + 1
+    LDA zp_addr
+    STA zp_ptr
+    LDA zp_addr + 1
+    STA zp_ptr + 1
+    LDA zp_page
+    STA jim_copy
+    STA jim_page_reg
+    ; Addresses &FFxxxxxx are always in the I/O processor
+    LDA zp_addr + 3
+    CMP #&FF
+    BEQ io
+    LDA TUBE_PRESENT
+    ASL A
+    RTS
+.io
+    CLC
+    RTS
+}
+
+; Claim the Tube and start a transfer of type A to/from zp_addr
+
+.tube_start
+{
+    PHA
+.claim
+    LDA #&C0 + TUBE_ID
+    JSR TUBE_ENTRY
+    BCC claim
+    PLA
+    LDX #zp_addr
+    LDY #&00
+    JSR TUBE_ENTRY
+    LDX #&00
+    RTS
+}
+
+.tube_delay
+    JSR delay
+.delay
+    RTS
+
+; Advance to the next byte (X is the offset in the JIM page)
+
+.next_byte
+{
+    INC zp_ptr
+    BNE no_carry
+    INC zp_ptr + 1
+.no_carry
+    INX
+    BNE dec_count
+    INC zp_page
+    LDA zp_page
+    STA jim_copy
+    STA jim_page_reg
+}
+
+.dec_count
+{
+    LDA zp_cnt
+    BNE no_borrow
+    DEC zp_cnt + 1
+.no_borrow
+    DEC zp_cnt
+    RTS
+}
+
+; ===============================================================================
+; Utilities
+; ===============================================================================
+
+; Print the inline string following the JSR, terminated by a byte with bit 7
+; set (usually a NOP), which is then executed
+
+.print_string
+{
+    PLA
+    STA zp_str
+    PLA
+    STA zp_str + 1
+    LDY #0
+.loop
+    INC zp_str
+    BNE nocarry
+    INC zp_str + 1
+.nocarry
+    LDA (zp_str),Y
+    BMI exit
+    JSR OSASCI
+    JMP loop
+.exit
+    JMP (zp_str)
+}
+
+.end
+
+SAVE "diskserv.rom", start, &C000
@@ -18,6 +18,7 @@ cp -a roms/tmp/rom_image.bin ${release}/de1
 
 mkdir -p ${release}/duo
 cp -a roms/tmp/merged.bit  ${release}/duo/bbc_micro_duo.bit
+cp -a roms/tmp/merged.mcs  ${release}/duo/bbc_micro_duo.mcs
 
 pushd releases
 zip -qr ${name}.zip ${name}
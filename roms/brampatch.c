@@ -0,0 +1,524 @@
+/*
+ * Block RAM Patcher
+ *
+ * Updates the block RAM contents of a Spartan-6 bitstream from a .mem
+ * file (e.g. the AVR firmware of the ICE, or the Spec Next config ROM),
+ * as data2mem does, but without needing ISE.
+ *
+ * Where each bit of a block RAM lives in the bitstream isn't documented,
+ * so it is learnt instead, once per build of the bitstream, on a machine
+ * with ISE: "calibrate" runs data2mem with a few test patterns, and sees
+ * which bitstream bits each one changes. That gives the location of every
+ * bit of the memory, saved in a .map file next to the .bit. From then on,
+ * "patch" needs only the .bit, the .map and the new .mem.
+ *
+ * The .mem files are as made by "od -An -tx1 -w16 -v": two hex digits per
+ * byte, with optional @<byte address> lines. The calibration uses the same
+ * format, so whatever data2mem does with the bytes, the patch matches it.
+ *
+ * The configuration CRC covers every register write, so it's recomputed
+ * after patching. The CRCs in the original bitstream are checked first, so
+ * one this can't reproduce, or one with no CRC check at all, is refused
+ * rather than patched with a bad CRC.
+ *
+ * Usage: brampatch calibrate <_bd.bmm> <input.bit> <output.map>
+ *        brampatch patch <.map> <input.mem> <input.bit> <output.bit>
+ *
+ * calibrate runs $DATA2MEM (default data2mem) in a temporary directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#define MAP_MAGIC         0x504D5242   // "BRMP"
+#define MAP_INVERTED      0x80000000
+
+// Spartan-6 configuration packets are 16 bit words
+#define SYNC_HI           0xAA99
+#define SYNC_LO           0x5566
+#define OP_WRITE          2
+#define REG_CRC           0x00
+#define REG_CMD           0x05
+#define CMD_RCRC          0x0007
+
+// CRC-32C (Castagnoli), bit reversed, as the later Xilinx families use
+#define CRC_POLY          0x82F63B78
+
+// What fix_crc does with each CRC check
+#define CRC_VERIFY        0
+#define CRC_CLEAR         1
+#define CRC_UPDATE        2
+
+#define MAX_LINE          1024
+
+typedef struct {
+	unsigned char *buf;          // whole file
+	unsigned len;
+	unsigned char *data;         // configuration data (the 'e' section)
+	unsigned data_len;
+} bit_type;
+
+static void __attribute__ ((format (printf, 1, 2), noreturn)) error(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+	va_end(ap);
+	exit(2);
+}
+
+static unsigned char *read_file(const char *path, unsigned *len) {
+	unsigned char *buf;
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) {
+		error("unable to open %s", path);
+	}
+	fseek(f, 0, SEEK_END);
+	*len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if ((buf = malloc(*len + 1)) == NULL) {
+		error("out of memory");
+	}
+	if (fread(buf, 1, *len, f) != *len) {
+		error("unable to read %s", path);
+	}
+	fclose(f);
+	return buf;
+}
+
+static void write_file(const char *path, const void *buf, unsigned len) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL || fwrite(buf, 1, len, f) != len || fclose(f)) {
+		error("unable to write %s", path);
+	}
+}
+
+// ==================================================================
+// Bitstreams
+// ==================================================================
+
+// A fixed preamble, then keyed fields 'a' to 'd' with 16 bit lengths, then
+// 'e' with a 32 bit one. Field 'b' is the part, which must be a Spartan-6.
+static void read_bit(const char *path, bit_type *bit) {
+	static const unsigned char preamble[] = {
+		0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01
+	};
+	unsigned char *p;
+	unsigned i = sizeof(preamble);
+	unsigned n;
+
+	p = bit->buf = read_file(path, &bit->len);
+	if (bit->len < i || memcmp(p, preamble, sizeof(preamble)) != 0) {
+		error("%s is not a .bit file", path);
+	}
+	while (i < bit->len && p[i] != 'e') {
+		if (p[i] < 'a' || p[i] > 'd' || i + 3 > bit->len) {
+			error("%s has a bad header", path);
+		}
+		n = (p[i + 1] << 8) | p[i + 2];
+		if (p[i] == 'b' && strncmp((char *) p + i + 3, "6s", 2) != 0) {
+			error("%s is for a %.*s, not a Spartan-6", path, n, p + i + 3);
+		}
+		i += 3 + n;
+	}
+	if (i + 5 > bit->len) {
+		error("%s has no configuration data", path);
+	}
+	n = (p[i + 1] << 24) | (p[i + 2] << 16) | (p[i + 3] << 8) | p[i + 4];
+	if (i + 5 + n != bit->len) {
+		error("%s length differs from the expected", path);
+	}
+	bit->data = p + i + 5;
+	bit->data_len = n;
+}
+
+static unsigned get16(const unsigned char *p) {
+	return (p[0] << 8) | p[1];
+}
+
+static void put16(unsigned char *p, unsigned v) {
+	p[0] = v >> 8;
+	p[1] = v;
+}
+
+// Each 16 bit word written to a register is shifted in LSB first, with
+// the 6 bit register address above it
+static unsigned crc_add(unsigned crc, unsigned addr, unsigned data) {
+	unsigned v = (addr << 16) | data;
+	int i;
+	for (i = 0; i < 22; i++) {
+		crc = ((crc ^ v) & 1) ? (crc >> 1) ^ CRC_POLY : crc >> 1;
+		v >>= 1;
+	}
+	return crc;
+}
+
+// Follows the CRC through the configuration packets, and verifies, clears
+// or rewrites each CRC check. Frame data (Type 2 packets) is walked word
+// by word, so can't be mistaken for commands. Returns the number of checks.
+static int fix_crc(bit_type *bit, const char *path, int mode) {
+	unsigned char *p = bit->data;
+	unsigned char *end = bit->data + (bit->data_len & ~1);
+	unsigned crc = 0;
+	unsigned w;
+	unsigned addr;
+	unsigned count;
+	unsigned value;
+	int checks = 0;
+
+	while (p + 4 <= end && !(get16(p) == SYNC_HI && get16(p + 2) == SYNC_LO)) {
+		p += 2;
+	}
+	if (p + 4 > end) {
+		error("no sync word in %s", path);
+	}
+	p += 4;
+	while (p + 2 <= end) {
+		w = get16(p);
+		p += 2;
+		if ((w >> 13) == 1) {
+			count = w & 0x1F;
+		} else if ((w >> 13) == 2) {
+			if (p + 4 > end) {
+				break;
+			}
+			count = (get16(p) << 16) | get16(p + 2);
+			p += 4;
+		} else {
+			continue;
+		}
+		if (((w >> 11) & 3) != OP_WRITE) {
+			continue;
+		}
+		addr = (w >> 5) & 0x3F;
+		if (count > (unsigned) (end - p) / 2) {
+			error("%s has a packet beyond the end of the bitstream", path);
+		}
+		if (addr == REG_CRC && count == 2) {
+			value = (get16(p) << 16) | get16(p + 2);
+			if (mode == CRC_VERIFY && value != crc) {
+				error("%s has CRC %08X where %08X was expected, so can't be patched",
+					  path, value, crc);
+			}
+			if (mode != CRC_VERIFY) {
+				value = (mode == CRC_UPDATE) ? crc : 0;
+				put16(p, value >> 16);
+				put16(p + 2, value);
+			}
+			checks++;
+			p += 4;
+			continue;
+		}
+		for (; count > 0; count--, p += 2) {
+			crc = crc_add(crc, addr, get16(p));
+			if (addr == REG_CMD && get16(p) == CMD_RCRC) {
+				crc = 0;
+			}
+		}
+	}
+	return checks;
+}
+
+static int get_bit(const bit_type *bit, unsigned pos) {
+	return (bit->data[pos >> 3] >> (pos & 7)) & 1;
+}
+
+static void set_bit(bit_type *bit, unsigned pos, int value) {
+	if (value) {
+		bit->data[pos >> 3] |= 1 << (pos & 7);
+	} else {
+		bit->data[pos >> 3] &= ~(1 << (pos & 7));
+	}
+}
+
+// ==================================================================
+// Memory files
+// ==================================================================
+
+// The size of the address space in a .bmm file, in bytes
+static unsigned read_bmm(const char *path) {
+	char line[MAX_LINE];
+	unsigned start;
+	unsigned end;
+	unsigned size = 0;
+	char *c;
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		error("unable to open %s", path);
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (strstr(line, "ADDRESS_SPACE") && !strstr(line, "END_ADDRESS_SPACE")) {
+			if ((c = strchr(line, '[')) == NULL || sscanf(c, "[%x:%x]", &start, &end) != 2) {
+				error("%s: expected ADDRESS_SPACE <name> <type> [<start>:<end>]", path);
+			}
+			if (size) {
+				error("%s: only one ADDRESS_SPACE is supported", path);
+			}
+			size = end - start + 1;
+		}
+	}
+	fclose(f);
+	if (size == 0) {
+		error("%s has no ADDRESS_SPACE", path);
+	}
+	return size;
+}
+
+static void read_mem(const char *path, unsigned char *mem, unsigned char *valid, unsigned size) {
+	char token[MAX_LINE];
+	unsigned addr = 0;
+	unsigned value;
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		error("unable to open %s", path);
+	}
+	while (fscanf(f, "%1023s", token) == 1) {
+		if (token[0] == '/' && token[1] == '/') {
+			fgets(token, sizeof(token), f);
+		} else if (token[0] == '@') {
+			if (sscanf(token + 1, "%x", &addr) != 1) {
+				error("%s: bad address %s", path, token);
+			}
+		} else {
+			if (strlen(token) != 2 || !isxdigit((unsigned char) token[0]) ||
+				!isxdigit((unsigned char) token[1])) {
+				error("%s: expected bytes as two hex digits, not %s", path, token);
+			}
+			if (addr >= size) {
+				error("%s: data beyond the %x byte address space", path, size);
+			}
+			sscanf(token, "%x", &value);
+			mem[addr] = value;
+			valid[addr] = 1;
+			addr++;
+		}
+	}
+	fclose(f);
+}
+
+static void write_mem(const char *path, unsigned size, int k) {
+	unsigned i;
+	unsigned b;
+	int v;
+	FILE *f = fopen(path, "w");
+	if (f == NULL) {
+		error("unable to write %s", path);
+	}
+	// k < 0: all zeros, k == 32: all ones, else bit j is bit k of j
+	for (i = 0; i < size; i++) {
+		v = 0;
+		for (b = 0; b < 8; b++) {
+			if (k == 32 || (k >= 0 && (((i * 8 + b) >> k) & 1))) {
+				v |= 1 << b;
+			}
+		}
+		fprintf(f, " %02x%s", v, (i & 15) == 15 ? "\n" : "");
+	}
+	fclose(f);
+}
+
+// ==================================================================
+// Calibration
+// ==================================================================
+
+static void run_data2mem(const char *bmm, const char *mem, const char *in, const char *out, bit_type *bit) {
+	char cmd[4 * MAX_LINE];
+	const char *data2mem = getenv("DATA2MEM") ? getenv("DATA2MEM") : "data2mem";
+	snprintf(cmd, sizeof(cmd), "%s -bm %s -bd %s -bt %s -o b %s > /dev/null", data2mem, bmm, mem, in, out);
+	if (system(cmd) != 0) {
+		error("%s failed", cmd);
+	}
+	read_bit(out, bit);
+	// The CRCs follow the data, so would look like memory bits
+	fix_crc(bit, out, CRC_CLEAR);
+}
+
+static void calibrate(const char *bmm, const char *in, const char *out) {
+	char dir[] = "/tmp/brampatchXXXXXX";
+	char mem[MAX_LINE];
+	char bit[MAX_LINE];
+	char cmd[MAX_LINE];
+	bit_type zeros;
+	bit_type ones;
+	bit_type *pattern;
+	unsigned *map;
+	unsigned size = read_bmm(bmm);
+	unsigned nbits = size * 8;
+	unsigned npatterns = 0;
+	unsigned pos;
+	unsigned j;
+	unsigned found = 0;
+	unsigned k;
+	unsigned header[3];
+	FILE *f;
+
+	while ((1u << npatterns) < nbits) {
+		npatterns++;
+	}
+	if (mkdtemp(dir) == NULL) {
+		error("unable to make a temporary directory");
+	}
+	snprintf(mem, sizeof(mem), "%s/pattern.mem", dir);
+	snprintf(bit, sizeof(bit), "%s/pattern.bit", dir);
+
+	printf("Calibrating %u bytes, with %u runs of data2mem\n", size, npatterns + 2);
+
+	write_mem(mem, size, -1);
+	run_data2mem(bmm, mem, in, bit, &zeros);
+	write_mem(mem, size, 32);
+	run_data2mem(bmm, mem, in, bit, &ones);
+	if (ones.data_len != zeros.data_len) {
+		error("data2mem changed the length of the bitstream");
+	}
+
+	pattern = calloc(npatterns, sizeof(bit_type));
+	map = malloc(nbits * sizeof(unsigned));
+	if (pattern == NULL || map == NULL) {
+		error("out of memory");
+	}
+	for (k = 0; k < npatterns; k++) {
+		write_mem(mem, size, k);
+		run_data2mem(bmm, mem, in, bit, &pattern[k]);
+		if (pattern[k].data_len != zeros.data_len) {
+			error("data2mem changed the length of the bitstream");
+		}
+	}
+	for (j = 0; j < nbits; j++) {
+		map[j] = ~0u;
+	}
+
+	// Each bit that differs between all zeros and all ones holds bit j of
+	// the memory, and the patterns it follows spell out j
+	for (pos = 0; pos < zeros.data_len * 8; pos++) {
+		if (get_bit(&zeros, pos) == get_bit(&ones, pos)) {
+			for (k = 0; k < npatterns; k++) {
+				if (get_bit(&pattern[k], pos) != get_bit(&zeros, pos)) {
+					error("bitstream bit %u changes with the data, but not with all ones", pos);
+				}
+			}
+			continue;
+		}
+		j = 0;
+		for (k = 0; k < npatterns; k++) {
+			if (get_bit(&pattern[k], pos) != get_bit(&zeros, pos)) {
+				j |= 1 << k;
+			}
+		}
+		if (j >= nbits || map[j] != ~0u) {
+			error("bitstream bit %u does not map to a unique memory bit", pos);
+		}
+		map[j] = pos | (get_bit(&zeros, pos) ? MAP_INVERTED : 0);
+		found++;
+	}
+	if (found != nbits) {
+		error("found %u of the %u memory bits in the bitstream", found, nbits);
+	}
+
+	f = fopen(out, "wb");
+	header[0] = MAP_MAGIC;
+	header[1] = nbits;
+	header[2] = zeros.data_len;
+	if (f == NULL || fwrite(header, sizeof(header), 1, f) != 1 ||
+		fwrite(map, sizeof(unsigned), nbits, f) != nbits || fclose(f)) {
+		error("unable to write %s", out);
+	}
+
+	snprintf(cmd, sizeof(cmd), "rm -rf %s", dir);
+	system(cmd);
+
+	printf("Written %s: all %u bits located\n", out, nbits);
+}
+
+// ==================================================================
+// Patching
+// ==================================================================
+
+static void patch(const char *mapfile, const char *memfile, const char *in, const char *out) {
+	unsigned char *buf;
+	unsigned len;
+	unsigned *header;
+	unsigned *map;
+	unsigned nbits;
+	unsigned size;
+	unsigned char *mem;
+	unsigned char *valid;
+	unsigned i;
+	unsigned b;
+	unsigned changed = 0;
+	unsigned pos;
+	int v;
+	int checks;
+	bit_type bit;
+
+	buf = read_file(mapfile, &len);
+	header = (unsigned *) buf;
+	if (len < 12 || header[0] != MAP_MAGIC || len != 12 + header[1] * sizeof(unsigned)) {
+		error("%s is not a map from brampatch calibrate", mapfile);
+	}
+	nbits = header[1];
+	map = header + 3;
+	size = nbits / 8;
+
+	read_bit(in, &bit);
+	if (bit.data_len != header[2]) {
+		error("%s is not the bitstream %s was made from", in, mapfile);
+	}
+	// With no CRC check found, a stale CRC can't be ruled out
+	checks = fix_crc(&bit, in, CRC_VERIFY);
+	if (checks == 0) {
+		error("no CRC check found in %s, so it can't be patched safely", in);
+	}
+
+	mem = calloc(size, 1);
+	valid = calloc(size, 1);
+	if (mem == NULL || valid == NULL) {
+		error("out of memory");
+	}
+	read_mem(memfile, mem, valid, size);
+
+	// Bytes not in the .mem file are left as they are
+	for (i = 0; i < size; i++) {
+		if (!valid[i]) {
+			continue;
+		}
+		for (b = 0; b < 8; b++) {
+			pos = map[i * 8 + b] & ~MAP_INVERTED;
+			v = ((mem[i] >> b) & 1) ^ ((map[i * 8 + b] & MAP_INVERTED) ? 1 : 0);
+			if (pos >= bit.data_len * 8) {
+				error("%s does not fit %s", mapfile, in);
+			}
+			if (get_bit(&bit, pos) != v) {
+				set_bit(&bit, pos, v);
+				changed++;
+			}
+		}
+	}
+
+	if (fix_crc(&bit, in, CRC_UPDATE) != checks) {
+		error("patching %s changed its configuration packets", in);
+	}
+	write_file(out, bit.buf, bit.len);
+	printf("Written %s: %u bits changed, %d CRC check%s updated\n", out, changed,
+		   checks, checks == 1 ? "" : "s");
+}
+
+int main(int argc, char *argv[]) {
+	if (argc == 5 && strcmp(argv[1], "calibrate") == 0) {
+		calibrate(argv[2], argv[3], argv[4]);
+	} else if (argc == 6 && strcmp(argv[1], "patch") == 0) {
+		patch(argv[2], argv[3], argv[4], argv[5]);
+	} else {
+		fprintf(stderr, "Usage: %s calibrate <_bd.bmm> <input.bit> <output.map>\n"
+				"       %s patch <.map> <input.mem> <input.bit> <output.bit>\n\n"
+				"Updates the block RAM contents of a Spartan-6 bitstream without data2mem,\n"
+				"using a map of the block RAM bits made with data2mem once per build\n",
+				argv[0], argv[0]);
+		return 1;
+	}
+	return 0;
+}
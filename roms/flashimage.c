@@ -0,0 +1,539 @@
+/*
+ * Flash Image Composer
+ *
+ * Builds a complete configuration flash image from a manifest of regions
+ * (boot loader, bitstreams, ROM images), in place of a chain of bitmerge
+ * calls. Every input is mapped rather than read, and the .bit, .bin and
+ * .mcs outputs are all written in a single pass over the layout.
+ *
+ * The manifest has one region per line, "<hex address> <file>", plus:
+ *
+ *   flash <size>    size of the flash, which no region may pass
+ *   fill <byte>     value of the gaps between regions (default 00)
+ *   sector <size>   erase sector size of the flash (default 0x10000)
+ *
+ * Blank lines and anything after a # are ignored. A region given as a .bit
+ * file contributes only its configuration data (the 'e' section), as
+ * "promgen -b -p bin" would give. The region at address 0 must be a .bit
+ * file, as the .bit output takes its header from it.
+ *
+ * Regions may be in any order, but must not overlap.
+ *
+ * A hash of each erase sector goes in <output base>.sectors. Given the
+ * .sectors file of the image last programmed (-p), the sectors that have
+ * changed are listed, and written to <output base>.delta as runs of
+ * "<hex address> <hex length>", so that only those need be erased and
+ * programmed (see program_duo.sh).
+ *
+ * Usage: flashimage [-p <programmed.sectors>] <manifest> <output base>
+ *
+ * writes <output base>.bit, .bin, .mcs, .sectors and (with -p) .delta
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MAX_REGIONS   32
+#define MAX_LINE      1024
+
+// Bytes of data in each .mcs record
+#define MCS_LINE      16
+
+#define MAX_SECTORS   4096
+#define FNV_OFFSET    0xcbf29ce484222325ULL
+#define FNV_PRIME     0x100000001b3ULL
+
+typedef struct {
+	unsigned addr;
+	char *path;
+	int line;
+	const unsigned char *map;   // whole file
+	size_t map_len;
+	const unsigned char *data;  // configuration data within it
+	unsigned len;
+} region_type;
+
+static region_type regions[MAX_REGIONS];
+static int num_regions;
+
+static unsigned flash_size;
+static int fill = 0x00;
+static unsigned sector_size = 0x10000;
+
+// .bit header of the region at address 0, up to the 'e' section
+static const unsigned char *bit_header;
+static unsigned bit_header_len;
+
+static void __attribute__ ((format (printf, 1, 2), noreturn)) error(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+	va_end(ap);
+	exit(2);
+}
+
+static int has_suffix(const char *path, const char *suffix) {
+	size_t n = strlen(path);
+	size_t m = strlen(suffix);
+	return n >= m && strcasecmp(path + n - m, suffix) == 0;
+}
+
+// ==================================================================
+// Inputs
+// ==================================================================
+
+static void map_file(region_type *r) {
+	struct stat st;
+	int fd = open(r->path, O_RDONLY);
+	if (fd < 0) {
+		error("line %d: unable to open %s", r->line, r->path);
+	}
+	if (fstat(fd, &st) < 0 || st.st_size == 0) {
+		error("line %d: %s is empty", r->line, r->path);
+	}
+	r->map_len = st.st_size;
+	r->map = mmap(NULL, r->map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (r->map == MAP_FAILED) {
+		error("line %d: unable to map %s", r->line, r->path);
+	}
+	close(fd);
+}
+
+// Finds the configuration data in a .bit file: a fixed preamble, then
+// keyed fields 'a' to 'd' with 16 bit lengths, then 'e' with a 32 bit one
+static void parse_bit(region_type *r) {
+	static const unsigned char preamble[] = {
+		0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01
+	};
+	const unsigned char *p = r->map;
+	size_t len = r->map_len;
+	size_t i = sizeof(preamble);
+	unsigned n;
+
+	if (len < i || memcmp(p, preamble, sizeof(preamble)) != 0) {
+		error("line %d: %s is not a .bit file", r->line, r->path);
+	}
+	while (i < len && p[i] != 'e') {
+		if (p[i] < 'a' || p[i] > 'd' || i + 3 > len) {
+			error("line %d: %s has a bad header", r->line, r->path);
+		}
+		n = (p[i + 1] << 8) | p[i + 2];
+		i += 3 + n;
+	}
+	if (i + 5 > len) {
+		error("line %d: %s has no configuration data", r->line, r->path);
+	}
+	n = (p[i + 1] << 24) | (p[i + 2] << 16) | (p[i + 3] << 8) | p[i + 4];
+	if (i + 5 + n != len) {
+		error("line %d: %s length differs from the expected", r->line, r->path);
+	}
+	if (r->addr == 0) {
+		bit_header = p;
+		bit_header_len = i;
+	}
+	r->data = p + i + 5;
+	r->len = n;
+}
+
+static void read_manifest(const char *path) {
+	char line[MAX_LINE];
+	char word[MAX_LINE];
+	char file[MAX_LINE];
+	char *c;
+	unsigned value;
+	int num = 0;
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		error("unable to open manifest %s", path);
+	}
+	while (fgets(line, sizeof(line), f)) {
+		num++;
+		if ((c = strchr(line, '#')) != NULL) {
+			*c = 0;
+		}
+		if (sscanf(line, "%s", word) != 1) {
+			continue;
+		}
+		if (strcmp(word, "flash") == 0) {
+			if (sscanf(line, "%*s %i", &flash_size) != 1) {
+				error("line %d: expected flash <size>", num);
+			}
+		} else if (strcmp(word, "sector") == 0) {
+			if (sscanf(line, "%*s %i", &sector_size) != 1 || sector_size == 0) {
+				error("line %d: expected sector <size>", num);
+			}
+		} else if (strcmp(word, "fill") == 0) {
+			if (sscanf(line, "%*s %x", &value) != 1 || value > 0xFF) {
+				error("line %d: expected fill <hex byte>", num);
+			}
+			fill = value;
+		} else if (isxdigit((unsigned char)word[0])) {
+			if (sscanf(line, "%x %s", &value, file) != 2) {
+				error("line %d: expected <hex address> <file>", num);
+			}
+			if (num_regions == MAX_REGIONS) {
+				error("line %d: more than %d regions", num, MAX_REGIONS);
+			}
+			regions[num_regions].addr = value;
+			regions[num_regions].path = strdup(file);
+			regions[num_regions].line = num;
+			num_regions++;
+		} else {
+			error("line %d: unknown keyword %s", num, word);
+		}
+	}
+	fclose(f);
+	if (num_regions == 0) {
+		error("%s has no regions", path);
+	}
+	if (flash_size == 0) {
+		error("%s does not give the flash size", path);
+	}
+	if (flash_size % sector_size || flash_size / sector_size > MAX_SECTORS) {
+		error("the flash must be a whole number of sectors, at most %d", MAX_SECTORS);
+	}
+}
+
+static int compare_regions(const void *a, const void *b) {
+	unsigned x = ((const region_type *)a)->addr;
+	unsigned y = ((const region_type *)b)->addr;
+	return (x > y) - (x < y);
+}
+
+static void check_layout() {
+	int i;
+	region_type *r;
+	qsort(regions, num_regions, sizeof(region_type), compare_regions);
+	if (regions[0].addr != 0 || bit_header == NULL) {
+		error("the region at address 0 must be a .bit file");
+	}
+	for (i = 0; i < num_regions; i++) {
+		r = &regions[i];
+		if ((unsigned long) r->addr + r->len > flash_size) {
+			error("%s (%06x-%06x) does not fit in the %x byte flash",
+				  r->path, r->addr, r->addr + r->len - 1, flash_size);
+		}
+		if (i + 1 < num_regions && r->addr + r->len > regions[i + 1].addr) {
+			error("%s (%06x-%06x) overlaps %s at %06x",
+				  r->path, r->addr, r->addr + r->len - 1,
+				  regions[i + 1].path, regions[i + 1].addr);
+		}
+	}
+	printf("Address  End      Size     Free     File\n");
+	for (i = 0; i < num_regions; i++) {
+		r = &regions[i];
+		printf("%06x   %06x   %06x   %06x   %s\n", r->addr, r->addr + r->len - 1, r->len,
+			   (i + 1 < num_regions ? regions[i + 1].addr : flash_size) - r->addr - r->len,
+			   r->path);
+	}
+}
+
+// ==================================================================
+// Outputs
+// ==================================================================
+
+static FILE *bit_file;
+static FILE *bin_file;
+static FILE *mcs_file;
+
+static unsigned char mcs_line[MCS_LINE];
+static unsigned mcs_count;
+static unsigned mcs_addr;
+
+static void mcs_record(int type, unsigned addr, const unsigned char *data, int len) {
+	int i;
+	int sum = len + (addr >> 8) + addr + type;
+	fprintf(mcs_file, ":%02X%04X%02X", len, addr & 0xFFFF, type);
+	for (i = 0; i < len; i++) {
+		fprintf(mcs_file, "%02X", data[i]);
+		sum += data[i];
+	}
+	fprintf(mcs_file, "%02X\n", -sum & 0xFF);
+}
+
+static void mcs_flush() {
+	unsigned char upper[2];
+	if (mcs_count == 0) {
+		return;
+	}
+	// Extended linear address record at the start of each 64KB
+	if ((mcs_addr & 0xFFFF) == 0) {
+		upper[0] = mcs_addr >> 24;
+		upper[1] = mcs_addr >> 16;
+		mcs_record(4, 0, upper, 2);
+	}
+	mcs_record(0, mcs_addr, mcs_line, mcs_count);
+	mcs_addr += mcs_count;
+	mcs_count = 0;
+}
+
+static void mcs_write(const unsigned char *data, unsigned len) {
+	unsigned n;
+	while (len) {
+		n = MCS_LINE - mcs_count;
+		if (n > len) {
+			n = len;
+		}
+		memcpy(mcs_line + mcs_count, data, n);
+		mcs_count += n;
+		data += n;
+		len -= n;
+		if (mcs_count == MCS_LINE) {
+			mcs_flush();
+		}
+	}
+}
+
+// ==================================================================
+// Sector hashes
+// ==================================================================
+
+static unsigned long long sector_hash[MAX_SECTORS];
+static unsigned num_sectors;
+static unsigned sector_count;   // bytes so far of the current sector
+
+static unsigned long long old_hash[MAX_SECTORS];
+static unsigned num_old_sectors;
+
+static void hash_write(const unsigned char *data, unsigned len) {
+	unsigned long long h = sector_hash[num_sectors];
+	while (len--) {
+		if (sector_count == 0) {
+			h = FNV_OFFSET;
+		}
+		h = (h ^ *data++) * FNV_PRIME;
+		if (++sector_count == sector_size) {
+			sector_hash[num_sectors++] = h;
+			sector_count = 0;
+		}
+	}
+	sector_hash[num_sectors] = h;
+}
+
+// A partial last sector also hashes its length, as the rest is erased
+static void hash_flush() {
+	if (sector_count) {
+		sector_hash[num_sectors] = (sector_hash[num_sectors] ^ sector_count) * FNV_PRIME;
+		num_sectors++;
+		sector_count = 0;
+	}
+}
+
+static void write_sectors(const char *base) {
+	char path[MAX_LINE];
+	unsigned i;
+	FILE *f;
+	snprintf(path, sizeof(path), "%s.sectors", base);
+	if ((f = fopen(path, "w")) == NULL) {
+		error("unable to open output %s", path);
+	}
+	fprintf(f, "sector %x\n", sector_size);
+	for (i = 0; i < num_sectors; i++) {
+		fprintf(f, "%06x %016llx\n", i * sector_size, sector_hash[i]);
+	}
+	fclose(f);
+}
+
+// A missing or mismatched file leaves no old sectors, so all have changed
+static void read_programmed(const char *path) {
+	char line[MAX_LINE];
+	unsigned size = 0;
+	unsigned addr;
+	unsigned long long h;
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		printf("No record of the programmed image (%s), so every sector has changed\n", path);
+		return;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "sector %x", &size) == 1) {
+			continue;
+		}
+		if (sscanf(line, "%x %llx", &addr, &h) != 2 || size != sector_size ||
+			addr != num_old_sectors * sector_size || num_old_sectors == MAX_SECTORS) {
+			printf("%s does not match this layout, so every sector has changed\n", path);
+			num_old_sectors = 0;
+			break;
+		}
+		old_hash[num_old_sectors++] = h;
+	}
+	fclose(f);
+}
+
+static void write_delta(const char *base, unsigned total) {
+	char path[MAX_LINE];
+	unsigned i;
+	unsigned j;
+	unsigned start;
+	unsigned end;
+	unsigned changed = 0;
+	unsigned runs = 0;
+	unsigned bytes = 0;
+	int first;
+	region_type *r;
+	FILE *f;
+	snprintf(path, sizeof(path), "%s.delta", base);
+	if ((f = fopen(path, "w")) == NULL) {
+		error("unable to open output %s", path);
+	}
+	printf("Changed sectors:\n");
+	for (i = 0; i < num_sectors; i = j) {
+		if (i < num_old_sectors && sector_hash[i] == old_hash[i]) {
+			j = i + 1;
+			continue;
+		}
+		for (j = i + 1; j < num_sectors; j++) {
+			if (j < num_old_sectors && sector_hash[j] == old_hash[j]) {
+				break;
+			}
+		}
+		start = i * sector_size;
+		end = j * sector_size < total ? j * sector_size : total;
+		fprintf(f, "%06x %06x\n", start, end - start);
+		changed += j - i;
+		runs++;
+		bytes += end - start;
+		// Name the regions in the run
+		printf("  %06x-%06x", start, end - 1);
+		first = 1;
+		for (r = regions; r < regions + num_regions; r++) {
+			if (r->addr < end && r->addr + r->len > start) {
+				printf("%s%s", first ? " " : ", ", r->path);
+				first = 0;
+			}
+		}
+		printf("%s\n", first ? " (gap)" : "");
+	}
+	fclose(f);
+	if (changed == 0) {
+		printf("  none\n");
+	}
+	printf("%u of %u sectors changed, in %u run%s: %u KB to program of %u KB\n",
+		   changed, num_sectors, runs, runs == 1 ? "" : "s", bytes / 1024, total / 1024);
+}
+
+static void emit(const unsigned char *data, unsigned len) {
+	if (fwrite(data, 1, len, bit_file) != len || fwrite(data, 1, len, bin_file) != len) {
+		error("unable to write output");
+	}
+	mcs_write(data, len);
+	hash_write(data, len);
+}
+
+static void emit_fill(unsigned len) {
+	unsigned char block[4096];
+	unsigned n;
+	memset(block, fill, sizeof(block));
+	while (len) {
+		n = len < sizeof(block) ? len : sizeof(block);
+		emit(block, n);
+		len -= n;
+	}
+}
+
+static FILE *open_output(const char *base, const char *suffix) {
+	char path[MAX_LINE];
+	FILE *f;
+	snprintf(path, sizeof(path), "%s%s", base, suffix);
+	if ((f = fopen(path, "wb")) == NULL) {
+		error("unable to open output %s", path);
+	}
+	return f;
+}
+
+int main(int argc, char *argv[]) {
+	int i;
+	unsigned addr = 0;
+	unsigned total;
+	unsigned char len[4];
+	region_type *r;
+	const char *programmed = NULL;
+	const char *base;
+	int c;
+
+	while ((c = getopt(argc, argv, "p:")) != -1) {
+		if (c == 'p') {
+			programmed = optarg;
+		} else {
+			return 1;
+		}
+	}
+	if (argc - optind != 2) {
+		fprintf(stderr, "Usage: %s [-p <programmed.sectors>] <manifest> <output base>\n\n"
+				"Composes a flash image from the regions in the manifest, as\n"
+				"<output base>.bit, <output base>.bin and <output base>.mcs, with\n"
+				"the sectors changed since the programmed image in <output base>.delta\n",
+				argv[0]);
+		return 1;
+	}
+	base = argv[optind + 1];
+
+	read_manifest(argv[optind]);
+
+	for (i = 0; i < num_regions; i++) {
+		r = &regions[i];
+		map_file(r);
+		if (has_suffix(r->path, ".bit")) {
+			parse_bit(r);
+		} else {
+			r->data = r->map;
+			r->len = r->map_len;
+		}
+	}
+
+	check_layout();
+
+	r = &regions[num_regions - 1];
+	total = r->addr + r->len;
+
+	bit_file = open_output(base, ".bit");
+	bin_file = open_output(base, ".bin");
+	mcs_file = open_output(base, ".mcs");
+
+	// The boot loader's .bit header, with the 'e' length of the whole image
+	if (fwrite(bit_header, 1, bit_header_len, bit_file) != bit_header_len) {
+		error("unable to write output");
+	}
+	len[0] = total >> 24;
+	len[1] = total >> 16;
+	len[2] = total >> 8;
+	len[3] = total;
+	fputc('e', bit_file);
+	fwrite(len, 1, 4, bit_file);
+
+	for (i = 0; i < num_regions; i++) {
+		r = &regions[i];
+		emit_fill(r->addr - addr);
+		emit(r->data, r->len);
+		addr = r->addr + r->len;
+		munmap((void *)r->map, r->map_len);
+	}
+	mcs_flush();
+	mcs_record(1, 0, NULL, 0);
+	hash_flush();
+
+	if (fclose(bit_file) || fclose(bin_file) || fclose(mcs_file)) {
+		error("unable to write output");
+	}
+
+	printf("Written %s.bit/.bin/.mcs: %u bytes (%u%% of the %u byte flash)\n",
+		   base, total, (unsigned) ((unsigned long long) total * 100 / flash_size), flash_size);
+
+	write_sectors(base);
+	if (programmed) {
+		read_programmed(programmed);
+		write_delta(base, total);
+	}
+
+	return 0;
+}
@@ -1,13 +1,14 @@
 #!/bin/bash
-. /opt/Xilinx/14.7/ISE_DS/settings64.sh
+. /opt/Xilinx/14.7/ISE_DS/settings64.sh 2> /dev/null
 
-# Set to true to run data2mem to merge in latest AVR firmware for ICE T65
+# Set to true to merge in latest AVR firmware for ICE T65 (see brampatch.c)
 run_data2mem=true
 
-# Papilio Programmer settings
-PAPILIO_LOADER=/opt/GadgetFactory/papilio-loader/programmer
-PROG=${PAPILIO_LOADER}/linux64/papilio-prog
-BSCAN=${PAPILIO_LOADER}/bscan_spi_xc6slx9.bit
+# How to program the Papilio Duo (see program_duo.sh):
+#   delta - only the flash sectors changed since the last time
+#   full  - the whole image
+#   none  - don't program, just report the changed sectors (a dry run)
+PROGRAM=${PROGRAM:-delta}
 
 # Merge in the AVR Firmware
 
@@ -15,29 +16,50 @@ if [ "$run_data2mem" = true ]; then
 
     echo "Merging AVR Firmware"
 
+    gcc -O2 -o tmp/brampatch brampatch.c
+
+    # Usage: merge_avr <bmm> <mem> <working bit> <output bit>
+    #
+    # Patches the firmware in with brampatch, using the map of the block
+    # RAM bits saved next to the working bitstream. data2mem is only needed
+    # to make that map, once after each build of the bitstream.
+    merge_avr() {
+        MAP=${3%.bit}.map
+        if [ ! "${MAP}" -nt "$3" ]; then
+            if ! type data2mem > /dev/null 2>&1; then
+                echo "ERROR: ${MAP} is out of date, and data2mem is needed to remake it"
+                exit 1
+            fi
+            ./tmp/brampatch calibrate $1 $3 ${MAP} || exit 1
+        fi
+        ./tmp/brampatch patch ${MAP} $2 $3 $4 || exit 1
+    }
+
     pushd ../AtomBusMon/target/lx9_dave/ice6502
     make -B avr_progmem.mem
     popd
-    data2mem -bm ../xilinx/duo_cpumon_modelb_bd.bmm \
-             -bd ../AtomBusMon/target/lx9_dave/ice6502/avr_progmem.mem \
-             -bt ../xilinx/working/bbc_micro_duo/bbc_micro_duo.bit \
-             -o b tmp/bbc_micro_duo.bit
-    data2mem -bm ../xilinx/duo_cpumon_modelb_nula_bd.bmm \
-             -bd ../AtomBusMon/target/lx9_dave/ice6502/avr_progmem.mem \
-             -bt ../xilinx/working/bbc_micro_duo_nula/bbc_micro_duo.bit \
-             -o b tmp/bbc_micro_duo_nula.bit
+    merge_avr ../xilinx/duo_cpumon_modelb_bd.bmm \
+              ../AtomBusMon/target/lx9_dave/ice6502/avr_progmem.mem \
+              ../xilinx/working/bbc_micro_duo/bbc_micro_duo.bit \
+              tmp/bbc_micro_duo.bit
+    merge_avr ../xilinx/duo_cpumon_modelb_nula_bd.bmm \
+              ../AtomBusMon/target/lx9_dave/ice6502/avr_progmem.mem \
+              ../xilinx/working/bbc_micro_duo_nula/bbc_micro_duo.bit \
+              tmp/bbc_micro_duo_nula.bit
 
     pushd ../AtomBusMon/target/lx9_dave/ice65c02
     make -B avr_progmem.mem
     popd
-    data2mem -bm ../xilinx/duo_cpumon_master_bd.bmm \
-             -bd ../AtomBusMon/target/lx9_dave/ice65c02/avr_progmem.mem \
-             -bt ../xilinx/working/bbc_master_duo/bbc_micro_duo.bit \
-             -o b tmp/bbc_master_duo.bit
-    data2mem -bm ../xilinx/duo_cpumon_master_nula_bd.bmm \
-             -bd ../AtomBusMon/target/lx9_dave/ice65c02/avr_progmem.mem \
-             -bt ../xilinx/working/bbc_master_duo_nula/bbc_micro_duo.bit \
-             -o b tmp/bbc_master_duo_nula.bit
+    merge_avr ../xilinx/duo_cpumon_master_bd.bmm \
+              ../AtomBusMon/target/lx9_dave/ice65c02/avr_progmem.mem \
+              ../xilinx/working/bbc_master_duo/bbc_micro_duo.bit \
+              tmp/bbc_master_duo.bit
+    merge_avr ../xilinx/duo_cpumon_master_nula_bd.bmm \
+              ../AtomBusMon/target/lx9_dave/ice65c02/avr_progmem.mem \
+              ../xilinx/working/bbc_master_duo_nula/bbc_micro_duo.bit \
+              tmp/bbc_master_duo_nula.bit
+
+    rm -f tmp/brampatch
 
 else
 
@@ -53,6 +75,10 @@ fi
 # Build a fresh ROM image (tmp/rom_image.bin)
 ./make_rom_image.sh
 
+# Compose the flash image (tmp/merged.bit, .bin and .mcs) in one pass,
+# using the layout in duo_flash.txt, and list the sectors that differ from
+# the image last programmed:
+#
 # 0x000000 - Boot Loader
 # 0x054000 - BBC Micro Bitstream
 # 0x0a8000 - BBC Master Bitstream
@@ -60,37 +86,19 @@ fi
 # 0x150000 - BBC Master Bitstream (NuLA)
 # 0x200000 - BBC Micro ROMS
 # 0x240000 - BBC Master ROMS
-
-# Compile the bitmerge tool, which merges addition data files into the main .bit file
-gcc -o tmp/bitmerge bitmerge.c
-
-# Strip of the bitstream header from target .bit files, so they can be treated as raw data
-promgen -b -u 0 tmp/bbc_micro_duo.bit       -o tmp/bbc_micro_duo.bin       -p bin -w
-promgen -b -u 0 tmp/bbc_master_duo.bit      -o tmp/bbc_master_duo.bin      -p bin -w
-promgen -b -u 0 tmp/bbc_micro_duo_nula.bit  -o tmp/bbc_micro_duo_nula.bin  -p bin -w
-promgen -b -u 0 tmp/bbc_master_duo_nula.bit -o tmp/bbc_master_duo_nula.bin -p bin -w
-
-# Merge everything together into a single .bit file
-cp ../xilinx/working/duo_boot_loader/duo_boot_loader.bit         tmp/merged.bit
-./tmp/bitmerge tmp/merged.bit  54000:tmp/bbc_micro_duo.bin       tmp/merged.bit
-./tmp/bitmerge tmp/merged.bit  A8000:tmp/bbc_master_duo.bin      tmp/merged.bit
-./tmp/bitmerge tmp/merged.bit  FC000:tmp/bbc_micro_duo_nula.bin  tmp/merged.bit
-./tmp/bitmerge tmp/merged.bit 150000:tmp/bbc_master_duo_nula.bin tmp/merged.bit
-./tmp/bitmerge tmp/merged.bit 200000:tmp/rom_image.bin           tmp/merged.bit
+gcc -O2 -o tmp/flashimage flashimage.c
+./tmp/flashimage -p tmp/programmed.sectors duo_flash.txt tmp/merged || exit 1
 
 # Remove working files
-rm -f tmp/bitmerge
-rm -f tmp/bbc_micro_duo.bin
-rm -f tmp/bbc_master_duo.bin
+rm -f tmp/flashimage
 rm -f tmp/bbc_micro_duo.bit
 rm -f tmp/bbc_master_duo.bit
-rm -f tmp/bbc_micro_duo_nula.bin
-rm -f tmp/bbc_master_duo_nula.bin
 rm -f tmp/bbc_micro_duo_nula.bit
 rm -f tmp/bbc_master_duo_nula.bit
 
 # Program the Papilo Duo
-sudo ${PROG} -v -f tmp/merged.bit -b ${BSCAN}  -sa -r
-
-# Reset the Papilio Duo
-sudo ${PROG} -c
+case ${PROGRAM} in
+    delta) ./program_duo.sh ;;
+    full)  ./program_duo.sh -f ;;
+    *)     echo "Not programming (PROGRAM=${PROGRAM})" ;;
+esac
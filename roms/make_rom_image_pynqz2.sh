@@ -1,59 +1,20 @@
 #!/bin/bash
 
-# Create the 512K ROM image
+# Create the 512K ROM image (tmp/pynqz2_rom.bin and .hex)
 #
 # This contains:
 # 16x 16K ROMS images for the Master 128
+#
+# The layout is in rom_image_pynqz2.txt
 
-BINIMAGE=tmp/pynqz2_rom.bin
-HEXIMAGE=tmp/pynqz2_rom.hex
-
-rm -f $BINIMAGE
-rm -f $HEXIMAGE
-
-# Master ROM Images
-
-cat generic/blank.rom          >  $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-
-# Note: It's not possible to pre-load the sideways RAM banks (4-7)
-cat m128/mos.rom               >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-
-cat m128/dfs.rom               >> $BINIMAGE # Retain this for SRAM Utils
-cat m128/mammfsspi.rom         >> $BINIMAGE # MMFS in a higher slot
-cat m128/viewsht.rom           >> $BINIMAGE
-cat m128/edit.rom              >> $BINIMAGE
-
-cat m128/basic4.rom            >> $BINIMAGE
-cat m128/adfs.rom              >> $BINIMAGE
-cat m128/view.rom              >> $BINIMAGE
-cat m128/terminal.rom          >> $BINIMAGE
-
-# Second 256K is all zeros
-
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
+mkdir -p tmp
 
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
+# Disk Server Filing System (served by the BeebFpgaApp on the ARM)
 
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
-cat generic/blank.rom          >> $BINIMAGE
+if ! (which beebasm > /dev/null && cd tmp && beebasm -i ../../firmware/diskserv.asm)
+then
+    cp generic/blank.rom tmp/diskserv.rom
+fi
 
-od -An -tx1 -w16 -v < $BINIMAGE > $HEXIMAGE
+gcc -O2 -o tmp/romimage romimage.c
+./tmp/romimage rom_image_pynqz2.txt || exit 1
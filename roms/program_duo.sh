@@ -0,0 +1,50 @@
+#!/bin/bash
+
+# Program the flash image from make_duo_bitstream.sh (tmp/merged) into the
+# Papilio Duo's SPI flash.
+#
+# Only the sectors that changed since the last time are erased and
+# programmed, using the runs in tmp/merged.delta (see flashimage.c). The
+# whole image is programmed with papilio-prog the first time, or with -f.
+#
+# Usage: ./program_duo.sh [-f]
+
+PAPILIO_LOADER=/opt/GadgetFactory/papilio-loader/programmer
+PROG=${PAPILIO_LOADER}/linux64/papilio-prog
+BSCAN=${PAPILIO_LOADER}/bscan_spi_xc6slx9.bit
+
+# xc3sprog can write at an offset, which papilio-prog can't
+XC3SPROG=${XC3SPROG:-xc3sprog}
+CABLE=${CABLE:-papilio}
+
+IMAGE=tmp/merged
+PROGRAMMED=tmp/programmed.sectors
+
+if [ "$1" = "-f" ] || [ ! -f ${PROGRAMMED} ] || [ ! -f ${IMAGE}.delta ]; then
+
+    echo "Programming the whole image"
+
+    sudo ${PROG} -v -f ${IMAGE}.bit -b ${BSCAN} -sa -r || exit 1
+
+else
+
+    SECTOR=$((0x$(awk '/^sector/ { print $2 }' ${IMAGE}.sectors)))
+
+    # The loop reads the runs on fd 3, so sudo can't swallow them
+    while read ADDR LEN <&3
+    do
+        echo "Programming 0x${LEN} bytes at 0x${ADDR}"
+        dd if=${IMAGE}.bin of=tmp/delta.bin bs=${SECTOR} skip=$((0x${ADDR} / SECTOR)) \
+           count=$(((0x${LEN} + SECTOR - 1) / SECTOR)) status=none
+        sudo ${XC3SPROG} -c ${CABLE} -I${BSCAN} tmp/delta.bin:w:0x${ADDR}:BIN || exit 1
+    done 3< ${IMAGE}.delta
+
+    rm -f tmp/delta.bin
+
+fi
+
+# Only now is the flash known to hold the image
+cp ${IMAGE}.sectors ${PROGRAMMED}
+
+# Reset the Papilio Duo
+sudo ${PROG} -c
@@ -0,0 +1,367 @@
+/*
+ * ROM Image Builder
+ *
+ * Builds ROM images from manifests of 16K banks, in place of chains of
+ * cat. Each bank's contents are hashed, and a record of the hashes is
+ * kept next to each output, so on a rebuild only the banks that have
+ * changed are rewritten, in place.
+ *
+ * The manifest has one bank per line, "<bank> <rom file> [os]", plus:
+ *
+ *   banks <count>                       size of the image, in 16K banks
+ *   output <file> [<first> <count>]     an output of all the banks, or
+ *                                       just <count> from bank <first>
+ *
+ * Banks not listed are blank (all zeros). Blank lines and anything after
+ * a # are ignored. Outputs ending .hex are written as hex bytes, 16 to a
+ * line, as "od -An -tx1 -w16 -v" would (for $readmemh), others as binary.
+ *
+ * Every ROM except those marked "os" must be a sideways ROM, with a valid
+ * type byte and copyright string. ROMs shorter than 16K are padded with
+ * zeros.
+ *
+ * Usage: romimage <manifest> [<manifest> ...]
+ *
+ * writes the outputs of each manifest, and <output>.banks for each
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/stat.h>
+
+#define BANK_SIZE     0x4000
+#define MAX_BANKS     256
+#define MAX_OUTPUTS   8
+#define MAX_LINE      1024
+
+// A hex output line holds 16 bytes, each as " xx", then a newline
+#define HEX_LINE      16
+#define HEX_LINE_LEN  (HEX_LINE * 3 + 1)
+
+#define FNV_OFFSET    0xcbf29ce484222325ULL
+#define FNV_PRIME     0x100000001b3ULL
+
+// Sideways ROM header
+#define ROM_TYPE      6
+#define ROM_COPYRIGHT 7
+#define ROM_TITLE     9
+#define ROM_SERVICE   0x80
+#define ROM_LANGUAGE  0x40
+#define ROM_CPU       0x0F
+
+typedef struct {
+	char *path;
+	int line;
+	int os;
+	unsigned char *data;
+	unsigned long long hash;
+} bank_type;
+
+typedef struct {
+	char *path;
+	unsigned first;
+	unsigned count;
+	int hex;
+} output_type;
+
+static const char *manifest;
+static bank_type banks[MAX_BANKS];
+static unsigned num_banks;
+static output_type outputs[MAX_OUTPUTS];
+static int num_outputs;
+
+static unsigned char blank[BANK_SIZE];
+static unsigned long long blank_hash;
+
+static void __attribute__ ((format (printf, 1, 2), noreturn)) error(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	fprintf(stderr, "ERROR: %s: ", manifest);
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+	va_end(ap);
+	exit(2);
+}
+
+static int has_suffix(const char *path, const char *suffix) {
+	size_t n = strlen(path);
+	size_t m = strlen(suffix);
+	return n >= m && strcasecmp(path + n - m, suffix) == 0;
+}
+
+static unsigned long long hash(const unsigned char *data, unsigned len) {
+	unsigned long long h = FNV_OFFSET;
+	while (len--) {
+		h = (h ^ *data++) * FNV_PRIME;
+	}
+	return h;
+}
+
+// ==================================================================
+// Inputs
+// ==================================================================
+
+static void read_manifest(const char *path) {
+	char line[MAX_LINE];
+	char word[MAX_LINE];
+	char file[MAX_LINE];
+	char flag[MAX_LINE];
+	char *c;
+	unsigned value;
+	int n;
+	int num = 0;
+	output_type *o;
+	FILE *f = fopen(path, "r");
+	if (f == NULL) {
+		error("unable to open manifest");
+	}
+	memset(banks, 0, sizeof(banks));
+	num_banks = 0;
+	num_outputs = 0;
+	while (fgets(line, sizeof(line), f)) {
+		num++;
+		if ((c = strchr(line, '#')) != NULL) {
+			*c = 0;
+		}
+		if (sscanf(line, "%s", word) != 1) {
+			continue;
+		}
+		if (strcmp(word, "banks") == 0) {
+			if (sscanf(line, "%*s %i", &num_banks) != 1 || num_banks == 0 || num_banks > MAX_BANKS) {
+				error("line %d: expected banks <count>, at most %d", num, MAX_BANKS);
+			}
+		} else if (strcmp(word, "output") == 0) {
+			if (num_outputs == MAX_OUTPUTS) {
+				error("line %d: more than %d outputs", num, MAX_OUTPUTS);
+			}
+			o = &outputs[num_outputs++];
+			n = sscanf(line, "%*s %s %i %i", file, &o->first, &o->count);
+			if (n == 2 || n < 1) {
+				error("line %d: expected output <file> [<first bank> <count>]", num);
+			}
+			if (n == 1) {
+				o->first = 0;
+				o->count = 0;   // all, once the size is known
+			}
+			o->path = strdup(file);
+			o->hex = has_suffix(file, ".hex");
+		} else if (isdigit((unsigned char)word[0])) {
+			n = sscanf(line, "%i %s %s", &value, file, flag);
+			if (n < 2 || (n == 3 && strcmp(flag, "os") != 0)) {
+				error("line %d: expected <bank> <rom file> [os]", num);
+			}
+			if (value >= num_banks) {
+				error("line %d: bank %d is beyond the %d bank image", num, value, num_banks);
+			}
+			if (banks[value].path) {
+				error("line %d: bank %d is already %s", num, value, banks[value].path);
+			}
+			banks[value].path = strdup(file);
+			banks[value].line = num;
+			banks[value].os = (n == 3);
+		} else {
+			error("line %d: unknown keyword %s", num, word);
+		}
+	}
+	fclose(f);
+	if (num_banks == 0) {
+		error("does not give the number of banks");
+	}
+	if (num_outputs == 0) {
+		error("has no outputs");
+	}
+	for (n = 0; n < num_outputs; n++) {
+		o = &outputs[n];
+		if (o->count == 0) {
+			o->count = num_banks - o->first;
+		}
+		if (o->first + o->count > num_banks) {
+			error("output %s (banks %d-%d) is beyond the %d bank image",
+				  o->path, o->first, o->first + o->count - 1, num_banks);
+		}
+	}
+}
+
+static void read_rom(bank_type *b) {
+	size_t len;
+	FILE *f = fopen(b->path, "rb");
+	if (f == NULL) {
+		error("line %d: unable to open %s", b->line, b->path);
+	}
+	if ((b->data = calloc(BANK_SIZE + 1, 1)) == NULL) {
+		error("out of memory");
+	}
+	len = fread(b->data, 1, BANK_SIZE + 1, f);
+	fclose(f);
+	if (len > BANK_SIZE) {
+		error("line %d: %s is bigger than 16K", b->line, b->path);
+	}
+	b->hash = hash(b->data, BANK_SIZE);
+}
+
+// A sideways ROM has a type byte, and an offset to "\0(C)" after its title
+static void check_rom(bank_type *b) {
+	const unsigned char *p = b->data;
+	unsigned copyright = p[ROM_COPYRIGHT];
+	if (b->os || b->hash == blank_hash) {
+		return;
+	}
+	if ((p[ROM_TYPE] & (ROM_SERVICE | ROM_LANGUAGE)) == 0) {
+		error("line %d: %s has neither a service nor a language entry (type %02x)",
+			  b->line, b->path, p[ROM_TYPE]);
+	}
+	switch (p[ROM_TYPE] & ROM_CPU) {
+	case 0x0: case 0x2: case 0x3: case 0x8: case 0x9: case 0xB: case 0xC: case 0xD:
+		break;
+	default:
+		error("line %d: %s has an unknown CPU in its type byte (%02x)",
+			  b->line, b->path, p[ROM_TYPE]);
+	}
+	if (copyright < ROM_TITLE || memcmp(p + copyright, "\0(C)", 4) != 0) {
+		error("line %d: %s has no copyright string at offset %02x (mark an OS ROM with \"os\")",
+			  b->line, b->path, copyright);
+	}
+}
+
+static void read_banks() {
+	unsigned i;
+	bank_type *b;
+	printf("Bank  Type  Hash              File\n");
+	for (i = 0; i < num_banks; i++) {
+		b = &banks[i];
+		if (b->path == NULL) {
+			b->data = blank;
+			b->hash = blank_hash;
+			continue;
+		}
+		read_rom(b);
+		check_rom(b);
+		if (b->os) {
+			printf("%2d    os    %016llx  %s\n", i, b->hash, b->path);
+		} else if (b->hash == blank_hash) {
+			printf("%2d    --    %016llx  %s (blank)\n", i, b->hash, b->path);
+		} else {
+			printf("%2d    %02x    %016llx  %s (%s)\n", i, b->data[ROM_TYPE], b->hash, b->path,
+				   (char *) b->data + ROM_TITLE);
+		}
+	}
+}
+
+// ==================================================================
+// Outputs
+// ==================================================================
+
+static void write_bank(FILE *f, const output_type *o, const bank_type *b, unsigned i) {
+	unsigned j;
+	if (o->hex) {
+		fseek(f, (long) (i - o->first) * (BANK_SIZE / HEX_LINE) * HEX_LINE_LEN, SEEK_SET);
+		for (j = 0; j < BANK_SIZE; j++) {
+			fprintf(f, " %02x%s", b->data[j], (j % HEX_LINE) == HEX_LINE - 1 ? "\n" : "");
+		}
+	} else {
+		fseek(f, (long) (i - o->first) * BANK_SIZE, SEEK_SET);
+		fwrite(b->data, 1, BANK_SIZE, f);
+	}
+}
+
+// <output>.banks records the size and time of the output as last written,
+// so an output changed by anything else is rewritten in full
+static int read_record(const output_type *o, unsigned long long *old_hash) {
+	char path[MAX_LINE];
+	char line[MAX_LINE];
+	struct stat st;
+	long long size;
+	long long sec;
+	long nsec;
+	unsigned i;
+	unsigned n = 0;
+	FILE *f;
+	snprintf(path, sizeof(path), "%s.banks", o->path);
+	if ((f = fopen(path, "r")) == NULL) {
+		return 0;
+	}
+	if (fgets(line, sizeof(line), f) == NULL ||
+		sscanf(line, "image %lld %lld.%ld", &size, &sec, &nsec) != 3 ||
+		stat(o->path, &st) < 0 || st.st_size != size ||
+		st.st_mtim.tv_sec != sec || st.st_mtim.tv_nsec != nsec) {
+		fclose(f);
+		return 0;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "%x %llx", &i, &old_hash[n]) != 2 || i != o->first + n || n == o->count) {
+			fclose(f);
+			return 0;
+		}
+		n++;
+	}
+	fclose(f);
+	return n == o->count;
+}
+
+static void write_record(const output_type *o) {
+	char path[MAX_LINE];
+	struct stat st;
+	unsigned i;
+	FILE *f;
+	snprintf(path, sizeof(path), "%s.banks", o->path);
+	if (stat(o->path, &st) < 0 || (f = fopen(path, "w")) == NULL) {
+		error("unable to open output %s", path);
+	}
+	fprintf(f, "image %lld %lld.%09ld\n", (long long) st.st_size,
+			(long long) st.st_mtim.tv_sec, (long) st.st_mtim.tv_nsec);
+	for (i = o->first; i < o->first + o->count; i++) {
+		fprintf(f, "%02x %016llx\n", i, banks[i].hash);
+	}
+	fclose(f);
+}
+
+static void write_output(const output_type *o) {
+	unsigned long long old_hash[MAX_BANKS];
+	unsigned i;
+	unsigned changed = 0;
+	int valid = read_record(o, old_hash);
+	FILE *f = fopen(o->path, valid ? "r+b" : "wb");
+	if (f == NULL) {
+		error("unable to open output %s", o->path);
+	}
+	for (i = o->first; i < o->first + o->count; i++) {
+		if (!valid || banks[i].hash != old_hash[i - o->first]) {
+			write_bank(f, o, &banks[i], i);
+			changed++;
+		}
+	}
+	if (fclose(f)) {
+		error("unable to write output %s", o->path);
+	}
+	write_record(o);
+	if (valid) {
+		printf("Written %s: %d of %d banks changed\n", o->path, changed, o->count);
+	} else {
+		printf("Written %s: %d banks\n", o->path, o->count);
+	}
+}
+
+int main(int argc, char *argv[]) {
+	int i;
+	int j;
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <manifest> [<manifest> ...]\n\n"
+				"Builds the ROM images described by each manifest, rewriting only the\n"
+				"16K banks that have changed since the last build\n", argv[0]);
+		return 1;
+	}
+	blank_hash = hash(blank, BANK_SIZE);
+	for (i = 1; i < argc; i++) {
+		manifest = argv[i];
+		printf("%s:\n", manifest);
+		read_manifest(manifest);
+		read_banks();
+		for (j = 0; j < num_outputs; j++) {
+			write_output(&outputs[j]);
+		}
+	}
+	return 0;
+}
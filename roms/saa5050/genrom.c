@@ -3,6 +3,10 @@
 #include <string.h>
 #include <stdlib.h>
 
+/* Size of the pre-rounded ROM, in 16-bit words: two for each row of the
+ * normal ROM */
+#define ROUNDED_SIZE	(256 * 16 * 2)
+
 // Characters on a 5x9 matrix.  This is padded up to 16 rows when the
 // ROM is generated
 static uint8_t saa5050_charset[] = {
@@ -142,12 +146,116 @@ void gen_gfx(char code,char *base)
 	}
 }
 
-int main(void) {
+/* Doubles up each of the 6 pixels of a ROM row, to give 12 */
+int doubled(int pixels)
+{
+	int p, d = 0;
+
+	for (p = 32; p > 0; p >>= 1) {
+		d <<= 2;
+		if (pixels & p) d += 3;
+	}
+	return d;
+}
+
+/* Generates the pre-rounded ROM from the normal one. Each row of the normal
+ * ROM becomes two 12-pixel rows, as saa5050.vhd would have shifted out:
+ *
+ * - for alpha-numerics, rounded with the row below (0) or above (1), which
+ *   saa5050.vhd chooses from the field (CRS) or, in double height, from the
+ *   scan line
+ * - for graphics (bit 7 set), contiguous (0) or separated (1)
+ *
+ * The words are written little-endian, and saa5050.vhd (with PREROUNDED)
+ * loads them straight into its shift register. */
+void gen_rounded(const char *rom, uint16_t *outbuf)
+{
+	int addr, sel, row, a, b;
+
+	for (addr = 0; addr < 256 * 16; addr++) {
+		row = addr & 15;
+		for (sel = 0; sel < 2; sel++) {
+			a = doubled(rom[addr] & 63);
+			if (rom[addr] & 128) {
+				if (sel) {
+					/* Separated graphics */
+					a &= ~0xC30;
+					if (row == 2 || row == 6 || row == 9) a = 0;
+				}
+			} else {
+				/* Character rounding, with the row below or above */
+				b = doubled(rom[(addr + (sel ? -1 : 1)) & 0xFFF] & 63);
+				a |= ((a >> 1) & b & ~(b >> 1)) |
+					 ((a << 1) & 0xFFF & b & ~((b << 1) & 0xFFF));
+			}
+			outbuf[2 * addr + sel] = a;
+		}
+	}
+}
+
+/* Writes the pre-rounded ROM as a VHDL entity */
+void write_vhdl(const uint16_t *outbuf)
+{
+	int i;
+
+	printf("-- SAA5050 pre-rounded character ROM, generated by roms/saa5050/genrom -r -v\n");
+	printf("--\n");
+	printf("-- Address is the normal ROM address (gfx & code & row) then one bit:\n");
+	printf("-- for alpha-numerics rounded with the row below (0) or above (1), for\n");
+	printf("-- graphics contiguous (0) or separated (1)\n\n");
+	printf("library ieee;\n");
+	printf("use ieee.std_logic_1164.all;\n");
+	printf("use ieee.numeric_std.all;\n\n");
+	printf("entity saa5050_rom_rounded is\n");
+	printf("    port(\n");
+	printf("        clock    : in  std_logic;\n");
+	printf("        address  : in  std_logic_vector(12 downto 0);\n");
+	printf("        Q        : out std_logic_vector(11 downto 0)\n");
+	printf("    );\n");
+	printf("end saa5050_rom_rounded;\n\n");
+	printf("architecture RTL of saa5050_rom_rounded is\n\n");
+	printf("    type mem_type is array (0 to %d) of std_logic_vector(11 downto 0);\n\n", ROUNDED_SIZE - 1);
+	printf("    constant mem : mem_type := (");
+	for (i = 0; i < ROUNDED_SIZE; i++) {
+		printf("%sx\"%03X\"", (i % 8) ? "," : "\n\t", outbuf[i]);
+		if (i < ROUNDED_SIZE - 1 && (i % 8) == 7) printf(",");
+	}
+	printf("\n    );\n\n");
+	printf("begin\n\n");
+	printf("    process(clock) is\n");
+	printf("    begin\n");
+	printf("        if (rising_edge(clock)) then\n");
+	printf("            Q <= mem(to_integer(unsigned(address)));\n");
+	printf("        end if;\n");
+	printf("    end process;\n");
+	printf("end RTL;\n");
+}
+
+/* Usage: genrom [-r [-v]] > output
+ *
+ * With no options, writes the normal 4K ROM (saa5050.rom). With -r, writes
+ * the 16K pre-rounded ROM instead, or with -v as well, saa5050_rom_rounded.vhd */
+int main(int argc, char *argv[]) {
 	char *outbuf;
-	int ch,row;
+	uint16_t *rounded;
+	uint8_t word[2];
+	int ch,row,i;
+	int opt_rounded = 0, opt_vhdl = 0;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-r") == 0) {
+			opt_rounded = 1;
+		} else if (strcmp(argv[i], "-v") == 0) {
+			opt_vhdl = 1;
+		} else {
+			fprintf(stderr,"Usage: %s [-r [-v]] > output\n", argv[0]);
+			return 1;
+		}
+	}
 
 	outbuf = malloc(256 * 16);
-	if (outbuf == NULL) {
+	rounded = malloc(ROUNDED_SIZE * sizeof(uint16_t));
+	if (outbuf == NULL || rounded == NULL) {
 		fprintf(stderr,"Out of memory\n");
 		return 1;
 	}
@@ -172,9 +280,22 @@ int main(void) {
 	}
 
 	/* Write to stdout */
-	fwrite(outbuf,256 * 16,1,stdout);
+	if (!opt_rounded) {
+		fwrite(outbuf,256 * 16,1,stdout);
+	} else {
+		gen_rounded(outbuf, rounded);
+		if (opt_vhdl) {
+			write_vhdl(rounded);
+		} else {
+			for (i = 0; i < ROUNDED_SIZE; i++) {
+				word[0] = rounded[i] & 0xff;
+				word[1] = rounded[i] >> 8;
+				fwrite(word,2,1,stdout);
+			}
+		}
+	}
 
+	free(rounded);
 	free(outbuf);
 	return 0;
 }
-
@@ -0,0 +1,364 @@
+/*
+ * bin2mem - convert a binary file to memory initialisation files
+ *
+ * Writes any number of formats in a single pass over the binary, in place
+ * of bin2bitvector.pl. The format of each output is given by its suffix:
+ *
+ *   .bit    bitvector, one byte per line, for read/readmemb
+ *   .hex    hex, 16 bytes per line, as "od -An -tx1 -w16 -v", for readmemh
+ *   .mem    the same, for data2mem
+ *   .coe    Xilinx core generator
+ *   .mif    Altera/Intel memory initialisation file
+ *   .mi     Gowin memory initialisation file
+ *   .vhd    VHDL ROM entity (named after the file), as tuberom_65c102.vhd
+ *
+ * An output of "-" writes the bitvector to stdout, so with just a binary
+ * file this behaves as bin2bitvector.pl did.
+ *
+ * Usage: bin2mem [options] <binary file> [<output> ...]
+ *
+ * options:
+ *   --fill <X=0>   value used to fill unused space before/after the data:
+ *                  any of U X 0 1 Z W L H - for .bit, 0 1 X Z for .hex/.mem,
+ *                  and 0 or 1 for the rest
+ *   --size <N>     the output is padded/truncated to this size
+ *   --b4 <N>       the output starts with N fill bytes before the data
+ *   --offset <N>   the data starts N bytes into the binary file
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <getopt.h>
+#include <sys/stat.h>
+
+#define MAX_OUTPUTS   16
+#define MAX_LINE      1024
+
+// Bytes per line in .hex/.mem outputs
+#define HEX_LINE      16
+
+// A byte of the fill value, rather than of data
+#define FILL          -1
+
+typedef enum {
+	FORMAT_BIT,
+	FORMAT_HEX,
+	FORMAT_COE,
+	FORMAT_MIF,
+	FORMAT_MI,
+	FORMAT_VHD
+} format_type;
+
+typedef struct {
+	const char *path;
+	format_type format;
+	FILE *f;
+} output_type;
+
+static output_type outputs[MAX_OUTPUTS];
+static int num_outputs;
+
+static char fill = '0';
+static long size = -1;
+static long b4 = 0;
+static long offset = 0;
+
+// Total bytes to write, and the width of addresses in .vhd and .mif
+static long depth;
+static int addr_bits;
+
+static void __attribute__ ((format (printf, 1, 2), noreturn)) error(const char *fmt, ...) {
+	va_list ap;
+	va_start(ap, fmt);
+	fprintf(stderr, "ERROR: ");
+	vfprintf(stderr, fmt, ap);
+	fprintf(stderr, "\n");
+	va_end(ap);
+	exit(2);
+}
+
+static int has_suffix(const char *path, const char *suffix) {
+	size_t n = strlen(path);
+	size_t m = strlen(suffix);
+	return n >= m && strcasecmp(path + n - m, suffix) == 0;
+}
+
+static long number(const char *arg, const char *name) {
+	char *end;
+	long value = strtol(arg, &end, 0);
+	if (*arg == 0 || *end != 0 || value < 0) {
+		error("bad %s parameter '%s'", name, arg);
+	}
+	return value;
+}
+
+// ==================================================================
+// Outputs
+// ==================================================================
+
+static void add_output(const char *path) {
+	output_type *o;
+	if (num_outputs == MAX_OUTPUTS) {
+		error("more than %d outputs", MAX_OUTPUTS);
+	}
+	o = &outputs[num_outputs++];
+	o->path = path;
+	if (strcmp(path, "-") == 0 || has_suffix(path, ".bit")) {
+		o->format = FORMAT_BIT;
+	} else if (has_suffix(path, ".hex") || has_suffix(path, ".mem")) {
+		o->format = FORMAT_HEX;
+	} else if (has_suffix(path, ".coe")) {
+		o->format = FORMAT_COE;
+	} else if (has_suffix(path, ".mif")) {
+		o->format = FORMAT_MIF;
+	} else if (has_suffix(path, ".mi")) {
+		o->format = FORMAT_MI;
+	} else if (has_suffix(path, ".vhd")) {
+		o->format = FORMAT_VHD;
+	} else {
+		error("unknown format of output %s", path);
+	}
+	// The fill must be something each format can represent
+	if (fill != '0' && fill != '1' && o->format != FORMAT_BIT &&
+		!(o->format == FORMAT_HEX && (fill == 'X' || fill == 'Z'))) {
+		error("fill '%c' can't be written to %s", fill, path);
+	}
+}
+
+// The entity name of a .vhd output is its file name, less the suffix
+static void vhd_name(const output_type *o, char *name) {
+	const char *base = strrchr(o->path, '/');
+	base = base ? base + 1 : o->path;
+	snprintf(name, MAX_LINE, "%.*s", (int) (strlen(base) - 4), base);
+}
+
+static void write_header(output_type *o) {
+	char name[MAX_LINE];
+	int rom_bits = (addr_bits + 3) & ~3;
+	FILE *f = o->f;
+	switch (o->format) {
+	case FORMAT_COE:
+		fprintf(f, "memory_initialization_radix=16;\n");
+		fprintf(f, "memory_initialization_vector=\n");
+		break;
+	case FORMAT_MIF:
+		fprintf(f, "WIDTH=8;\nDEPTH=%ld;\n\n", depth);
+		fprintf(f, "ADDRESS_RADIX=HEX;\nDATA_RADIX=HEX;\n\n");
+		fprintf(f, "CONTENT BEGIN\n");
+		break;
+	case FORMAT_MI:
+		fprintf(f, "#File_format=Hex\n#Address_depth=%ld\n#Data_width=8\n", depth);
+		break;
+	case FORMAT_VHD:
+		vhd_name(o, name);
+		fprintf(f, "library ieee;\n");
+		fprintf(f, "use ieee.std_logic_1164.all;\n");
+		fprintf(f, "use ieee.numeric_std.all;\n\n");
+		fprintf(f, "entity %s is\n", name);
+		fprintf(f, "    port (\n");
+		fprintf(f, "        CLK  : in  std_logic;\n");
+		fprintf(f, "        ADDR : in  std_logic_vector(%d downto 0);\n", addr_bits - 1);
+		fprintf(f, "        DATA : out std_logic_vector(7 downto 0)\n");
+		fprintf(f, "        );\n");
+		fprintf(f, "end;\n\n");
+		fprintf(f, "architecture RTL of %s is\n\n", name);
+		fprintf(f, "    signal rom_addr : std_logic_vector(%d downto 0);\n\n", rom_bits - 1);
+		fprintf(f, "begin\n\n");
+		fprintf(f, "    p_addr : process(ADDR)\n");
+		fprintf(f, "    begin\n");
+		fprintf(f, "        rom_addr              <= (others => '0');\n");
+		fprintf(f, "        rom_addr(%d downto 0) <= ADDR;\n", addr_bits - 1);
+		fprintf(f, "    end process;\n\n");
+		fprintf(f, "    p_rom : process\n");
+		fprintf(f, "    begin\n");
+		fprintf(f, "        wait until rising_edge(CLK);\n");
+		fprintf(f, "        DATA <= (others => '0');\n");
+		fprintf(f, "        case rom_addr is\n");
+		break;
+	default:
+		break;
+	}
+}
+
+// Writes one byte, or the fill value (FILL), at addr
+static void write_byte(output_type *o, long addr, int value) {
+	int i;
+	int last = (addr == depth - 1);
+	int hex_fill = (fill == '1') ? 0xFF : 0x00;
+	FILE *f = o->f;
+	switch (o->format) {
+	case FORMAT_BIT:
+		for (i = 7; i >= 0; i--) {
+			fputc(value == FILL ? fill : '0' + ((value >> i) & 1), f);
+		}
+		fputc('\n', f);
+		break;
+	case FORMAT_HEX:
+		if (value == FILL && fill != '0' && fill != '1') {
+			fprintf(f, " %c%c", tolower(fill), tolower(fill));
+		} else {
+			fprintf(f, " %02x", value == FILL ? hex_fill : value);
+		}
+		if ((addr % HEX_LINE) == HEX_LINE - 1 || last) {
+			fputc('\n', f);
+		}
+		break;
+	case FORMAT_COE:
+		fprintf(f, "%02X%s\n", value == FILL ? hex_fill : value, last ? ";" : ",");
+		break;
+	case FORMAT_MIF:
+		fprintf(f, "\t%0*lX : %02X;\n", (addr_bits + 3) / 4, addr, value == FILL ? hex_fill : value);
+		break;
+	case FORMAT_MI:
+		fprintf(f, "%02X\n", value == FILL ? hex_fill : value);
+		break;
+	case FORMAT_VHD:
+		fprintf(f, "            when x\"%0*lX\" => DATA <= x\"%02X\";\n", (addr_bits + 3) / 4, addr,
+				value == FILL ? hex_fill : value);
+		break;
+	}
+}
+
+static void write_trailer(output_type *o) {
+	FILE *f = o->f;
+	switch (o->format) {
+	case FORMAT_MIF:
+		fprintf(f, "END;\n");
+		break;
+	case FORMAT_VHD:
+		fprintf(f, "            when others => DATA <= (others => '0');\n");
+		fprintf(f, "        end case;\n");
+		fprintf(f, "    end process;\n");
+		fprintf(f, "end RTL;\n");
+		break;
+	default:
+		break;
+	}
+}
+
+static void write_all(long addr, int value) {
+	int i;
+	for (i = 0; i < num_outputs; i++) {
+		write_byte(&outputs[i], addr, value);
+	}
+}
+
+// ==================================================================
+// Main
+// ==================================================================
+
+static void __attribute__ ((noreturn)) usage(int status) {
+	fprintf(status ? stderr : stdout,
+			"Usage: bin2mem [options] <binary file> [<output> ...]\n\n"
+			"Outputs are .bit (readmemb), .hex/.mem (readmemh, data2mem), .coe, .mif,\n"
+			".mi or .vhd, by suffix; \"-\" or no output writes the .bit to stdout\n\n"
+			"options:\n"
+			"  --fill <X=0>   A value to use to fill unused space before/after the data\n"
+			"  --size <N>     The file will be padded/truncated to this size\n"
+			"  --b4 <N>       The file will be padded with N fill bytes before the binary\n"
+			"                 data\n"
+			"  --offset <N>   The data starts N bytes into the binary file\n");
+	exit(status);
+}
+
+int main(int argc, char *argv[]) {
+	static const struct option options[] = {
+		{ "fill",   required_argument, NULL, 'f' },
+		{ "size",   required_argument, NULL, 's' },
+		{ "b4",     required_argument, NULL, 'b' },
+		{ "offset", required_argument, NULL, 'o' },
+		{ "help",   no_argument,       NULL, 'h' },
+		{ NULL,     0,                 NULL, 0   }
+	};
+	unsigned char buf[65536];
+	struct stat st;
+	const char *path;
+	long addr = 0;
+	long data_len;
+	size_t n;
+	size_t i;
+	int opt;
+	FILE *f;
+
+	while ((opt = getopt_long(argc, argv, "h", options, NULL)) != -1) {
+		switch (opt) {
+		case 'f':
+			fill = toupper((unsigned char) optarg[0]);
+			if (optarg[1] != 0 || strchr("UX01ZWLH-", fill) == NULL) {
+				error("bad fill character '%s' should be one of 'U', 'X', '0', '1', 'Z', 'W', 'L', 'H', '-'", optarg);
+			}
+			break;
+		case 's':
+			size = number(optarg, "size");
+			break;
+		case 'b':
+			b4 = number(optarg, "b4");
+			break;
+		case 'o':
+			offset = number(optarg, "offset");
+			break;
+		case 'h':
+			usage(0);
+		default:
+			usage(1);
+		}
+	}
+	if (optind >= argc) {
+		usage(1);
+	}
+	path = argv[optind++];
+	if (optind == argc) {
+		add_output("-");
+	}
+	while (optind < argc) {
+		add_output(argv[optind++]);
+	}
+
+	if ((f = fopen(path, "rb")) == NULL || fstat(fileno(f), &st) < 0) {
+		error("cannot open input file \"%s\"", path);
+	}
+	if (offset > st.st_size) {
+		error("offset %ld is beyond the end of %s", offset, path);
+	}
+	fseek(f, offset, SEEK_SET);
+	data_len = st.st_size - offset;
+	depth = (size >= 0) ? size : b4 + data_len;
+	if (size >= 0 && b4 + data_len > size) {
+		data_len = (b4 < size) ? size - b4 : 0;
+	}
+	for (addr_bits = 1; (1L << addr_bits) < depth; addr_bits++) {
+	}
+
+	for (opt = 0; opt < num_outputs; opt++) {
+		if (strcmp(outputs[opt].path, "-") == 0) {
+			outputs[opt].f = stdout;
+		} else if ((outputs[opt].f = fopen(outputs[opt].path, "w")) == NULL) {
+			error("unable to open output %s", outputs[opt].path);
+		}
+		write_header(&outputs[opt]);
+	}
+
+	while (addr < b4 && addr < depth) {
+		write_all(addr++, FILL);
+	}
+	while (addr < b4 + data_len && (n = fread(buf, 1, sizeof(buf), f)) > 0) {
+		for (i = 0; i < n && addr < b4 + data_len; i++) {
+			write_all(addr++, buf[i]);
+		}
+	}
+	fclose(f);
+	while (addr < depth) {
+		write_all(addr++, FILL);
+	}
+
+	for (opt = 0; opt < num_outputs; opt++) {
+		write_trailer(&outputs[opt]);
+		if (outputs[opt].f != stdout && fclose(outputs[opt].f)) {
+			error("unable to write output %s", outputs[opt].path);
+		}
+	}
+	return 0;
+}
@@ -3,133 +3,1118 @@
  *
  * AUthor:  Mike Field <hamster@snap.net.nz<
  *
- * A Little utility to convert hex strings
- * into HDMI CTL and TERC4 symbols for
- * further analysis.
+ * A Little utility to decode the hex TMDS
+ * trace written by the test harnesses
+ * (one 30 bit word per pixel clock, red
+ * in bits 29:20, green 19:10, blue 9:0)
+ * into HDMI periods, video characters and
+ * data island packets for further analysis.
+ *
+ * The trace is memory mapped and parsed in
+ * a single pass, so even very long runs of
+ * hdmidataencoder.v decode in seconds.
+ *
+ * Each complete frame (vsync to vsync) is
+ * reconstructed and listed with a hash of
+ * its pixels and of its audio samples, so a
+ * change in timing, picture, aspect or audio
+ * can be caught without a monitor.
+ *
+ * Usage:
+ *   hdmi_decode [options] <out.txt | ->
+ *
+ *   -v            list every symbol (the old output)
+ *   -p            list every data island packet
+ *   -f <Hz>       pixel clock, for audio rates (default 27000000)
+ *   -o <pattern>  write each frame, e.g. frame%03d.png (or .ppm)
+ *   -w <file>     write the audio samples as a WAV file
+ *   -s <file>     save the frame list (size, timing and hashes)
+ *   -c <file>     check the frame list against one saved with -s,
+ *                 exiting with 1 if it differs
  ***************************************/
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define GUARD          0x133   // Green and red (data island) guard band
+#define VIDEO_GUARD    0x2CC   // Blue and red video guard band
+
+enum { CONTROL, VIDEO_GUARD_BAND, VIDEO, ISLAND_GUARD_BAND, ISLAND, ISLAND_TRAILER };
+
+// Distinct values and how often they were seen
+#define HIST_SIZE 8
+
+typedef struct {
+   long value[HIST_SIZE];
+   long count[HIST_SIZE];
+   long other;
+} hist_t;
+
+static int hex_value[256];
+static int ctl_value[1024];
+static int terc4_value[1024];
+
+// Video characters, and the encoding expected for each byte and running disparity
+#define BIAS_LIMIT 16
+
+static unsigned char tmds_value[1024];
+static uint32_t crc_table[256];
+static unsigned short tmds_code[2 * BIAS_LIMIT + 1][256];
+static signed char tmds_next[2 * BIAS_LIMIT + 1][256];
+
+static int verbose = 0;
+static int list_packets = 0;
+static double pixel_clock = 27000000.0;
+
+// Position in the trace
+static unsigned long n = 0;
+
+// Period tracking
+static int state = CONTROL;
+static int guard_len = 0;
+static int preamble = -1;
+static int preamble_len = 0;
+static int bias[3];
+static int pixels = 0;
+static int island_pos = 0;
+static int island_packets = 0;
+
+// Sync tracking
+static int hsync = -1;
+static int vsync = -1;
+static int hsync_edge = -1;
+static int vsync_edge = -1;
+static unsigned long line_start = 0;
+static int active_lines = 0;
+static int line_islands = 0;
+
+// Packet assembly
+static uint32_t header;
+static uint64_t subpacket[4];
+
+// Last packets reported, so only changes are listed
+static unsigned char last_avi[31];
+static unsigned char last_audio_if[31];
+static long last_n = -1;
+static long last_cts = -1;
+static int cs_bits[2][192];
+static int cs_index = -1;
+static unsigned char last_cs[2][5];
+
+// Reconstruction
+#define MAX_WIDTH  2048
+#define MAX_HEIGHT 1536
+
+static const char *frame_pattern = NULL;
+static const char *wav_path = NULL;
+static const char *save_path = NULL;
+static const char *check_path = NULL;
+static FILE *wav_file = NULL;
+static FILE *save_file = NULL;
+static FILE *check_file = NULL;
+
+static unsigned char *frame;
+static int frame_width = 0;
+static int frame_height = 0;
+static unsigned long frame_start = 0;
+static int frame_samples = 0;
+static uint64_t audio_hash;
+static int avi_aspect = -1;
+static unsigned long wav_samples = 0;
+static unsigned long check_errors = 0;
+
+// Statistics
+static struct {
+   unsigned long symbols;
+   unsigned long unknown;
+   unsigned long frames;
+   unsigned long video_periods;
+   unsigned long islands;
+   unsigned long packets;
+   unsigned long packet_types[256];
+   unsigned long guard_errors;
+   unsigned long preamble_errors;
+   unsigned long disparity_errors;
+   unsigned long terc4_errors;
+   unsigned long control_errors;
+   unsigned long island_errors;
+   unsigned long ecc_errors;
+   unsigned long ecc_corrected;
+   unsigned long checksum_errors;
+   unsigned long samples;
+   unsigned long parity_errors;
+   int sample_min[2];
+   int sample_max[2];
+   int max_packets;
+   hist_t line_length;
+   hist_t active_pixels;
+   hist_t lines_per_frame;
+   hist_t islands_per_line;
+} stats;
+
+// ======================================================================
+// Symbol tables
+// ======================================================================
+
+static const unsigned ctl_codes[4] = {
+   0x354, 0x0AB, 0x154, 0x2AB
+};
+
+static const unsigned terc4_codes[16] = {
+   0x29C, 0x263, 0x2E4, 0x2E2, 0x171, 0x11E, 0x18E, 0x13C,
+   0x2CC, 0x139, 0x19C, 0x2C6, 0x28E, 0x271, 0x163, 0x2C3
+};
+
+static int tmds_decode(unsigned q);
+static unsigned tmds_encode(int d, int *cnt);
+
+static void init_tables(void) {
+   int i, j, cnt;
+   for (i = 0; i < 256; i++) {
+      hex_value[i] = -1;
+   }
+   for (i = 0; i < 10; i++) {
+      hex_value['0' + i] = i;
+   }
+   for (i = 0; i < 6; i++) {
+      hex_value['a' + i] = 10 + i;
+      hex_value['A' + i] = 10 + i;
+   }
+   for (i = 0; i < 1024; i++) {
+      ctl_value[i] = -1;
+      terc4_value[i] = -1;
+   }
+   for (i = 0; i < 4; i++) {
+      ctl_value[ctl_codes[i]] = i;
+   }
+   for (i = 0; i < 16; i++) {
+      terc4_value[terc4_codes[i]] = i;
+   }
+   for (i = 0; i < 1024; i++) {
+      tmds_value[i] = tmds_decode(i);
+   }
+   for (i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (j = 0; j < 8; j++) {
+         c = c & 1 ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      }
+      crc_table[i] = c;
+   }
+   for (i = 0; i <= 2 * BIAS_LIMIT; i++) {
+      for (j = 0; j < 256; j++) {
+         cnt = i - BIAS_LIMIT;
+         tmds_code[i][j] = tmds_encode(j, &cnt);
+         tmds_next[i][j] = cnt;
+      }
+   }
+}
+
+static int ones(unsigned x) {
+   return __builtin_popcount(x);
+}
+
+static int tmds_decode(unsigned q) {
+   unsigned d = q & 0xFF;
+   unsigned out;
+   if (q & 0x200) {
+      d ^= 0xFF;
+   }
+   out = d ^ (d << 1);
+   if (!(q & 0x100)) {
+      out ^= 0xFE;
+   }
+   return (out & 0xFE) | (d & 1);
+}
+
+// The DVI encoder, with the running disparity kept in half units
+static unsigned tmds_encode(int d, int *cnt) {
+   unsigned qm = d & 1;
+   int i, disparity;
+   int use_xnor = ones(d) > 4 || (ones(d) == 4 && !(d & 1));
+   for (i = 1; i < 8; i++) {
+      unsigned bit = ((d >> i) ^ (qm >> (i - 1)) ^ use_xnor) & 1;
+      qm |= bit << i;
+   }
+   if (!use_xnor) {
+      qm |= 0x100;
+   }
+   disparity = ones(qm & 0xFF) - 4;
+   if (*cnt == 0 || disparity == 0) {
+      if (qm & 0x100) {
+         *cnt += disparity;
+         return 0x100 | (qm & 0xFF);
+      }
+      *cnt -= disparity;
+      return 0x200 | (~qm & 0xFF);
+   }
+   if ((*cnt > 0 && disparity > 0) || (*cnt < 0 && disparity < 0)) {
+      *cnt += ((qm >> 8) & 1) - disparity;
+      return 0x200 | (qm & 0x100) | (~qm & 0xFF);
+   }
+   *cnt += disparity - (((qm >> 8) & 1) ^ 1);
+   return qm;
+}
+
+// Checks a video character is the one the encoder would have sent. After
+// an error the running disparity may differ until the end of the line
+static int tmds_check(int ch, unsigned q) {
+   int d = tmds_value[q];
+   int i = bias[ch] + BIAS_LIMIT;
+   if (i < 0 || i > 2 * BIAS_LIMIT) {
+      return tmds_encode(d, &bias[ch]) == q;
+   }
+   bias[ch] = tmds_next[i][d];
+   return tmds_code[i][d] == q;
+}
 
-void ctl_decode(unsigned s) {
-  switch(s) {
-     case 0x354: printf(" CTL0"); return;
-     case 0x0AB: printf(" CTL1"); return;
-     case 0x154: printf(" CTL2"); return;
-     case 0x2AB: printf(" CTL3"); return;
-  }
-  printf("     ");
-}
-
-int terc4_decode(unsigned s) {
-   int ret = -1;
-   switch(s) {
-   case 0x29C: ret=0x0; break;
-   case 0x263: ret=0x1; break;
-   case 0x2E4: ret=0x2; break;
-   case 0x2E2: ret=0x3; break;
-
-   case 0x171: ret=0x4; break;
-   case 0x11E: ret=0x5; break;
-   case 0x18E: ret=0x6; break;
-   case 0x13C: ret=0x7; break;
-
-   case 0x2CC: ret=0x8; break;
-   case 0x139: ret=0x9; break;
-   case 0x19C: ret=0xA; break;
-   case 0x2C6: ret=0xB; break;
-
-   case 0x28E: ret=0xC; break;
-   case 0x271: ret=0xD; break;
-   case 0x163: ret=0xE; break;
-   case 0x2C3: ret=0xF; break;
-   }
-   if (ret >= 0) {
-      printf(" %x", ret);
+// ======================================================================
+// Statistics
+// ======================================================================
+
+static void hist_add(hist_t *h, long value) {
+   int i;
+   for (i = 0; i < HIST_SIZE; i++) {
+      if (h->count[i] && h->value[i] == value) {
+         h->count[i]++;
+         return;
+      }
+      if (!h->count[i]) {
+         h->value[i] = value;
+         h->count[i] = 1;
+         return;
+      }
+   }
+   h->other++;
+}
+
+static void hist_print(const char *name, hist_t *h) {
+   int i;
+   printf("  %-22s", name);
+   if (!h->count[0]) {
+      printf(" -");
+   }
+   for (i = 0; i < HIST_SIZE && h->count[i]; i++) {
+      printf(" %ld (x%ld)", h->value[i], h->count[i]);
+   }
+   if (h->other) {
+      printf(" others (x%ld)", h->other);
+   }
+   printf("\n");
+}
+
+static void report(void) {
+   int i;
+   double seconds = stats.symbols / pixel_clock;
+   printf("\nSymbols:                 %lu (%.3f ms)\n", stats.symbols, seconds * 1000.0);
+   if (stats.unknown) {
+      printf("  unknown (X/U)          %lu\n", stats.unknown);
+   }
+   printf("Timing:\n");
+   printf("  frames                 %lu\n", stats.frames);
+   hist_print("lines per frame", &stats.lines_per_frame);
+   hist_print("line length", &stats.line_length);
+   hist_print("active pixels", &stats.active_pixels);
+   hist_print("islands per line", &stats.islands_per_line);
+   printf("Periods:\n");
+   printf("  video                  %lu\n", stats.video_periods);
+   printf("  data islands           %lu (%lu packets, at most %d per island)\n",
+          stats.islands, stats.packets, stats.max_packets);
+   printf("Packets:\n");
+   for (i = 0; i < 256; i++) {
+      if (stats.packet_types[i]) {
+         printf("  type %02X                %lu\n", i, stats.packet_types[i]);
+      }
+   }
+   if (stats.samples) {
+      printf("Audio:\n");
+      printf("  samples                %lu (%.1f Hz)\n", stats.samples, stats.samples / seconds);
+      printf("  left                   %d to %d\n", stats.sample_min[0], stats.sample_max[0]);
+      printf("  right                  %d to %d\n", stats.sample_min[1], stats.sample_max[1]);
+   }
+   if (last_cts > 0) {
+      printf("  ACR sample rate        %.1f Hz\n", pixel_clock * last_n / (128.0 * last_cts));
+   }
+   printf("Errors:\n");
+   printf("  guard band             %lu\n", stats.guard_errors);
+   printf("  preamble               %lu\n", stats.preamble_errors);
+   printf("  TMDS disparity         %lu\n", stats.disparity_errors);
+   printf("  TERC4                  %lu\n", stats.terc4_errors);
+   printf("  control period         %lu\n", stats.control_errors);
+   printf("  island framing         %lu\n", stats.island_errors);
+   printf("  BCH ECC                %lu (%lu corrected)\n", stats.ecc_errors, stats.ecc_corrected);
+   printf("  InfoFrame checksum     %lu\n", stats.checksum_errors);
+   printf("  audio parity           %lu\n", stats.parity_errors);
+}
+
+// ======================================================================
+// Reconstruction
+// ======================================================================
+
+static uint64_t fnv_hash(uint64_t hash, const unsigned char *p, size_t len) {
+   while (len--) {
+      hash = (hash ^ *p++) * 0x100000001B3ULL;
+   }
+   return hash;
+}
+
+static void frame_sample(int value) {
+   unsigned char le[2] = { value & 0xFF, (value >> 8) & 0xFF };
+   audio_hash = fnv_hash(audio_hash, le, 2);
+   if (wav_file) {
+      fwrite(le, 1, 2, wav_file);
+   }
+}
+
+static void frame_pixel(int x, int y, int r, int g, int b) {
+   unsigned char *p;
+   if (vsync_edge < 0 || y < 0 || x >= MAX_WIDTH || y >= MAX_HEIGHT) {
+      return;
+   }
+   p = frame + 3 * (y * MAX_WIDTH + x);
+   p[0] = r;
+   p[1] = g;
+   p[2] = b;
+   if (x >= frame_width) {
+      frame_width = x + 1;
+   }
+   if (y >= frame_height) {
+      frame_height = y + 1;
+   }
+}
+
+static void png_chunk(FILE *f, const char *type, const unsigned char *data, uint32_t len) {
+   unsigned char be[4] = { len >> 24, len >> 16, len >> 8, len };
+   uint32_t crc = 0xFFFFFFFF;
+   uint32_t i;
+   fwrite(be, 1, 4, f);
+   fwrite(type, 1, 4, f);
+   fwrite(data, 1, len, f);
+   for (i = 0; i < 4; i++) {
+      crc = crc_table[(crc ^ type[i]) & 0xFF] ^ (crc >> 8);
+   }
+   for (i = 0; i < len; i++) {
+      crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+   }
+   crc ^= 0xFFFFFFFF;
+   be[0] = crc >> 24;
+   be[1] = crc >> 16;
+   be[2] = crc >> 8;
+   be[3] = crc;
+   fwrite(be, 1, 4, f);
+}
+
+// An uncompressed (stored deflate blocks) PNG, to avoid needing zlib
+static void write_png(FILE *f) {
+   static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+   unsigned char ihdr[13] = { 0 };
+   size_t row = 1 + 3 * frame_width;
+   size_t raw_len = row * frame_height;
+   size_t len = 2 + raw_len + 5 * (raw_len / 65535 + 1) + 4;
+   unsigned char *idat = malloc(len);
+   unsigned char *p = idat;
+   uint32_t a = 1, b = 0;
+   size_t i, j, k, block;
+   int y;
+
+   ihdr[0] = frame_width >> 24;
+   ihdr[1] = frame_width >> 16;
+   ihdr[2] = frame_width >> 8;
+   ihdr[3] = frame_width;
+   ihdr[4] = frame_height >> 24;
+   ihdr[5] = frame_height >> 16;
+   ihdr[6] = frame_height >> 8;
+   ihdr[7] = frame_height;
+   ihdr[8] = 8;    // bit depth
+   ihdr[9] = 2;    // RGB
+
+   *p++ = 0x78;
+   *p++ = 0x01;
+   for (i = 0; i < raw_len; i += block) {
+      block = raw_len - i < 65535 ? raw_len - i : 65535;
+      *p++ = i + block == raw_len;
+      *p++ = block & 0xFF;
+      *p++ = block >> 8;
+      *p++ = ~block & 0xFF;
+      *p++ = (~block >> 8) & 0xFF;
+      for (j = 0; j < block; j++) {
+         k = i + j;
+         y = k / row;
+         *p = k % row ? frame[3 * y * MAX_WIDTH + k % row - 1] : 0;
+         a = (a + *p) % 65521;
+         b = (b + a) % 65521;
+         p++;
+      }
+   }
+   *p++ = b >> 8;
+   *p++ = b;
+   *p++ = a >> 8;
+   *p++ = a;
+
+   fwrite(signature, 1, 8, f);
+   png_chunk(f, "IHDR", ihdr, 13);
+   png_chunk(f, "IDAT", idat, p - idat);
+   png_chunk(f, "IEND", NULL, 0);
+   free(idat);
+}
+
+static void write_frame(void) {
+   char path[1024];
+   const char *ext;
+   FILE *f;
+   int y;
+   snprintf(path, sizeof(path), frame_pattern, (int) stats.frames);
+   f = fopen(path, "wb");
+   if (f == NULL) {
+      fprintf(stderr, "Unable to write %s\n", path);
+      exit(1);
+   }
+   ext = strrchr(path, '.');
+   if (ext && strcmp(ext, ".png") == 0) {
+      write_png(f);
    } else {
-      printf("  ");
-   }
-   return ret;
-}
-
-int byteswap(int i) {
-   return
-      ((i & 0x01) << 7) |
-      ((i & 0x02) << 5) |
-      ((i & 0x04) << 3) |
-      ((i & 0x08) << 1) |
-      ((i & 0x10) >> 1) |
-      ((i & 0x20) >> 3) |
-      ((i & 0x40) >> 5) |
-      ((i & 0x80) >> 7);
-}
-
-
-int main(int argc, char *argv[])
-{
-  FILE *f;
-  unsigned value;
-  unsigned n = 0;
-  int data_state = 0;
-  int data_active = 0;
-
-  unsigned int hdr;
-  unsigned char payload[32];
-  unsigned last_ch0 = 0;
-  unsigned last_ch1 = 0;
-  unsigned last_ch2 = 0;
-
-  f = fopen(argv[1], "rb");
-  if(f == NULL) {
-     fprintf(stderr,"Unable to open file\n");
-     return 1;
-  }
-
-  while(fscanf(f,"%x",&value) == 1)
-  {
-    unsigned ch2, ch1, ch0;
-    int terc2, terc1, terc0;
-    ch2 = (value>>20)&0x3FF;
-    ch1 = (value>>10)&0x3FF;
-    ch0 = (value>> 0)&0x3FF;
-    printf("%8i: %03X %03X %03X   ",n, ch2, ch1, ch0);
-    ctl_decode(ch2);
-    ctl_decode(ch1);
-    ctl_decode(ch0);
-    terc2 = terc4_decode(ch2);
-    terc1 = terc4_decode(ch1);
-    terc0 = terc4_decode(ch0);
-    printf("\n");
-
-    if (last_ch1 = 0x133 && ch1 == 0x133 && last_ch2 == 0x133 && ch2 == 0x133) {
-       data_active = !data_active;
-       if (data_active) {
-          data_state = 0;
-       }
-    } else if (data_active) {
-       hdr = (hdr << 1) | ((terc0 >> 2) & 1);
-       payload[data_state] = 0;
-       data_state = (data_state + 1) & 31;
-       if (!data_state) {
-          printf("%8i Header", n);
-          printf(" %02x", byteswap(hdr >> 24));
-          printf(" %02x", byteswap(hdr >> 16));
-          printf(" %02x", byteswap(hdr >>  9));
-          printf(" %02x", byteswap(hdr      ));
-          printf("\n");
-#if 0
-          printf("Payload:");
-          for (int = 0; i < 32; i++) {
-             printf(" %02x", payload[i]);
-          }
-          printf("\n");
-#endif
-       }
-    }
-
-    last_ch2 = ch2;
-    last_ch1 = ch1;
-    last_ch0 = ch0;
-    n++;
-  }
-  fclose(f);
-  return 0;
+      fprintf(f, "P6\n%d %d\n255\n", frame_width, frame_height);
+      for (y = 0; y < frame_height; y++) {
+         fwrite(frame + 3 * y * MAX_WIDTH, 3, frame_width, f);
+      }
+   }
+   fclose(f);
+}
+
+static void end_of_frame(void) {
+   static const char *aspects[] = { "none", "4:3", "16:9", "future" };
+   char summary[256];
+   char expected[256];
+   uint64_t video_hash = 0xCBF29CE484222325ULL;
+   int y;
+
+   for (y = 0; y < frame_height; y++) {
+      video_hash = fnv_hash(video_hash, frame + 3 * y * MAX_WIDTH, 3 * frame_width);
+   }
+   snprintf(summary, sizeof(summary), "%dx%d %lu clocks video %016llx audio %d %016llx aspect %s",
+            frame_width, frame_height, n - frame_start, (unsigned long long) video_hash,
+            frame_samples, (unsigned long long) audio_hash, avi_aspect < 0 ? "-" : aspects[avi_aspect]);
+   printf("%10lu: Frame %lu: %s\n", n, stats.frames, summary);
+
+   if (save_file) {
+      fprintf(save_file, "%s\n", summary);
+   }
+   if (check_file) {
+      if (fgets(expected, sizeof(expected), check_file) == NULL) {
+         expected[0] = 0;
+      }
+      expected[strcspn(expected, "\r\n")] = 0;
+      if (strcmp(summary, expected)) {
+         check_errors++;
+         printf("%10lu: Frame %lu differs, expected: %s\n", n, stats.frames, expected[0] ? expected : "no frame");
+      }
+   }
+   if (frame_pattern && frame_width && frame_height) {
+      write_frame();
+   }
+}
+
+static void start_of_frame(void) {
+   memset(frame, 0, 3 * MAX_WIDTH * (frame_height ? frame_height : MAX_HEIGHT));
+   frame_width = 0;
+   frame_height = 0;
+   frame_start = n;
+   frame_samples = 0;
+   audio_hash = 0xCBF29CE484222325ULL;
+}
+
+static void write_wav_header(unsigned rate) {
+   unsigned data_len = wav_samples * 4;
+   unsigned char header[44] = {
+      'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 16, 0,
+      'd', 'a', 't', 'a', 0, 0, 0, 0
+   };
+   int i;
+   for (i = 0; i < 4; i++) {
+      header[4 + i] = (36 + data_len) >> (8 * i);
+      header[24 + i] = rate >> (8 * i);
+      header[28 + i] = (rate * 4) >> (8 * i);
+      header[40 + i] = data_len >> (8 * i);
+   }
+   fseek(wav_file, 0, SEEK_SET);
+   fwrite(header, 1, sizeof(header), wav_file);
+}
+
+// ======================================================================
+// Data island packets
+// ======================================================================
+
+static unsigned bch_parity(uint64_t data, int bits) {
+   unsigned ecc = 0;
+   int i;
+   for (i = 0; i < bits; i++) {
+      int feedback = (ecc ^ (unsigned) (data >> i)) & 1;
+      ecc >>= 1;
+      if (feedback) {
+         ecc ^= 0x83;
+      }
+   }
+   return ecc;
+}
+
+// Checks (and corrects single bit errors in) a BCH block of bits data bits + 8 parity
+static void bch_check(uint64_t *block, int bits, const char *name) {
+   uint64_t mask = bits == 56 ? ~0ULL : (1ULL << (bits + 8)) - 1;
+   uint64_t fixed;
+   int i;
+   if (bch_parity(*block, bits) == ((*block >> bits) & 0xFF)) {
+      return;
+   }
+   stats.ecc_errors++;
+   for (i = 0; i < bits + 8; i++) {
+      fixed = (*block ^ (1ULL << i)) & mask;
+      if (bch_parity(fixed, bits) == ((fixed >> bits) & 0xFF)) {
+         stats.ecc_corrected++;
+         printf("%10lu: %s ECC error, corrected bit %d\n", n, name, i);
+         *block = fixed;
+         return;
+      }
+   }
+   printf("%10lu: %s ECC error\n", n, name);
+}
+
+static int infoframe_checksum(unsigned char *hb, unsigned char *pb) {
+   int sum = hb[0] + hb[1] + hb[2];
+   int i;
+   for (i = 0; i <= hb[2] && i < 28; i++) {
+      sum += pb[i];
+   }
+   if (sum & 0xFF) {
+      stats.checksum_errors++;
+      printf("%10lu: InfoFrame %02X checksum error\n", n, hb[0]);
+      return 0;
+   }
+   return 1;
+}
+
+// Reports an InfoFrame when it differs from the last one of its type
+static int infoframe_changed(unsigned char *last, unsigned char *hb, unsigned char *pb) {
+   unsigned char frame[31];
+   memcpy(frame, hb, 3);
+   memcpy(frame + 3, pb, 28);
+   if (memcmp(last, frame, sizeof(frame)) == 0) {
+      return 0;
+   }
+   memcpy(last, frame, sizeof(frame));
+   return 1;
+}
+
+static void avi_infoframe(unsigned char *hb, unsigned char *pb) {
+   static const char *colour[] = { "RGB", "YCbCr 4:2:2", "YCbCr 4:4:4", "future" };
+   static const char *aspect[] = { "none", "4:3", "16:9", "future" };
+   if (!infoframe_checksum(hb, pb)) {
+      return;
+   }
+   avi_aspect = (pb[2] >> 4) & 3;
+   if (!infoframe_changed(last_avi, hb, pb)) {
+      return;
+   }
+   printf("%10lu: AVI InfoFrame v%d: %s, picture %s, active format %s%d, bars %d, scan %d, scaling %d, VIC %d, repeat %d\n",
+          n, hb[1], colour[(pb[1] >> 5) & 3], aspect[(pb[2] >> 4) & 3],
+          pb[1] & 0x10 ? "" : "(invalid) ", pb[2] & 0xF, (pb[1] >> 2) & 3, pb[1] & 3,
+          pb[3] & 3, pb[4] & 0x7F, pb[5] & 0xF);
+}
+
+static void audio_infoframe(unsigned char *hb, unsigned char *pb) {
+   static const char *rate[] = { "stream", "32K", "44.1K", "48K", "88.2K", "96K", "176.4K", "192K" };
+   static const char *size[] = { "stream", "16", "20", "24" };
+   if (!infoframe_checksum(hb, pb) || !infoframe_changed(last_audio_if, hb, pb)) {
+      return;
+   }
+   printf("%10lu: Audio InfoFrame v%d: coding %d, %d channels, rate %s, size %s, allocation %02X\n",
+          n, hb[1], pb[1] >> 4, (pb[1] & 7) ? (pb[1] & 7) + 1 : 0,
+          rate[(pb[2] >> 2) & 7], size[pb[2] & 3], pb[4]);
+}
+
+static void audio_clock_regeneration(unsigned char *pb) {
+   long cts = ((pb[1] & 0xF) << 16) | (pb[2] << 8) | pb[3];
+   long N = ((pb[4] & 0xF) << 16) | (pb[5] << 8) | pb[6];
+   if (cts != last_cts || N != last_n) {
+      printf("%10lu: Audio Clock Regeneration: N %ld, CTS %ld\n", n, N, cts);
+      last_cts = cts;
+      last_n = N;
+   }
+}
+
+// IEC 60958 channel status, from the C bits of a 192 frame block
+static void channel_status(void) {
+   static const char *rate[] = {
+      "44.1K", "?", "48K", "32K", "?", "?", "?", "?", "88.2K", "?", "96K", "?", "176.4K", "?", "192K", "?"
+   };
+   unsigned char cs[5];
+   int ch, i;
+   for (ch = 0; ch < 2; ch++) {
+      memset(cs, 0, sizeof(cs));
+      for (i = 0; i < 40; i++) {
+         cs[i >> 3] |= cs_bits[ch][i] << (i & 7);
+      }
+      if (memcmp(cs, last_cs[ch], sizeof(cs))) {
+         memcpy(last_cs[ch], cs, sizeof(cs));
+         printf("%10lu: %s channel status: %02X %02X %02X %02X %02X (%s, %s, channel %d, %s)\n",
+                n, ch ? "Right" : "Left", cs[0], cs[1], cs[2], cs[3], cs[4],
+                cs[0] & 1 ? "professional" : "consumer", cs[0] & 2 ? "non-PCM" : "PCM",
+                cs[2] >> 4, rate[cs[3] & 0xF]);
+      }
+   }
+}
+
+static void audio_sample(unsigned char *hb, unsigned char *pb) {
+   int k, ch;
+   if (hb[1] & 0x10) {
+      // Layout 1 (multichannel) samples are only counted
+      stats.samples++;
+      return;
+   }
+   for (k = 0; k < 4; k++) {
+      unsigned char *sp = pb + 7 * k;
+      if (!(hb[1] & (1 << k))) {
+         continue;
+      }
+      if (hb[2] & (0x10 << k)) {
+         cs_index = 0;
+      }
+      for (ch = 0; ch < 2; ch++) {
+         unsigned sample = sp[3 * ch] | (sp[3 * ch + 1] << 8) | (sp[3 * ch + 2] << 16);
+         int flags = (sp[6] >> (4 * ch)) & 0xF;
+         int value = (int) (sample << 8) >> 16;
+         if ((ones(sample) + ones(flags)) & 1) {
+            stats.parity_errors++;
+         }
+         if (!stats.samples || value < stats.sample_min[ch]) {
+            stats.sample_min[ch] = value;
+         }
+         if (!stats.samples || value > stats.sample_max[ch]) {
+            stats.sample_max[ch] = value;
+         }
+         if (cs_index >= 0) {
+            cs_bits[ch][cs_index] = (flags >> 2) & 1;
+         }
+         frame_sample(value);
+      }
+      frame_samples++;
+      wav_samples++;
+      if (cs_index >= 0 && ++cs_index == 192) {
+         channel_status();
+         cs_index = -1;
+      }
+      stats.samples++;
+   }
+}
+
+static void packet(void) {
+   unsigned char hb[3];
+   unsigned char pb[28];
+   uint64_t block = header;
+   int i, k;
+
+   bch_check(&block, 24, "header");
+   for (i = 0; i < 3; i++) {
+      hb[i] = block >> (8 * i);
+   }
+   for (k = 0; k < 4; k++) {
+      char name[16];
+      sprintf(name, "subpacket %d", k);
+      bch_check(&subpacket[k], 56, name);
+      for (i = 0; i < 7; i++) {
+         pb[7 * k + i] = subpacket[k] >> (8 * i);
+      }
+   }
+
+   stats.packets++;
+   stats.packet_types[hb[0]]++;
+   if (++island_packets > stats.max_packets) {
+      stats.max_packets = island_packets;
+   }
+   if (list_packets) {
+      printf("%10lu: Packet %02X %02X %02X", n, hb[0], hb[1], hb[2]);
+      for (i = 0; i < 28; i++) {
+         printf("%s%02X", i % 7 ? " " : " | ", pb[i]);
+      }
+      printf("\n");
+   }
+
+   switch (hb[0]) {
+   case 0x00:
+      break;
+   case 0x01:
+      audio_clock_regeneration(pb);
+      break;
+   case 0x02:
+      audio_sample(hb, pb);
+      break;
+   case 0x82:
+      avi_infoframe(hb, pb);
+      break;
+   case 0x84:
+      audio_infoframe(hb, pb);
+      break;
+   default:
+      if (hb[0] & 0x80) {
+         infoframe_checksum(hb, pb);
+      }
+      break;
+   }
+}
+
+// ======================================================================
+// Periods
+// ======================================================================
+
+static void sync_update(int h, int v) {
+   if (h != hsync) {
+      if (hsync >= 0 && hsync_edge < 0) {
+         hsync_edge = h;
+      }
+      if (h == hsync_edge) {
+         if (line_start) {
+            hist_add(&stats.line_length, n - line_start);
+            hist_add(&stats.islands_per_line, line_islands);
+         }
+         line_start = n;
+         line_islands = 0;
+      }
+      hsync = h;
+   }
+   if (v != vsync) {
+      if (vsync >= 0 && vsync_edge < 0) {
+         vsync_edge = v;
+         active_lines = -1;
+      }
+      if (v == vsync_edge) {
+         if (active_lines >= 0) {
+            hist_add(&stats.lines_per_frame, active_lines);
+            stats.frames++;
+            end_of_frame();
+         }
+         start_of_frame();
+         active_lines = 0;
+      }
+      vsync = v;
+   }
+}
+
+static void end_of_period(void) {
+   if (state == VIDEO) {
+      hist_add(&stats.active_pixels, pixels);
+      if (active_lines >= 0) {
+         active_lines++;
+      }
+   } else if (state == ISLAND && island_pos) {
+      stats.island_errors++;
+      printf("%10lu: data island ended part way through a packet\n", n);
+   }
+}
+
+static void guard_band(int video) {
+   int expected = video ? 0x1 : 0x5;
+   if (state == (video ? VIDEO_GUARD_BAND : ISLAND_GUARD_BAND)) {
+      guard_len++;
+      return;
+   }
+   if (!video && state == ISLAND) {
+      // Trailing guard band
+      if (island_pos) {
+         stats.island_errors++;
+         printf("%10lu: data island ended part way through a packet\n", n);
+      }
+      state = ISLAND_TRAILER;
+      guard_len = 1;
+      return;
+   }
+   if (!video && state == ISLAND_TRAILER && guard_len < 2) {
+      guard_len++;
+      return;
+   }
+   end_of_period();
+   if (state != CONTROL || preamble != expected || preamble_len < 8) {
+      stats.preamble_errors++;
+   }
+   state = video ? VIDEO_GUARD_BAND : ISLAND_GUARD_BAND;
+   guard_len = 1;
+   if (video) {
+      stats.video_periods++;
+      pixels = 0;
+      bias[0] = bias[1] = bias[2] = 0;
+   } else {
+      stats.islands++;
+      line_islands++;
+      island_pos = 0;
+      island_packets = 0;
+   }
+}
+
+static void symbol(unsigned ch2, unsigned ch1, unsigned ch0) {
+   int c0 = ctl_value[ch0], c1 = ctl_value[ch1], c2 = ctl_value[ch2];
+   int t0 = terc4_value[ch0], t1, t2;
+
+   if (ch1 == GUARD && ch2 == VIDEO_GUARD && ch0 == VIDEO_GUARD) {
+      guard_band(1);
+      return;
+   }
+   if (ch1 == GUARD && ch2 == GUARD && t0 >= 0) {
+      sync_update(t0 & 1, (t0 >> 1) & 1);
+      guard_band(0);
+      return;
+   }
+
+   if (c0 >= 0 && c1 >= 0 && c2 >= 0) {
+      if (state != CONTROL) {
+         if (state == VIDEO_GUARD_BAND || state == ISLAND_GUARD_BAND || (state == ISLAND_TRAILER && guard_len != 2)) {
+            stats.guard_errors++;
+         }
+         end_of_period();
+         state = CONTROL;
+         preamble = -1;
+      }
+      // CTL3:0 from green and red: 0001 before video, 0101 before a data island
+      if (preamble == (c1 | (c2 << 2))) {
+         preamble_len++;
+      } else {
+         preamble = c1 | (c2 << 2);
+         preamble_len = 1;
+      }
+      sync_update(c0 & 1, (c0 >> 1) & 1);
+      return;
+   }
+
+   switch (state) {
+   case VIDEO_GUARD_BAND:
+      if (guard_len != 2) {
+         stats.guard_errors++;
+      }
+      state = VIDEO;
+      // fall through
+   case VIDEO:
+      if (!tmds_check(2, ch2) || !tmds_check(1, ch1) || !tmds_check(0, ch0)) {
+         stats.disparity_errors++;
+      }
+      frame_pixel(pixels, active_lines, tmds_value[ch2], tmds_value[ch1], tmds_value[ch0]);
+      pixels++;
+      break;
+   case ISLAND_GUARD_BAND:
+      if (guard_len != 2) {
+         stats.guard_errors++;
+      }
+      state = ISLAND;
+      island_pos = 0;
+      // fall through
+   case ISLAND: {
+      int k;
+      t1 = terc4_value[ch1];
+      t2 = terc4_value[ch2];
+      if (t0 < 0 || t1 < 0 || t2 < 0) {
+         stats.terc4_errors++;
+         t0 = t0 < 0 ? 0 : t0;
+         t1 = t1 < 0 ? 0 : t1;
+         t2 = t2 < 0 ? 0 : t2;
+      }
+      sync_update(t0 & 1, (t0 >> 1) & 1);
+      // Bit 3 of blue is low only for the first character of the island
+      if (((t0 >> 3) & 1) != (island_pos || island_packets)) {
+         stats.island_errors++;
+      }
+      if (island_pos == 0) {
+         header = 0;
+         memset(subpacket, 0, sizeof(subpacket));
+      }
+      header |= (uint32_t) ((t0 >> 2) & 1) << island_pos;
+      for (k = 0; k < 4; k++) {
+         subpacket[k] |= (uint64_t) ((t1 >> k) & 1) << (2 * island_pos);
+         subpacket[k] |= (uint64_t) ((t2 >> k) & 1) << (2 * island_pos + 1);
+      }
+      if (++island_pos == 32) {
+         island_pos = 0;
+         packet();
+      }
+      break;
+   }
+   default:
+      stats.control_errors++;
+      break;
+   }
+}
+
+// ======================================================================
+// Trace parsing
+// ======================================================================
+
+static void list_symbol(unsigned ch2, unsigned ch1, unsigned ch0) {
+   unsigned ch[3] = { ch2, ch1, ch0 };
+   int i;
+   printf("%8lu: %03X %03X %03X   ", n, ch2, ch1, ch0);
+   for (i = 0; i < 3; i++) {
+      if (ctl_value[ch[i]] >= 0) {
+         printf(" CTL%d", ctl_value[ch[i]]);
+      } else {
+         printf("     ");
+      }
+   }
+   for (i = 0; i < 3; i++) {
+      if (terc4_value[ch[i]] >= 0) {
+         printf(" %x", terc4_value[ch[i]]);
+      } else {
+         printf("  ");
+      }
+   }
+   if (state == VIDEO) {
+      printf("   %02X %02X %02X", tmds_value[ch2], tmds_value[ch1], tmds_value[ch0]);
+   }
+   printf("\n");
+}
+
+static void decode(const unsigned char *p, const unsigned char *end) {
+   while (p < end) {
+      uint32_t value = 0;
+      int digits = 0;
+      int known = 1;
+      while (p < end && *p != '\n') {
+         int h = hex_value[*p];
+         if (h >= 0) {
+            value = (value << 4) | h;
+            digits++;
+         } else if (*p != ' ' && *p != '\r' && *p != '\t') {
+            known = 0;
+         }
+         p++;
+      }
+      p++;
+      if (!digits && known) {
+         continue;
+      }
+      if (!known) {
+         stats.unknown++;
+      } else {
+         unsigned ch2 = (value >> 20) & 0x3FF, ch1 = (value >> 10) & 0x3FF, ch0 = value & 0x3FF;
+         symbol(ch2, ch1, ch0);
+         if (verbose) {
+            list_symbol(ch2, ch1, ch0);
+         }
+      }
+      n++;
+   }
+   stats.symbols = n;
+}
+
+int main(int argc, char *argv[]) {
+   const char *path = NULL;
+   unsigned char *data;
+   size_t size = 0;
+   struct stat st;
+   int fd, i;
+
+   for (i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-v") == 0) {
+         verbose = 1;
+      } else if (strcmp(argv[i], "-p") == 0) {
+         list_packets = 1;
+      } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+         pixel_clock = atof(argv[++i]);
+      } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+         frame_pattern = argv[++i];
+      } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+         wav_path = argv[++i];
+      } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+         save_path = argv[++i];
+      } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+         check_path = argv[++i];
+      } else if (!path) {
+         path = argv[i];
+      } else {
+         path = NULL;
+         break;
+      }
+   }
+   if (!path || pixel_clock <= 0) {
+      fprintf(stderr, "Usage: %s [-v] [-p] [-f <pixel clock Hz>] [-o <frame%%03d.png>] [-w <audio.wav>]\n"
+              "          [-s <frames.txt>] [-c <frames.txt>] <out.txt | ->\n", argv[0]);
+      return 1;
+   }
+
+   fd = strcmp(path, "-") ? open(path, O_RDONLY) : 0;
+   if (fd < 0) {
+      fprintf(stderr, "Unable to open file %s\n", path);
+      return 1;
+   }
+   init_tables();
+
+   frame = calloc(3 * MAX_WIDTH, MAX_HEIGHT);
+   if (!frame) {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+   }
+   if (wav_path) {
+      wav_file = fopen(wav_path, "wb");
+      if (wav_file) {
+         write_wav_header(0);
+      }
+   }
+   if (save_path) {
+      save_file = fopen(save_path, "w");
+   }
+   if (check_path) {
+      check_file = fopen(check_path, "r");
+   }
+   if ((wav_path && !wav_file) || (save_path && !save_file) || (check_path && !check_file)) {
+      fprintf(stderr, "Unable to open the output files\n");
+      return 1;
+   }
+
+   data = MAP_FAILED;
+   if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      size = st.st_size;
+      data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+         madvise(data, size, MADV_SEQUENTIAL);
+      }
+   }
+   if (data == MAP_FAILED) {
+      // A pipe, so read it all
+      size_t capacity = 1 << 20;
+      ssize_t got;
+      data = malloc(capacity);
+      size = 0;
+      while (data && (got = read(fd, data + size, capacity - size)) > 0) {
+         size += got;
+         if (size == capacity) {
+            capacity *= 2;
+            data = realloc(data, capacity);
+         }
+      }
+      if (!data) {
+         fprintf(stderr, "Out of memory\n");
+         return 1;
+      }
+   }
+
+   decode(data, data + size);
+   report();
+
+   if (wav_file) {
+      // The rate the sink would recover from N and CTS
+      write_wav_header(last_cts > 0 ? (unsigned) (pixel_clock * last_n / (128.0 * last_cts) + 0.5) : 48000);
+      fclose(wav_file);
+   }
+   if (save_file) {
+      fclose(save_file);
+   }
+   if (check_file) {
+      char expected[256];
+      while (fgets(expected, sizeof(expected), check_file)) {
+         check_errors++;
+      }
+      fclose(check_file);
+      printf("\nFrame check: %s\n", check_errors ? "FAILED" : "passed");
+      return check_errors ? 1 : 0;
+   }
+   return 0;
 }
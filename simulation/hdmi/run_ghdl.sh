@@ -1,11 +1,18 @@
 #!/bin/bash
 
-ghdl -a -fexplicit --ieee=synopsys ../../src/xilinx/hdmi/encoder.vhd
-ghdl -a -fexplicit --ieee=synopsys ../../src/xilinx/hdmi/hdmidelay.vhd
-ghdl -a -fexplicit --ieee=synopsys ../../src/xilinx/hdmi/hdmi.vhd
+# Usage: run_ghdl.sh [-gASPECT_169=true] [-gAUDIO_ENABLE=true]
+#
+# Leaves the reconstructed frames in frameNN.png, the audio in audio.wav
+# and the frame list in frames.txt (compare runs with hdmi_decode -c)
+
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/hdmi/encoder.vhd
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/hdmi/hdmidelay.vhd
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/hdmi/hdmi.vhd
 ghdl -a -fexplicit --ieee=synopsys vhdl_tb/test_harness.vhd
 
 ghdl -e -fexplicit --ieee=synopsys test_harness
-ghdl -r -fexplicit --ieee=synopsys test_harness --vcd=dump.vcd
+ghdl -r -fexplicit --ieee=synopsys test_harness --vcd=dump.vcd "$@"
 
 #--wave=dump.ghw
+
+gcc -O2 -o hdmi_decode hdmi_decode.c && ./hdmi_decode -o frame%02d.png -w audio.wav -s frames.txt out.txt
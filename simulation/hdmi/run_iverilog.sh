@@ -2,6 +2,8 @@
 
 rm -f a.out
 
-iverilog verilog_tb/test_harness.v ../../src/xilinx/hdmi/*.v
+iverilog verilog_tb/test_harness.v ../../src/common/hdmi/*.v
 
 ./a.out
+
+gcc -O2 -o hdmi_decode hdmi_decode.c && ./hdmi_decode -o frame%02d.png -w audio.wav -s frames.txt out.txt
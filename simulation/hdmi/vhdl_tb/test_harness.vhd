@@ -8,6 +8,10 @@ library std;
 use std.textio.all;                     -- basic i/o
 
 entity test_harness is
+    generic (
+        ASPECT_169   : boolean := false;
+        AUDIO_ENABLE : boolean := false
+    );
 end test_harness;
 
 architecture rtl of test_harness is
@@ -31,8 +35,14 @@ architecture rtl of test_harness is
     signal tdms_b          : std_logic_vector(9 downto 0);
 
     signal tdms            : std_logic_vector(31 downto 0);
+
+    signal aspect          : std_logic;
+    signal audio_enable    : std_logic;
 begin
 
+    aspect       <= '1' when ASPECT_169   else '0';
+    audio_enable <= '1' when AUDIO_ENABLE else '0';
+
     -- Clock process definitions
     process
     begin
@@ -155,10 +165,11 @@ begin
       I_BLANK          => hdmi_blank,
       I_HSYNC          => hdmi_hsync,
       I_VSYNC          => hdmi_vsync,
+      I_ASPECT_169     => aspect,
       -- PCM audio
-      I_AUDIO_ENABLE   => '0',
-      I_AUDIO_PCM_L    => (others => '0'),
-      I_AUDIO_PCM_R    => (others => '0'),
+      I_AUDIO_ENABLE   => audio_enable,
+      I_AUDIO_PCM_L    => x"AAAA",
+      I_AUDIO_PCM_R    => x"5555",
       -- TMDS parallel pixel synchronous outputs (serialize LSB first)
       O_RED            => tdms_r,
       O_GREEN          => tdms_g,
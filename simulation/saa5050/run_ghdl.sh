@@ -0,0 +1,27 @@
+#!/bin/bash
+
+# Usage: run_ghdl.sh [charset|hold|<mode7 screen dump>] [rounded]
+#
+# Displays a test page through saa5050.vhd and compares every pixel of
+# the captured frame with saa5050_golden's rendering of the same page
+
+PAGE=${1:-charset}
+
+GENERICS=
+if [ "$2" == "rounded" ]; then
+    GENERICS=-gPREROUNDED=true
+fi
+
+gcc -O2 -o saa5050_golden saa5050_golden.c || exit 2
+./saa5050_golden page ${PAGE} page.txt || exit 2
+
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/saa5050_rom_dual_port.vhd
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/saa5050_rom_rounded.vhd
+ghdl -a -fexplicit --ieee=synopsys ../../src/common/saa5050.vhd
+ghdl -a -fexplicit --ieee=synopsys vhdl_tb/test_harness.vhd
+
+ghdl -e -fexplicit --ieee=synopsys test_harness
+ghdl -r -fexplicit --ieee=synopsys test_harness ${GENERICS}
+
+./saa5050_golden render ../../roms/saa5050/saa5050.rom page.txt golden.ppm
+./saa5050_golden compare ../../roms/saa5050/saa5050.rom page.txt capture.txt capture.ppm
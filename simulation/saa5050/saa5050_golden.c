@@ -0,0 +1,420 @@
+/*****************************************
+ * saa5050_golden.c
+ *
+ * Renders a teletext page as saa5050.vhd should display it, from the
+ * character ROM (roms/saa5050/saa5050.rom), for regression testing
+ * against frames captured from the simulation (see run_ghdl.sh).
+ *
+ * The rules are those of saa5050.vhd, written out independently: Set-At
+ * and Set-After control codes, character rounding, separated graphics,
+ * double height, graphics hold (including the SAA5050 quirks that clear
+ * the held character), conceal and flash (in its off phase). The frame
+ * is 480x500: 25 rows of 20 lines, the two fields interleaved, with CRS
+ * high giving the upper line of each pair.
+ *
+ * Usage:
+ *   saa5050_golden page <charset|hold|mode7 screen dump> <page.txt>
+ *   saa5050_golden render <rom> <page.txt> <golden.ppm>
+ *   saa5050_golden compare <rom> <page.txt> <capture.txt> [<capture.ppm>]
+ *
+ * compare exits with 1 if the capture differs from the golden image.
+ ***************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ROWS     25
+#define COLS     40
+#define WIDTH    (COLS * 12)
+#define HEIGHT   (ROWS * 20)
+
+/* Pixels captured per line, from the start of LOSE */
+#define CAPTURE  528
+
+typedef struct {
+  int fg, bg, conceal, gfx, sep, hold, flash, dh;
+  /* One-shot "Set-After" changes, applied at the next character */
+  int fg_next, gfx_next, alpha_next, release_next, flash_next, dh_next, unconceal_next;
+  /* Last graphics character, for hold */
+  int last_gfx, last_gfx_sep;
+} state_t;
+
+static unsigned char rom[4096];
+static unsigned char page[ROWS * COLS];
+static unsigned char golden[HEIGHT][WIDTH];
+static unsigned char captured[HEIGHT][CAPTURE];
+static int captured_lines[HEIGHT];
+
+static void fail(const char *msg, const char *arg) {
+  fprintf(stderr, "ERROR: %s%s\n", msg, arg);
+  exit(2);
+}
+
+/* ======================================================================
+ * Pages
+ * ====================================================================== */
+
+static void put(int row, int col, const char *codes, int len) {
+  memcpy(&page[row * COLS + col], codes, len);
+}
+
+static void put_text(int row, int col, const char *text) {
+  put(row, col, text, strlen(text));
+}
+
+static void charset_page(void) {
+  int row, i;
+  put_text(0, 0, "\x03SAA5050 golden image: character set");
+  for (row = 0; row < 3; row++) {
+    /* Alpha-numerics, contiguous and separated graphics */
+    page[(1 + row) * COLS] = 0x07;
+    page[(4 + row) * COLS] = 0x17;
+    page[(7 + row) * COLS] = 0x17;
+    page[(7 + row) * COLS + 1] = 0x1A;
+    for (i = 0; i < 32; i++) {
+      page[(1 + row) * COLS + 1 + i] = 0x20 + 32 * row + i;
+      page[(4 + row) * COLS + 1 + i] = 0x20 + 32 * row + i;
+      page[(7 + row) * COLS + 2 + i] = 0x20 + 32 * row + i;
+    }
+  }
+  /* Double height text and graphics, over two rows */
+  for (row = 10; row < 12; row++) {
+    put_text(row, 0, "\x0D\x06" "Double height\x0C normal \x0D\x16\x2C\x7F\x23\x35\x1A\x7F\x6A");
+  }
+  /* Colours, backgrounds, flash, conceal */
+  put_text(12, 0, "\x01red\x02green\x03yellow\x04" "blue\x05" "magenta\x06" "cyan\x07white");
+  put_text(13, 0, "\x01\x1D\x07red bg\x1C\x04\x1D\x03yellow on blue\x1C black bg");
+  put_text(14, 0, "\x08" "Flash\x09Steady\x18" "Conceal\x03Revealed");
+  /* Normal height on the lower row of a double height pair is blank */
+  put_text(15, 0, "\x0DTop half\x0C normal");
+  put_text(16, 0, "\x0D" "Bottom half\x0C hidden");
+  put_text(17, 0, "\x12\x1D\x11\x7F\x0D\x7F\x0C\x7F\x1C\x7F");
+}
+
+static void hold_page(void) {
+  put_text(0, 0, "\x03SAA5050 golden image: graphics hold");
+  /* Held character shown in place of the colour changes */
+  put(1, 0, "\x17\x7F\x1E\x11\x12\x13\x14\x15\x16\x7F", 10);
+  /* Control codes before hold clear the held character */
+  put(2, 0, "\x17\x7F\x11\x1E\x12\x13\x35\x14\x15", 9);
+  /* The held character keeps its separation */
+  put(3, 0, "\x17\x1E\x35\x1A\x12\x13\x35\x19\x14\x15", 10);
+  /* A change of height clears the held character */
+  put(4, 0, "\x17\x1E\x7F\x0D\x12\x7F\x0C\x13\x14", 9);
+  put(5, 0, "\x17\x1E\x7F\x0D\x12\x7F\x0C\x13\x14", 9);
+  /* Release is Set-After */
+  put(6, 0, "\x17\x1E\x7F\x1F\x12\x13", 6);
+  /* Alpha colour releases hold (Set-After) */
+  put(7, 0, "\x17\x1E\x7F\x01\x41\x12\x13", 7);
+  /* Capitals in graphics mode aren't graphics, so aren't held */
+  put(8, 0, "\x17\x1E\x7F\x41\x12\x13", 6);
+  /* Background changes in hold */
+  put(9, 0, "\x17\x1E\x7F\x1D\x11\x1C\x12\x1D", 8);
+  /* Conceal in hold, then a colour change, which reveals */
+  put(10, 0, "\x17\x1E\x7F\x18\x12\x7F\x13\x7F", 8);
+  /* Hold across the gap between double and normal height */
+  put(11, 0, "\x0D\x17\x1E\x7F\x13\x0C\x14\x7F\x15", 9);
+  put(12, 0, "\x0D\x17\x1E\x7F\x13\x0C\x14\x7F\x15", 9);
+}
+
+static void write_page(const char *name, const char *path) {
+  FILE *f;
+  int row, col;
+  memset(page, ' ', sizeof(page));
+  if (strcmp(name, "charset") == 0) {
+    charset_page();
+  } else if (strcmp(name, "hold") == 0) {
+    hold_page();
+  } else {
+    /* A Mode 7 screen dump, 1000 bytes from &7C00 */
+    f = fopen(name, "rb");
+    if (f == NULL || fread(page, 1, sizeof(page), f) != sizeof(page)) {
+      fail("unable to read a 1000 byte screen dump from ", name);
+    }
+    fclose(f);
+  }
+  f = fopen(path, "w");
+  if (f == NULL) {
+    fail("unable to write ", path);
+  }
+  for (row = 0; row < ROWS; row++) {
+    for (col = 0; col < COLS; col++) {
+      fprintf(f, "%02X%c", page[row * COLS + col] & 0x7F, col == COLS - 1 ? '\n' : ' ');
+    }
+  }
+  fclose(f);
+}
+
+static void read_page(const char *path) {
+  FILE *f = fopen(path, "r");
+  unsigned value;
+  int i;
+  if (f == NULL) {
+    fail("unable to open ", path);
+  }
+  for (i = 0; i < ROWS * COLS; i++) {
+    if (fscanf(f, "%x", &value) != 1) {
+      fail("expected 25 lines of 40 hex bytes in ", path);
+    }
+    page[i] = value & 0x7F;
+  }
+  fclose(f);
+}
+
+static void read_rom(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL || fread(rom, 1, sizeof(rom), f) != sizeof(rom)) {
+    fail("unable to read a 4K character ROM from ", path);
+  }
+  fclose(f);
+}
+
+/* ======================================================================
+ * Rendering
+ * ====================================================================== */
+
+/* The state after the control character handling of code c */
+static void next_state(state_t *s, int c) {
+  state_t n = *s;
+
+  n.fg_next = n.gfx_next = n.alpha_next = n.release_next = 0;
+  n.flash_next = n.dh_next = n.unconceal_next = 0;
+
+  if (c & 0x20) {
+    n.last_gfx = c;
+    n.last_gfx_sep = s->sep;
+  } else if ((c & 0x60) == 0 && !s->hold && (c & 0x1F) != 0x1E) {
+    /* SAA5050 hold bug: control codes outside of hold clear the held character */
+    n.last_gfx = 0;
+  }
+
+  /* Set-After codes from the previous character */
+  if (s->fg_next)      n.fg = s->fg_next;
+  if (s->gfx_next)     n.gfx = 1;
+  if (s->alpha_next)   n.gfx = 0;
+  if (s->flash_next)   n.flash = 1;
+  if (s->dh_next)      n.dh = 1;
+  if (s->release_next) n.hold = 0;
+  if (s->conceal && s->unconceal_next) n.conceal = 0;
+
+  /* Set-At codes, and Set-After codes for the next character */
+  if ((c & 0x60) == 0) {
+    if ((c & 0x08) == 0) {
+      if (c & 0x07) {
+        n.unconceal_next = 1;
+        n.fg_next = c & 0x07;
+        if (c & 0x10) {
+          n.gfx_next = 1;
+        } else {
+          n.alpha_next = 1;
+          n.release_next = 1;
+        }
+      }
+    } else {
+      switch (c & 0x1F) {
+      case 0x08: n.flash_next = 1; break;
+      case 0x09: n.flash = 0; break;
+      case 0x0C:
+        n.dh = 0;
+        if (s->dh) n.last_gfx = 0;
+        break;
+      case 0x0D:
+        n.dh_next = 1;
+        if (!s->dh) n.last_gfx = 0;
+        break;
+      case 0x18: n.conceal = 1; break;
+      case 0x19: n.sep = 0; break;
+      case 0x1A: n.sep = 1; break;
+      case 0x1C: n.bg = 0; break;
+      case 0x1D: n.bg = s->fg_next ? s->fg_next : s->fg; break;
+      case 0x1E: n.hold = 1; break;
+      case 0x1F: n.release_next = 1; break;
+      }
+    }
+  }
+  *s = n;
+}
+
+static int doubled(int pixels) {
+  int p, d = 0;
+  for (p = 32; p > 0; p >>= 1) {
+    d <<= 2;
+    if (pixels & p) d |= 3;
+  }
+  return d;
+}
+
+/* The 12 pixels of code c on a line, bit 11 first */
+static int glyph(const state_t *s, int c, int line, int crs, int dh2) {
+  int hold_active = s->hold && (c & 0x60) == 0;
+  int line_addr = s->dh ? (line >> 1) + (dh2 ? 5 : 0) : line;
+  int addr = 0;
+  int below, d1, d2, a, b, sep;
+
+  if (s->dh || !dh2) {
+    addr = (s->gfx << 11) | ((hold_active ? s->last_gfx : c) << 4) | line_addr;
+  }
+  below = (!s->dh && !crs) || (s->dh && (line & 1));
+  d1 = rom[addr];
+  d2 = rom[(addr + (below ? 1 : -1)) & 0xFFF];
+  a = doubled(d1 & 63);
+  b = doubled(d2 & 63);
+  if (d1 & 0x80) {
+    sep = hold_active ? s->last_gfx_sep : s->sep;
+    if (sep) {
+      a &= ~0xC30;
+      if (line_addr == 2 || line_addr == 6 || line_addr == 9) a = 0;
+    }
+  } else {
+    a |= ((a >> 1) & b & ~(b >> 1)) | ((a << 1) & 0xFFF & b & ~((b << 1) & 0xFFF));
+  }
+  return a;
+}
+
+static void render(void) {
+  state_t s;
+  int crs, v, row, line, col, p, y, pixels, dh1, dh2;
+
+  for (crs = 0; crs < 2; crs++) {
+    dh1 = dh2 = 0;
+    for (v = 0; v < ROWS * 10; v++) {
+      row = v / 10;
+      line = v % 10;
+      y = 2 * v + 1 - crs;
+      memset(&s, 0, sizeof(s));
+      s.fg = 7;
+      for (col = 0; col < COLS; col++) {
+        next_state(&s, page[row * COLS + col]);
+        if (s.dh && !dh1 && !dh2) {
+          dh1 = 1;
+        }
+        pixels = glyph(&s, page[row * COLS + col], line, crs, dh2);
+        for (p = 0; p < 12; p++) {
+          golden[y][col * 12 + p] = ((pixels >> (11 - p)) & 1) && !s.conceal ? s.fg : s.bg;
+        }
+      }
+      if (line == 9) {
+        dh2 = dh1;
+        dh1 = 0;
+      }
+    }
+  }
+}
+
+/* ======================================================================
+ * Output and comparison
+ * ====================================================================== */
+
+static void write_ppm(const char *path, unsigned char *frame, int stride, int offset) {
+  FILE *f = fopen(path, "wb");
+  int x, y, c;
+  if (f == NULL) {
+    fail("unable to write ", path);
+  }
+  fprintf(f, "P6\n%d %d\n255\n", WIDTH, HEIGHT);
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      c = frame[y * stride + offset + x];
+      fputc(c & 1 ? 255 : 0, f);
+      fputc(c & 2 ? 255 : 0, f);
+      fputc(c & 4 ? 255 : 0, f);
+    }
+  }
+  fclose(f);
+}
+
+static void read_capture(const char *path) {
+  FILE *f = fopen(path, "r");
+  static char pixels[4096];
+  int crs, num, y, x;
+  if (f == NULL) {
+    fail("unable to open ", path);
+  }
+  while (fscanf(f, "%d %d %4095s", &crs, &num, pixels) == 3) {
+    y = 2 * num + 1 - crs;
+    if (num < 0 || num >= ROWS * 10 || strlen(pixels) != CAPTURE) {
+      fail("unexpected line in ", path);
+    }
+    for (x = 0; x < CAPTURE; x++) {
+      captured[y][x] = pixels[x] - '0';
+    }
+    captured_lines[y] = 1;
+  }
+  fclose(f);
+  for (y = 0; y < HEIGHT; y++) {
+    if (!captured_lines[y]) {
+      fail("capture is missing lines: ", path);
+    }
+  }
+}
+
+static int compare(const char *capture_ppm) {
+  int offset, best = 0, best_diffs = -1, diffs, x, y, row, col, cells = 0;
+  int cell[ROWS][COLS];
+
+  /* The delay through the SAA5050 is found, not assumed */
+  for (offset = 0; offset <= CAPTURE - WIDTH; offset++) {
+    diffs = 0;
+    for (y = 0; y < HEIGHT; y++) {
+      for (x = 0; x < WIDTH; x++) {
+        diffs += captured[y][offset + x] != golden[y][x];
+      }
+    }
+    if (best_diffs < 0 || diffs < best_diffs) {
+      best_diffs = diffs;
+      best = offset;
+    }
+  }
+  printf("Pixel delay %d, %d pixels differ\n", best, best_diffs);
+
+  if (capture_ppm) {
+    write_ppm(capture_ppm, &captured[0][0], CAPTURE, best);
+  }
+  if (best_diffs == 0) {
+    return 0;
+  }
+
+  memset(cell, 0, sizeof(cell));
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      cell[y / 20][x / 12] += captured[y][best + x] != golden[y][x];
+    }
+  }
+  for (row = 0; row < ROWS; row++) {
+    for (col = 0; col < COLS; col++) {
+      if (cell[row][col] && cells++ < 20) {
+        printf("  row %2d col %2d (code %02X): %d pixels differ\n",
+               row, col, page[row * COLS + col], cell[row][col]);
+      }
+    }
+  }
+  printf("%d character cells differ\n", cells);
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 4 && strcmp(argv[1], "page") == 0) {
+    write_page(argv[2], argv[3]);
+    return 0;
+  }
+  if (argc == 5 && strcmp(argv[1], "render") == 0) {
+    read_rom(argv[2]);
+    read_page(argv[3]);
+    render();
+    write_ppm(argv[4], &golden[0][0], WIDTH, 0);
+    return 0;
+  }
+  if ((argc == 5 || argc == 6) && strcmp(argv[1], "compare") == 0) {
+    read_rom(argv[2]);
+    read_page(argv[3]);
+    read_capture(argv[4]);
+    render();
+    return compare(argc == 6 ? argv[5] : NULL);
+  }
+  fprintf(stderr, "Usage:\n"
+          "  %s page <charset|hold|mode7 screen dump> <page.txt>\n"
+          "  %s render <rom> <page.txt> <golden.ppm>\n"
+          "  %s compare <rom> <page.txt> <capture.txt> [<capture.ppm>]\n",
+          argv[0], argv[0], argv[0]);
+  return 2;
+}
@@ -0,0 +1,172 @@
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.std_logic_unsigned.all;
+use ieee.numeric_std.all;
+use ieee.std_logic_textio.all;          -- i/o for logic types
+
+library std;
+use std.textio.all;                     -- basic i/o
+
+-- Displays a teletext page (page.txt, 25 lines of 40 hex bytes) through
+-- the SAA5050 for both fields of a frame, and writes the pixels of every
+-- active line to capture.txt, for saa5050_golden to compare
+
+entity test_harness is
+    generic (
+        PREROUNDED : boolean := false
+    );
+end test_harness;
+
+architecture rtl of test_harness is
+
+    -- Cycles of the 12MHz pixel clock per line, of which the first 480
+    -- are active, and the number captured from the start of each line
+    constant LINE_CYCLES    : integer := 768;
+    constant ACTIVE_CYCLES  : integer := 480;
+    constant CAPTURE_CYCLES : integer := 528;
+
+    type page_type is array (0 to 25 * 40 - 1) of std_logic_vector(6 downto 0);
+
+    signal clock    : std_logic := '0';
+    signal nreset   : std_logic := '0';
+    signal di       : std_logic_vector(6 downto 0) := (others => '0');
+    signal dew      : std_logic := '0';
+    signal crs      : std_logic := '0';
+    signal lose     : std_logic := '0';
+    signal r        : std_logic;
+    signal g        : std_logic;
+    signal b        : std_logic;
+    signal y        : std_logic;
+
+    signal finished : boolean := false;
+
+    impure function read_page return page_type is
+        file     page_file : text open read_mode is "page.txt";
+        variable line_v    : line;
+        variable byte      : std_logic_vector(7 downto 0);
+        variable page      : page_type;
+    begin
+        for row in 0 to 24 loop
+            readline(page_file, line_v);
+            for col in 0 to 39 loop
+                hread(line_v, byte);
+                page(row * 40 + col) := byte(6 downto 0);
+            end loop;
+        end loop;
+        return page;
+    end function;
+
+begin
+
+    -- Clock process definitions
+    process
+    begin
+        if finished then
+            wait;
+        end if;
+        clock <= '0';
+        wait for 41.6667 ns;
+        clock <= '1';
+        wait for 41.6667 ns;
+    end process;
+
+    -- Stimulus process
+    process
+        variable page : page_type := read_page;
+    begin
+
+        for i in 0 to 15 loop
+            wait until falling_edge(clock);
+        end loop;
+        nreset <= '1';
+
+        -- The field with CRS high has the upper half of each character row
+        for f in 0 to 1 loop
+            if f = 0 then
+                crs <= '1';
+            else
+                crs <= '0';
+            end if;
+            report "field " & integer'image(f);
+
+            -- Vertical sync
+            dew <= '1';
+            for i in 0 to 4 * LINE_CYCLES - 1 loop
+                wait until falling_edge(clock);
+            end loop;
+            dew <= '0';
+
+            -- 25 rows of 10 lines, each character held for 12 pixels
+            for v in 0 to 249 loop
+                for h in 0 to LINE_CYCLES - 1 loop
+                    wait until falling_edge(clock);
+                    if h < ACTIVE_CYCLES then
+                        lose <= '1';
+                        di <= page((v / 10) * 40 + h / 12);
+                    else
+                        lose <= '0';
+                        di <= (others => '0');
+                    end if;
+                end loop;
+            end loop;
+        end loop;
+
+        finished <= true;
+        wait;
+    end process;
+
+    -- Capture process: "<crs> <line> <pixels>", with each pixel as 0-7 (R + 2G + 4B)
+    process
+        variable line_v   : line;
+        variable num      : integer := 0;
+        variable colour   : integer;
+        file     out_file : text open write_mode is "capture.txt";
+    begin
+        wait until rising_edge(lose) or dew = '1';
+        if dew = '1' then
+            num := 0;
+            wait until dew = '0';
+        else
+            if crs = '1' then
+                write(line_v, string'("1 "));
+            else
+                write(line_v, string'("0 "));
+            end if;
+            write(line_v, num);
+            write(line_v, ' ');
+            for i in 0 to CAPTURE_CYCLES - 1 loop
+                wait until rising_edge(clock);
+                colour := 0;
+                if r = '1' then colour := colour + 1; end if;
+                if g = '1' then colour := colour + 2; end if;
+                if b = '1' then colour := colour + 4; end if;
+                write(line_v, character'val(character'pos('0') + colour));
+            end loop;
+            writeline(out_file, line_v);
+            num := num + 1;
+        end if;
+    end process;
+
+    inst_saa5050 : entity work.saa5050
+    generic map (
+        PREROUNDED => PREROUNDED
+    )
+    port map (
+        CLOCK    => clock,
+        CLKEN    => '1',
+        nRESET   => nreset,
+        VGA      => '0',
+        DI_CLOCK => clock,
+        DI_CLKEN => '1',
+        DI       => di,
+        GLR      => '1',
+        DEW      => dew,
+        CRS      => crs,
+        LOSE     => lose,
+        R        => r,
+        G        => g,
+        B        => b,
+        Y        => y
+    );
+
+end;
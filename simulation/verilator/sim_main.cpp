@@ -0,0 +1,741 @@
+/*****************************************
+ * sim_main.cpp
+ *
+ * Harness for the compiled (Verilator)
+ * simulation of bbc_micro_core, built by
+ * the Makefile from sim_top.vhd.
+ *
+ * The core is clocked at 48MHz with no
+ * tracing. The harness models the 512K
+ * external memory, the original keyboard
+ * matrix (as on the Model B's ribbon cable)
+ * and an SDHC card in SPI mode.
+ *
+ * The video is composite sync RGB, so each
+ * field (csync low for more than a line) is
+ * sampled at 16MHz and listed with a hash of
+ * its pixels and of its audio, so a whole
+ * program run can be checked against an
+ * earlier one without a monitor.
+ *
+ * Usage:
+ *   sim_top [options]
+ *
+ *   -r <file>       ROM image from make_rom_image.sh (512K, banks 0-15
+ *                   for the Model B, 16-31 for the Master), or a 256K one
+ *   -m              Master 128 mode
+ *   -d <file>       SD card image (e.g. BEEB.MMB); writes are not saved
+ *   -k <hex>        keyboard DIP switches (default 00)
+ *   -n <fields>     fields to run (default 250, i.e. 5 seconds)
+ *   -a              autoboot, holding SHIFT for the first second
+ *   -t <field:text> type some text, starting at a field. \n is Return,
+ *                   \e Escape, \b Break; lower case is typed with SHIFT
+ *   -o <pattern>    write fields as PPM, e.g. field%04d.ppm
+ *   -e <n>          only write every nth field: n-1, 2n-1... (default 1)
+ *   -w <file>       write the audio as a 48KHz WAV file
+ *   -s <file>       save the field list (size, timing and hashes)
+ *   -c <file>       check the field list against one saved with -s,
+ *                   exiting with 1 if it differs
+ ***************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "verilated.h"
+#include "Vsim_top.h"
+
+#define CLOCK_HZ       48000000
+#define MEM_SIZE       0x80000
+#define ROM_SIZE       0x40000
+
+// A field is 312 or 313 lines of 64us, sampled at 16MHz
+#define FIELD_WIDTH    1024
+#define FIELD_HEIGHT   320
+#define PIXEL_CYCLES   3
+
+// Composite sync low for longer than this is vertical sync
+#define VSYNC_CYCLES   (CLOCK_HZ / 20000)
+
+// Key presses are held for 40ms, with 40ms between them
+#define KEY_CYCLES     (CLOCK_HZ / 25)
+#define FIELD_CYCLES   (CLOCK_HZ / 50)
+
+#define AUDIO_CYCLES   (CLOCK_HZ / 48000)
+
+// Not needed by newer versions of Verilator, but harmless
+double sc_time_stamp() {
+   return 0;
+}
+
+static Vsim_top *top;
+
+static uint64_t cycle = 0;
+
+static uint8_t mem[MEM_SIZE];
+
+// ======================================================================
+// Keyboard
+// ======================================================================
+
+// Internal key numbers (row in bits 6:4, column in bits 3:0)
+#define KEY_SHIFT      0x00
+#define KEY_RETURN     0x49
+#define KEY_ESCAPE     0x70
+#define KEY_BREAK      0xFF
+
+typedef struct {
+   uint64_t cycle;
+   int key;
+   int down;
+} key_event_t;
+
+static key_event_t *key_events = NULL;
+static int num_key_events = 0;
+static int next_key_event = 0;
+
+// One bit per row, for each column
+static uint8_t key_matrix[16];
+static int key_column = 0;
+static int key_break = 0;
+static int last_1mhz = 0;
+
+// Key number, plus 0x100 if SHIFT is needed, for each printable character
+static int ascii_key(int c) {
+   static const char *unshifted = "0\x27" "1\x30" "2\x31" "3\x11" "4\x12" "5\x13" "6\x34" "7\x24" "8\x15" "9\x26"
+      "-\x17" "^\x18" "@\x47" "[\x38" "_\x28" ";\x57" ":\x48" "]\x58" ",\x66" ".\x67" "/\x68" "\\\x78" " \x62";
+   static const char *shifted = "!1\"2#3$4%5&6'7(8)9=-~^|\\{[}]+;*:<,>.?/";
+   static const uint8_t letters[26] = {
+      0x41, 0x64, 0x52, 0x32, 0x22, 0x43, 0x53, 0x54, 0x25, 0x45, 0x46, 0x56, 0x65,
+      0x55, 0x36, 0x37, 0x10, 0x33, 0x51, 0x23, 0x35, 0x63, 0x21, 0x42, 0x44, 0x61
+   };
+   int i;
+   // CAPS LOCK is on after reset, so SHIFT gives lower case
+   if (c >= 'A' && c <= 'Z') {
+      return letters[c - 'A'];
+   }
+   if (c >= 'a' && c <= 'z') {
+      return letters[c - 'a'] | 0x100;
+   }
+   for (i = 0; unshifted[i]; i += 2) {
+      if (unshifted[i] == c) {
+         return (uint8_t) unshifted[i + 1];
+      }
+   }
+   for (i = 0; shifted[i]; i += 2) {
+      if (shifted[i] == c) {
+         return ascii_key(shifted[i + 1]) | 0x100;
+      }
+   }
+   return -1;
+}
+
+static void add_key_event(uint64_t when, int key, int down) {
+   key_events = (key_event_t *) realloc(key_events, (num_key_events + 1) * sizeof(key_event_t));
+   if (!key_events) {
+      fprintf(stderr, "Out of memory\n");
+      exit(1);
+   }
+   key_events[num_key_events].cycle = when;
+   key_events[num_key_events].key = key;
+   key_events[num_key_events].down = down;
+   num_key_events++;
+}
+
+static int compare_key_events(const void *a, const void *b) {
+   const key_event_t *ea = (const key_event_t *) a;
+   const key_event_t *eb = (const key_event_t *) b;
+   if (ea->cycle != eb->cycle) {
+      return ea->cycle < eb->cycle ? -1 : 1;
+   }
+   return 0;
+}
+
+// <field>:<text>
+static int add_typing(const char *arg) {
+   char *text;
+   uint64_t when = strtoul(arg, &text, 10) * FIELD_CYCLES;
+   if (*text++ != ':') {
+      return 0;
+   }
+   for (; *text; text++) {
+      int key;
+      if (*text == '\\' && text[1]) {
+         text++;
+         key = *text == 'n' ? KEY_RETURN : *text == 'e' ? KEY_ESCAPE : *text == 'b' ? KEY_BREAK : ascii_key(*text);
+      } else {
+         key = ascii_key(*text);
+      }
+      if (key < 0) {
+         fprintf(stderr, "ERROR: no key for '%c'\n", *text);
+         return 0;
+      }
+      if (key & 0x100) {
+         add_key_event(when, KEY_SHIFT, 1);
+         add_key_event(when + KEY_CYCLES, KEY_SHIFT, 0);
+      }
+      add_key_event(when, key & 0xFF, 1);
+      add_key_event(when + KEY_CYCLES, key & 0xFF, 0);
+      when += 2 * KEY_CYCLES;
+   }
+   return 1;
+}
+
+static void set_key(int key, int down) {
+   if (key == KEY_BREAK) {
+      key_break = down;
+   } else if (down) {
+      key_matrix[key & 15] |= 1 << (key >> 4);
+   } else {
+      key_matrix[key & 15] &= ~(1 << (key >> 4));
+   }
+}
+
+// The 74LS163 column counter is loaded from PA3:0 while the keyboard is
+// enabled, and counts at 1MHz otherwise, interrupting (CA2) if any key
+// other than those in row 0 is down in the current column
+static inline void keyboard_update() {
+   int pa = top->ext_keyb_pa;
+   while (next_key_event < num_key_events && key_events[next_key_event].cycle <= cycle) {
+      set_key(key_events[next_key_event].key, key_events[next_key_event].down);
+      next_key_event++;
+   }
+   if (!top->ext_keyb_en_n) {
+      key_column = pa & 15;
+   } else if (top->ext_keyb_1mhz && !last_1mhz) {
+      key_column = (key_column + 1) & 15;
+   }
+   last_1mhz = top->ext_keyb_1mhz;
+   top->ext_keyb_pa7 = (key_matrix[key_column] >> ((pa >> 4) & 7)) & 1;
+   top->ext_keyb_ca2 = (key_matrix[key_column] & 0xFE) != 0;
+   top->ext_keyb_rst_n = !key_break;
+}
+
+// ======================================================================
+// SD card (SDHC, SPI mode)
+// ======================================================================
+
+static uint8_t *sd_data = NULL;
+static size_t sd_size = 0;
+
+static int sd_last_clk = 0;
+static int sd_bits = 0;
+static uint8_t sd_in = 0;
+static uint8_t sd_out = 0xFF;
+
+static uint8_t sd_cmd[6];
+static int sd_cmd_len = 0;
+static int sd_idle = 1;
+static int sd_app = 0;
+
+// Bytes queued for the host: a response, a data block, or busy
+static uint8_t sd_resp[520];
+static int sd_resp_len = 0;
+static int sd_resp_pos = 0;
+
+// Write state: 0 = none, 1 = waiting for the start token, 2 = data
+static int sd_write = 0;
+static size_t sd_write_addr = 0;
+static int sd_write_pos = 0;
+static uint8_t sd_write_buf[514];
+
+static void sd_queue(uint8_t value) {
+   if (sd_resp_len < (int) sizeof(sd_resp)) {
+      sd_resp[sd_resp_len++] = value;
+   }
+}
+
+static void sd_queue_block(const uint8_t *data, int len) {
+   int i;
+   sd_queue(0xFF);
+   sd_queue(0xFE);
+   for (i = 0; i < len; i++) {
+      sd_queue(data[i]);
+   }
+   // The CRC, which isn't checked in SPI mode
+   sd_queue(0xFF);
+   sd_queue(0xFF);
+}
+
+static void sd_command() {
+   int cmd = sd_cmd[0] & 0x3F;
+   uint32_t arg = (sd_cmd[1] << 24) | (sd_cmd[2] << 16) | (sd_cmd[3] << 8) | sd_cmd[4];
+   int app = sd_app;
+   uint8_t reg[16];
+   size_t addr;
+   sd_app = 0;
+   sd_resp_len = 0;
+   sd_resp_pos = 0;
+   // NCR
+   sd_queue(0xFF);
+   if (app && cmd == 41) {
+      sd_idle = 0;
+      sd_queue(0x00);
+      return;
+   }
+   switch (cmd) {
+   case 0:
+      sd_idle = 1;
+      sd_queue(0x01);
+      break;
+   case 8:
+      sd_queue(sd_idle);
+      sd_queue(0x00);
+      sd_queue(0x00);
+      sd_queue((arg >> 8) & 0x0F);
+      sd_queue(arg & 0xFF);
+      break;
+   case 9:
+   case 10:
+      // CSD version 2.0 with the card's size, or an empty CID
+      memset(reg, 0, sizeof(reg));
+      if (cmd == 9) {
+         uint32_t c_size = sd_size >> 19;
+         c_size = c_size ? c_size - 1 : 0;
+         reg[0] = 0x40;
+         reg[7] = (c_size >> 16) & 0x3F;
+         reg[8] = c_size >> 8;
+         reg[9] = c_size;
+      }
+      sd_queue(sd_idle);
+      sd_queue_block(reg, 16);
+      break;
+   case 17:
+      sd_queue(sd_idle);
+      addr = (size_t) arg * 512;
+      if (addr + 512 <= sd_size) {
+         sd_queue_block(sd_data + addr, 512);
+      } else {
+         uint8_t blank[512];
+         memset(blank, 0, sizeof(blank));
+         sd_queue_block(blank, 512);
+      }
+      break;
+   case 24:
+      sd_queue(sd_idle);
+      sd_write = 1;
+      sd_write_addr = (size_t) arg * 512;
+      break;
+   case 55:
+      sd_app = 1;
+      sd_queue(sd_idle);
+      break;
+   case 58:
+      // OCR: powered up, high capacity (block addressed)
+      sd_queue(sd_idle);
+      sd_queue(0xC0);
+      sd_queue(0xFF);
+      sd_queue(0x80);
+      sd_queue(0x00);
+      break;
+   case 12:
+   case 16:
+   case 59:
+      sd_queue(sd_idle);
+      break;
+   default:
+      // Illegal command
+      sd_queue(sd_idle | 0x04);
+      break;
+   }
+}
+
+// Called with each byte from the host, returns the next byte to send
+static uint8_t sd_byte(uint8_t value) {
+   if (sd_write == 1) {
+      if (value == 0xFE) {
+         sd_write = 2;
+         sd_write_pos = 0;
+      }
+   } else if (sd_write == 2) {
+      sd_write_buf[sd_write_pos++] = value;
+      if (sd_write_pos == (int) sizeof(sd_write_buf)) {
+         if (sd_write_addr + 512 <= sd_size) {
+            memcpy(sd_data + sd_write_addr, sd_write_buf, 512);
+         }
+         sd_write = 0;
+         // Data accepted, then busy for a few bytes
+         sd_resp_len = 0;
+         sd_resp_pos = 0;
+         sd_queue(0x05);
+         sd_queue(0x00);
+         sd_queue(0x00);
+         sd_queue(0x00);
+      }
+   } else if (sd_cmd_len > 0 || (value & 0xC0) == 0x40) {
+      sd_cmd[sd_cmd_len++] = value;
+      if (sd_cmd_len == 6) {
+         sd_cmd_len = 0;
+         sd_command();
+      }
+   }
+   if (sd_resp_pos < sd_resp_len) {
+      return sd_resp[sd_resp_pos++];
+   }
+   return 0xFF;
+}
+
+// SPI mode 0: MOSI is sampled on the rising edge of SDCLK, and MISO
+// changes on the falling edge
+static inline void sd_update() {
+   int clk = top->sdclk;
+   if (top->sdss) {
+      sd_bits = 0;
+      sd_cmd_len = 0;
+      top->sdmiso = 1;
+   } else if (clk && !sd_last_clk) {
+      sd_in = (sd_in << 1) | top->sdmosi;
+      if (++sd_bits == 8) {
+         sd_out = sd_byte(sd_in);
+         sd_bits = 0;
+      }
+   } else if (!clk && sd_last_clk) {
+      top->sdmiso = (sd_out >> (7 - sd_bits)) & 1;
+   }
+   sd_last_clk = clk;
+}
+
+// ======================================================================
+// Video and audio capture
+// ======================================================================
+
+static const char *field_pattern = NULL;
+static int field_every = 1;
+static FILE *wav_file = NULL;
+static FILE *save_file = NULL;
+static FILE *check_file = NULL;
+static int check_errors = 0;
+
+static uint8_t *field;
+static int field_num = 0;
+static int field_line = -1;
+static int field_x = 0;
+static int field_phase = 0;
+static int field_lines = 0;
+static uint64_t field_start = 0;
+
+static int last_csync = 1;
+static int csync_low = 0;
+
+static int audio_phase = 0;
+static unsigned wav_samples = 0;
+static int field_samples = 0;
+static uint64_t audio_hash = 0xCBF29CE484222325ULL;
+
+static uint64_t fnv_hash(uint64_t hash, const uint8_t *data, size_t len) {
+   while (len--) {
+      hash ^= *data++;
+      hash *= 0x100000001B3ULL;
+   }
+   return hash;
+}
+
+static void write_field() {
+   char path[1024];
+   FILE *f;
+   snprintf(path, sizeof(path), field_pattern, field_num);
+   f = fopen(path, "wb");
+   if (f == NULL) {
+      fprintf(stderr, "Unable to write %s\n", path);
+      exit(1);
+   }
+   fprintf(f, "P6\n%d %d\n255\n", FIELD_WIDTH, field_lines);
+   fwrite(field, 3 * FIELD_WIDTH, field_lines, f);
+   fclose(f);
+}
+
+static void end_of_field() {
+   char summary[256];
+   char expected[256];
+   uint64_t video_hash;
+
+   field_lines = field_line + 1 < FIELD_HEIGHT ? field_line + 1 : FIELD_HEIGHT;
+   video_hash = fnv_hash(0xCBF29CE484222325ULL, field, 3 * FIELD_WIDTH * field_lines);
+   snprintf(summary, sizeof(summary), "%d lines %lu clocks video %016llx audio %d %016llx",
+            field_lines, (unsigned long) (cycle - field_start), (unsigned long long) video_hash,
+            field_samples, (unsigned long long) audio_hash);
+   printf("%10lu: Field %d: %s\n", (unsigned long) cycle, field_num, summary);
+
+   if (save_file) {
+      fprintf(save_file, "%s\n", summary);
+   }
+   if (check_file) {
+      if (fgets(expected, sizeof(expected), check_file) == NULL) {
+         expected[0] = 0;
+      }
+      expected[strcspn(expected, "\r\n")] = 0;
+      if (strcmp(summary, expected)) {
+         check_errors++;
+         printf("%10lu: Field %d differs, expected: %s\n", (unsigned long) cycle, field_num, expected[0] ? expected : "no field");
+      }
+   }
+   if (field_pattern && field_lines && ((field_num + 1) % field_every) == 0) {
+      write_field();
+   }
+
+   memset(field, 0, 3 * FIELD_WIDTH * FIELD_HEIGHT);
+   field_num++;
+   field_line = -1;
+   field_start = cycle;
+   field_samples = 0;
+   audio_hash = 0xCBF29CE484222325ULL;
+}
+
+// Lines start on the falling edge of composite sync
+static inline void video_update() {
+   int csync = top->video_hsync;
+   if (!csync) {
+      if (last_csync) {
+         csync_low = 0;
+         field_line++;
+         field_x = 0;
+         field_phase = 0;
+      }
+      if (++csync_low == VSYNC_CYCLES) {
+         end_of_field();
+      }
+   }
+   last_csync = csync;
+   if (field_line >= 0 && field_line < FIELD_HEIGHT && field_x < FIELD_WIDTH && ++field_phase == PIXEL_CYCLES) {
+      uint8_t *p = field + 3 * (field_line * FIELD_WIDTH + field_x);
+      p[0] = top->video_red * 17;
+      p[1] = top->video_green * 17;
+      p[2] = top->video_blue * 17;
+      field_phase = 0;
+      field_x++;
+   }
+}
+
+static void write_wav_header(unsigned rate) {
+   unsigned data_len = wav_samples * 4;
+   unsigned char header[44] = {
+      'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 16, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 16, 0,
+      'd', 'a', 't', 'a', 0, 0, 0, 0
+   };
+   int i;
+   for (i = 0; i < 4; i++) {
+      header[4 + i] = (36 + data_len) >> (8 * i);
+      header[24 + i] = rate >> (8 * i);
+      header[28 + i] = (rate * 4) >> (8 * i);
+      header[40 + i] = data_len >> (8 * i);
+   }
+   fseek(wav_file, 0, SEEK_SET);
+   fwrite(header, 1, sizeof(header), wav_file);
+}
+
+// The SN76489 output is unsigned, so is centred before being written
+static inline void audio_update() {
+   uint8_t sample[4];
+   if (++audio_phase < AUDIO_CYCLES) {
+      return;
+   }
+   audio_phase = 0;
+   sample[0] = (top->audio_l - 0x2000) & 0xFF;
+   sample[1] = ((top->audio_l - 0x2000) >> 8) & 0xFF;
+   sample[2] = (top->audio_r - 0x2000) & 0xFF;
+   sample[3] = ((top->audio_r - 0x2000) >> 8) & 0xFF;
+   audio_hash = fnv_hash(audio_hash, sample, 4);
+   field_samples++;
+   if (wav_file) {
+      fwrite(sample, 1, 4, wav_file);
+      wav_samples++;
+   }
+}
+
+// ======================================================================
+// Main
+// ======================================================================
+
+static int load_file(const char *path, uint8_t **data, size_t *size) {
+   FILE *f = fopen(path, "rb");
+   long len;
+   if (f == NULL) {
+      fprintf(stderr, "Unable to open file %s\n", path);
+      return 0;
+   }
+   fseek(f, 0, SEEK_END);
+   len = ftell(f);
+   fseek(f, 0, SEEK_SET);
+   *data = (uint8_t *) calloc(len > 0 ? len : 1, 1);
+   if (!*data || fread(*data, 1, len, f) != (size_t) len) {
+      fprintf(stderr, "Unable to read file %s\n", path);
+      fclose(f);
+      return 0;
+   }
+   fclose(f);
+   *size = len;
+   return 1;
+}
+
+// The boards map ext_A(17:0) into the upper half of the 512K image in
+// Master mode; main memory and sideways RAM live above 0x40000
+static int load_roms(const char *path, int master) {
+   uint8_t *data;
+   size_t size;
+   if (!load_file(path, &data, &size)) {
+      return 0;
+   }
+   if (size != ROM_SIZE && size != 2 * ROM_SIZE) {
+      fprintf(stderr, "ERROR: %s should be 256K or 512K\n", path);
+      return 0;
+   }
+   memcpy(mem, data + (master && size > ROM_SIZE ? ROM_SIZE : 0), ROM_SIZE);
+   free(data);
+   return 1;
+}
+
+int main(int argc, char *argv[]) {
+   const char *rom_path = NULL;
+   const char *sd_path = NULL;
+   const char *wav_path = NULL;
+   const char *save_path = NULL;
+   const char *check_path = NULL;
+   int master = 0;
+   int autoboot = 0;
+   int keyb_dip = 0;
+   int num_fields = 250;
+   int usage = 0;
+   struct timespec start, end;
+   double wall, emulated;
+   int i;
+
+   for (i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+         rom_path = argv[++i];
+      } else if (strcmp(argv[i], "-m") == 0) {
+         master = 1;
+      } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+         sd_path = argv[++i];
+      } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+         keyb_dip = strtol(argv[++i], NULL, 16);
+      } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+         num_fields = atoi(argv[++i]);
+      } else if (strcmp(argv[i], "-a") == 0) {
+         autoboot = 1;
+      } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+         if (!add_typing(argv[++i])) {
+            usage = 1;
+         }
+      } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+         field_pattern = argv[++i];
+      } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+         field_every = atoi(argv[++i]);
+      } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+         wav_path = argv[++i];
+      } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+         save_path = argv[++i];
+      } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+         check_path = argv[++i];
+      } else {
+         usage = 1;
+      }
+   }
+   if (usage || !rom_path || num_fields <= 0 || field_every <= 0) {
+      fprintf(stderr, "Usage: %s -r <rom_image.bin> [-m] [-d <sd.img>] [-k <dip>] [-n <fields>] [-a]\n"
+              "          [-t <field:text>] [-o <field%%04d.ppm>] [-e <n>] [-w <audio.wav>]\n"
+              "          [-s <fields.txt>] [-c <fields.txt>]\n", argv[0]);
+      return 1;
+   }
+
+   if (!load_roms(rom_path, master)) {
+      return 1;
+   }
+   if (sd_path && !load_file(sd_path, &sd_data, &sd_size)) {
+      return 1;
+   }
+   if (autoboot) {
+      add_key_event(0, KEY_SHIFT, 1);
+      add_key_event(CLOCK_HZ, KEY_SHIFT, 0);
+   }
+   if (num_key_events) {
+      qsort(key_events, num_key_events, sizeof(key_event_t), compare_key_events);
+   }
+
+   field = (uint8_t *) calloc(3 * FIELD_WIDTH, FIELD_HEIGHT);
+   if (!field) {
+      fprintf(stderr, "Out of memory\n");
+      return 1;
+   }
+   if (wav_path) {
+      wav_file = fopen(wav_path, "wb");
+      if (wav_file) {
+         write_wav_header(0);
+      }
+   }
+   if (save_path) {
+      save_file = fopen(save_path, "w");
+   }
+   if (check_path) {
+      check_file = fopen(check_path, "r");
+   }
+   if ((wav_path && !wav_file) || (save_path && !save_file) || (check_path && !check_file)) {
+      fprintf(stderr, "Unable to open the output files\n");
+      return 1;
+   }
+
+   Verilated::commandArgs(argc, argv);
+   top = new Vsim_top;
+   top->m128_mode = master;
+   top->keyb_dip = keyb_dip;
+   top->ps2_kbd_clk = 1;
+   top->ps2_kbd_data = 1;
+   top->ps2_mse_clk = 1;
+   top->ps2_mse_data = 1;
+   top->sdmiso = 1;
+   top->ext_keyb_rst_n = 1;
+
+   clock_gettime(CLOCK_MONOTONIC, &start);
+
+   while (field_num < num_fields) {
+      uint32_t addr;
+
+      top->hard_reset_n = cycle >= 1000;
+      top->clock_48 = 0;
+      top->eval();
+      top->clock_48 = 1;
+      top->eval();
+      cycle++;
+
+      // Asynchronous SRAM, with the ROM region read only
+      addr = top->ext_a;
+      if (!top->ext_ncs && !top->ext_nwe && addr >= ROM_SIZE) {
+         mem[addr] = top->ext_din;
+      }
+      top->ext_dout = mem[addr];
+
+      keyboard_update();
+      if (sd_data) {
+         sd_update();
+      }
+      video_update();
+      audio_update();
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &end);
+   wall = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+   emulated = (double) cycle / CLOCK_HZ;
+   printf("\n%.3f seconds emulated in %.3f seconds (%.2fx real time)\n", emulated, wall, wall > 0 ? emulated / wall : 0);
+
+   top->final();
+   delete top;
+
+   if (wav_file) {
+      write_wav_header(48000);
+      fclose(wav_file);
+   }
+   if (save_file) {
+      fclose(save_file);
+   }
+   if (check_file) {
+      char expected[256];
+      while (fgets(expected, sizeof(expected), check_file)) {
+         check_errors++;
+      }
+      fclose(check_file);
+      printf("\nField check: %s\n", check_errors ? "FAILED" : "passed");
+      return check_errors ? 1 : 0;
+   }
+   return 0;
+}
@@ -0,0 +1,165 @@
+library ieee;
+use ieee.std_logic_1164.all;
+
+-- Top level for the compiled simulation of bbc_micro_core
+--
+-- Only clock_48 is driven: with vid_mode "0000" the video comes straight
+-- from the video ULA / SAA5050 (composite sync on video_hsync), so the
+-- scan doublers and HDMI, the only users of clock_27 and clock_96, are
+-- never exercised. Everything else that sim_main.cpp models (the memory,
+-- the original keyboard matrix and the SD card) is brought out as a port.
+
+entity sim_top is
+    generic (
+        UseT65Core     : boolean := false;
+        UseAlanDCore   : boolean := true
+    );
+    port (
+        clock_48       : in    std_logic;
+        hard_reset_n   : in    std_logic;
+        m128_mode      : in    std_logic;
+        keyb_dip       : in    std_logic_vector(7 downto 0);
+
+        -- Open collector in hardware; the harness drives these high
+        ps2_kbd_clk    : inout std_logic;
+        ps2_kbd_data   : inout std_logic;
+        ps2_mse_clk    : inout std_logic;
+        ps2_mse_data   : inout std_logic;
+
+        video_red      : out   std_logic_vector(3 downto 0);
+        video_green    : out   std_logic_vector(3 downto 0);
+        video_blue     : out   std_logic_vector(3 downto 0);
+        video_hsync    : out   std_logic;
+
+        audio_l        : out   std_logic_vector(15 downto 0);
+        audio_r        : out   std_logic_vector(15 downto 0);
+
+        ext_nwe        : out   std_logic;
+        ext_ncs        : out   std_logic;
+        ext_a          : out   std_logic_vector(18 downto 0);
+        ext_dout       : in    std_logic_vector(7 downto 0);
+        ext_din        : out   std_logic_vector(7 downto 0);
+
+        sdmiso         : in    std_logic;
+        sdss           : out   std_logic;
+        sdclk          : out   std_logic;
+        sdmosi         : out   std_logic;
+
+        caps_led       : out   std_logic;
+        shift_led      : out   std_logic;
+
+        ext_keyb_1mhz  : out   std_logic;
+        ext_keyb_en_n  : out   std_logic;
+        ext_keyb_pa    : out   std_logic_vector(6 downto 0);
+        ext_keyb_rst_n : in    std_logic;
+        ext_keyb_ca2   : in    std_logic;
+        ext_keyb_pa7   : in    std_logic;
+
+        cpu_addr       : out   std_logic_vector(15 downto 0)
+    );
+end sim_top;
+
+architecture rtl of sim_top is
+
+begin
+
+    bbc_micro : entity work.bbc_micro_core
+    generic map (
+        IncludeAMXMouse    => false,
+        IncludeSPISD       => true,
+        IncludeSID         => false,
+        IncludeMusic5000   => false,
+        IncludeICEDebugger => false,
+        IncludeCoPro6502   => false,
+        IncludeCoProSPI    => false,
+        IncludeCoProExt    => false,
+        IncludeVideoNuLA   => false,
+        IncludeHDMI        => false,
+        UseOrigKeyboard    => true,
+        UseT65Core         => UseT65Core,
+        UseAlanDCore       => UseAlanDCore
+    )
+    port map (
+        clock_27       => '0',
+        clock_32       => '0',
+        clock_48       => clock_48,
+        clock_96       => '0',
+        clock_avr      => '0',
+        hard_reset_n   => hard_reset_n,
+        ps2_kbd_clk    => ps2_kbd_clk,
+        ps2_kbd_clk_o  => open,
+        ps2_kbd_data   => ps2_kbd_data,
+        ps2_kbd_data_o => open,
+        ps2_mse_clk    => ps2_mse_clk,
+        ps2_mse_clk_o  => open,
+        ps2_mse_data   => ps2_mse_data,
+        ps2_mse_data_o => open,
+        video_red      => video_red,
+        video_green    => video_green,
+        video_blue     => video_blue,
+        video_vsync    => open,
+        video_hsync    => video_hsync,
+        audio_l        => audio_l,
+        audio_r        => audio_r,
+        ext_A_stb      => open,
+        ext_nOE        => open,
+        ext_nWE        => ext_nwe,
+        ext_nWE_long   => open,
+        ext_nCS        => ext_ncs,
+        ext_A          => ext_a,
+        ext_Dout       => ext_dout,
+        ext_Din        => ext_din,
+        SDMISO         => sdmiso,
+        SDSS           => sdss,
+        SDCLK          => sdclk,
+        SDMOSI         => sdmosi,
+        caps_led       => caps_led,
+        shift_led      => shift_led,
+        motor_led      => open,
+        keyb_dip       => keyb_dip,
+        ext_keyb_led1  => open,
+        ext_keyb_led2  => open,
+        ext_keyb_led3  => open,
+        ext_keyb_1mhz  => ext_keyb_1mhz,
+        ext_keyb_en_n  => ext_keyb_en_n,
+        ext_keyb_pa    => ext_keyb_pa,
+        ext_keyb_rst_n => ext_keyb_rst_n,
+        ext_keyb_ca2   => ext_keyb_ca2,
+        ext_keyb_pa7   => ext_keyb_pa7,
+        config         => open,
+        vid_mode       => "0000",
+        joystick1      => (others => '1'),
+        joystick2      => (others => '1'),
+        avr_reset      => '0',
+        avr_RxD        => '1',
+        avr_TxD        => open,
+        cpu_addr       => cpu_addr,
+        m128_mode      => m128_mode,
+        copro_mode     => '0',
+        p_spi_ssel     => '0',
+        p_spi_sck      => '0',
+        p_spi_mosi     => '0',
+        p_spi_miso     => open,
+        p_irq_b        => open,
+        p_nmi_b        => open,
+        p_rst_b        => open,
+        ext_tube_r_nw  => open,
+        ext_tube_nrst  => open,
+        ext_tube_ntube => open,
+        ext_tube_phi2  => open,
+        ext_tube_a     => open,
+        ext_tube_di    => open,
+        trace_data     => open,
+        trace_r_nw     => open,
+        trace_sync     => open,
+        trace_rstn     => open,
+        trace_phi2     => open,
+        tmds_r         => open,
+        tmds_g         => open,
+        tmds_b         => open,
+        hsync_ref      => open,
+        snap_status    => open,
+        test           => open
+    );
+
+end rtl;
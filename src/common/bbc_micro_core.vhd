@@ -66,10 +66,13 @@ entity bbc_micro_core is
         IncludeCoProExt    : boolean := false; -- (i.e. select just one)
         IncludeVideoNuLA   : boolean := false;
         IncludeHDMI        : boolean := false;
+        IncludeJimRam      : boolean := false; -- Paged RAM in JIM (used by the PYNQ-Z2 disk server)
         IncludeTrace       : boolean := false;
+        IncludeSnapshot    : boolean := false; -- Freeze / instruction injection for save states (PYNQ-Z2)
         UseOrigKeyboard    : boolean := false;
         UseT65Core         : boolean := false;
         UseAlanDCore       : boolean := true;
+        UseRoundedTtxtRom  : boolean := false; -- Pre-rounded teletext ROM: more block RAM, less logic
         OverrideCMOS       : boolean := true   -- Overide CMOS/RTC mode settings with keyb_dip
     );
     port (
@@ -220,6 +223,15 @@ entity bbc_micro_core is
         tmds_b         : out   std_logic_vector(9 downto 0);
         hsync_ref      : out   std_logic;
 
+        -- Snapshot control (see Save States below)
+        --   bit  0     - freeze
+        --   bit  1     - inject
+        --   bits 14..4 - injection length
+        snap_ctrl      : in    std_logic_vector(15 downto 0) := (others => '0');
+        --   bit  0     - frozen
+        --   bit  1     - injection done
+        snap_status    : out   std_logic_vector(1 downto 0);
+
         -- Test outputs
         test           : out   std_logic_vector(7 downto 0)
 
@@ -694,6 +706,32 @@ signal adc_ch3          :   std_logic_vector(11 downto 0);
 -- ROM select latch
 signal romsel           :   std_logic_vector(7 downto 0);
 
+-- JIM paging register (0xFCFF) and paged RAM
+signal jim_page         :   std_logic_vector(7 downto 0);
+signal jim_ram_enable   :   std_logic;      -- 0xFD00 (when jim_page < 0x30)
+
+-- Save states
+signal snap_ctrl1       :   std_logic_vector(15 downto 0);
+signal snap_ctrl2       :   std_logic_vector(15 downto 0);
+signal snap_freeze      :   std_logic;
+signal snap_inject      :   std_logic;
+signal snap_len         :   unsigned(10 downto 0);
+signal snap_armed       :   std_logic := '0';
+signal snap_frozen      :   std_logic := '0';
+signal snap_slot        :   std_logic := '0';
+signal snap_injecting   :   std_logic := '0';
+signal snap_done        :   std_logic := '0';
+signal snap_stop        :   std_logic;
+signal snap_go          :   std_logic;
+signal snap_rd_ptr      :   unsigned(10 downto 0) := (others => '0');
+signal snap_wr_ptr      :   unsigned(10 downto 0) := (others => '0');
+signal snap_redirect    :   std_logic;
+signal snap_shadow_we   :   std_logic;
+signal snap_shadow_a    :   std_logic_vector(7 downto 0);
+signal snap_shadow_d    :   std_logic_vector(7 downto 0);
+signal crtc_index       :   std_logic_vector(4 downto 0) := (others => '0');
+signal sound_reg        :   std_logic_vector(2 downto 0) := (others => '0');
+
 signal mhz1_enable      :   std_logic;      -- Set for access to any 1 MHz peripheral
 
 -- Master Real Time Clock / CMOS RAM
@@ -907,6 +945,9 @@ begin
     end generate;
 
     teletext : entity work.saa5050
+        generic map (
+            PREROUNDED => UseRoundedTtxtRom
+        )
         port map (
             CLOCK    => clock_48, -- This runs at 12 MHz, which we can't derive from the 32 MHz clock
             CLKEN    => ttxt_clken,
@@ -1557,14 +1598,14 @@ begin
             end if;
 
             -- 4MHz clock enable
-            if div3_counter = 1 and clken_counter(1 downto 0) = 3 then
+            if div3_counter = 1 and clken_counter(1 downto 0) = 3 and snap_frozen = '0' then
                 mhz4_clken <= '1';
             else
                 mhz4_clken <= '0';
             end if;
 
             -- 2MHz clock enable
-            if div3_counter = 1 and clken_counter(2 downto 0) = 3 then
+            if div3_counter = 1 and clken_counter(2 downto 0) = 3 and snap_frozen = '0' then
                 -- Compute cycle stretching
                 if mhz1_enable = '1' and cpu_cycle_mask = "00" then
                     -- Block CPU cycles until 1 MHz cycle has completed
@@ -1580,14 +1621,15 @@ begin
             end if;
 
             -- 1MHz clock enable
-            if div3_counter = 1 and clken_counter(3 downto 0) = 3 then
+            if div3_counter = 1 and clken_counter(3 downto 0) = 3 and snap_frozen = '0' then
                 mhz1_clken <= '1';
             else
                 mhz1_clken <= '0';
             end if;
 
-            -- CPU clock enable (taking account of cycle stretching)
-            if div3_counter = 2 and clken_counter(2 downto 0) = 3 and cpu_cycle_mask = "00" then
+            -- CPU clock enable (taking account of cycle stretching and freezing)
+            if div3_counter = 2 and clken_counter(2 downto 0) = 3 and cpu_cycle_mask = "00" and
+                ((snap_frozen = '0' and snap_stop = '0') or snap_go = '1') then
                 cpu_clken <= '1';
             else
                 cpu_clken <= '0';
@@ -1682,6 +1724,8 @@ begin
     io_sheila_n <= not io_sheila;
     -- The following IO regions are accessed at 1 MHz and hence will stall the
     -- CPU accordingly
+    -- JIM pages 0x00-0x2F are RAM (0x30-0x3F are used by the Music 5000)
+    jim_ram_enable <= '1' when IncludeJimRam and io_jim = '1' and jim_page(7 downto 4) < "0011" else '0';
     mhz1_enable <= io_fred or io_jim or
         adc_enable or sys_via_enable or user_via_enable or
         serproc_enable or acia_enable or crtc_enable;
@@ -1850,7 +1894,7 @@ begin
     -- CPU data bus mux and interrupts
     cpu_di <=
         cpu_do         when cpu_r_nw = '0' else
-        cpu_mem_data   when ram_enable = '1' or rom_enable = '1' or mos_enable = '1' else
+        cpu_mem_data   when ram_enable = '1' or rom_enable = '1' or mos_enable = '1' or jim_ram_enable = '1' else
         crtc_do        when crtc_enable = '1' else
         adc_do         when adc_enable = '1' else
         "00000010"     when acia_enable = '1' else
@@ -1869,7 +1913,9 @@ begin
         "11111111"     when io_fred = '1' or io_jim = '1' else
         (others => '0'); -- un-decoded locations are pulled down by RP1
 
-    cpu_irq_n <= not ((not sys_via_irq_n) or (not user_via_irq_n) or acc_irr) when m128_mode = '1' else
+    -- Interrupts are masked while freezing and injecting (see Save States below)
+    cpu_irq_n <= '1' when IncludeSnapshot and (snap_freeze = '1' or snap_injecting = '1') else
+                 not ((not sys_via_irq_n) or (not user_via_irq_n) or acc_irr) when m128_mode = '1' else
                  not ((not sys_via_irq_n) or (not user_via_irq_n));
     -- SRAM bus
 
@@ -1916,7 +1962,10 @@ begin
     -- 110 1011 xxxx xxxx xxxx = Shadow memory (4K, at 3000-3FFF)     (unused in Beeb Mode)
     -- 110 11xx xxxx xxxx xxxx = Shadow memory (16K, at 4000-7FFF)    (unused in Beeb Mode)
     -- 111 00xx xxxx xxxx xxxx = RAM Slot 8 (B600-BFFF)
-    -- 111 01xx xxxx xxxx xxxx = unused
+    -- 111 01xx xxxx xxxx xxxx = JIM RAM (12K, pages 00-2F at FDxx)   (if IncludeJimRam)
+    -- 111 0111 0xxx xxxx xxxx = Snapshot injection buffer (2K)       (if IncludeSnapshot)
+    -- 111 0111 1xxx xxxx xxxx = Snapshot capture buffer (1.75K)      (if IncludeSnapshot)
+    -- 111 0111 1111 xxxx xxxx = Snapshot shadow registers            (if IncludeSnapshot)
     -- 111 10xx xxxx xxxx xxxx = unused
     -- 111 11xx xxxx xxxx xxxx = unused
 
@@ -1960,7 +2009,25 @@ begin
             else
                 ext_nCS <= '0';
                 -- Fetch data from previous CPU cycle
-                if rom_enable = '1' then
+                if snap_redirect = '1' then
+                    -- Injected instructions are read from the injection buffer,
+                    -- and anything they write goes to the capture buffer
+                    if cpu_r_nw = '1' then
+                        ext_A <= "11101110" & std_logic_vector(snap_rd_ptr);
+                    else
+                        ext_A <= "11101111" & std_logic_vector(snap_wr_ptr);
+                    end if;
+                    ext_nWE <= not ((not cpu_r_nw) and mem_write_strobe);
+                    ext_nWE_long <= cpu_r_nw;
+                    ext_nOE <= not cpu_r_nw;
+                elsif snap_shadow_we = '1' then
+                    -- Copy of a write to a write-only register
+                    ext_A   <= "11101111111" & snap_shadow_a;
+                    ext_Din <= snap_shadow_d;
+                    ext_nWE <= not mem_write_strobe;
+                    ext_nWE_long <= '0';
+                    ext_nOE <= '1';
+                elsif rom_enable = '1' then
                     if m128_mode = '1' and cpu_a(15 downto 12) = "1000" and romsel(7) = '1' then
                         -- Master 128, RAM bit maps 8000-8FFF as private RAM
                         ext_A   <= "1101000" & cpu_a(11 downto 0);
@@ -2020,6 +2087,12 @@ begin
                     ext_nWE <= not ((not cpu_r_nw) and mem_write_strobe);
                     ext_nWE_long <= cpu_r_nw;
                     ext_nOE <= not cpu_r_nw;
+                elsif jim_ram_enable = '1' then
+                    -- JIM RAM
+                    ext_A   <= "11101" & jim_page(5 downto 0) & cpu_a(7 downto 0);
+                    ext_nWE <= not ((not cpu_r_nw) and mem_write_strobe);
+                    ext_nWE_long <= cpu_r_nw;
+                    ext_nOE <= not cpu_r_nw;
                 end if;
             end if;
         end if;
@@ -2161,6 +2234,18 @@ begin
         end if;
     end process;
 
+    -- JIM paging register (write only, as on the Music 5000)
+    process(clock_48,reset_n)
+    begin
+        if reset_n = '0' then
+            jim_page <= (others => '1');
+        elsif rising_edge(clock_48) then
+            if io_fred = '1' and cpu_a(7 downto 0) = x"FF" and cpu_r_nw = '0' then
+                jim_page <= cpu_do;
+            end if;
+        end if;
+    end process;
+
     -- IC32 latch
     sound_enable_n <= ic32(0);
  -- speech_write_n <= ic32(1);
@@ -2612,6 +2697,187 @@ begin
     end generate;
 
 
+-----------------------------------------------
+-- Save States
+-----------------------------------------------
+
+    -- The PS captures and restores the state of the machine as follows:
+    --
+    -- Freeze: interrupts are masked, and once the CPU has completed an
+    -- instruction with them masked it is stopped at the next opcode fetch.
+    -- The 1MHz/4MHz clock enables (VIAs, sound, keyboard, ADC) stop at the
+    -- same time, but the video keeps running. The machine is restarted in
+    -- the same phase of clken_counter, so the 1MHz bus doesn't slip.
+    --
+    -- Inject: the CPU runs again, but all its non-IO reads are taken in
+    -- sequence from the injection buffer (regardless of address) and all its
+    -- non-IO writes go in sequence to the capture buffer. IO accesses go to
+    -- the real devices. After snap_len bytes the CPU is frozen again at the
+    -- next opcode fetch. This is used both to capture the CPU registers and
+    -- to restore the CPU and device registers.
+    --
+    -- Shadow registers: writes to registers that can't be read back are
+    -- copied into the shadow area (offsets in the App's snapshot.h):
+    --   0x00-0x1F CRTC R0-R31     0x80-0x8F Palette (by logical colour)
+    --   0x20      ULA control     0x90-0x97 Sound latch bytes (by register)
+    --   0x30      ROMSEL          0x98-0x9F Sound data bytes (by register)
+    --   0x34      ACCCON          0xA0      CRTC address register
+    --   0x40-0x4F System VIA      0xA1      JIM paging register
+    --   0x60-0x6F User VIA        0xB0-0xB7 IC32 latch (by bit)
+    --
+    -- VIA registers are indexed by function (6/7 -> 4/5, F -> 1). System VIA
+    -- port B writes go to the IC32 shadow, or to the sound shadow (with the
+    -- data from port A) if they enable the sound chip.
+
+    GenSnapshot: if IncludeSnapshot generate
+
+        snap_freeze <= snap_ctrl2(0);
+        snap_inject <= snap_ctrl2(1);
+        snap_len    <= unsigned(snap_ctrl2(14 downto 4));
+
+        snap_stop <= '1' when snap_frozen = '0' and cpu_sync = '1' and
+                     ((snap_injecting = '0' and snap_freeze = '1' and snap_armed = '1') or
+                      (snap_injecting = '1' and snap_rd_ptr = snap_len)) else '0';
+
+        snap_go   <= '1' when snap_frozen = '1' and clken_counter(3) = snap_slot and
+                     ((snap_freeze = '0' and snap_inject = '0') or snap_injecting = '1') else '0';
+
+        snap_redirect <= snap_injecting and not (io_fred or io_jim or io_sheila);
+
+        snap_status <= snap_done & snap_frozen;
+
+        process(clock_48)
+        begin
+            if rising_edge(clock_48) then
+                -- The control register is written from the PS clock domain
+                snap_ctrl1 <= snap_ctrl;
+                snap_ctrl2 <= snap_ctrl1;
+                -- Everything else happens in the CPU clock enable slot
+                if div3_counter = 2 and clken_counter(2 downto 0) = 3 and cpu_cycle_mask = "00" then
+                    if snap_frozen = '1' and snap_go = '0' then
+                        if snap_inject = '1' and snap_injecting = '0' and snap_done = '0' then
+                            -- Start injecting from the next slot, so the
+                            -- first read is already redirected
+                            snap_injecting <= '1';
+                            snap_rd_ptr <= (others => '0');
+                            snap_wr_ptr <= (others => '0');
+                        end if;
+                    elsif snap_stop = '1' then
+                        snap_frozen <= '1';
+                        snap_slot <= clken_counter(3);
+                        snap_armed <= '0';
+                        if snap_injecting = '1' then
+                            snap_injecting <= '0';
+                            snap_done <= '1';
+                        end if;
+                    else
+                        -- The CPU runs in this slot
+                        snap_frozen <= '0';
+                        if cpu_sync = '1' and snap_freeze = '1' then
+                            snap_armed <= '1';
+                        end if;
+                        if snap_redirect = '1' then
+                            if cpu_r_nw = '1' then
+                                snap_rd_ptr <= snap_rd_ptr + 1;
+                            else
+                                snap_wr_ptr <= snap_wr_ptr + 1;
+                            end if;
+                        end if;
+                    end if;
+                end if;
+                if snap_freeze = '0' then
+                    snap_armed <= '0';
+                end if;
+                if snap_inject = '0' then
+                    snap_done <= '0';
+                end if;
+                -- Track the CRTC address register and sound chip latch
+                if cpu_clken = '1' and cpu_r_nw = '0' then
+                    if crtc_enable = '1' and cpu_a(0) = '0' then
+                        crtc_index <= cpu_do(4 downto 0);
+                    end if;
+                    if sys_via_enable = '1' and cpu_a(3 downto 0) = "0000" and cpu_do(3 downto 0) = "0000" and sys_via_pa_out(7) = '1' then
+                        sound_reg <= sys_via_pa_out(6 downto 4);
+                    end if;
+                end if;
+            end if;
+        end process;
+
+        process(cpu_r_nw, cpu_a, cpu_do, io_fred, crtc_enable, crtc_index, vidproc_enable,
+                romsel_enable, acccon_enable, sys_via_enable, user_via_enable, sys_via_pa_out, sound_reg)
+            variable reg : std_logic_vector(3 downto 0);
+        begin
+            snap_shadow_we <= '0';
+            snap_shadow_a  <= cpu_a(7 downto 0);
+            snap_shadow_d  <= cpu_do;
+            reg := cpu_a(3 downto 0);
+            case reg is
+                when x"6"   => reg := x"4";
+                when x"7"   => reg := x"5";
+                when x"F"   => reg := x"1";
+                when others => null;
+            end case;
+            if cpu_r_nw = '0' then
+                if crtc_enable = '1' then
+                    snap_shadow_we <= '1';
+                    if cpu_a(0) = '0' then
+                        snap_shadow_a <= x"A0";
+                    else
+                        snap_shadow_a <= "000" & crtc_index;
+                    end if;
+                elsif vidproc_enable = '1' and (cpu_a(1) = '0' or not IncludeVideoNuLA) then
+                    snap_shadow_we <= '1';
+                    if cpu_a(0) = '0' then
+                        snap_shadow_a <= x"20";
+                    else
+                        snap_shadow_a <= x"8" & cpu_do(7 downto 4);
+                    end if;
+                elsif romsel_enable = '1' then
+                    snap_shadow_we <= '1';
+                    snap_shadow_a <= x"30";
+                elsif acccon_enable = '1' then
+                    snap_shadow_we <= '1';
+                    snap_shadow_a <= x"34";
+                elsif sys_via_enable = '1' and reg = x"0" then
+                    snap_shadow_we <= '1';
+                    if cpu_do(3 downto 0) = "0000" then
+                        snap_shadow_d <= sys_via_pa_out;
+                        if sys_via_pa_out(7) = '1' then
+                            snap_shadow_a <= x"9" & '0' & sys_via_pa_out(6 downto 4);
+                        else
+                            snap_shadow_a <= x"9" & '1' & sound_reg;
+                        end if;
+                    else
+                        snap_shadow_a <= x"B" & '0' & cpu_do(2 downto 0);
+                    end if;
+                elsif sys_via_enable = '1' then
+                    snap_shadow_we <= '1';
+                    snap_shadow_a <= x"4" & reg;
+                elsif user_via_enable = '1' then
+                    snap_shadow_we <= '1';
+                    snap_shadow_a <= x"6" & reg;
+                elsif io_fred = '1' and cpu_a(7 downto 0) = x"FF" then
+                    snap_shadow_we <= '1';
+                    snap_shadow_a <= x"A1";
+                end if;
+            end if;
+        end process;
+
+    end generate;
+
+    GenNotSnapshot: if not IncludeSnapshot generate
+        snap_freeze    <= '0';
+        snap_inject    <= '0';
+        snap_stop      <= '0';
+        snap_go        <= '0';
+        snap_redirect  <= '0';
+        snap_shadow_we <= '0';
+        snap_shadow_a  <= (others => '0');
+        snap_shadow_d  <= (others => '0');
+        snap_status    <= (others => '0');
+    end generate;
+
+
     -- Test output
     test <= crtc_vsync & crtc_hsync & crtc_ra(0) & crtc_enable & crtc_test(3 downto 0);
 
@@ -54,6 +54,9 @@
 -- Lots of fixes to correctly implement Set-At and Set-After control codes
 --
 -- (C) 2015 David Banks
+--
+-- Optional pre-rounded character ROM (PREROUNDED), which holds each row
+-- already rounded and separated, so none of that is done in logic
 
 library ieee;
 use ieee.std_logic_1164.all;
@@ -61,6 +64,10 @@ use ieee.std_logic_unsigned.all;
 use ieee.numeric_std.all;
 
 entity saa5050 is
+generic (
+    -- Use the pre-rounded character ROM (see roms/saa5050/genrom.c)
+    PREROUNDED  :   boolean := false
+);
 port (
     CLOCK       :   in  std_logic;
     -- 6 MHz dot clock enable
@@ -109,6 +116,11 @@ signal rom_address1 :   std_logic_vector(11 downto 0);
 signal rom_address2 :   std_logic_vector(11 downto 0);
 signal rom_data1    :   std_logic_vector(7 downto 0);
 signal rom_data2    :   std_logic_vector(7 downto 0);
+-- Pre-rounded character ROM
+signal rom_graphics :   std_logic;
+signal rom_select   :   std_logic;
+signal rom_address_r:   std_logic_vector(12 downto 0);
+signal rom_data_r   :   std_logic_vector(11 downto 0);
 
 -- Delayed display enable derived from LOSE by delaying for one and two characters
 signal disp_enable  :   std_logic;
@@ -488,13 +500,41 @@ begin
     rom_address2 <= rom_address1 + 1 when ((double_high = '0' and CRS = '0') or (double_high = '1' and line_counter(0) = '1')) else
                     rom_address1 - 1;
 
-    char_rom : entity work.saa5050_rom_dual_port port map (
-        clock    => CLOCK,
-        addressA => rom_address1,
-        QA       => rom_data1,
-        addressB => rom_address2,
-        QB       => rom_data2
-    );
+    gen_rom : if not PREROUNDED generate
+
+        char_rom : entity work.saa5050_rom_dual_port port map (
+            clock    => CLOCK,
+            addressA => rom_address1,
+            QA       => rom_data1,
+            addressB => rom_address2,
+            QB       => rom_data2
+        );
+
+    end generate;
+
+    gen_rom_rounded : if PREROUNDED generate
+
+        -- Graphics characters are those with gfx and bit 5 of the code set
+        rom_graphics <= rom_address1(11) and rom_address1(9);
+
+        -- Selects between the two versions of each row: for graphics,
+        -- separated or not; otherwise rounded with the row above or below
+        rom_select <= ((not hold_active and gfx_sep) or (hold_active and last_gfx_sep)) when rom_graphics = '1' else
+                      '0' when ((double_high = '0' and CRS = '0') or (double_high = '1' and line_counter(0) = '1')) else
+                      '1';
+
+        rom_address_r <= rom_address1 & rom_select;
+
+        char_rom : entity work.saa5050_rom_rounded port map (
+            clock    => CLOCK,
+            address  => rom_address_r,
+            Q        => rom_data_r
+        );
+
+        rom_data1 <= (others => '0');
+        rom_data2 <= (others => '0');
+
+    end generate;
 
     --------------------------------------------------------------------
     -- Shift register
@@ -507,7 +547,11 @@ begin
             shift_reg <= (others => '0');
         elsif rising_edge(CLOCK) then
             if CLKEN = '1' then
-                if disp_enable_r = '1' and pixel_counter = 0 then
+                if disp_enable_r = '1' and pixel_counter = 0 and PREROUNDED then
+                    -- The row is already rounded or separated
+                    shift_reg <= rom_data_r;
+
+                elsif disp_enable_r = '1' and pixel_counter = 0 then
                     -- Character rounding
 
                     -- a is the current row of pixels, doubled up
@@ -0,0 +1,1058 @@
+-- SAA5050 pre-rounded character ROM, generated by roms/saa5050/genrom -r -v
+--
+-- Address is the normal ROM address (gfx & code & row) then one bit:
+-- for alpha-numerics rounded with the row below (0) or above (1), for
+-- graphics contiguous (0) or separated (1)
+
+library ieee;
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+entity saa5050_rom_rounded is
+    port(
+        clock    : in  std_logic;
+        address  : in  std_logic_vector(12 downto 0);
+        Q        : out std_logic_vector(11 downto 0)
+    );
+end saa5050_rom_rounded;
+
+architecture RTL of saa5050_rom_rounded is
+
+    type mem_type is array (0 to 8191) of std_logic_vector(11 downto 0);
+
+    constant mem : mem_type := (
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"07E",x"03C",x"0C3",x"0E7",x"0C0",x"0C0",
+	x"3F0",x"3F0",x"0C0",x"0C0",x"0C0",x"0C0",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"333",x"3B7",x"3B0",x"330",
+	x"0FE",x"1FC",x"033",x"037",x"3B7",x"333",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3C0",x"3C0",x"3C7",x"3C3",x"01C",x"00E",
+	x"070",x"038",x"1C0",x"0E0",x"30F",x"38F",x"00F",x"00F",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1E0",x"0C0",x"330",x"3F0",x"3F0",x"330",
+	x"1E0",x"1E0",x"33F",x"3F3",x"39E",x"31E",x"0F3",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"01C",x"00C",x"070",x"038",x"0C0",x"0E0",
+	x"0C0",x"0C0",x"0E0",x"0C0",x"038",x"070",x"00C",x"01C",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0E0",x"0C0",x"038",x"070",x"00C",x"01C",
+	x"00C",x"00C",x"01C",x"00C",x"070",x"038",x"0C0",x"0E0",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"3B7",x"333",x"0FC",x"1FE",
+	x"030",x"030",x"1FE",x"0FC",x"333",x"3B7",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"030",x"030",
+	x"3FF",x"3FF",x"030",x"030",x"030",x"030",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"070",x"030",
+	x"0C0",x"0E0",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"0FC",x"0FC",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"007",x"003",x"01C",x"00E",
+	x"070",x"038",x"1C0",x"0E0",x"300",x"380",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"078",x"030",x"1CE",x"0FC",x"303",x"387",
+	x"303",x"303",x"387",x"303",x"0FC",x"1CE",x"030",x"078",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"0F0",x"0F0",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"007",x"003",
+	x"07C",x"03E",x"1C0",x"0E0",x"300",x"380",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"007",x"003",x"00C",x"00E",
+	x"03E",x"03C",x"003",x"007",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"00C",x"00C",x"07C",x"03C",x"1CC",x"0EC",
+	x"30C",x"38C",x"3FF",x"3FF",x"00C",x"00C",x"00C",x"00C",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"300",x"300",x"3FE",x"3FC",
+	x"003",x"007",x"003",x"003",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"07C",x"03C",x"1C0",x"0E0",x"300",x"380",
+	x"3FE",x"3FC",x"303",x"307",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"007",x"003",x"01C",x"00E",
+	x"070",x"038",x"0C0",x"0E0",x"0C0",x"0C0",x"0C0",x"0C0",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"387",x"303",
+	x"1FE",x"1FE",x"303",x"387",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"383",x"303",
+	x"0FF",x"1FF",x"007",x"003",x"01C",x"00E",x"0F0",x"0F8",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"070",x"030",
+	x"0C0",x"0E0",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"01C",x"00C",x"070",x"038",x"1C0",x"0E0",
+	x"380",x"380",x"0E0",x"1C0",x"038",x"070",x"00C",x"01C",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"3FF",x"3FF",
+	x"000",x"000",x"3FF",x"3FF",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0E0",x"0C0",x"038",x"070",x"00E",x"01C",
+	x"007",x"007",x"01C",x"00E",x"070",x"038",x"0C0",x"0E0",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"307",x"387",x"01C",x"00E",
+	x"030",x"038",x"030",x"030",x"000",x"000",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"33F",x"33F",
+	x"333",x"333",x"33F",x"33F",x"380",x"300",x"0FC",x"1FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"078",x"030",x"1CE",x"0FC",x"303",x"387",
+	x"303",x"303",x"3FF",x"3FF",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FE",x"3FE",x"303",x"307",x"307",x"303",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"300",x"300",
+	x"300",x"300",x"300",x"300",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"307",x"303",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"300",x"300",x"300",x"300",
+	x"3FC",x"3FC",x"300",x"300",x"300",x"300",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"300",x"300",x"300",x"300",
+	x"3FC",x"3FC",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"300",x"300",
+	x"300",x"300",x"30F",x"30F",x"383",x"303",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"3FF",x"3FF",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0FC",x"0FC",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"003",x"003",x"003",x"003",x"003",x"003",
+	x"003",x"003",x"003",x"003",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"307",x"303",x"31C",x"30E",x"370",x"338",
+	x"3E0",x"3E0",x"338",x"370",x"30E",x"31C",x"303",x"307",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"300",x"300",x"300",x"300",x"300",x"300",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"3FF",x"3CF",x"333",x"37B",
+	x"333",x"333",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"3E3",x"3C3",
+	x"33B",x"373",x"30F",x"31F",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FC",x"3FE",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"303",x"303",
+	x"303",x"303",x"33F",x"333",x"39E",x"31E",x"0F3",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FC",x"3FE",x"338",x"330",x"30E",x"31C",x"303",x"307",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"380",x"300",
+	x"0FE",x"1FC",x"003",x"007",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"387",x"303",
+	x"0CC",x"1CE",x"0FC",x"0CC",x"030",x"078",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"333",x"333",x"333",x"333",x"3FF",x"333",x"0CC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"387",x"303",x"0FC",x"1CE",
+	x"078",x"078",x"1CE",x"0FC",x"303",x"387",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"387",x"303",x"0FC",x"1CE",
+	x"030",x"078",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"007",x"003",x"01C",x"00E",
+	x"070",x"038",x"1C0",x"0E0",x"300",x"380",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"070",x"030",x"0C0",x"0E0",
+	x"3FF",x"3FF",x"0E0",x"0C0",x"030",x"070",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"300",x"300",x"33E",x"33C",x"007",x"007",x"01C",x"00E",
+	x"030",x"038",x"03F",x"03F",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"038",x"030",x"00C",x"01C",
+	x"3FF",x"3FF",x"01C",x"00C",x"030",x"038",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"1FE",x"0FC",
+	x"333",x"3B7",x"030",x"030",x"030",x"030",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0CC",x"0CC",x"0CC",x"0CC",x"3FF",x"3FF",
+	x"0CC",x"0CC",x"3FF",x"3FF",x"0CC",x"0CC",x"0CC",x"0CC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"3FF",x"3FF",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"0FE",x"0FC",
+	x"003",x"007",x"1FF",x"0FF",x"383",x"383",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"3FE",x"3FC",
+	x"303",x"307",x"303",x"303",x"307",x"303",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FF",x"0FF",
+	x"300",x"380",x"300",x"300",x"380",x"300",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"003",x"003",x"003",x"003",x"1FF",x"0FF",
+	x"303",x"383",x"303",x"303",x"383",x"303",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FE",x"0FC",
+	x"303",x"387",x"3FF",x"3FF",x"380",x"300",x"0FC",x"1FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"01C",x"00C",x"030",x"038",x"030",x"030",
+	x"0FC",x"0FC",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FF",x"0FF",
+	x"303",x"383",x"303",x"303",x"383",x"303",x"0FF",x"1FF",
+	x"007",x"003",x"0FC",x"0FE",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"3FE",x"3FC",
+	x"303",x"307",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"000",x"000",x"0F0",x"0F0",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"000",x"000",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"070",x"030",x"0C0",x"0E0",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0C0",x"0C0",x"0C0",x"0C0",x"0C7",x"0C3",
+	x"0DC",x"0CE",x"0F8",x"0F8",x"0CE",x"0DC",x"0C3",x"0C7",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0F0",x"0F0",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"3FE",x"3CC",
+	x"333",x"37F",x"333",x"333",x"333",x"333",x"333",x"333",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"3FE",x"3FC",
+	x"303",x"307",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FE",x"0FC",
+	x"303",x"387",x"303",x"303",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"3FE",x"3FC",
+	x"303",x"307",x"303",x"303",x"307",x"303",x"3FC",x"3FE",
+	x"300",x"300",x"300",x"300",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FF",x"0FF",
+	x"303",x"383",x"303",x"303",x"383",x"303",x"0FF",x"1FF",
+	x"003",x"003",x"003",x"003",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"0DF",x"0CF",
+	x"0F0",x"0F8",x"0C0",x"0C0",x"0C0",x"0C0",x"0C0",x"0C0",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"1FF",x"0FF",
+	x"380",x"380",x"0FE",x"1FC",x"007",x"007",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"030",x"030",x"030",x"030",x"038",x"030",x"00C",x"01C",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"383",x"303",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"303",x"303",
+	x"387",x"303",x"0CC",x"1CE",x"0FC",x"0CC",x"030",x"078",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"303",x"303",
+	x"303",x"303",x"333",x"333",x"3FF",x"333",x"0CC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"387",x"303",
+	x"0FC",x"1CE",x"078",x"078",x"1CE",x"0FC",x"303",x"387",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"383",x"303",x"0FF",x"1FF",
+	x"007",x"003",x"0FC",x"0FE",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"3FF",x"3FF",
+	x"01C",x"00C",x"070",x"038",x"0C0",x"0E0",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0C0",x"0C0",x"0C0",x"0C0",x"0C0",x"0C0",
+	x"0C0",x"0C0",x"0C3",x"0C3",x"01F",x"00F",x"033",x"03B",
+	x"03F",x"03F",x"003",x"003",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",
+	x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",x"0CC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3E0",x"3C0",x"070",x"070",x"3E0",x"3E0",
+	x"070",x"070",x"3C3",x"3E3",x"01F",x"00F",x"033",x"03B",
+	x"03F",x"03F",x"003",x"003",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"000",x"000",
+	x"3FF",x"3FF",x"000",x"000",x"030",x"030",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",
+	x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"33F",x"33F",
+	x"333",x"333",x"33F",x"33F",x"380",x"300",x"0FC",x"1FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"078",x"030",x"1CE",x"0FC",x"303",x"387",
+	x"303",x"303",x"3FF",x"3FF",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FE",x"3FE",x"303",x"307",x"307",x"303",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"300",x"300",
+	x"300",x"300",x"300",x"300",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"307",x"303",x"3FC",x"3FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"300",x"300",x"300",x"300",
+	x"3FC",x"3FC",x"300",x"300",x"300",x"300",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"300",x"300",x"300",x"300",
+	x"3FC",x"3FC",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"300",x"300",
+	x"300",x"300",x"30F",x"30F",x"383",x"303",x"0FF",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"3FF",x"3FF",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0FC",x"0FC",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"0FC",x"0FC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"003",x"003",x"003",x"003",x"003",x"003",
+	x"003",x"003",x"003",x"003",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"307",x"303",x"31C",x"30E",x"370",x"338",
+	x"3E0",x"3E0",x"338",x"370",x"30E",x"31C",x"303",x"307",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"300",x"300",x"300",x"300",x"300",x"300",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"3FF",x"3CF",x"333",x"37B",
+	x"333",x"333",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"3E3",x"3C3",
+	x"33B",x"373",x"30F",x"31F",x"303",x"303",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FC",x"3FE",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"303",x"303",
+	x"303",x"303",x"33F",x"333",x"39E",x"31E",x"0F3",x"1FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FE",x"3FC",x"303",x"307",x"307",x"303",
+	x"3FC",x"3FE",x"338",x"330",x"30E",x"31C",x"303",x"307",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"1FE",x"0FC",x"303",x"387",x"380",x"300",
+	x"0FE",x"1FC",x"003",x"007",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"030",x"030",x"030",x"030",
+	x"030",x"030",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"303",x"303",x"303",x"303",x"387",x"303",x"0FC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"387",x"303",
+	x"0CC",x"1CE",x"0FC",x"0CC",x"030",x"078",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"303",x"303",x"303",x"303",
+	x"333",x"333",x"333",x"333",x"3FF",x"333",x"0CC",x"1FE",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"387",x"303",x"0FC",x"1CE",
+	x"078",x"078",x"1CE",x"0FC",x"303",x"387",x"303",x"303",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"303",x"303",x"387",x"303",x"0FC",x"1CE",
+	x"030",x"078",x"030",x"030",x"030",x"030",x"030",x"030",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"3FF",x"3FF",x"007",x"003",x"01C",x"00E",
+	x"070",x"038",x"1C0",x"0E0",x"300",x"380",x"3FF",x"3FF",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"070",x"030",x"0C0",x"0E0",
+	x"3FF",x"3FF",x"0E0",x"0C0",x"030",x"070",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"300",x"300",x"300",x"300",x"300",x"300",
+	x"300",x"300",x"33E",x"33C",x"007",x"007",x"01C",x"00E",
+	x"030",x"038",x"03F",x"03F",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"038",x"030",x"00C",x"01C",
+	x"3FF",x"3FF",x"01C",x"00C",x"030",x"038",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"030",x"030",x"1FE",x"0FC",
+	x"333",x"3B7",x"030",x"030",x"030",x"030",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"0CC",x"0CC",x"0CC",x"0CC",x"3FF",x"3FF",
+	x"0CC",x"0CC",x"3FF",x"3FF",x"0CC",x"0CC",x"0CC",x"0CC",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FC0",x"3C0",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"03F",x"00F",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FC0",x"3C0",x"FC0",x"3C0",x"FC0",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"03F",x"00F",x"03F",x"00F",x"03F",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"3CF",x"FFF",x"000",x"FFF",x"3CF",
+	x"FFF",x"3CF",x"FFF",x"000",x"000",x"000",x"000",x"000",
+	x"000",x"000",x"000",x"000",x"000",x"000",x"000",x"000"
+    );
+
+begin
+
+    process(clock) is
+    begin
+        if (rising_edge(clock)) then
+            Q <= mem(to_integer(unsigned(address)));
+        end if;
+    end process;
+end RTL;
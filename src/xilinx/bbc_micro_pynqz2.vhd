@@ -224,6 +224,13 @@ architecture rtl of bbc_micro_pynqz2 is
     signal avr_RxD         : std_logic;
     signal avr_TxD         : std_logic;
 
+    signal ps_bram_addr    : std_logic_vector(18 downto 0);
+    signal ps_bram_clk     : std_logic;
+    signal ps_bram_din     : std_logic_vector(31 downto 0);
+    signal ps_bram_dout    : std_logic_vector(31 downto 0);
+    signal ps_bram_en      : std_logic;
+    signal ps_bram_we      : std_logic_vector(3 downto 0);
+
     signal usb_kb_matrix   : std_logic_vector(127 downto 0);
     signal usb_kb_col      : std_logic_vector(7 downto 0);
     signal usb_kb_counter  : std_logic_vector(3 downto 0);
@@ -239,6 +246,26 @@ architecture rtl of bbc_micro_pynqz2 is
     signal keyb_pa7        : std_logic;
     signal fn_keys         : std_logic_vector(9 downto 0);
     signal fn_keys_last    : std_logic_vector(9 downto 0);
+    signal keyb_en_n_last  : std_logic;
+    signal keyb_scan_count : std_logic_vector(15 downto 0) := (others => '0');
+    signal keyb_scan_gray  : std_logic_vector(15 downto 0) := (others => '0');
+    signal keyb_status     : std_logic_vector(31 downto 0);
+
+    signal snap_ctrl       : std_logic_vector(31 downto 0);
+    signal snap_status     : std_logic_vector(1 downto 0);
+
+    signal video_vsync     : std_logic;
+    signal vsync_last      : std_logic;
+    signal frame_count     : std_logic_vector(7 downto 0) := (others => '0');
+    signal frame_gray      : std_logic_vector(7 downto 0) := (others => '0');
+
+    signal dirty_map       : std_logic_vector(2047 downto 0) := (others => '0');
+    signal ps_dirty_map    : std_logic_vector(2047 downto 0) := (others => '0');
+    signal ps_dirty_clear1 : std_logic;
+    signal ps_dirty_clear2 : std_logic;
+    signal dirty_ctrl1     : std_logic_vector(6 downto 0);
+    signal dirty_ctrl2     : std_logic_vector(6 downto 0);
+    signal dirty_word      : std_logic_vector(31 downto 0);
 
 begin
 
@@ -267,6 +294,8 @@ begin
         IncludeCoProExt    => IncludeCoProExt,
         IncludeVideoNuLA   => IncludeVideoNuLA,
         IncludeHDMI        => true,
+        IncludeJimRam      => true,
+        IncludeSnapshot    => true,
         UseOrigKeyboard    => UseOrigKeyboard,
         UseT65Core         => not IncludeMaster,  -- select the 6502 for the Beeb
         UseAlanDCore       => IncludeMaster,      -- select the 65C02 for the Master
@@ -287,7 +316,7 @@ begin
         video_red      => open,
         video_green    => open,
         video_blue     => open,
-        video_vsync    => open,
+        video_vsync    => video_vsync,
         video_hsync    => open,
         audio_l        => audio_l,
         audio_r        => audio_r,
@@ -329,6 +358,10 @@ begin
         ext_tube_do    => ext_tube_do,
         test           => open,
 
+        -- save states
+        snap_ctrl      => snap_ctrl(15 downto 0),
+        snap_status    => snap_status,
+
         -- original keyboard
         ext_keyb_led1  => ext_keyb_led1,
         ext_keyb_led2  => ext_keyb_led2,
@@ -379,9 +412,35 @@ begin
                 config <= (others => '0');
             end if;
             keyb_1mhz_last <= keyb_1mhz;
+            -- Count the end of each MOS keyboard scan (keyb_en_n rising), which
+            -- lets the PS autotype pace key presses to the 100Hz scan
+            if keyb_en_n = '1' and keyb_en_n_last = '0' then
+                keyb_scan_count <= keyb_scan_count + 1;
+            end if;
+            keyb_en_n_last <= keyb_en_n;
+            -- Gray coded, as the PS samples this in a different clock domain
+            keyb_scan_gray <= keyb_scan_count xor ('0' & keyb_scan_count(15 downto 1));
+            -- Count the start of each frame (video_vsync is inverted by vid_mode(3)),
+            -- which lets the PS take one rewind snapshot per frame
+            if (video_vsync xor vid_mode(3)) = '1' and vsync_last = '0' then
+                frame_count <= frame_count + 1;
+            end if;
+            vsync_last <= video_vsync xor vid_mode(3);
+            frame_gray <= frame_count xor ('0' & frame_count(7 downto 1));
         end if;
     end process;
 
+    -- Keyboard status, read by the PS through axi_gpio_2
+    --   bits 15..0 - scan count (gray coded)
+    --   bit  16    - keyb_en_n
+    --   bit  17    - caps lock led
+    --   bit  18    - shift lock led
+    --   bit  19    - snapshot: frozen
+    --   bit  20    - snapshot: injection done
+    --   bit  21    - m128_mode (a Master build)
+    --   bits 31..24 - frame count (gray coded)
+    keyb_status <= frame_gray & "00" & m128_mode & snap_status & shift_led & caps_led & keyb_en_n & keyb_scan_gray;
+
     usb_kb_col <= usb_kb_matrix(to_integer(unsigned(usb_kb_counter)) * 8 + 7 downto to_integer(unsigned(usb_kb_counter)) * 8);
     usb_kb_ca2 <= usb_kb_col(1) or usb_kb_col(2) or usb_kb_col(3) or usb_kb_col(4) or usb_kb_col(5) or usb_kb_col(6) or usb_kb_col(7);
     usb_kb_pa7 <= '0' when keyb_en_n = '1' else usb_kb_col(to_integer(unsigned(keyb_pa(6 downto 4))));
@@ -400,6 +459,13 @@ begin
 
     inst_PS : entity work.ProcessingSystemOnly_wrapper
      port map (
+      BRAM_PORTA_0_addr => ps_bram_addr,
+      BRAM_PORTA_0_clk => ps_bram_clk,
+      BRAM_PORTA_0_din => ps_bram_din,
+      BRAM_PORTA_0_dout => ps_bram_dout,
+      BRAM_PORTA_0_en => ps_bram_en,
+      BRAM_PORTA_0_rst => open,
+      BRAM_PORTA_0_we => ps_bram_we,
       DDR_addr(14 downto 0) => DDR_addr(14 downto 0),
       DDR_ba(2 downto 0) => DDR_ba(2 downto 0),
       DDR_cas_n => DDR_cas_n,
@@ -428,7 +494,10 @@ begin
       gpio_io_o_0 => usb_kb_matrix(31 downto  0),
       gpio_io_o_1 => usb_kb_matrix(63 downto 32),
       gpio_io_o_2 => usb_kb_matrix(95 downto 64),
-      gpio_io_o_3 => usb_kb_matrix(127 downto 96)
+      gpio_io_o_3 => usb_kb_matrix(127 downto 96),
+      gpio_io_i_0 => keyb_status,
+      gpio_io_o_4 => snap_ctrl,
+      gpio_io_i_1 => dirty_word
     );
 
 --------------------------------------------------------
@@ -609,20 +678,70 @@ begin
     RAM_CS <= not RAM_nCS;
     RAM_WE <= not RAM_nWE;
 
-    sram : entity work.generic_ram
+    -- Port B gives the Zynq PS access to the whole of the 512KB through an
+    -- AXI BRAM Controller at 0x40000000. This is used by the App's disk
+    -- server to exchange data with the 6502 (see JIM RAM in bbc_micro_core).
+    sram : entity work.generic_dpram
     generic map (
-        ADDR_BITS => 19,
-        DATA_BITS => 8
+        ADDR_BITS => 19
     )
     port map (
-        clk  => clock_48,
-        ena  => RAM_CS,
-        wea  => RAM_WE,
-        addr => RAM_A,
-        din  => RAM_Din,
-        dout => RAM_Dout
+        clka  => clock_48,
+        ena   => RAM_CS,
+        wea   => RAM_WE,
+        addra => RAM_A,
+        dina  => RAM_Din,
+        douta => RAM_Dout,
+        clkb  => ps_bram_clk,
+        enb   => ps_bram_en,
+        web   => ps_bram_we,
+        addrb => ps_bram_addr(18 downto 2),
+        dinb  => ps_bram_din,
+        doutb => ps_bram_dout
     );
 
+--------------------------------------------------------
+-- Dirty Page Map
+--------------------------------------------------------
+
+    -- One bit per 256 byte page of the 512KB, set by every write from the
+    -- core or from the PS (port B), so the App's rewind buffer only needs to
+    -- copy the pages that have changed since the last frame. Controlled from
+    -- the PS through the snapshot control register (axi_gpio_2 channel 2):
+    --   bit  2      - clear the whole map (only safe while the core is frozen)
+    --   bits 21..16 - index of the 32-bit word read through axi_gpio_3
+
+    process(clock_48)
+    begin
+        if rising_edge(clock_48) then
+            dirty_ctrl1 <= snap_ctrl(21 downto 16) & snap_ctrl(2);
+            dirty_ctrl2 <= dirty_ctrl1;
+            if dirty_ctrl2(0) = '1' then
+                dirty_map <= (others => '0');
+            elsif RAM_CS = '1' and RAM_WE = '1' then
+                dirty_map(to_integer(unsigned(RAM_A(18 downto 8)))) <= '1';
+            end if;
+            dirty_word <= dirty_map(to_integer(unsigned(dirty_ctrl2(6 downto 1))) * 32 + 31 downto to_integer(unsigned(dirty_ctrl2(6 downto 1))) * 32) or
+                          ps_dirty_map(to_integer(unsigned(dirty_ctrl2(6 downto 1))) * 32 + 31 downto to_integer(unsigned(dirty_ctrl2(6 downto 1))) * 32);
+        end if;
+    end process;
+
+    -- PS writes (e.g. the disk server loading a file straight into memory)
+    -- are tracked in the PS clock domain. The PS only reads the map while
+    -- it isn't writing itself, so the bits are stable when they're sampled.
+    process(ps_bram_clk)
+    begin
+        if rising_edge(ps_bram_clk) then
+            ps_dirty_clear1 <= snap_ctrl(2);
+            ps_dirty_clear2 <= ps_dirty_clear1;
+            if ps_dirty_clear2 = '1' then
+                ps_dirty_map <= (others => '0');
+            elsif ps_bram_en = '1' and ps_bram_we /= "0000" then
+                ps_dirty_map(to_integer(unsigned(ps_bram_addr(18 downto 8)))) <= '1';
+            end if;
+        end if;
+    end process;
+
 --------------------------------------------------------
 -- 24-bit Audio
 --------------------------------------------------------
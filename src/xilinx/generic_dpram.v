@@ -0,0 +1,64 @@
+// Dual port version of generic_ram
+//
+// Port A is the original 8-bit port, used by the BBC core
+//
+// Port B is a 32-bit port with byte write enables, used by the Zynq PS
+// (through an AXI BRAM Controller) for loading and inspecting memory.
+// The address is a word address, and bytes are little endian.
+//
+// The two ports can be in different clock domains.
+
+module generic_dpram #
+  (
+   parameter ADDR_BITS = 10,
+   parameter INIT_FILE = "pynqz2_rom.hex"
+   )
+
+   (
+    input                      clka,
+    input                      ena,
+    input                      wea,
+    input [ADDR_BITS-1:0]      addra,
+    input [7:0]                dina,
+    output reg [7:0]           douta,
+
+    input                      clkb,
+    input                      enb,
+    input [3:0]                web,
+    input [ADDR_BITS-3:0]      addrb,
+    input [31:0]               dinb,
+    output reg [31:0]          doutb
+    );
+
+   reg [7:0] ram[(2**ADDR_BITS)-1:0];
+
+   initial begin
+      if (INIT_FILE != "") begin
+         $readmemh(INIT_FILE, ram, 0, (2**ADDR_BITS)-1);
+      end
+   end
+
+   always @(posedge clka) begin
+      if (ena) begin
+         if (wea) begin
+            ram[addra] <= dina;
+         end
+         douta <= ram[addra];
+      end
+   end
+
+   // This follows the Vivado asymmetric RAM template (one loop iteration
+   // per byte lane) so it still infers block RAM
+   integer i;
+   always @(posedge clkb) begin
+      for (i = 0; i < 4; i = i + 1) begin
+         if (enb) begin
+            if (web[i]) begin
+               ram[{addrb, i[1:0]}] <= dinb[8*i +: 8];
+            end
+            doutb[8*i +: 8] <= ram[{addrb, i[1:0]}];
+         end
+      end
+   end
+
+endmodule
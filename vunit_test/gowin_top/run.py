@@ -33,6 +33,7 @@ lib.add_source_file("../../src/common/mouse/quadrature_fsm.vhd")
 lib.add_source_file("../../src/common/rtc.vhd")
 lib.add_source_file("../../src/common/saa5050.vhd")
 lib.add_source_file("../../src/common/saa5050_rom_dual_port.vhd")
+lib.add_source_file("../../src/common/saa5050_rom_rounded.vhd")
 lib.add_source_file("../../src/common/scandoubler/mist_scandoubler.vhd")
 lib.add_source_file("../../src/common/scandoubler/retimer.vhd")
 lib.add_source_file("../../src/common/scandoubler/rgb2vga_dpram.vhd")
@@ -0,0 +1,417 @@
+/*
+ * BeebFPGA Application
+ *
+ * Autotype / Paste Engine
+ *
+ * Each character is typed by pressing (and releasing) the corresponding key
+ * in the emulated keyboard matrix, with SHIFT or CTRL asserted first where
+ * needed. The timing follows the MOS rather than a fixed rate:
+ *
+ * - a character is only typed while the MOS keyboard buffer has room, and
+ *   after RETURN only once the buffer is empty (i.e. the line was read)
+ * - modifiers are held for one scan before the key is pressed
+ * - the key is held until the MOS has put it in the keyboard buffer
+ * - all keys are released for at least one scan before the next character
+ *
+ * The buffer pointers are read from the BBC's memory through the AXI BRAM
+ * Controller, and the keyboard scans are counted in the FPGA. So typing
+ * keeps up with long pastes and slow commands rather than dropping keys.
+ *
+ * Programs that read the keyboard directly never see the key in the
+ * buffer, and ones that stop reading it leave it full, so the hold and
+ * the wait for the buffer each have a (configurable) fallback timeout.
+ */
+
+#include <stdio.h>
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "memmap.h"
+#include "keyboard.h"
+#include "sdcard.h"
+#include "autotype.h"
+
+// Must be a power of two
+#define AT_QUEUE_SIZE      0x10000
+
+#define AT_SHIFT           0x80
+#define AT_CTRL            0x100
+#define AT_NONE            -1
+
+// Scancode from a BBC internal key number (as in the BBC Micro User Guide)
+#define K(n)               ((((n) & 0x0F) << 3) | ((n) >> 4))
+
+#define KEY_TAB            K(0x60)
+#define KEY_RETURN         K(0x49)
+#define KEY_DELETE         K(0x59)
+#define KEY_ESCAPE         K(0x70)
+
+// MOS buffer offsets (the same in MOS 1.20 and 3.20): the keyboard
+// buffer (buffer 0) holds up to 31 characters, at offsets &E0-&FF
+#define MOS_BUFFER_START   0x02D8
+#define MOS_BUFFER_END     0x02E1
+#define MOS_KEYB_MASK      0x1F
+
+// Characters that may be waiting in the keyboard buffer before typing more
+#define AT_BUFFER_LIMIT    16
+
+// Fallback timeouts (in ms), for when the keyboard buffer isn't being used
+#define AT_HOLD_MS         250
+#define AT_WAIT_MS         10000
+#define AT_MODIFIER_MS     20
+#define AT_RELEASE_MS      20
+#define AT_MIN_MS          10
+
+enum {
+	AT_IDLE,
+	AT_MODIFIER,
+	AT_PRESS,
+	AT_RELEASE,
+	AT_WAIT
+};
+
+// Map from ASCII (0x20..0x7F) to BBC Keyboard Matrix
+//
+// Letters are mapped to the unshifted key, and SHIFT is then added
+// depending on the state of CAPS LOCK.
+
+static const u8 ascii_map[] = {
+	K(0x62),            // 20 Space
+	K(0x30) | AT_SHIFT, // 21 !
+	K(0x31) | AT_SHIFT, // 22 "
+	K(0x11) | AT_SHIFT, // 23 #
+	K(0x12) | AT_SHIFT, // 24 $
+	K(0x13) | AT_SHIFT, // 25 %
+	K(0x34) | AT_SHIFT, // 26 &
+	K(0x24) | AT_SHIFT, // 27 '
+	K(0x15) | AT_SHIFT, // 28 (
+	K(0x26) | AT_SHIFT, // 29 )
+	K(0x48) | AT_SHIFT, // 2A *
+	K(0x57) | AT_SHIFT, // 2B +
+	K(0x66),            // 2C ,
+	K(0x17),            // 2D -
+	K(0x67),            // 2E .
+	K(0x68),            // 2F /
+	K(0x27),            // 30 0
+	K(0x30),            // 31 1
+	K(0x31),            // 32 2
+	K(0x11),            // 33 3
+	K(0x12),            // 34 4
+	K(0x13),            // 35 5
+	K(0x34),            // 36 6
+	K(0x24),            // 37 7
+	K(0x15),            // 38 8
+	K(0x26),            // 39 9
+	K(0x48),            // 3A :
+	K(0x57),            // 3B ;
+	K(0x66) | AT_SHIFT, // 3C <
+	K(0x17) | AT_SHIFT, // 3D =
+	K(0x67) | AT_SHIFT, // 3E >
+	K(0x68) | AT_SHIFT, // 3F ?
+	K(0x47),            // 40 @
+	K(0x41),            // 41 A
+	K(0x64),            // 42 B
+	K(0x52),            // 43 C
+	K(0x32),            // 44 D
+	K(0x22),            // 45 E
+	K(0x43),            // 46 F
+	K(0x53),            // 47 G
+	K(0x54),            // 48 H
+	K(0x25),            // 49 I
+	K(0x45),            // 4A J
+	K(0x46),            // 4B K
+	K(0x56),            // 4C L
+	K(0x65),            // 4D M
+	K(0x55),            // 4E N
+	K(0x36),            // 4F O
+	K(0x37),            // 50 P
+	K(0x10),            // 51 Q
+	K(0x33),            // 52 R
+	K(0x51),            // 53 S
+	K(0x23),            // 54 T
+	K(0x35),            // 55 U
+	K(0x63),            // 56 V
+	K(0x21),            // 57 W
+	K(0x42),            // 58 X
+	K(0x44),            // 59 Y
+	K(0x61),            // 5A Z
+	K(0x38),            // 5B [
+	K(0x78),            // 5C backslash
+	K(0x58),            // 5D ]
+	K(0x18),            // 5E ^
+	K(0x28),            // 5F _
+	K(0x28) | AT_SHIFT, // 60 ` (displayed as a pound sign)
+	K(0x41),            // 61 a
+	K(0x64),            // 62 b
+	K(0x52),            // 63 c
+	K(0x32),            // 64 d
+	K(0x22),            // 65 e
+	K(0x43),            // 66 f
+	K(0x53),            // 67 g
+	K(0x54),            // 68 h
+	K(0x25),            // 69 i
+	K(0x45),            // 6A j
+	K(0x46),            // 6B k
+	K(0x56),            // 6C l
+	K(0x65),            // 6D m
+	K(0x55),            // 6E n
+	K(0x36),            // 6F o
+	K(0x37),            // 70 p
+	K(0x10),            // 71 q
+	K(0x33),            // 72 r
+	K(0x51),            // 73 s
+	K(0x23),            // 74 t
+	K(0x35),            // 75 u
+	K(0x63),            // 76 v
+	K(0x21),            // 77 w
+	K(0x42),            // 78 x
+	K(0x44),            // 79 y
+	K(0x61),            // 7A z
+	K(0x38) | AT_SHIFT, // 7B {
+	K(0x78) | AT_SHIFT, // 7C |
+	K(0x58) | AT_SHIFT, // 7D }
+	K(0x18) | AT_SHIFT, // 7E ~
+	K(0x59)             // 7F Delete
+};
+
+static char at_queue[AT_QUEUE_SIZE];
+static u32 at_head;
+static u32 at_tail;
+
+static FIL at_fil;
+static int at_file_open;
+
+static int at_state;
+static int at_key;
+static int at_last_char;
+static u16 at_scan;
+static XTime at_time;
+static u8 at_buffer_end;
+
+static u32 at_hold_ms = AT_HOLD_MS;
+static u32 at_wait_ms = AT_WAIT_MS;
+
+static u32 at_typed;
+static u32 at_timeouts;
+
+static u32 elapsed_ms() {
+	XTime now;
+	XTime_GetTime(&now);
+	return (u32) ((now - at_time) / (COUNTS_PER_SECOND / 1000));
+}
+
+static u16 elapsed_scans() {
+	return (u16) (keyboard_scan_count() - at_scan);
+}
+
+static u8 buffer_end() {
+	return Xil_In8(BEEB_MAIN_RAM + MOS_BUFFER_END);
+}
+
+static int buffer_used() {
+	return (buffer_end() - Xil_In8(BEEB_MAIN_RAM + MOS_BUFFER_START)) & MOS_KEYB_MASK;
+}
+
+static void start_phase(int state) {
+	at_state = state;
+	at_scan = keyboard_scan_count();
+	XTime_GetTime(&at_time);
+}
+
+static void set_keys(int key, int press) {
+	u32 words[4] = {0, 0, 0, 0};
+	if (key & AT_SHIFT) {
+		words[0] |= 1 << BBC_KEY_SHIFT;
+	}
+	if (key & AT_CTRL) {
+		words[0] |= 1 << BBC_KEY_CTRL;
+	}
+	if (press) {
+		int scancode = key & 0x7F;
+		words[scancode >> 5] |= 1 << (scancode & 0x1F);
+	}
+	keyboard_set(KEYB_SRC_AUTOTYPE, words);
+}
+
+// Returns the key (scancode plus modifiers) needed to type c, or AT_NONE
+static int translate(int c) {
+	int key;
+	switch (c) {
+	case 0x0A:
+		// Treat CR, LF and CR LF all as a single RETURN
+		return at_last_char == 0x0D ? AT_NONE : KEY_RETURN;
+	case 0x0D:
+		return KEY_RETURN;
+	case 0x09:
+		return KEY_TAB;
+	case 0x08:
+		return KEY_DELETE;
+	case 0x1B:
+		return KEY_ESCAPE;
+	case 0xA3:
+		// Pound sign (ISO 8859-1)
+		return ascii_map[0x60 - 0x20];
+	}
+	if (c < 0x20) {
+		// Other control characters are typed as CTRL plus a key
+		return (ascii_map[c + 0x40 - 0x20] & ~AT_SHIFT) | AT_CTRL;
+	}
+	if (c > 0x7F) {
+		return AT_NONE;
+	}
+	key = ascii_map[c - 0x20];
+	if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+		int caps = (keyboard_status() & KEYB_STATUS_CAPS) != 0;
+		int lower = (c >= 'a');
+		if (lower == caps) {
+			key |= AT_SHIFT;
+		}
+	}
+	return key;
+}
+
+static u32 queue_free() {
+	return AT_QUEUE_SIZE - 1 - ((at_head - at_tail) & (AT_QUEUE_SIZE - 1));
+}
+
+static void refill_from_file() {
+	char buffer[512];
+	UINT br = 0;
+	if (!at_file_open || queue_free() < sizeof(buffer)) {
+		return;
+	}
+	if (f_read(&at_fil, buffer, sizeof(buffer), &br) != FR_OK || br < sizeof(buffer)) {
+		f_close(&at_fil);
+		at_file_open = 0;
+	}
+	autotype_text(buffer, br);
+}
+
+void autotype_init() {
+	at_head = 0;
+	at_tail = 0;
+	at_file_open = 0;
+	at_last_char = 0;
+	at_state = AT_IDLE;
+}
+
+// Queue text to be typed, returns the number of characters accepted
+int autotype_text(const char *text, int len) {
+	int i;
+	for (i = 0; i < len && queue_free() > 0; i++) {
+		at_queue[at_head] = text[i];
+		at_head = (at_head + 1) & (AT_QUEUE_SIZE - 1);
+	}
+	return i;
+}
+
+// Queue the contents of a file on the SD card, which is read as required
+int autotype_file(const char *path) {
+	FRESULT rc;
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	if (at_file_open) {
+		f_close(&at_fil);
+		at_file_open = 0;
+	}
+	rc = f_open(&at_fil, path, FA_READ);
+	if (rc != FR_OK) {
+		printf("Autotype: unable to open %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	at_file_open = 1;
+	refill_from_file();
+	return XST_SUCCESS;
+}
+
+void autotype_cancel() {
+	if (at_file_open) {
+		f_close(&at_fil);
+		at_file_open = 0;
+	}
+	at_tail = at_head;
+	set_keys(0, 0);
+	at_state = AT_IDLE;
+}
+
+int autotype_busy() {
+	return at_state != AT_IDLE || at_head != at_tail || at_file_open;
+}
+
+void autotype_set_hold(u32 ms) {
+	at_hold_ms = ms;
+}
+
+void autotype_set_wait(u32 ms) {
+	at_wait_ms = ms;
+}
+
+void autotype_print_status() {
+	printf("Autotype: %s, %lu queued%s\r\n",
+			autotype_busy() ? "busy" : "idle",
+			(at_head - at_tail) & (AT_QUEUE_SIZE - 1),
+			at_file_open ? " (plus file)" : "");
+	printf("  keyboard buffer %d used, fallback hold %lu ms, wait %lu ms\r\n", buffer_used(), at_hold_ms, at_wait_ms);
+	printf("  %lu typed, %lu timeouts\r\n", at_typed, at_timeouts);
+}
+
+// Called regularly from the main loop, never blocks
+void autotype_poll() {
+	int c;
+	switch (at_state) {
+	case AT_IDLE:
+		refill_from_file();
+		if (at_head == at_tail) {
+			return;
+		}
+		c = (u8) at_queue[at_tail];
+		at_tail = (at_tail + 1) & (AT_QUEUE_SIZE - 1);
+		at_key = translate(c);
+		at_last_char = c;
+		if (at_key == AT_NONE) {
+			return;
+		}
+		at_buffer_end = buffer_end();
+		if (at_key & (AT_SHIFT | AT_CTRL)) {
+			set_keys(at_key, 0);
+			start_phase(AT_MODIFIER);
+		} else {
+			set_keys(at_key, 1);
+			start_phase(AT_PRESS);
+		}
+		break;
+	case AT_MODIFIER:
+		if ((elapsed_scans() >= 1 && elapsed_ms() >= AT_MIN_MS) || elapsed_ms() >= AT_MODIFIER_MS) {
+			set_keys(at_key, 1);
+			start_phase(AT_PRESS);
+		}
+		break;
+	case AT_PRESS:
+		// Held until the MOS has buffered the key (ESCAPE never is)
+		if (buffer_end() != at_buffer_end || elapsed_ms() >= at_hold_ms) {
+			if (buffer_end() == at_buffer_end) {
+				at_timeouts++;
+			}
+			set_keys(0, 0);
+			start_phase(AT_RELEASE);
+			at_typed++;
+		}
+		break;
+	case AT_RELEASE:
+		if ((elapsed_scans() >= 1 && elapsed_ms() >= AT_MIN_MS) || elapsed_ms() >= AT_RELEASE_MS) {
+			start_phase(AT_WAIT);
+		}
+		break;
+	case AT_WAIT:
+		// Wait for room in the keyboard buffer, or after RETURN for the
+		// line to have been read
+		if (buffer_used() < (at_key == KEY_RETURN ? 1 : AT_BUFFER_LIMIT)) {
+			at_state = AT_IDLE;
+		} else if (elapsed_ms() >= at_wait_ms) {
+			at_timeouts++;
+			at_state = AT_IDLE;
+		}
+		break;
+	}
+}
@@ -0,0 +1,25 @@
+/*
+ * BeebFPGA Application
+ *
+ * Autotype / Paste Engine
+ *
+ * Text is queued from the console (UART) or from a file on the SD card, and
+ * typed into the BBC by driving the emulated keyboard matrix.
+ */
+
+#ifndef __AUTOTYPE_H_
+#define __AUTOTYPE_H_
+
+#include "xil_types.h"
+
+void autotype_init();
+void autotype_poll();
+int  autotype_text(const char *text, int len);
+int  autotype_file(const char *path);
+void autotype_cancel();
+int  autotype_busy();
+void autotype_set_hold(u32 ms);
+void autotype_set_wait(u32 ms);
+void autotype_print_status();
+
+#endif
@@ -0,0 +1,65 @@
+/*
+ * BeebFPGA Application
+ *
+ * Boot Timeline
+ */
+
+#include <stdio.h>
+#include "memmap.h"
+#include "boottime.h"
+
+#define BOOT_TIMELINE ((boot_timeline_type *) BOOT_TIMELINE_ADDR)
+
+// Indexed by the loader's TIMELINE_ stage numbers
+static const char *stage_names[] = {
+	"ps7_init",
+	"ddr check",
+	"pcap init",
+	"sd mount",
+	"sd open",
+	"headers",
+	"read",
+	"checksum",
+	"pcap",
+	"stream",
+	"handoff",
+	"cpu1 wait"
+};
+
+#define NUM_STAGES (sizeof(stage_names) / sizeof(stage_names[0]))
+
+static u32 ticks_to_us(u64 ticks, u32 counts_per_second) {
+	return (u32) (ticks * 1000000 / counts_per_second);
+}
+
+void boottime_print() {
+	boot_timeline_type *tl = BOOT_TIMELINE;
+	u32 count;
+	if (tl->magic != BOOT_TIMELINE_MAGIC || tl->counts_per_second == 0) {
+		printf("Boot timeline: not recorded by the loader\r\n");
+		return;
+	}
+	count = tl->count;
+	if (count > BOOT_TIMELINE_ENTRIES) {
+		count = BOOT_TIMELINE_ENTRIES;
+	}
+	printf("Boot timeline (us from the start of the loader):\r\n");
+	printf("  %-12s %9s %9s %9s\r\n", "stage", "start", "end", "duration");
+	for (u32 i = 0; i < count; i++) {
+		boot_stage_type *e = &tl->entry[i];
+		const char *name = e->stage < NUM_STAGES ? stage_names[e->stage] : "?";
+		char label[16];
+		if (e->stage >= BOOT_STAGE_PART_FIRST && e->stage <= BOOT_STAGE_PART_LAST) {
+			snprintf(label, sizeof(label), "%s %lu", name, e->arg);
+		} else {
+			snprintf(label, sizeof(label), "%s", name);
+		}
+		printf("  %-12s %9lu %9lu %9lu\r\n", label,
+				ticks_to_us(e->start, tl->counts_per_second),
+				ticks_to_us(e->end, tl->counts_per_second),
+				ticks_to_us(e->end - e->start, tl->counts_per_second));
+	}
+	if (count > 0) {
+		printf("  total %lu us\r\n", ticks_to_us(tl->entry[count - 1].end, tl->counts_per_second));
+	}
+}
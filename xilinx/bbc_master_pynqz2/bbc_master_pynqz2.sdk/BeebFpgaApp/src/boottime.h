@@ -0,0 +1,40 @@
+/*
+ * BeebFPGA Application
+ *
+ * Boot Timeline
+ *
+ * The loader records the start and end of each boot stage in global timer
+ * ticks, and leaves the table in DDR at handoff (see fsbl_timeline.h in
+ * BeebFpgaLoader, which this must match).
+ */
+
+#ifndef __BOOTTIME_H_
+#define __BOOTTIME_H_
+
+#include "xil_types.h"
+
+#define BOOT_TIMELINE_MAGIC   0x4C544F42
+#define BOOT_TIMELINE_ENTRIES 32
+
+// The per-partition stages, whose arg is the partition number
+#define BOOT_STAGE_PART_FIRST 6
+#define BOOT_STAGE_PART_LAST  9
+
+typedef struct {
+	u32 stage;
+	u32 arg;
+	u64 start;
+	u64 end;
+} boot_stage_type;
+
+typedef struct {
+	u32 magic;
+	u32 count;
+	u32 counts_per_second;
+	u32 reserved;
+	boot_stage_type entry[BOOT_TIMELINE_ENTRIES];
+} boot_timeline_type;
+
+void boottime_print();
+
+#endif
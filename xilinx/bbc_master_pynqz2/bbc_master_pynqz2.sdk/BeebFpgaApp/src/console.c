@@ -0,0 +1,375 @@
+/*
+ * BeebFPGA Application
+ *
+ * Command Console
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xil_printf.h"
+#include "xstatus.h"
+#include "autotype.h"
+#include "trace.h"
+#include "disk.h"
+#include "diskserv.h"
+#include "snapshot.h"
+#include "rewind.h"
+#include "boottime.h"
+#include "romset.h"
+#include "plconfig.h"
+#include "console.h"
+
+#define CONSOLE_LINE_SIZE 256
+#define CONSOLE_EOF       0x04
+
+enum {
+	CON_PASSTHROUGH,
+	CON_COMMAND,
+	CON_PASTE
+};
+
+typedef struct {
+	const char *name;
+	void (*handler)(char *args);
+	const char *args;
+	const char *help;
+} command_type;
+
+static void cmd_help(char *args);
+static void cmd_exit(char *args);
+static void cmd_type(char *args);
+static void cmd_paste(char *args);
+static void cmd_typefile(char *args);
+static void cmd_autotype(char *args);
+static void cmd_trace(char *args);
+static void cmd_disk(char *args);
+static void cmd_snapshot(char *args);
+static void cmd_rewind(char *args);
+static void cmd_boot(char *args);
+static void cmd_romset(char *args);
+static void cmd_pl(char *args);
+
+static const command_type commands[] = {
+	{"help",     cmd_help,     "",                      "list commands"},
+	{"exit",     cmd_exit,     "",                      "return to the ICE Debugger"},
+	{"type",     cmd_type,     "<text>",                "type text (\\n \\t \\e \\\\ \\xNN escapes)"},
+	{"paste",    cmd_paste,    "",                      "type everything received until Ctrl-D"},
+	{"typefile", cmd_typefile, "<path>",                "type the contents of a file on the SD card"},
+	{"autotype", cmd_autotype, "[cancel|hold|wait n]",  "autotype status and fallback timeouts (ms)"},
+	{"trace",    cmd_trace,    "[dump n|clear|mask m]", "event trace (on|off to enable/disable)"},
+	{"disk",     cmd_disk,     "[mount <path>|din d n]", "disk server status, mount an SSD/DSD/MMB image"},
+	{"snapshot", cmd_snapshot, "[save|restore|write|read]", "save state (write/read [path] on the SD card)"},
+	{"rewind",   cmd_rewind,   "[n]",                   "step back n frames (on|off to enable/disable)"},
+	{"boot",     cmd_boot,     "",                      "print the loader's boot timeline"},
+	{"romset",   cmd_romset,   "[list|<profile>]",      "load a ROM set profile from the SD card"},
+	{"pl",       cmd_pl,       "[list|<path>]",         "reconfigure the PL from a bitstream on the SD card"},
+};
+
+#define NUM_COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+static int mode;
+static char line[CONSOLE_LINE_SIZE];
+static int line_len;
+static u32 paste_count;
+static u32 paste_dropped;
+static u8 last_c;
+
+static void prompt() {
+	printf("beeb> ");
+	fflush(stdout);
+}
+
+// Split off the first word of args, returning the remainder
+static char *next_word(char *args, char **word) {
+	while (*args == ' ') {
+		args++;
+	}
+	*word = args;
+	while (*args && *args != ' ') {
+		args++;
+	}
+	if (*args) {
+		*args++ = 0;
+	}
+	while (*args == ' ') {
+		args++;
+	}
+	return args;
+}
+
+static void cmd_help(char *args) {
+	for (int i = 0; i < NUM_COMMANDS; i++) {
+		printf("%-10s%-24s%s\r\n", commands[i].name, commands[i].args, commands[i].help);
+	}
+	printf("Ctrl-] toggles between the console and the ICE Debugger\r\n");
+}
+
+static void cmd_exit(char *args) {
+	mode = CON_PASSTHROUGH;
+}
+
+static void cmd_type(char *args) {
+	char *src = args;
+	char *dst = args;
+	int len;
+	// Escapes are expanded in place, as the result is never longer
+	while (*src) {
+		if (*src == '\\' && src[1]) {
+			src++;
+			switch (*src) {
+			case 'n':
+			case 'r':
+				*dst++ = 0x0D;
+				break;
+			case 't':
+				*dst++ = 0x09;
+				break;
+			case 'e':
+				*dst++ = 0x1B;
+				break;
+			case 'x':
+				*dst++ = (char) strtoul(src + 1, &src, 16);
+				src--;
+				break;
+			default:
+				*dst++ = *src;
+				break;
+			}
+			src++;
+		} else {
+			*dst++ = *src++;
+		}
+	}
+	len = dst - args;
+	if (autotype_text(args, len) < len) {
+		printf("Autotype queue full\r\n");
+	}
+}
+
+static void cmd_paste(char *args) {
+	printf("Paste text now, Ctrl-D to finish\r\n");
+	paste_count = 0;
+	paste_dropped = 0;
+	mode = CON_PASTE;
+}
+
+static void cmd_typefile(char *args) {
+	char *path;
+	next_word(args, &path);
+	if (!*path) {
+		printf("Usage: typefile <path>\r\n");
+		return;
+	}
+	autotype_file(path);
+}
+
+static void cmd_autotype(char *args) {
+	char *word;
+	args = next_word(args, &word);
+	if (!strcmp(word, "cancel")) {
+		autotype_cancel();
+	} else if (!strcmp(word, "hold") && *args) {
+		autotype_set_hold(strtoul(args, NULL, 0));
+	} else if (!strcmp(word, "wait") && *args) {
+		autotype_set_wait(strtoul(args, NULL, 0));
+	} else if (*word) {
+		printf("Usage: autotype [cancel|hold <ms>|wait <ms>]\r\n");
+		return;
+	}
+	autotype_print_status();
+}
+
+static void cmd_trace(char *args) {
+	char *word;
+	args = next_word(args, &word);
+	if (!strcmp(word, "dump")) {
+		trace_dump(strtoul(args, NULL, 0));
+		return;
+	} else if (!strcmp(word, "clear")) {
+		trace_clear();
+	} else if (!strcmp(word, "mask") && *args) {
+		trace_set_mask(strtoul(args, NULL, 16));
+	} else if (!strcmp(word, "on")) {
+		trace_set_enable(1);
+	} else if (!strcmp(word, "off")) {
+		trace_set_enable(0);
+	} else if (*word) {
+		printf("Usage: trace [dump [n]|clear|mask <hex>|on|off]\r\n");
+		return;
+	}
+	trace_print_status();
+}
+
+static void cmd_disk(char *args) {
+	char *word;
+	args = next_word(args, &word);
+	if (!strcmp(word, "mount") && *args) {
+		next_word(args, &word);
+		disk_mount(word);
+	} else if (!strcmp(word, "din") && *args) {
+		char *drive;
+		args = next_word(args, &drive);
+		if (disk_din(strtoul(drive, NULL, 0), strtoul(args, NULL, 0)) != XST_SUCCESS) {
+			printf("Unable to insert disk\r\n");
+		}
+	} else if (*word) {
+		printf("Usage: disk [mount <path>|din <drive> <disk>]\r\n");
+		return;
+	}
+	diskserv_print_status();
+}
+
+static void cmd_snapshot(char *args) {
+	char *word;
+	char *path;
+	args = next_word(args, &word);
+	next_word(args, &path);
+	if (!*path) {
+		path = SNAPSHOT_DEFAULT_FILE;
+	}
+	if (!strcmp(word, "save")) {
+		snapshot_save();
+	} else if (!strcmp(word, "restore")) {
+		// The restore bypasses the dirty page map, so start a new history
+		if (snapshot_restore() == XST_SUCCESS && rewind_enabled()) {
+			rewind_enable(1);
+		}
+	} else if (!strcmp(word, "write")) {
+		if (snapshot_write(path) == XST_SUCCESS) {
+			printf("Written %s\r\n", path);
+		}
+	} else if (!strcmp(word, "read")) {
+		if (snapshot_read(path) == XST_SUCCESS) {
+			printf("Read %s\r\n", path);
+		}
+	} else if (*word) {
+		printf("Usage: snapshot [save|restore|write [<path>]|read [<path>]]\r\n");
+		return;
+	}
+	snapshot_print_status();
+}
+
+static void cmd_rewind(char *args) {
+	char *word;
+	next_word(args, &word);
+	if (!strcmp(word, "on")) {
+		rewind_enable(1);
+	} else if (!strcmp(word, "off")) {
+		rewind_enable(0);
+	} else if (*word >= '0' && *word <= '9') {
+		rewind_back(strtoul(word, NULL, 0));
+	} else if (*word) {
+		printf("Usage: rewind [<frames>|on|off]\r\n");
+		return;
+	}
+	rewind_print_status();
+}
+
+static void cmd_boot(char *args) {
+	boottime_print();
+}
+
+static void cmd_romset(char *args) {
+	char *word;
+	next_word(args, &word);
+	if (!strcmp(word, "list")) {
+		romset_list();
+		return;
+	} else if (*word) {
+		romset_load(word);
+	}
+	romset_print_status();
+}
+
+static void cmd_pl(char *args) {
+	char *word;
+	next_word(args, &word);
+	if (!strcmp(word, "list")) {
+		plconfig_list();
+		return;
+	} else if (*word) {
+		plconfig_program(word);
+	}
+	plconfig_print_status();
+}
+
+static void execute() {
+	char *name;
+	char *args;
+	line[line_len] = 0;
+	args = next_word(line, &name);
+	if (!*name) {
+		return;
+	}
+	for (int i = 0; i < NUM_COMMANDS; i++) {
+		if (!strcmp(name, commands[i].name)) {
+			(*commands[i].handler)(args);
+			return;
+		}
+	}
+	printf("Unknown command: %s (try help)\r\n", name);
+}
+
+void console_init() {
+	mode = CON_PASSTHROUGH;
+	line_len = 0;
+}
+
+// Returns 1 if the character was consumed by the console, or 0 if it
+// should be passed through to the ICE Debugger
+int console_input(u8 c) {
+	u8 prev_c = last_c;
+	last_c = c;
+	switch (mode) {
+	case CON_PASSTHROUGH:
+		if (c == CONSOLE_ESCAPE) {
+			printf("\r\nBeebFPGA Console (help for commands)\r\n");
+			mode = CON_COMMAND;
+			line_len = 0;
+			prompt();
+			return 1;
+		}
+		return 0;
+	case CON_COMMAND:
+		if (c == CONSOLE_ESCAPE) {
+			printf("\r\n");
+			mode = CON_PASSTHROUGH;
+		} else if (c == '\n' && prev_c == '\r') {
+			// Ignore the LF of CR LF
+		} else if (c == '\r' || c == '\n') {
+			printf("\r\n");
+			execute();
+			line_len = 0;
+			if (mode == CON_COMMAND) {
+				prompt();
+			}
+		} else if (c == 0x08 || c == 0x7F) {
+			if (line_len > 0) {
+				line_len--;
+				printf("\b \b");
+				fflush(stdout);
+			}
+		} else if (c >= 0x20 && line_len < CONSOLE_LINE_SIZE - 1) {
+			line[line_len++] = c;
+			outbyte(c);
+		}
+		return 1;
+	case CON_PASTE:
+		if (c == CONSOLE_EOF || c == CONSOLE_ESCAPE) {
+			printf("\r\n%lu characters queued", paste_count);
+			if (paste_dropped) {
+				printf(", %lu dropped (queue full)", paste_dropped);
+			}
+			printf("\r\n");
+			mode = CON_COMMAND;
+			prompt();
+		} else if (autotype_text((char *) &c, 1)) {
+			paste_count++;
+		} else {
+			paste_dropped++;
+		}
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * BeebFPGA Application
+ *
+ * Command Console
+ *
+ * UART0 is normally cross connected to the ICE Debugger (UART1). Typing the
+ * escape character (Ctrl-]) switches UART0 to a simple command line for
+ * controlling the App, and typing it again (or "exit") switches back.
+ */
+
+#ifndef __CONSOLE_H_
+#define __CONSOLE_H_
+
+#include "xil_types.h"
+
+#define CONSOLE_ESCAPE 0x1D
+
+void console_init();
+int  console_input(u8 c);
+
+#endif
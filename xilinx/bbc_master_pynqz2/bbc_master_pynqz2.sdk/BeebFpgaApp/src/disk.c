@@ -0,0 +1,302 @@
+/*
+ * BeebFPGA Application
+ *
+ * Disk Images (SSD, DSD and MMB)
+ *
+ * Drive mapping:
+ * - SSD: drive 0
+ * - DSD: drive 0 (side 0) and drive 2 (side 1), interleaved by track
+ * - MMB: drives 0-3, each holding one of the 511 disks in the image
+ *
+ * An MMB file starts with an 8KB header, containing the disks initially
+ * in drives 0-3 (low bytes at 0-3, high bytes at 4-7), followed by a 16
+ * byte entry per disk (12 character title, status in the last byte). The
+ * disks themselves are 200KB single sided images from offset 0x2000.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+#include "xstatus.h"
+#include "memmap.h"
+#include "sdcard.h"
+#include "disk.h"
+
+#define MMB_HEADER_SIZE    0x2000
+#define MMB_ENTRY_SIZE     16
+#define MMB_TITLE_SIZE     12
+
+#define MMB_READ_ONLY      0x00
+#define MMB_READ_WRITE     0x0F
+#define MMB_UNFORMATTED    0xF0
+#define MMB_INVALID        0xFF
+
+#define TRACK_SIZE         (DISK_TRACK_SECTORS * DISK_SECTOR_SIZE)
+
+#define DISK_CACHE(drive)  ((u8 *) (DISK_CACHE_ADDR + (drive) * DISK_SIDE_SIZE))
+
+static const char *type_names[] = {
+	"none",
+	"SSD",
+	"DSD",
+	"MMB"
+};
+
+static FIL img_fil;
+static int img_type = DISK_NONE;
+static int img_read_only;
+static char img_path[256];
+static u8 mmb_header[MMB_HEADER_SIZE];
+
+static int drv_loaded[DISK_NUM_DRIVES];
+static int drv_disk[DISK_NUM_DRIVES];
+
+// Offset in the image file of a sector (always within one track)
+static FSIZE_t sector_offset(int drive, int sector) {
+	switch (img_type) {
+	case DISK_DSD:
+		return ((sector / DISK_TRACK_SECTORS) * 2 + (drive >> 1)) * TRACK_SIZE +
+				(sector % DISK_TRACK_SECTORS) * DISK_SECTOR_SIZE;
+	case DISK_MMB:
+		return MMB_HEADER_SIZE + (FSIZE_t) drv_disk[drive] * DISK_SIDE_SIZE +
+				sector * DISK_SECTOR_SIZE;
+	default:
+		return sector * DISK_SECTOR_SIZE;
+	}
+}
+
+// Number of consecutive sectors from sector that are contiguous in the file
+static int contiguous_sectors(int sector, int count) {
+	if (img_type == DISK_DSD) {
+		int n = DISK_TRACK_SECTORS - sector % DISK_TRACK_SECTORS;
+		return n < count ? n : count;
+	}
+	return count;
+}
+
+static int valid_drive(int drive) {
+	switch (img_type) {
+	case DISK_SSD:
+		return drive == 0;
+	case DISK_DSD:
+		return drive == 0 || drive == 2;
+	case DISK_MMB:
+		return drive >= 0 && drive < DISK_NUM_DRIVES;
+	default:
+		return 0;
+	}
+}
+
+// Load a whole side into the cache. Anything past the end of the file
+// reads as zero.
+static int load_drive(int drive) {
+	u8 *cache = DISK_CACHE(drive);
+	int sector = 0;
+	drv_loaded[drive] = 0;
+	memset(cache, 0, DISK_SIDE_SIZE);
+	while (sector < DISK_SIDE_SECTORS) {
+		int n = contiguous_sectors(sector, DISK_SIDE_SECTORS - sector);
+		UINT br = 0;
+		if (f_lseek(&img_fil, sector_offset(drive, sector)) != FR_OK ||
+				f_read(&img_fil, cache + sector * DISK_SECTOR_SIZE, n * DISK_SECTOR_SIZE, &br) != FR_OK) {
+			printf("Disk: read error on drive %d\r\n", drive);
+			return XST_FAILURE;
+		}
+		if (br < n * DISK_SECTOR_SIZE) {
+			break;
+		}
+		sector += n;
+	}
+	drv_loaded[drive] = 1;
+	return XST_SUCCESS;
+}
+
+static int has_extension(const char *path, const char *ext) {
+	int len = strlen(path);
+	if (len < 4 || path[len - 4] != '.') {
+		return 0;
+	}
+	for (int i = 0; i < 3; i++) {
+		if (toupper((int) path[len - 3 + i]) != ext[i]) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int disk_mount(const char *path) {
+	FRESULT rc;
+	int type;
+	if (has_extension(path, "MMB")) {
+		type = DISK_MMB;
+	} else if (has_extension(path, "DSD")) {
+		type = DISK_DSD;
+	} else if (has_extension(path, "SSD")) {
+		type = DISK_SSD;
+	} else {
+		printf("Disk: %s is not an SSD, DSD or MMB image\r\n", path);
+		return XST_FAILURE;
+	}
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	disk_unmount();
+	img_read_only = 0;
+	rc = f_open(&img_fil, path, FA_READ | FA_WRITE);
+	if (rc == FR_DENIED || rc == FR_WRITE_PROTECTED) {
+		img_read_only = 1;
+		rc = f_open(&img_fil, path, FA_READ);
+	}
+	if (rc != FR_OK) {
+		printf("Disk: unable to open %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	img_type = type;
+	strncpy(img_path, path, sizeof(img_path) - 1);
+	if (type == DISK_MMB) {
+		UINT br = 0;
+		if (f_read(&img_fil, mmb_header, MMB_HEADER_SIZE, &br) != FR_OK || br < MMB_HEADER_SIZE) {
+			printf("Disk: %s has no MMB header\r\n", path);
+			disk_unmount();
+			return XST_FAILURE;
+		}
+		for (int drive = 0; drive < DISK_NUM_DRIVES; drive++) {
+			int n = mmb_header[drive] | (mmb_header[drive + 4] << 8);
+			if (n >= MMB_NUM_DISKS || disk_din(drive, n) != XST_SUCCESS) {
+				// Fall back to the default of disks 0-3
+				disk_din(drive, drive);
+			}
+		}
+	} else {
+		for (int drive = 0; drive < DISK_NUM_DRIVES; drive++) {
+			if (valid_drive(drive)) {
+				load_drive(drive);
+			}
+		}
+	}
+	return XST_SUCCESS;
+}
+
+void disk_unmount() {
+	if (img_type != DISK_NONE) {
+		f_close(&img_fil);
+	}
+	img_type = DISK_NONE;
+	for (int drive = 0; drive < DISK_NUM_DRIVES; drive++) {
+		drv_loaded[drive] = 0;
+		drv_disk[drive] = -1;
+	}
+}
+
+int disk_type() {
+	return img_type;
+}
+
+int disk_loaded(int drive) {
+	return valid_drive(drive) && drv_loaded[drive];
+}
+
+int disk_read_only(int drive) {
+	if (img_read_only) {
+		return 1;
+	}
+	return img_type == DISK_MMB && disk_mmb_status(drv_disk[drive]) == MMB_READ_ONLY;
+}
+
+u8 *disk_sector(int drive, int sector) {
+	return DISK_CACHE(drive) + sector * DISK_SECTOR_SIZE;
+}
+
+// Write count sectors from the cache back to the SD card
+int disk_flush(int drive, int sector, int count) {
+	if (!disk_loaded(drive) || disk_read_only(drive)) {
+		return XST_FAILURE;
+	}
+	while (count > 0) {
+		int n = contiguous_sectors(sector, count);
+		UINT bw = 0;
+		if (f_lseek(&img_fil, sector_offset(drive, sector)) != FR_OK ||
+				f_write(&img_fil, disk_sector(drive, sector), n * DISK_SECTOR_SIZE, &bw) != FR_OK ||
+				bw < n * DISK_SECTOR_SIZE) {
+			printf("Disk: write error on drive %d\r\n", drive);
+			return XST_FAILURE;
+		}
+		sector += n;
+		count -= n;
+	}
+	return f_sync(&img_fil) == FR_OK ? XST_SUCCESS : XST_FAILURE;
+}
+
+// Insert MMB disk n into a drive
+int disk_din(int drive, int n) {
+	int status;
+	if (img_type != DISK_MMB || !valid_drive(drive) || n < 0 || n >= MMB_NUM_DISKS) {
+		return XST_FAILURE;
+	}
+	status = disk_mmb_status(n);
+	if (status != MMB_READ_ONLY && status != MMB_READ_WRITE) {
+		return XST_FAILURE;
+	}
+	drv_disk[drive] = n;
+	return load_drive(drive);
+}
+
+int disk_number(int drive) {
+	return valid_drive(drive) ? drv_disk[drive] : -1;
+}
+
+int disk_mmb_status(int n) {
+	if (img_type != DISK_MMB || n < 0 || n >= MMB_NUM_DISKS) {
+		return MMB_INVALID;
+	}
+	return mmb_header[(n + 1) * MMB_ENTRY_SIZE + MMB_ENTRY_SIZE - 1];
+}
+
+// Copy the title of disk n (up to 12 characters, zero terminated)
+void disk_mmb_title(int n, char *title) {
+	int i;
+	title[0] = 0;
+	if (disk_mmb_status(n) == MMB_INVALID || disk_mmb_status(n) == MMB_UNFORMATTED) {
+		return;
+	}
+	for (i = 0; i < MMB_TITLE_SIZE; i++) {
+		char c = mmb_header[(n + 1) * MMB_ENTRY_SIZE + i] & 0x7F;
+		if (c == 0) {
+			break;
+		}
+		title[i] = c;
+	}
+	title[i] = 0;
+}
+
+// Find a disk by title (case insensitive), returning -1 if not found
+int disk_mmb_find(const char *title) {
+	char t[MMB_TITLE_SIZE + 1];
+	for (int n = 0; n < MMB_NUM_DISKS; n++) {
+		disk_mmb_title(n, t);
+		if (t[0] && !strcasecmp(t, title)) {
+			return n;
+		}
+	}
+	return -1;
+}
+
+void disk_print_status() {
+	if (img_type == DISK_NONE) {
+		printf("Disk: no image mounted\r\n");
+		return;
+	}
+	printf("Disk: %s (%s%s)\r\n", img_path, type_names[img_type], img_read_only ? ", read only" : "");
+	for (int drive = 0; drive < DISK_NUM_DRIVES; drive++) {
+		if (!valid_drive(drive)) {
+			continue;
+		}
+		printf("  drive %d: ", drive);
+		if (img_type == DISK_MMB) {
+			char title[MMB_TITLE_SIZE + 1];
+			disk_mmb_title(drv_disk[drive], title);
+			printf("disk %3d %-12s ", drv_disk[drive], title);
+		}
+		printf("%s\r\n", drv_loaded[drive] ? "" : "(not loaded)");
+	}
+}
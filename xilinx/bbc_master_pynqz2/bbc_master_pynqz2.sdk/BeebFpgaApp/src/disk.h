@@ -0,0 +1,47 @@
+/*
+ * BeebFPGA Application
+ *
+ * Disk Images (SSD, DSD and MMB)
+ *
+ * A single image file on the SD card is mounted at a time, and provides
+ * up to four DFS drives. Each drive is cached in DDR, and writes go
+ * straight through to the SD card.
+ */
+
+#ifndef __DISK_H_
+#define __DISK_H_
+
+#include "xil_types.h"
+
+#define DISK_NUM_DRIVES    4
+#define DISK_SECTOR_SIZE   256
+#define DISK_TRACK_SECTORS 10
+#define DISK_SIDE_SECTORS  800
+#define DISK_SIDE_SIZE     (DISK_SIDE_SECTORS * DISK_SECTOR_SIZE)
+
+#define MMB_NUM_DISKS      511
+
+#define DISK_DEFAULT_IMAGE "0:/BEEB.MMB"
+
+enum {
+	DISK_NONE,
+	DISK_SSD,
+	DISK_DSD,
+	DISK_MMB
+};
+
+int  disk_mount(const char *path);
+void disk_unmount();
+int  disk_type();
+int  disk_loaded(int drive);
+int  disk_read_only(int drive);
+u8  *disk_sector(int drive, int sector);
+int  disk_flush(int drive, int sector, int count);
+int  disk_din(int drive, int n);
+int  disk_number(int drive);
+int  disk_mmb_status(int n);
+void disk_mmb_title(int n, char *title);
+int  disk_mmb_find(const char *title);
+void disk_print_status();
+
+#endif
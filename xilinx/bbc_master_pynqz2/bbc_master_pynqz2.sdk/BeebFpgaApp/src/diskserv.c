@@ -0,0 +1,1792 @@
+/*
+ * BeebFPGA Application
+ *
+ * Disk Server
+ *
+ * The mailbox is JIM page 0 (see firmware/diskserv.asm for the layout).
+ * JIM pages 0x01-0x20 are used for data, and pages 0x21-0x2F for text
+ * to be printed. The whole of the BBC's memory is visible through the AXI
+ * BRAM Controller, so control blocks and filenames are read directly from
+ * main memory, and most loads and saves are done directly too. Only
+ * transfers to sideways RAM or the Tube go through the data pages, in 8KB
+ * chunks.
+ *
+ * A request can take several round trips (text, then data, then the
+ * final reply), so the reply is built up first and then sent in pieces.
+ *
+ * Printing can re-enter the filing system (e.g. a *SPOOL BPUT from the
+ * ROM's OSASCI), so a request that arrives while text is being printed is
+ * nested: the reply in progress is saved, the nested request's text is
+ * added after it, and the reply is restored (with its text pages) once the
+ * nested request is complete. An error abandons every reply in progress,
+ * as the BRK never returns to the print loops.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include "xil_io.h"
+#include "xstatus.h"
+#include "memmap.h"
+#include "disk.h"
+#include "diskserv.h"
+
+// Mailbox
+#define MB_STATUS          0x00
+#define MB_OP              0x01
+#define MB_A               0x02
+#define MB_X               0x03
+#define MB_Y               0x04
+#define MB_FLAGS           0x05
+#define MB_ADDR            0x06
+#define MB_LEN             0x0A
+#define MB_TEXT            0x40
+
+#define MB_TEXT_SIZE       0xC0
+
+#define DATA_OFFSET        0x0100
+#define DATA_SIZE          0x2000
+#define TEXT_OFFSET        0x2100
+#define TEXT_SIZE          0x0F00
+
+#define STATUS_REQUEST     0x01
+
+#define FLAG_CARRY         0x01
+#define FLAG_TUBE          0x80
+
+enum {
+	OP_CONTINUE,
+	OP_FILE,
+	OP_ARGS,
+	OP_BGET,
+	OP_BPUT,
+	OP_GBPB,
+	OP_FIND,
+	OP_FSC,
+	OP_BOOT
+};
+
+enum {
+	ACT_DONE,
+	ACT_ERROR,
+	ACT_PRINT,
+	ACT_READ,
+	ACT_WRITE,
+	ACT_EXEC
+};
+
+#define FS_NUMBER          0x15
+
+#define NUM_CHANNELS       5
+#define FIRST_HANDLE       0x11
+
+#define CAT_MAX_FILES      31
+#define CAT_NAME_LEN       7
+
+// Space reserved for a file opened with OPENOUT
+#define OPENOUT_SIZE       0x4000
+
+#define OUTPUT_SIZE        0x4000
+
+// Replies that can be saved while nested requests are served
+#define MAX_NESTED         4
+
+// DFS error numbers
+#define ERR_OUTSIDE        0xB7
+#define ERR_CAT_FULL       0xBE
+#define ERR_CANT_EXTEND    0xBF
+#define ERR_TOO_MANY_OPEN  0xC0
+#define ERR_READ_ONLY      0xC1
+#define ERR_OPEN           0xC2
+#define ERR_LOCKED         0xC3
+#define ERR_EXISTS         0xC4
+#define ERR_DISC_FULL      0xC6
+#define ERR_DISC_FAULT     0xC7
+#define ERR_DISC_RO        0xC9
+#define ERR_BAD_NAME       0xCC
+#define ERR_BAD_DRIVE      0xCD
+#define ERR_BAD_DIR        0xCE
+#define ERR_NOT_FOUND      0xD6
+#define ERR_CHANNEL        0xDE
+#define ERR_WILD           0xFD
+#define ERR_BAD_COMMAND    0xFE
+
+typedef struct {
+	int drive;
+	char dir;
+	int explicit_dir;
+	char name[CAT_NAME_LEN + 1];
+} fname_type;
+
+typedef struct {
+	int open;
+	int drive;
+	char dir;
+	char name[CAT_NAME_LEN + 1];
+	int writeable;
+	int start;
+	int sectors;
+	u32 ptr;
+	u32 ext;
+	int changed;
+	int dirty;
+} channel_type;
+
+typedef struct {
+	const char *name;
+	void (*handler)(const char *args);
+} ds_command_type;
+
+// A reply in progress (see save_reply)
+typedef struct {
+	int req_tube;
+	u8 action;
+	u8 a;
+	u8 x;
+	u8 y;
+	u8 flags;
+	u32 addr;
+	u32 output_len;
+	u32 output_pos;
+	u32 output_sent;
+	u8 *xfer_buf;
+	u32 xfer_addr;
+	u32 xfer_len;
+	int xfer_write;
+	u32 xfer_chunk;
+	int flush_drive;
+	int flush_sector;
+	int flush_count;
+} reply_type;
+
+static void cmd_access(const char *args);
+static void cmd_dcat(const char *args);
+static void cmd_delete(const char *args);
+static void cmd_din(const char *args);
+static void cmd_dir(const char *args);
+static void cmd_drive(const char *args);
+static void cmd_info(const char *args);
+static void cmd_lib(const char *args);
+static void cmd_rename(const char *args);
+static void cmd_title(const char *args);
+
+// In the order used for matching abbreviations
+static const ds_command_type ds_commands[] = {
+	{"ACCESS", cmd_access},
+	{"DCAT",   cmd_dcat},
+	{"DELETE", cmd_delete},
+	{"DIN",    cmd_din},
+	{"DIR",    cmd_dir},
+	{"DRIVE",  cmd_drive},
+	{"INFO",   cmd_info},
+	{"LIB",    cmd_lib},
+	{"RENAME", cmd_rename},
+	{"TITLE",  cmd_title},
+};
+
+#define NUM_DS_COMMANDS (sizeof(ds_commands) / sizeof(ds_commands[0]))
+
+static const char *option_names[] = {
+	"off",
+	"LOAD",
+	"RUN",
+	"EXEC"
+};
+
+// Filing system state
+static int cur_drive;
+static char cur_dir;
+static int lib_drive;
+static char lib_dir;
+static u32 run_tail;
+static channel_type channels[NUM_CHANNELS];
+static int auto_mounted;
+
+// The request being served
+static int req_tube;
+
+// The reply being built
+static u8 reply_action;
+static u8 reply_a;
+static u8 reply_x;
+static u8 reply_y;
+static u8 reply_flags;
+static u32 reply_addr;
+static u8 error_num;
+static char error_msg[MB_TEXT_SIZE];
+
+static char output[OUTPUT_SIZE];
+static u32 output_len;
+static u32 output_pos;
+static u32 output_sent;
+
+static u8 *xfer_buf;
+static u32 xfer_addr;
+static u32 xfer_len;
+static int xfer_write;
+static u32 xfer_chunk;
+
+static int flush_drive;
+static int flush_sector;
+static int flush_count;
+
+// The last action sent, and the replies saved for nested requests
+static u8 last_action;
+static int nested_printed;
+static reply_type nested[MAX_NESTED];
+static int num_nested;
+
+static u8 gbpb_buf[256];
+
+static u32 requests;
+static u32 direct_bytes;
+static u32 chunked_bytes;
+
+// ============================================================
+// BBC memory access
+// ============================================================
+
+static u8 jim_rd(u32 offset) {
+	return Xil_In8(BEEB_JIM_RAM + offset);
+}
+
+static void jim_wr(u32 offset, u8 data) {
+	Xil_Out8(BEEB_JIM_RAM + offset, data);
+}
+
+// Main memory (&0000-&7FFF)
+static u8 mem_rd(u32 addr) {
+	return Xil_In8(BEEB_MAIN_RAM + (addr & 0x7FFF));
+}
+
+static void mem_wr(u32 addr, u8 data) {
+	Xil_Out8(BEEB_MAIN_RAM + (addr & 0x7FFF), data);
+}
+
+static u32 mem_rd32(u32 addr) {
+	return mem_rd(addr) | (mem_rd(addr + 1) << 8) | (mem_rd(addr + 2) << 16) | (mem_rd(addr + 3) << 24);
+}
+
+static void mem_wr32(u32 addr, u32 data) {
+	for (int i = 0; i < 4; i++) {
+		mem_wr(addr + i, data >> (i * 8));
+	}
+}
+
+// Read a CR terminated string from main memory
+static void mem_str(u32 addr, char *buf, int size) {
+	int i;
+	for (i = 0; i < size - 1; i++) {
+		char c = mem_rd(addr + i);
+		if (c == 0x0D || c == 0) {
+			break;
+		}
+		buf[i] = c;
+	}
+	buf[i] = 0;
+}
+
+// ============================================================
+// Reply
+// ============================================================
+
+static void fs_error(u8 num, const char *msg) {
+	reply_action = ACT_ERROR;
+	error_num = num;
+	strncpy(error_msg, msg, sizeof(error_msg) - 1);
+	error_msg[sizeof(error_msg) - 1] = 0;
+}
+
+// Text for the ROM to print (CR starts a new line)
+static void fs_printf(const char *fmt, ...) {
+	va_list args;
+	int n;
+	va_start(args, fmt);
+	n = vsnprintf(output + output_len, OUTPUT_SIZE - output_len, fmt, args);
+	va_end(args);
+	if (n > 0) {
+		output_len += n;
+		if (output_len > OUTPUT_SIZE - 1) {
+			output_len = OUTPUT_SIZE - 1;
+		}
+	}
+}
+
+// Transfer between buf and BBC memory at addr (to memory unless write).
+// Addresses &FFxxxxxx (or any address, if there's no Tube) are in the I/O
+// processor, and main memory there is accessed directly.
+static void transfer(u8 *buf, u32 addr, u32 len, int write) {
+	if (((addr >> 24) == 0xFF || !req_tube) && (addr & 0xFFFF) + len <= 0x8000) {
+		for (u32 i = 0; i < len; i++) {
+			if (write) {
+				buf[i] = mem_rd(addr + i);
+			} else {
+				mem_wr(addr + i, buf[i]);
+			}
+		}
+		direct_bytes += len;
+		return;
+	}
+	xfer_buf = buf;
+	xfer_addr = addr;
+	xfer_len = len;
+	xfer_write = write;
+	xfer_chunk = 0;
+	chunked_bytes += len;
+}
+
+// Sectors to write back once the transfer has completed
+static void flush_later(int drive, int sector, int count) {
+	flush_drive = drive;
+	flush_sector = sector;
+	flush_count = count;
+}
+
+// Save the reply being printed, before serving a nested request
+static void save_reply() {
+	reply_type *r = &nested[num_nested++];
+	r->req_tube = req_tube;
+	r->action = reply_action;
+	r->a = reply_a;
+	r->x = reply_x;
+	r->y = reply_y;
+	r->flags = reply_flags;
+	r->addr = reply_addr;
+	r->output_len = output_len;
+	r->output_pos = output_pos;
+	r->output_sent = output_sent;
+	r->xfer_buf = xfer_buf;
+	r->xfer_addr = xfer_addr;
+	r->xfer_len = xfer_len;
+	r->xfer_write = xfer_write;
+	r->xfer_chunk = xfer_chunk;
+	r->flush_drive = flush_drive;
+	r->flush_sector = flush_sector;
+	r->flush_count = flush_count;
+	nested_printed = 0;
+}
+
+// Restore the saved reply once the nested request is complete, along with
+// the text the ROM is part way through printing if it has been overwritten
+static void restore_reply() {
+	reply_type *r = &nested[--num_nested];
+	req_tube = r->req_tube;
+	reply_action = r->action;
+	reply_a = r->a;
+	reply_x = r->x;
+	reply_y = r->y;
+	reply_flags = r->flags;
+	reply_addr = r->addr;
+	output_len = r->output_len;
+	output_pos = r->output_pos;
+	output_sent = r->output_sent;
+	xfer_buf = r->xfer_buf;
+	xfer_addr = r->xfer_addr;
+	xfer_len = r->xfer_len;
+	xfer_write = r->xfer_write;
+	xfer_chunk = r->xfer_chunk;
+	flush_drive = r->flush_drive;
+	flush_sector = r->flush_sector;
+	flush_count = r->flush_count;
+	if (nested_printed) {
+		for (u32 i = output_sent; i < output_pos; i++) {
+			jim_wr(TEXT_OFFSET + i - output_sent, output[i]);
+		}
+	}
+	// Any text pages written from here on are the outer reply's
+	nested_printed = num_nested > 0;
+	last_action = ACT_PRINT;
+}
+
+static void send_reply() {
+	if (reply_action != ACT_ERROR && output_pos < output_len) {
+		u32 n = output_len - output_pos;
+		if (n > TEXT_SIZE) {
+			n = TEXT_SIZE;
+		}
+		for (u32 i = 0; i < n; i++) {
+			jim_wr(TEXT_OFFSET + i, output[output_pos + i]);
+		}
+		output_sent = output_pos;
+		output_pos += n;
+		nested_printed = 1;
+		last_action = ACT_PRINT;
+		jim_wr(MB_OP, ACT_PRINT);
+		jim_wr(MB_LEN, n & 0xFF);
+		jim_wr(MB_LEN + 1, n >> 8);
+	} else if (reply_action != ACT_ERROR && xfer_len > 0) {
+		u32 n = xfer_len < DATA_SIZE ? xfer_len : DATA_SIZE;
+		if (xfer_write) {
+			xfer_chunk = n;
+		} else {
+			for (u32 i = 0; i < n; i++) {
+				jim_wr(DATA_OFFSET + i, xfer_buf[i]);
+			}
+			xfer_buf += n;
+		}
+		for (int i = 0; i < 4; i++) {
+			jim_wr(MB_ADDR + i, xfer_addr >> (i * 8));
+		}
+		last_action = xfer_write ? ACT_WRITE : ACT_READ;
+		jim_wr(MB_OP, last_action);
+		jim_wr(MB_LEN, n & 0xFF);
+		jim_wr(MB_LEN + 1, n >> 8);
+		xfer_addr += n;
+		xfer_len -= n;
+	} else {
+		if (reply_action != ACT_ERROR && flush_count > 0) {
+			if (disk_flush(flush_drive, flush_sector, flush_count) != XST_SUCCESS) {
+				fs_error(ERR_DISC_FAULT, "Disc fault");
+			}
+			flush_count = 0;
+		}
+		if (reply_action == ACT_ERROR) {
+			int i;
+			jim_wr(MB_A, error_num);
+			for (i = 0; error_msg[i]; i++) {
+				jim_wr(MB_TEXT + i, error_msg[i]);
+			}
+			jim_wr(MB_TEXT + i, 0);
+		} else {
+			jim_wr(MB_A, reply_a);
+			jim_wr(MB_X, reply_x);
+			jim_wr(MB_Y, reply_y);
+			jim_wr(MB_FLAGS, reply_flags);
+			for (int i = 0; i < 4; i++) {
+				jim_wr(MB_ADDR + i, reply_addr >> (i * 8));
+			}
+		}
+		jim_wr(MB_OP, reply_action);
+		last_action = reply_action;
+		if (reply_action == ACT_ERROR) {
+			num_nested = 0;
+		} else if (num_nested > 0) {
+			restore_reply();
+		}
+	}
+	// The status byte is always written last, as this releases the 6502
+	jim_wr(MB_STATUS, 0);
+}
+
+// ============================================================
+// Catalogue
+// ============================================================
+
+static u8 *cat0(int drive) {
+	return disk_sector(drive, 0);
+}
+
+static u8 *cat1(int drive) {
+	return disk_sector(drive, 1);
+}
+
+static int cat_count(int drive) {
+	return cat1(drive)[5] >> 3;
+}
+
+static int cat_disk_sectors(int drive) {
+	return ((cat1(drive)[6] & 0x03) << 8) | cat1(drive)[7];
+}
+
+static int cat_option(int drive) {
+	return (cat1(drive)[6] >> 4) & 0x03;
+}
+
+static void cat_title(int drive, char *title) {
+	int i;
+	for (i = 0; i < 12; i++) {
+		char c = (i < 8 ? cat0(drive)[i] : cat1(drive)[i - 8]) & 0x7F;
+		if (c == 0) {
+			break;
+		}
+		title[i] = c;
+	}
+	title[i] = 0;
+}
+
+static char ent_dir(int drive, int i) {
+	return cat0(drive)[8 + i * 8 + 7] & 0x7F;
+}
+
+static int ent_locked(int drive, int i) {
+	return (cat0(drive)[8 + i * 8 + 7] & 0x80) != 0;
+}
+
+static void ent_name(int drive, int i, char *name) {
+	int n;
+	for (n = 0; n < CAT_NAME_LEN; n++) {
+		name[n] = cat0(drive)[8 + i * 8 + n] & 0x7F;
+	}
+	while (n > 0 && (name[n - 1] == ' ' || name[n - 1] == 0)) {
+		n--;
+	}
+	name[n] = 0;
+}
+
+// 18-bit addresses with both top bits set are in the I/O processor
+static u32 expand_addr(u32 addr) {
+	return (addr & 0x30000) == 0x30000 ? (addr | 0xFFFF0000) : addr;
+}
+
+static u32 ent_load(int drive, int i) {
+	u8 *e = cat1(drive) + 8 + i * 8;
+	return expand_addr(e[0] | (e[1] << 8) | (((e[6] >> 2) & 0x03) << 16));
+}
+
+static u32 ent_exec(int drive, int i) {
+	u8 *e = cat1(drive) + 8 + i * 8;
+	return expand_addr(e[2] | (e[3] << 8) | (((e[6] >> 6) & 0x03) << 16));
+}
+
+static u32 ent_length(int drive, int i) {
+	u8 *e = cat1(drive) + 8 + i * 8;
+	return e[4] | (e[5] << 8) | (((e[6] >> 4) & 0x03) << 16);
+}
+
+static int ent_start(int drive, int i) {
+	u8 *e = cat1(drive) + 8 + i * 8;
+	return e[7] | ((e[6] & 0x03) << 8);
+}
+
+static int ent_sectors(int drive, int i) {
+	return (ent_length(drive, i) + 0xFF) >> 8;
+}
+
+static void ent_set(int drive, int i, u32 load, u32 exec, u32 length, int start) {
+	u8 *e = cat1(drive) + 8 + i * 8;
+	e[0] = load;
+	e[1] = load >> 8;
+	e[2] = exec;
+	e[3] = exec >> 8;
+	e[4] = length;
+	e[5] = length >> 8;
+	e[6] = (((exec >> 16) & 0x03) << 6) | (((length >> 16) & 0x03) << 4) |
+			(((load >> 16) & 0x03) << 2) | ((start >> 8) & 0x03);
+	e[7] = start;
+}
+
+static void ent_set_name(int drive, int i, char dir, const char *name, int locked) {
+	u8 *e = cat0(drive) + 8 + i * 8;
+	int n;
+	for (n = 0; n < CAT_NAME_LEN && name[n]; n++) {
+		e[n] = name[n];
+	}
+	for (; n < CAT_NAME_LEN; n++) {
+		e[n] = ' ';
+	}
+	e[7] = dir | (locked ? 0x80 : 0);
+}
+
+// Wildcards: # matches any character, * matches any sequence
+static int wild_match(const char *pat, const char *s) {
+	if (*pat == '*') {
+		for (;;) {
+			if (wild_match(pat + 1, s)) {
+				return 1;
+			}
+			if (!*s) {
+				return 0;
+			}
+			s++;
+		}
+	}
+	if (!*pat) {
+		return !*s;
+	}
+	if (!*s) {
+		return 0;
+	}
+	if (*pat != '#' && toupper((int) *pat) != toupper((int) *s)) {
+		return 0;
+	}
+	return wild_match(pat + 1, s + 1);
+}
+
+// Find the first entry from index i matching fn, or -1
+static int cat_find(const fname_type *fn, int i) {
+	char name[CAT_NAME_LEN + 1];
+	char dir[2] = {0, 0};
+	char pat[2] = {fn->dir, 0};
+	for (; i < cat_count(fn->drive); i++) {
+		dir[0] = ent_dir(fn->drive, i);
+		ent_name(fn->drive, i, name);
+		if (wild_match(pat, dir) && wild_match(fn->name, name)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Increment the cycle number (BCD) and write the catalogue to the SD card
+static int cat_write(int drive) {
+	u8 c = cat1(drive)[4];
+	c = ((c & 0x0F) == 9) ? (c & 0xF0) + 0x10 : c + 1;
+	cat1(drive)[4] = c >= 0xA0 ? 0 : c;
+	if (disk_flush(drive, 0, 2) != XST_SUCCESS) {
+		fs_error(ERR_DISC_FAULT, "Disc fault");
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+static void cat_delete(int drive, int i) {
+	int n = cat_count(drive);
+	memmove(cat0(drive) + 8 + i * 8, cat0(drive) + 16 + i * 8, (n - 1 - i) * 8);
+	memmove(cat1(drive) + 8 + i * 8, cat1(drive) + 16 + i * 8, (n - 1 - i) * 8);
+	cat1(drive)[5] = (n - 1) << 3;
+}
+
+// First free sector with room for a file of the given size, or -1
+static int cat_alloc(int drive, int sectors) {
+	int start = 2;
+	for (int i = cat_count(drive) - 1; i >= 0; i--) {
+		if (ent_start(drive, i) - start >= sectors) {
+			return start;
+		}
+		start = ent_start(drive, i) + ent_sectors(drive, i);
+	}
+	return cat_disk_sectors(drive) - start >= sectors ? start : -1;
+}
+
+// Add an entry (keeping the sort order), returning its index
+static int cat_insert(int drive, int start) {
+	int n = cat_count(drive);
+	int i = 0;
+	while (i < n && ent_start(drive, i) > start) {
+		i++;
+	}
+	memmove(cat0(drive) + 16 + i * 8, cat0(drive) + 8 + i * 8, (n - i) * 8);
+	memmove(cat1(drive) + 16 + i * 8, cat1(drive) + 8 + i * 8, (n - i) * 8);
+	cat1(drive)[5] = (n + 1) << 3;
+	return i;
+}
+
+// ============================================================
+// Names and drives
+// ============================================================
+
+static int check_drive(int drive) {
+	if (!disk_loaded(drive)) {
+		fs_error(ERR_BAD_DRIVE, "Bad drive");
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+static int check_writeable(int drive) {
+	if (disk_read_only(drive)) {
+		fs_error(ERR_DISC_RO, "Disc read only");
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+static const char *skip_spaces(const char *p) {
+	while (*p == ' ') {
+		p++;
+	}
+	return p;
+}
+
+// Parse [:drive.][dir.]name, returning the rest of the string or NULL
+static const char *parse_name(const char *p, fname_type *fn, int wild) {
+	int n = 0;
+	int quoted;
+	p = skip_spaces(p);
+	quoted = (*p == '"');
+	if (quoted) {
+		p++;
+	}
+	fn->drive = cur_drive;
+	fn->dir = cur_dir;
+	fn->explicit_dir = 0;
+	if (p[0] == ':' && p[1]) {
+		if (p[1] < '0' || p[1] > '3') {
+			fs_error(ERR_BAD_DRIVE, "Bad drive");
+			return NULL;
+		}
+		fn->drive = p[1] - '0';
+		fn->explicit_dir = 1;
+		p += 2;
+		if (*p == '.') {
+			p++;
+		}
+	}
+	if (p[0] > ' ' && p[1] == '.') {
+		fn->dir = p[0];
+		fn->explicit_dir = 1;
+		p += 2;
+	}
+	while (*p > ' ' && *p != '"' && n < CAT_NAME_LEN + 1) {
+		fn->name[n++] = *p++;
+	}
+	if (quoted && *p == '"') {
+		p++;
+	}
+	if (n == 0 || n > CAT_NAME_LEN || *p > ' ') {
+		fs_error(ERR_BAD_NAME, "Bad name");
+		return NULL;
+	}
+	fn->name[n] = 0;
+	if (!wild && (strchr(fn->name, '#') || strchr(fn->name, '*') || fn->dir == '#' || fn->dir == '*')) {
+		fs_error(ERR_WILD, "Wild cards");
+		return NULL;
+	}
+	if (check_drive(fn->drive) != XST_SUCCESS) {
+		return NULL;
+	}
+	return skip_spaces(p);
+}
+
+// Parse [:]drive[.dir] or dir, for *DRIVE, *DIR and *LIB
+static int parse_dir(const char *p, int *drive, char *dir) {
+	p = skip_spaces(p);
+	if (*p == ':') {
+		p++;
+	}
+	if (*p >= '0' && *p <= '3' && (p[1] <= ' ' || p[1] == '.')) {
+		*drive = *p++ - '0';
+		if (*p == '.') {
+			p++;
+		}
+	}
+	if (*p > ' ') {
+		if (p[1] > ' ' || *p == '#' || *p == '*' || *p == ':') {
+			fs_error(ERR_BAD_DIR, "Bad dir");
+			return XST_FAILURE;
+		}
+		*dir = *p;
+	}
+	return XST_SUCCESS;
+}
+
+// ============================================================
+// Channels
+// ============================================================
+
+static channel_type *get_channel(int handle) {
+	if (handle >= FIRST_HANDLE && handle < FIRST_HANDLE + NUM_CHANNELS && channels[handle - FIRST_HANDLE].open) {
+		return &channels[handle - FIRST_HANDLE];
+	}
+	fs_error(ERR_CHANNEL, "Channel");
+	return NULL;
+}
+
+static channel_type *find_channel(int drive, char dir, const char *name) {
+	for (int i = 0; i < NUM_CHANNELS; i++) {
+		channel_type *ch = &channels[i];
+		if (ch->open && ch->drive == drive && toupper((int) ch->dir) == toupper((int) dir) &&
+				!strcasecmp(ch->name, name)) {
+			return ch;
+		}
+	}
+	return NULL;
+}
+
+// Check an entry can be replaced (or deleted)
+static int check_unlocked(int drive, int i) {
+	char name[CAT_NAME_LEN + 1];
+	ent_name(drive, i, name);
+	if (ent_locked(drive, i)) {
+		fs_error(ERR_LOCKED, "Locked");
+		return XST_FAILURE;
+	}
+	if (find_channel(drive, ent_dir(drive, i), name)) {
+		fs_error(ERR_OPEN, "Open");
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+static u8 *channel_data(channel_type *ch, u32 offset) {
+	return disk_sector(ch->drive, ch->start) + offset;
+}
+
+static int flush_channel(channel_type *ch) {
+	if (ch->dirty >= 0) {
+		int sector = ch->start + ch->dirty;
+		ch->dirty = -1;
+		if (disk_flush(ch->drive, sector, 1) != XST_SUCCESS) {
+			fs_error(ERR_DISC_FAULT, "Disc fault");
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+static void close_channel(channel_type *ch) {
+	fname_type fn;
+	int i;
+	flush_channel(ch);
+	ch->open = 0;
+	if (!ch->writeable || !disk_loaded(ch->drive)) {
+		return;
+	}
+	// Trim the reserved space back to the actual length
+	fn.drive = ch->drive;
+	fn.dir = ch->dir;
+	strcpy(fn.name, ch->name);
+	i = cat_find(&fn, 0);
+	if (i >= 0 && (ch->changed || ent_length(ch->drive, i) != ch->ext)) {
+		ent_set(ch->drive, i, ent_load(ch->drive, i), ent_exec(ch->drive, i), ch->ext, ch->start);
+		cat_write(ch->drive);
+	}
+}
+
+static void close_all(int drive) {
+	for (int i = 0; i < NUM_CHANNELS; i++) {
+		if (channels[i].open && (drive < 0 || channels[i].drive == drive)) {
+			close_channel(&channels[i]);
+		}
+	}
+}
+
+// Make sure the space allocated to a file covers size bytes, if there is
+// room after it on the disc
+static int extend_channel(channel_type *ch, u32 size) {
+	fname_type fn;
+	int i;
+	int limit;
+	int sectors = (size + 0xFF) >> 8;
+	if (sectors <= ch->sectors) {
+		return XST_SUCCESS;
+	}
+	fn.drive = ch->drive;
+	fn.dir = ch->dir;
+	strcpy(fn.name, ch->name);
+	i = cat_find(&fn, 0);
+	limit = (i > 0) ? ent_start(ch->drive, i - 1) : cat_disk_sectors(ch->drive);
+	if (i < 0 || ch->start + sectors > limit) {
+		fs_error(ERR_CANT_EXTEND, "Can't extend");
+		return XST_FAILURE;
+	}
+	ch->sectors = sectors;
+	ent_set(ch->drive, i, ent_load(ch->drive, i), ent_exec(ch->drive, i), sectors << 8, ch->start);
+	return cat_write(ch->drive);
+}
+
+// Move the pointer, extending the file (with zeros) if necessary
+static int set_ptr(channel_type *ch, u32 ptr) {
+	if (ptr > ch->ext) {
+		if (!ch->writeable) {
+			fs_error(ERR_OUTSIDE, "Outside file");
+			return XST_FAILURE;
+		}
+		if (extend_channel(ch, ptr) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		memset(channel_data(ch, ch->ext), 0, ptr - ch->ext);
+		if (disk_flush(ch->drive, ch->start + (ch->ext >> 8), ((ptr + 0xFF) >> 8) - (ch->ext >> 8)) != XST_SUCCESS) {
+			fs_error(ERR_DISC_FAULT, "Disc fault");
+			return XST_FAILURE;
+		}
+		ch->ext = ptr;
+		ch->changed = 1;
+	}
+	ch->ptr = ptr;
+	return XST_SUCCESS;
+}
+
+// ============================================================
+// Files
+// ============================================================
+
+// Create a file (replacing any existing one), returning its index or -1
+static int create_file(const fname_type *fn, u32 load, u32 exec, u32 length, u32 reserve) {
+	int i;
+	int start;
+	if (check_writeable(fn->drive) != XST_SUCCESS) {
+		return -1;
+	}
+	i = cat_find(fn, 0);
+	if (i >= 0) {
+		if (check_unlocked(fn->drive, i) != XST_SUCCESS) {
+			return -1;
+		}
+		cat_delete(fn->drive, i);
+	}
+	if (cat_count(fn->drive) >= CAT_MAX_FILES) {
+		fs_error(ERR_CAT_FULL, "Catalogue full");
+		return -1;
+	}
+	if (reserve < length) {
+		reserve = length;
+	}
+	start = cat_alloc(fn->drive, (reserve + 0xFF) >> 8);
+	if (start < 0) {
+		fs_error(ERR_DISC_FULL, "Disc full");
+		return -1;
+	}
+	i = cat_insert(fn->drive, start);
+	ent_set_name(fn->drive, i, fn->dir, fn->name, 0);
+	ent_set(fn->drive, i, load, exec, reserve, start);
+	if (cat_write(fn->drive) != XST_SUCCESS) {
+		return -1;
+	}
+	return i;
+}
+
+// Fill in an OSFILE control block from a catalogue entry
+static void write_file_info(u32 blk, int drive, int i) {
+	mem_wr32(blk + 2, ent_load(drive, i));
+	mem_wr32(blk + 6, ent_exec(drive, i));
+	mem_wr32(blk + 10, ent_length(drive, i));
+	mem_wr32(blk + 14, ent_locked(drive, i) ? 0x08 : 0x00);
+}
+
+static void load_file(int drive, int i, u32 addr) {
+	if (ent_start(drive, i) * DISK_SECTOR_SIZE + ent_length(drive, i) > DISK_SIDE_SIZE) {
+		fs_error(ERR_DISC_FAULT, "Disc fault");
+		return;
+	}
+	transfer(disk_sector(drive, ent_start(drive, i)), addr, ent_length(drive, i), 0);
+}
+
+// *RUN (and unrecognised commands), with the tail address for OSARGS
+static void run_file(u32 addr, int is_command) {
+	char str[256];
+	fname_type fn;
+	const char *tail;
+	int i;
+	mem_str(addr, str, sizeof(str));
+	tail = parse_name(str, &fn, 0);
+	if (!tail) {
+		if (is_command) {
+			fs_error(ERR_BAD_COMMAND, "Bad command");
+		}
+		return;
+	}
+	i = cat_find(&fn, 0);
+	if (i < 0 && !fn.explicit_dir) {
+		// Try the library
+		fn.drive = lib_drive;
+		fn.dir = lib_dir;
+		if (disk_loaded(fn.drive)) {
+			i = cat_find(&fn, 0);
+		}
+	}
+	if (i < 0) {
+		if (is_command) {
+			fs_error(ERR_BAD_COMMAND, "Bad command");
+		} else {
+			fs_error(ERR_NOT_FOUND, "Not found");
+		}
+		return;
+	}
+	run_tail = addr + (tail - str);
+	load_file(fn.drive, i, ent_load(fn.drive, i));
+	reply_action = ACT_EXEC;
+	reply_addr = ent_exec(fn.drive, i);
+}
+
+static void print_info(int drive, int i) {
+	char name[CAT_NAME_LEN + 1];
+	ent_name(drive, i, name);
+	fs_printf("%c.%-7s %c  %06lX %06lX %06lX %03X\r", ent_dir(drive, i), name,
+			ent_locked(drive, i) ? 'L' : ' ', ent_load(drive, i) & 0xFFFFFF,
+			ent_exec(drive, i) & 0xFFFFFF, ent_length(drive, i), ent_start(drive, i));
+}
+
+// Sort order for *CAT: the current directory first, then by name
+static int cat_before(int drive, int a, int b) {
+	char na[CAT_NAME_LEN + 1];
+	char nb[CAT_NAME_LEN + 1];
+	char da = ent_dir(drive, a);
+	char db = ent_dir(drive, b);
+	if ((da == cur_dir) != (db == cur_dir)) {
+		return da == cur_dir;
+	}
+	if (da != db) {
+		return da < db;
+	}
+	ent_name(drive, a, na);
+	ent_name(drive, b, nb);
+	return strcasecmp(na, nb) < 0;
+}
+
+static void print_cat(int drive) {
+	char title[13];
+	char name[CAT_NAME_LEN + 1];
+	int order[CAT_MAX_FILES];
+	int n = cat_count(drive);
+	int col = 0;
+	for (int i = 0; i < n; i++) {
+		int j = i;
+		while (j > 0 && cat_before(drive, i, order[j - 1])) {
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = i;
+	}
+	cat_title(drive, title);
+	fs_printf("%-12s (%02X)", title, cat1(drive)[4]);
+	if (disk_number(drive) >= 0) {
+		fs_printf("  Disk %d", disk_number(drive));
+	}
+	fs_printf("\rDrive %d             Option %d (%s)\r", drive, cat_option(drive), option_names[cat_option(drive)]);
+	fs_printf("Directory :%d.%c      Library :%d.%c\r\r", cur_drive, cur_dir, lib_drive, lib_dir);
+	for (int k = 0; k < n; k++) {
+		int i = order[k];
+		char dir = ent_dir(drive, i);
+		ent_name(drive, i, name);
+		if (dir == cur_dir) {
+			fs_printf("    %-7s %c    ", name, ent_locked(drive, i) ? 'L' : ' ');
+		} else {
+			fs_printf("  %c.%-7s %c    ", dir, name, ent_locked(drive, i) ? 'L' : ' ');
+		}
+		if (++col == 2) {
+			fs_printf("\r");
+			col = 0;
+		}
+	}
+	if (col) {
+		fs_printf("\r");
+	}
+}
+
+// ============================================================
+// Commands
+// ============================================================
+
+static void cmd_access(const char *args) {
+	fname_type fn;
+	int locked;
+	int found = 0;
+	args = parse_name(args, &fn, 1);
+	if (!args || check_writeable(fn.drive) != XST_SUCCESS) {
+		return;
+	}
+	locked = (toupper((int) *args) == 'L');
+	for (int i = cat_find(&fn, 0); i >= 0; i = cat_find(&fn, i + 1)) {
+		cat0(fn.drive)[8 + i * 8 + 7] = ent_dir(fn.drive, i) | (locked ? 0x80 : 0);
+		found = 1;
+	}
+	if (!found) {
+		fs_error(ERR_NOT_FOUND, "Not found");
+		return;
+	}
+	cat_write(fn.drive);
+}
+
+static void cmd_dcat(const char *args) {
+	char title[13];
+	int col = 0;
+	int count = 0;
+	if (disk_type() != DISK_MMB) {
+		fs_error(ERR_BAD_DRIVE, "Not an MMB");
+		return;
+	}
+	for (int n = 0; n < MMB_NUM_DISKS; n++) {
+		disk_mmb_title(n, title);
+		if (!title[0]) {
+			continue;
+		}
+		fs_printf(" %4d %-12s %c", n, title, disk_mmb_status(n) ? ' ' : 'P');
+		count++;
+		if (++col == 2) {
+			fs_printf("\r");
+			col = 0;
+		}
+	}
+	if (col) {
+		fs_printf("\r");
+	}
+	fs_printf("%d disks found\r", count);
+}
+
+static void cmd_delete(const char *args) {
+	fname_type fn;
+	int i;
+	if (!parse_name(args, &fn, 0) || check_writeable(fn.drive) != XST_SUCCESS) {
+		return;
+	}
+	i = cat_find(&fn, 0);
+	if (i < 0) {
+		fs_error(ERR_NOT_FOUND, "Not found");
+		return;
+	}
+	if (check_unlocked(fn.drive, i) != XST_SUCCESS) {
+		return;
+	}
+	cat_delete(fn.drive, i);
+	cat_write(fn.drive);
+}
+
+// *DIN [drive] <disk number or title>
+static void cmd_din(const char *args) {
+	char word1[16];
+	char word2[16];
+	int drive = 0;
+	int n;
+	const char *disk;
+	if (sscanf(args, "%15s %15s", word1, word2) == 2) {
+		drive = word1[0] - '0';
+		if (drive < 0 || drive >= DISK_NUM_DRIVES || word1[1]) {
+			fs_error(ERR_BAD_DRIVE, "Bad drive");
+			return;
+		}
+		disk = word2;
+	} else if (sscanf(args, "%15s", word1) == 1) {
+		disk = word1;
+	} else {
+		fs_error(ERR_BAD_COMMAND, "Syntax: DIN [drv] <disk>");
+		return;
+	}
+	n = isdigit((int) disk[0]) ? atoi(disk) : disk_mmb_find(disk);
+	close_all(drive);
+	if (disk_din(drive, n) != XST_SUCCESS) {
+		fs_error(ERR_NOT_FOUND, "Disk not found");
+	}
+}
+
+static void cmd_dir(const char *args) {
+	parse_dir(args, &cur_drive, &cur_dir);
+}
+
+static void cmd_drive(const char *args) {
+	int drive = cur_drive;
+	char dir = cur_dir;
+	if (parse_dir(args, &drive, &dir) == XST_SUCCESS && check_drive(drive) == XST_SUCCESS) {
+		cur_drive = drive;
+	}
+}
+
+static void cmd_info(const char *args) {
+	fname_type fn;
+	int found = 0;
+	if (!parse_name(args, &fn, 1)) {
+		return;
+	}
+	for (int i = cat_find(&fn, 0); i >= 0; i = cat_find(&fn, i + 1)) {
+		print_info(fn.drive, i);
+		found = 1;
+	}
+	if (!found) {
+		fs_error(ERR_NOT_FOUND, "Not found");
+	}
+}
+
+static void cmd_lib(const char *args) {
+	parse_dir(args, &lib_drive, &lib_dir);
+}
+
+static void cmd_rename(const char *args) {
+	fname_type from;
+	fname_type to;
+	int i;
+	args = parse_name(args, &from, 0);
+	if (!args || !parse_name(args, &to, 0) || check_writeable(from.drive) != XST_SUCCESS) {
+		return;
+	}
+	if (to.drive != from.drive) {
+		fs_error(ERR_BAD_DRIVE, "Bad drive");
+		return;
+	}
+	i = cat_find(&from, 0);
+	if (i < 0) {
+		fs_error(ERR_NOT_FOUND, "Not found");
+		return;
+	}
+	if (check_unlocked(from.drive, i) != XST_SUCCESS) {
+		return;
+	}
+	if (cat_find(&to, 0) >= 0) {
+		fs_error(ERR_EXISTS, "Exists");
+		return;
+	}
+	ent_set_name(from.drive, i, to.dir, to.name, 0);
+	cat_write(from.drive);
+}
+
+static void cmd_title(const char *args) {
+	int quoted;
+	if (check_drive(cur_drive) != XST_SUCCESS || check_writeable(cur_drive) != XST_SUCCESS) {
+		return;
+	}
+	args = skip_spaces(args);
+	quoted = (*args == '"');
+	if (quoted) {
+		args++;
+	}
+	for (int i = 0; i < 12; i++) {
+		char c = *args;
+		if (c == 0 || (quoted ? c == '"' : c == ' ')) {
+			c = 0;
+		} else {
+			args++;
+		}
+		if (i < 8) {
+			cat0(cur_drive)[i] = c;
+		} else {
+			cat1(cur_drive)[i - 8] = c;
+		}
+	}
+	cat_write(cur_drive);
+}
+
+// Returns 1 if the command was recognised
+static int ds_command(u32 addr) {
+	char str[256];
+	char *p = str;
+	mem_str(addr, str, sizeof(str));
+	for (int i = 0; i < NUM_DS_COMMANDS; i++) {
+		const char *name = ds_commands[i].name;
+		int n = 0;
+		while (name[n] && toupper((int) p[n]) == name[n]) {
+			n++;
+		}
+		if (p[n] == '.' && n > 0) {
+			// Abbreviated
+			n++;
+		} else if (name[n] || isalpha((int) p[n])) {
+			continue;
+		}
+		(*ds_commands[i].handler)(p + n);
+		return 1;
+	}
+	return 0;
+}
+
+// ============================================================
+// Filing system calls
+// ============================================================
+
+static void fs_osfile(u8 a, u32 blk) {
+	char str[256];
+	fname_type fn;
+	int i;
+	mem_str(mem_rd(blk) | (mem_rd(blk + 1) << 8), str, sizeof(str));
+	if (!parse_name(str, &fn, 0)) {
+		return;
+	}
+	i = cat_find(&fn, 0);
+	switch (a) {
+	case 0x00:
+	case 0x07: {
+		// Save, or create
+		u32 start = mem_rd32(blk + 10);
+		u32 length = mem_rd32(blk + 14) - start;
+		i = create_file(&fn, mem_rd32(blk + 2), mem_rd32(blk + 6), length, 0);
+		if (i < 0) {
+			return;
+		}
+		if (a == 0x00) {
+			transfer(disk_sector(fn.drive, ent_start(fn.drive, i)), start, length, 1);
+			flush_later(fn.drive, ent_start(fn.drive, i), ent_sectors(fn.drive, i));
+		}
+		write_file_info(blk, fn.drive, i);
+		reply_a = 1;
+		break;
+	}
+	case 0x01:
+	case 0x02:
+	case 0x03:
+	case 0x04:
+		// Write catalogue information
+		if (i < 0) {
+			reply_a = 0;
+			return;
+		}
+		if (check_writeable(fn.drive) != XST_SUCCESS) {
+			return;
+		}
+		if (a == 0x01 || a == 0x02 || a == 0x03) {
+			u32 load = (a == 0x03) ? ent_load(fn.drive, i) : mem_rd32(blk + 2);
+			u32 exec = (a == 0x02) ? ent_exec(fn.drive, i) : mem_rd32(blk + 6);
+			ent_set(fn.drive, i, load, exec, ent_length(fn.drive, i), ent_start(fn.drive, i));
+		}
+		if (a == 0x01 || a == 0x04) {
+			char name[CAT_NAME_LEN + 1];
+			ent_name(fn.drive, i, name);
+			ent_set_name(fn.drive, i, ent_dir(fn.drive, i), name, mem_rd(blk + 14) & 0x0A);
+		}
+		cat_write(fn.drive);
+		reply_a = 1;
+		break;
+	case 0x05:
+		// Read catalogue information
+		if (i >= 0) {
+			write_file_info(blk, fn.drive, i);
+		}
+		reply_a = (i >= 0) ? 1 : 0;
+		break;
+	case 0x06:
+		// Delete
+		if (i < 0) {
+			reply_a = 0;
+			return;
+		}
+		if (check_writeable(fn.drive) != XST_SUCCESS || check_unlocked(fn.drive, i) != XST_SUCCESS) {
+			return;
+		}
+		write_file_info(blk, fn.drive, i);
+		cat_delete(fn.drive, i);
+		cat_write(fn.drive);
+		reply_a = 1;
+		break;
+	case 0xFF:
+		// Load
+		if (i < 0) {
+			fs_error(ERR_NOT_FOUND, "Not found");
+			return;
+		}
+		load_file(fn.drive, i, mem_rd(blk + 6) == 0 ? mem_rd32(blk + 2) : ent_load(fn.drive, i));
+		write_file_info(blk, fn.drive, i);
+		reply_a = 1;
+		break;
+	}
+}
+
+static void fs_osfind(u8 a, u8 x, u8 y) {
+	char str[256];
+	fname_type fn;
+	channel_type *ch = NULL;
+	int mode = a & 0xC0;
+	int i;
+	if (mode == 0) {
+		// Close
+		if (y == 0) {
+			close_all(-1);
+		} else if ((ch = get_channel(y))) {
+			close_channel(ch);
+		}
+		return;
+	}
+	reply_a = 0;
+	mem_str(x | (y << 8), str, sizeof(str));
+	if (!parse_name(str, &fn, 0)) {
+		return;
+	}
+	for (int n = 0; n < NUM_CHANNELS; n++) {
+		if (!channels[n].open) {
+			ch = &channels[n];
+			break;
+		}
+	}
+	if (!ch) {
+		fs_error(ERR_TOO_MANY_OPEN, "Too many open");
+		return;
+	}
+	i = cat_find(&fn, 0);
+	if (i >= 0) {
+		channel_type *other = find_channel(fn.drive, ent_dir(fn.drive, i), fn.name);
+		if (other && (mode != 0x40 || other->writeable)) {
+			fs_error(ERR_OPEN, "Open");
+			return;
+		}
+	}
+	if (mode == 0x80) {
+		// OPENOUT
+		i = create_file(&fn, 0, 0, 0, OPENOUT_SIZE);
+		if (i < 0) {
+			return;
+		}
+		ch->ext = 0;
+	} else {
+		// OPENIN or OPENUP
+		if (i < 0) {
+			return;
+		}
+		if (mode == 0xC0 && (check_writeable(fn.drive) != XST_SUCCESS || check_unlocked(fn.drive, i) != XST_SUCCESS)) {
+			return;
+		}
+		ch->ext = ent_length(fn.drive, i);
+	}
+	ch->open = 1;
+	ch->drive = fn.drive;
+	ch->dir = ent_dir(fn.drive, i);
+	ent_name(fn.drive, i, ch->name);
+	ch->writeable = (mode != 0x40);
+	ch->start = ent_start(fn.drive, i);
+	ch->sectors = ent_sectors(fn.drive, i);
+	ch->ptr = 0;
+	ch->changed = 0;
+	ch->dirty = -1;
+	reply_a = FIRST_HANDLE + (ch - channels);
+}
+
+static void fs_osargs(u8 a, u8 x, u8 y) {
+	channel_type *ch;
+	if (y == 0) {
+		switch (a) {
+		case 0x00:
+			reply_a = FS_NUMBER;
+			break;
+		case 0x01:
+			mem_wr32(x, run_tail | 0xFFFF0000);
+			break;
+		case 0xFF:
+			for (int i = 0; i < NUM_CHANNELS; i++) {
+				if (channels[i].open) {
+					flush_channel(&channels[i]);
+				}
+			}
+			break;
+		}
+		return;
+	}
+	if (!(ch = get_channel(y))) {
+		return;
+	}
+	switch (a) {
+	case 0x00:
+		mem_wr32(x, ch->ptr);
+		break;
+	case 0x01:
+		set_ptr(ch, mem_rd32(x));
+		break;
+	case 0x02:
+		mem_wr32(x, ch->ext);
+		break;
+	case 0x03:
+		if (mem_rd32(x) > ch->ext) {
+			set_ptr(ch, mem_rd32(x));
+		} else if (ch->writeable) {
+			ch->ext = mem_rd32(x);
+			ch->changed = 1;
+			if (ch->ptr > ch->ext) {
+				ch->ptr = ch->ext;
+			}
+		}
+		break;
+	case 0xFF:
+		flush_channel(ch);
+		break;
+	}
+}
+
+static void fs_osbget(u8 y) {
+	channel_type *ch = get_channel(y);
+	if (!ch) {
+		return;
+	}
+	if (ch->ptr >= ch->ext) {
+		reply_a = 0xFE;
+		reply_flags = FLAG_CARRY;
+		return;
+	}
+	reply_a = *channel_data(ch, ch->ptr++);
+}
+
+static void fs_osbput(u8 a, u8 y) {
+	channel_type *ch = get_channel(y);
+	int sector;
+	if (!ch) {
+		return;
+	}
+	if (!ch->writeable) {
+		fs_error(ERR_READ_ONLY, "Read only");
+		return;
+	}
+	if (extend_channel(ch, ch->ptr + 1) != XST_SUCCESS) {
+		return;
+	}
+	// Sectors are written back to the SD card when the pointer moves on
+	sector = ch->ptr >> 8;
+	if (ch->dirty >= 0 && ch->dirty != sector && flush_channel(ch) != XST_SUCCESS) {
+		return;
+	}
+	*channel_data(ch, ch->ptr++) = a;
+	ch->dirty = sector;
+	if (ch->ptr > ch->ext) {
+		ch->ext = ch->ptr;
+		ch->changed = 1;
+	}
+}
+
+static void fs_osgbpb(u8 a, u32 blk) {
+	u32 addr = mem_rd32(blk + 1);
+	u32 count = mem_rd32(blk + 5);
+	u32 n = 0;
+	channel_type *ch;
+	switch (a) {
+	case 0x01:
+	case 0x02:
+	case 0x03:
+	case 0x04:
+		if (!(ch = get_channel(mem_rd(blk)))) {
+			return;
+		}
+		if ((a == 0x01 || a == 0x03) && set_ptr(ch, mem_rd32(blk + 9)) != XST_SUCCESS) {
+			return;
+		}
+		if (a <= 0x02) {
+			// Write
+			if (!ch->writeable) {
+				fs_error(ERR_READ_ONLY, "Read only");
+				return;
+			}
+			if (extend_channel(ch, ch->ptr + count) != XST_SUCCESS || flush_channel(ch) != XST_SUCCESS) {
+				return;
+			}
+			n = count;
+			if (n > 0) {
+				transfer(channel_data(ch, ch->ptr), addr, n, 1);
+				flush_later(ch->drive, ch->start + (ch->ptr >> 8), ((ch->ptr + n + 0xFF) >> 8) - (ch->ptr >> 8));
+			}
+			if (ch->ptr + n > ch->ext) {
+				ch->ext = ch->ptr + n;
+				ch->changed = 1;
+			}
+		} else {
+			// Read
+			n = ch->ext - ch->ptr;
+			if (n > count) {
+				n = count;
+			}
+			if (n > 0) {
+				transfer(channel_data(ch, ch->ptr), addr, n, 0);
+			}
+		}
+		ch->ptr += n;
+		mem_wr32(blk + 1, addr + n);
+		mem_wr32(blk + 5, count - n);
+		mem_wr32(blk + 9, ch->ptr);
+		reply_flags = (count != n) ? FLAG_CARRY : 0;
+		break;
+	case 0x05: {
+		// Title, boot option and drive
+		char title[13];
+		if (check_drive(cur_drive) != XST_SUCCESS) {
+			return;
+		}
+		cat_title(cur_drive, title);
+		gbpb_buf[n++] = strlen(title);
+		for (int i = 0; title[i]; i++) {
+			gbpb_buf[n++] = title[i];
+		}
+		gbpb_buf[n++] = cat_option(cur_drive);
+		gbpb_buf[n++] = cur_drive;
+		transfer(gbpb_buf, addr, n, 0);
+		break;
+	}
+	case 0x06:
+	case 0x07:
+		// Current or library drive and directory
+		gbpb_buf[n++] = 1;
+		gbpb_buf[n++] = '0' + (a == 0x06 ? cur_drive : lib_drive);
+		gbpb_buf[n++] = 1;
+		gbpb_buf[n++] = (a == 0x06 ? cur_dir : lib_dir);
+		transfer(gbpb_buf, addr, n, 0);
+		break;
+	case 0x08: {
+		// Filenames in the current directory, from index blk+9
+		u32 index = mem_rd32(blk + 9);
+		u32 found = 0;
+		u32 seen = 0;
+		if (check_drive(cur_drive) != XST_SUCCESS) {
+			return;
+		}
+		for (int i = 0; i < cat_count(cur_drive) && found < count && n + 8 <= sizeof(gbpb_buf); i++) {
+			char name[CAT_NAME_LEN + 1];
+			if (ent_dir(cur_drive, i) != cur_dir) {
+				continue;
+			}
+			if (seen++ < index) {
+				continue;
+			}
+			ent_name(cur_drive, i, name);
+			gbpb_buf[n++] = CAT_NAME_LEN;
+			for (int j = 0; j < CAT_NAME_LEN; j++) {
+				gbpb_buf[n++] = (j < strlen(name)) ? name[j] : ' ';
+			}
+			found++;
+		}
+		transfer(gbpb_buf, addr, n, 0);
+		mem_wr(blk, cat1(cur_drive)[4]);
+		mem_wr32(blk + 1, addr + n);
+		mem_wr32(blk + 5, count - found);
+		mem_wr32(blk + 9, index + found);
+		reply_flags = (found < count) ? FLAG_CARRY : 0;
+		break;
+	}
+	}
+}
+
+static void fs_fsc(u8 a, u8 x, u8 y) {
+	u32 xy = x | (y << 8);
+	channel_type *ch;
+	switch (a) {
+	case 0x00:
+		// *OPT
+		if (x == 4 && check_drive(cur_drive) == XST_SUCCESS && check_writeable(cur_drive) == XST_SUCCESS) {
+			cat1(cur_drive)[6] = (cat1(cur_drive)[6] & 0xCF) | ((y & 0x03) << 4);
+			cat_write(cur_drive);
+		}
+		break;
+	case 0x01:
+		// EOF
+		if ((ch = get_channel(x))) {
+			reply_x = (ch->ptr >= ch->ext) ? 0xFF : 0x00;
+		}
+		break;
+	case 0x02:
+	case 0x04:
+		// */ and *RUN
+		run_file(xy, 0);
+		break;
+	case 0x03:
+		// Unrecognised * command
+		if (!ds_command(xy)) {
+			run_file(xy, 1);
+		}
+		break;
+	case 0x05: {
+		// *CAT
+		char str[16];
+		int drive = cur_drive;
+		char dir = cur_dir;
+		mem_str(xy, str, sizeof(str));
+		if (parse_dir(str, &drive, &dir) == XST_SUCCESS && check_drive(drive) == XST_SUCCESS) {
+			print_cat(drive);
+		}
+		break;
+	}
+	case 0x06:
+		// New filing system taking over
+		close_all(-1);
+		break;
+	case 0x07:
+		// Range of file handles
+		reply_x = FIRST_HANDLE;
+		reply_y = FIRST_HANDLE + NUM_CHANNELS - 1;
+		break;
+	case 0x09:
+	case 0x0A: {
+		// *EX and *INFO
+		char str[256];
+		if (a == 0x09) {
+			snprintf(str, sizeof(str), ":%d.%c.*", cur_drive, cur_dir);
+			cmd_info(str);
+		} else {
+			mem_str(xy, str, sizeof(str));
+			cmd_info(str);
+		}
+		break;
+	}
+	}
+}
+
+// Select drive 0 and return the boot option for SHIFT+BREAK (Y=0)
+static void fs_boot(u8 y) {
+	close_all(-1);
+	cur_drive = 0;
+	cur_dir = '$';
+	lib_drive = 0;
+	lib_dir = '$';
+	reply_a = (y == 0 && disk_loaded(0)) ? cat_option(0) : 0;
+}
+
+// ============================================================
+// Mailbox
+// ============================================================
+
+static void start_request(u8 op) {
+	u8 a = jim_rd(MB_A);
+	u8 x = jim_rd(MB_X);
+	u8 y = jim_rd(MB_Y);
+	reply_action = ACT_DONE;
+	reply_a = a;
+	reply_x = x;
+	reply_y = y;
+	reply_flags = 0;
+	reply_addr = 0;
+	// A nested request's text goes after the text still being printed
+	output_len = num_nested > 0 ? nested[num_nested - 1].output_len : 0;
+	output_pos = output_len;
+	xfer_len = 0;
+	xfer_chunk = 0;
+	flush_count = 0;
+	req_tube = (jim_rd(MB_FLAGS) & FLAG_TUBE) != 0;
+	requests++;
+	if (disk_type() == DISK_NONE && !auto_mounted) {
+		auto_mounted = 1;
+		disk_mount(DISK_DEFAULT_IMAGE);
+	}
+	switch (op) {
+	case OP_FILE:
+		fs_osfile(a, x | (y << 8));
+		break;
+	case OP_ARGS:
+		fs_osargs(a, x, y);
+		break;
+	case OP_BGET:
+		fs_osbget(y);
+		break;
+	case OP_BPUT:
+		fs_osbput(a, y);
+		break;
+	case OP_GBPB:
+		fs_osgbpb(a, x | (y << 8));
+		break;
+	case OP_FIND:
+		fs_osfind(a, x, y);
+		break;
+	case OP_FSC:
+		fs_fsc(a, x, y);
+		break;
+	case OP_BOOT:
+		fs_boot(y);
+		break;
+	}
+}
+
+// The ROM has finished the last action
+static void continue_request() {
+	if (xfer_chunk > 0) {
+		for (u32 i = 0; i < xfer_chunk; i++) {
+			xfer_buf[i] = jim_rd(DATA_OFFSET + i);
+		}
+		xfer_buf += xfer_chunk;
+		xfer_chunk = 0;
+	}
+}
+
+void diskserv_init() {
+	cur_drive = 0;
+	cur_dir = '$';
+	lib_drive = 0;
+	lib_dir = '$';
+	for (int i = 0; i < NUM_CHANNELS; i++) {
+		channels[i].open = 0;
+	}
+	last_action = ACT_DONE;
+	num_nested = 0;
+	jim_wr(MB_STATUS, 0);
+}
+
+void diskserv_poll() {
+	u8 op;
+	if (jim_rd(MB_STATUS) != STATUS_REQUEST) {
+		return;
+	}
+	op = jim_rd(MB_OP);
+	if (op == OP_CONTINUE) {
+		continue_request();
+	} else {
+		if (op == OP_BOOT) {
+			num_nested = 0;
+		} else if (last_action == ACT_PRINT) {
+			if (num_nested == MAX_NESTED) {
+				num_nested = 0;
+			}
+			save_reply();
+		}
+		start_request(op);
+	}
+	send_reply();
+}
+
+void diskserv_print_status() {
+	int open = 0;
+	for (int i = 0; i < NUM_CHANNELS; i++) {
+		open += channels[i].open;
+	}
+	printf("Disk server: drive %d, dir %c, lib :%d.%c, %d files open\r\n",
+			cur_drive, cur_dir, lib_drive, lib_dir, open);
+	printf("  %lu requests, %lu bytes direct, %lu bytes via JIM\r\n",
+			requests, direct_bytes, chunked_bytes);
+	disk_print_status();
+}
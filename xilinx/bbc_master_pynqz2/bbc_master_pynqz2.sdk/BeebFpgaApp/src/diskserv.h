@@ -0,0 +1,19 @@
+/*
+ * BeebFPGA Application
+ *
+ * Disk Server
+ *
+ * Implements a DFS compatible filing system on the disk images in disk.c,
+ * for the DSFS sideways ROM (firmware/diskserv.asm). The ROM passes each
+ * filing system call through a mailbox in JIM RAM, which is polled from
+ * the main loop.
+ */
+
+#ifndef __DISKSERV_H_
+#define __DISKSERV_H_
+
+void diskserv_init();
+void diskserv_poll();
+void diskserv_print_status();
+
+#endif
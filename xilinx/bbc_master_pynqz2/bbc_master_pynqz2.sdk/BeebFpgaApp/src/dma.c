@@ -0,0 +1,91 @@
+/*
+ * BeebFPGA Application
+ *
+ * Memory to Memory DMA
+ *
+ * Only channel 0 is used, and dma_copy() waits for the transfer to
+ * complete. The data cache is disabled (see main()), so there's no cache
+ * maintenance to do.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xscugic.h"
+#include "xdmaps.h"
+#include "xtime_l.h"
+#include "dma.h"
+
+#define DMA_DEVICE_ID      XPAR_XDMAPS_1_DEVICE_ID
+#define DMA_DONE_INTR      XPAR_XDMAPS_0_DONE_INTR_0
+#define DMA_FAULT_INTR     XPAR_XDMAPS_0_FAULT_INTR
+#define DMA_CHANNEL        0
+
+// Much longer than the ~5ms it takes to copy the BBC's 512KB
+#define DMA_TIMEOUT        (COUNTS_PER_SECOND / 10)
+
+extern XScuGic INTCInst;
+
+static XDmaPs dma_inst;
+static volatile int dma_done;
+static int dma_ready;
+
+static void dma_done_handler(unsigned int channel, XDmaPs_Cmd *cmd, void *ref) {
+	dma_done = 1;
+}
+
+// Must be called after the interrupt controller has been initialized
+int dma_init() {
+	XDmaPs_Config *config = XDmaPs_LookupConfig(DMA_DEVICE_ID);
+	if (config == NULL || XDmaPs_CfgInitialize(&dma_inst, config, config->BaseAddress) != XST_SUCCESS) {
+		printf("DMA: initialization failed\r\n");
+		return XST_FAILURE;
+	}
+	XScuGic_Connect(&INTCInst, DMA_FAULT_INTR, (Xil_InterruptHandler) XDmaPs_FaultISR, &dma_inst);
+	XScuGic_Connect(&INTCInst, DMA_DONE_INTR, (Xil_InterruptHandler) XDmaPs_DoneISR_0, &dma_inst);
+	XScuGic_Enable(&INTCInst, DMA_FAULT_INTR);
+	XScuGic_Enable(&INTCInst, DMA_DONE_INTR);
+	XDmaPs_SetDoneHandler(&dma_inst, DMA_CHANNEL, dma_done_handler, NULL);
+	dma_ready = 1;
+	return XST_SUCCESS;
+}
+
+// Copy len bytes (a multiple of 4, word aligned) using 16 beat bursts
+int dma_copy(u32 dst, u32 src, u32 len) {
+	XDmaPs_Cmd cmd;
+	XTime start;
+	XTime now;
+	if (!dma_ready) {
+		// Word by word, as the BBC's memory is mapped as device memory
+		for (u32 i = 0; i < len; i += 4) {
+			Xil_Out32(dst + i, Xil_In32(src + i));
+		}
+		return XST_SUCCESS;
+	}
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.ChanCtrl.SrcBurstSize = 4;
+	cmd.ChanCtrl.SrcBurstLen = 16;
+	cmd.ChanCtrl.SrcInc = 1;
+	cmd.ChanCtrl.DstBurstSize = 4;
+	cmd.ChanCtrl.DstBurstLen = 16;
+	cmd.ChanCtrl.DstInc = 1;
+	cmd.BD.SrcAddr = src;
+	cmd.BD.DstAddr = dst;
+	cmd.BD.Length = len;
+	dma_done = 0;
+	if (XDmaPs_Start(&dma_inst, DMA_CHANNEL, &cmd, 0) != XST_SUCCESS) {
+		printf("DMA: unable to start transfer\r\n");
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&start);
+	while (!dma_done) {
+		XTime_GetTime(&now);
+		if (now - start > DMA_TIMEOUT) {
+			printf("DMA: transfer timed out\r\n");
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
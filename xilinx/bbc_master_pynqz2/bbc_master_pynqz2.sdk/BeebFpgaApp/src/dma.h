@@ -0,0 +1,18 @@
+/*
+ * BeebFPGA Application
+ *
+ * Memory to Memory DMA
+ *
+ * Uses the PS DMA Controller, e.g. to copy the BBC's memory (through the
+ * AXI BRAM Controller) to and from DDR much faster than the CPU can.
+ */
+
+#ifndef __DMA_H_
+#define __DMA_H_
+
+#include "xil_types.h"
+
+int dma_init();
+int dma_copy(u32 dst, u32 src, u32 len);
+
+#endif
@@ -35,6 +35,10 @@
  *
  * - UART0/UART1 cross connection for ICE Debugger
  * - USB Host Keyboard Handling
+ * - Command console on UART0 (Ctrl-])
+ * - Autotype / Paste
+ * - Event trace
+ * - ROM sets and PL reconfiguration
  */
 
 #include <stdio.h>
@@ -50,6 +54,15 @@
 #include "xgpiops.h"
 #include "xuartps.h"
 #include "ulpi.h"
+#include "keyboard.h"
+#include "autotype.h"
+#include "console.h"
+#include "trace.h"
+#include "diskserv.h"
+#include "dma.h"
+#include "rewind.h"
+#include "romset.h"
+#include "plconfig.h"
 
 #define UART_BUFFER_SIZE 32
 
@@ -74,6 +87,17 @@ enum {
 	ST_SET_CONFIGURATION,
 	ST_SETUP_PERIODIC,
 	ST_PERIODIC,
+	ST_NUM_STATES
+};
+
+static const char *state_names[] = {
+	"INITIAL",
+	"RESET",
+	"SET_ADDRESS",
+	"DELAY",
+	"SET_CONFIGURATION",
+	"SETUP_PERIODIC",
+	"PERIODIC"
 };
 
 
@@ -99,12 +123,6 @@ typedef struct qh_struct {
 
 void state_machine();
 
-// AXI Registers that implement the 128-bit keyboard matrix
-#define GPIO_REG0          0x41200000
-#define GPIO_REG1          0x41200008
-#define GPIO_REG2          0x41210000
-#define GPIO_REG3          0x41210008
-
 // USB0 Periperal Registers
 #define USB0_GPTIMER0LD    0xE0002080
 #define USB0_GPTIMER0CTRL  0xE0002084
@@ -199,7 +217,17 @@ void dump_ulpi() {
 	}
 }
 
+const char *usb_state_name(int state) {
+	return (state >= 0 && state < ST_NUM_STATES) ? state_names[state] : "?";
+}
+
+void set_state(int new_status) {
+	trace_event(TR_STATE, new_status, status, 0, 0, 0);
+	status = new_status;
+}
+
 void scheduleTimer(int usec) {
+	trace_event(TR_TIMER, 0, usec, 0, 0, 0);
 	//set timer value
 	Xil_Out32(USB0_GPTIMER0LD, usec);
 	//reload timer
@@ -505,10 +533,7 @@ void processKeyboardInfo(u32 usbWord0, u32 usbWord1) {
 				}
 			}
 		}
-		Xil_Out32(GPIO_REG0, bbcwords[0]);
-		Xil_Out32(GPIO_REG1, bbcwords[1]);
-		Xil_Out32(GPIO_REG2, bbcwords[2]);
-		Xil_Out32(GPIO_REG3, bbcwords[3]);
+		keyboard_set(KEYB_SRC_USB, bbcwords);
 		usbWord0_last = usbWord0;
 		usbWord1_last = usbWord1;
 	}
@@ -538,6 +563,7 @@ void schedTransfer(int setup, int direction, int size, qh_type *qh) {
 	qtd_type *first_qtd = qh->qtd.next;
 	qtd_type *firstTD = first_qtd;
 	qtd_type *nextTD = first_qtd;
+	trace_event(TR_XFER, setup, direction, size, 0, 0);
 	if (setup) {
 		firstTD->next = calNextPointer(first_qtd); //next qtd + terminate
 		firstTD->altnext = QTD_TERMINATOR; // alternate pointer
@@ -682,29 +708,31 @@ void setup_periodic() {
 }
 
 void state_machine() {
-	u32 in2 = Xil_In32(USB0_ISR) | (1 << 24) | (1 << 18);
+	u32 in2 = Xil_In32(USB0_ISR);
+	trace_event(TR_IRQ, status, in2, 0, 0, 0);
+	in2 |= (1 << 24) | (1 << 18);
 	Xil_Out32(USB0_ISR, in2); //clear
 
 	if (status == ST_INITIAL) {
 		set_port_reset_state(1);
 		scheduleTimer(12000);
-		status = ST_RESET;
+		set_state(ST_RESET);
 		return;
 	} else if (status == ST_RESET) {
 		set_port_reset_state(0);
 		scheduleTimer(12000);
-		status = ST_SET_ADDRESS;
+		set_state(ST_SET_ADDRESS);
 		return;
 	} else if (status == ST_SET_ADDRESS) {
 		//set address
 		USB_ASYNC_DATA0[0] = 0x00030500;
 		USB_ASYNC_DATA0[1] = 0x00000000;
 		schedTransfer(1, 0, 0, USB_ASYNC_QH);
-		status = ST_DELAY;
+		set_state(ST_DELAY);
 		return;
 	} else if (status == ST_DELAY) {
 		scheduleTimer(3000);
-		status = ST_SET_CONFIGURATION;
+		set_state(ST_SET_CONFIGURATION);
 		return;
 	} else if (status == ST_SET_CONFIGURATION) {
 		USB_ASYNC_QH->qh_endpt1 |= 3;
@@ -712,14 +740,14 @@ void state_machine() {
 		USB_ASYNC_DATA0[0] = 0x00010900;
 		USB_ASYNC_DATA0[1] = 0x00000000;
 		schedTransfer(1, 0, 0, USB_ASYNC_QH);
-		status = ST_SETUP_PERIODIC;
+		set_state(ST_SETUP_PERIODIC);
 		return;
 	} else if (status == ST_SETUP_PERIODIC) {
 		//enable periodic scheduling
 		setup_periodic();
 		in2 = Xil_In32(USB0_CMD) | 16;
 		Xil_Out32(USB0_CMD, in2);
-		status = ST_PERIODIC;
+		set_state(ST_PERIODIC);
 		scheduleTimer(10000);
 		return;
 	} else if (status == ST_PERIODIC) {
@@ -730,7 +758,8 @@ void state_machine() {
 		if (!(qTDAddressCheck->token & 0x80)) {
 			u32 word0 = USB_PERIODIC_DATA[0];
 			u32 word1 = USB_PERIODIC_DATA[1];
-            processKeyboardInfo(word0, word1);
+			trace_event(TR_DONE, 0, qTDAddressCheck->token, word0, word1, 0);
+			processKeyboardInfo(word0, word1);
 
 			qh_type *qh = USB_PERIODIC_QH;
 			qh->qh_link = QH_LINK(QH_TERMINATOR);
@@ -751,6 +780,8 @@ void state_machine() {
 
 			qh->qh_link = QH_LINK(qh2);
 			currentTD = ~currentTD;
+		} else {
+			trace_event(TR_RETRY, 0, qTDAddressCheck->token, 0, 0, 0);
 		}
 		scheduleTimer(10000);
 		return;
@@ -805,13 +836,19 @@ int main() {
 	 * USB/KB initialization *
 	 *************************/
 
+	trace_init();
+
 	// Clear the emulated keyboard matrix registers
-	Xil_Out32(GPIO_REG0, 0);
-	Xil_Out32(GPIO_REG1, 0);
-	Xil_Out32(GPIO_REG2, 0);
-	Xil_Out32(GPIO_REG3, 0);
+	keyboard_init();
+	autotype_init();
+	console_init();
+	diskserv_init();
+	rewind_init();
 
 	initint();
+	dma_init();
+	plconfig_init();
+	romset_init();
 	initUsb();
 	status = ST_INITIAL;
 	state_machine();
@@ -838,13 +875,25 @@ int main() {
 	while (1) {
 		len = XUartPs_Recv(&Uart_PS_0, buffer, sizeof(buffer));
 		if (len > 0) {
-			XUartPs_Send(&Uart_PS_1, buffer, len);
+			// Anything not consumed by the console goes to the ICE Debugger
+			int n = 0;
+			for (int i = 0; i < len; i++) {
+				if (!console_input(buffer[i])) {
+					buffer[n++] = buffer[i];
+				}
+			}
+			if (n > 0) {
+				XUartPs_Send(&Uart_PS_1, buffer, n);
+			}
 		}
 		len = XUartPs_Recv(&Uart_PS_1, buffer, sizeof(buffer));
 		if (len > 0) {
 			XUartPs_Send(&Uart_PS_0, buffer, len);
 			led = !led;
 		}
+		autotype_poll();
+		diskserv_poll();
+		rewind_poll();
 	}
 	cleanup_platform();
 	return 0;
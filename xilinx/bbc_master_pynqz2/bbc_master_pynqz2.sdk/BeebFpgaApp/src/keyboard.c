@@ -0,0 +1,85 @@
+/*
+ * BeebFPGA Application
+ *
+ * Emulated BBC Keyboard Matrix
+ */
+
+#include "xil_io.h"
+#include "xil_exception.h"
+#include "keyboard.h"
+#include "trace.h"
+
+static u32 keyb_words[KEYB_NUM_SRC][4];
+
+static void keyboard_write(int src) {
+	u32 words[4];
+	for (int i = 0; i < 4; i++) {
+		words[i] = 0;
+		for (int s = 0; s < KEYB_NUM_SRC; s++) {
+			words[i] |= keyb_words[s][i];
+		}
+	}
+	trace_event(TR_MATRIX, src, words[0], words[1], words[2], words[3]);
+	Xil_Out32(GPIO_REG0, words[0]);
+	Xil_Out32(GPIO_REG1, words[1]);
+	Xil_Out32(GPIO_REG2, words[2]);
+	Xil_Out32(GPIO_REG3, words[3]);
+}
+
+void keyboard_init() {
+	for (int src = 0; src < KEYB_NUM_SRC; src++) {
+		for (int i = 0; i < 4; i++) {
+			keyb_words[src][i] = 0;
+		}
+	}
+	keyboard_write(KEYB_SRC_USB);
+}
+
+// Called from both the USB interrupt handler and the main loop, so the
+// update of the matrix registers must not be interrupted part way through
+void keyboard_set(int src, const u32 *words) {
+	u32 cpsr = mfcpsr();
+	Xil_ExceptionDisable();
+	for (int i = 0; i < 4; i++) {
+		keyb_words[src][i] = words[i];
+	}
+	keyboard_write(src);
+	if (!(cpsr & XIL_EXCEPTION_IRQ)) {
+		Xil_ExceptionEnable();
+	}
+}
+
+// Rewrite the matrix registers, e.g. after the PL has been reconfigured
+void keyboard_refresh() {
+	u32 cpsr = mfcpsr();
+	Xil_ExceptionDisable();
+	keyboard_write(KEYB_SRC_USB);
+	if (!(cpsr & XIL_EXCEPTION_IRQ)) {
+		Xil_ExceptionEnable();
+	}
+}
+
+u32 keyboard_status() {
+	return Xil_In32(GPIO_KEYB_STATUS);
+}
+
+// Number of MOS keyboard scans completed (modulo 65536)
+u16 keyboard_scan_count() {
+	u16 n = keyboard_status() & 0xFFFF;
+	// Convert from gray code
+	n ^= n >> 8;
+	n ^= n >> 4;
+	n ^= n >> 2;
+	n ^= n >> 1;
+	return n;
+}
+
+// Number of video frames started (modulo 256)
+u8 keyboard_frame_count() {
+	u8 n = keyboard_status() >> KEYB_STATUS_FRAME;
+	// Convert from gray code
+	n ^= n >> 4;
+	n ^= n >> 2;
+	n ^= n >> 1;
+	return n;
+}
@@ -0,0 +1,48 @@
+/*
+ * BeebFPGA Application
+ *
+ * Emulated BBC Keyboard Matrix
+ *
+ * The 128-bit matrix is the OR of the USB keyboard, the autotype engine and
+ * the ROM set loader (which holds CTRL-BREAK), so they can all be active at
+ * the same time without trampling on each other.
+ */
+
+#ifndef __KEYBOARD_H_
+#define __KEYBOARD_H_
+
+#include "xil_types.h"
+
+// AXI Registers that implement the 128-bit keyboard matrix
+#define GPIO_REG0          0x41200000
+#define GPIO_REG1          0x41200008
+#define GPIO_REG2          0x41210000
+#define GPIO_REG3          0x41210008
+
+// AXI Register that returns the keyboard status (see bbc_micro_pynqz2.vhd)
+#define GPIO_KEYB_STATUS   0x41220000
+
+#define KEYB_STATUS_EN_N   (1 << 16)
+#define KEYB_STATUS_CAPS   (1 << 17)
+#define KEYB_STATUS_SHIFT  (1 << 18)
+#define KEYB_STATUS_MASTER (1 << 21)
+#define KEYB_STATUS_FRAME  24
+
+// Matrix scancodes are column * 8 + row (the same as bbc_map[])
+#define BBC_KEY_SHIFT      0
+#define BBC_KEY_CTRL       8
+#define BBC_KEY_BREAK      127
+
+#define KEYB_SRC_USB       0
+#define KEYB_SRC_AUTOTYPE  1
+#define KEYB_SRC_ROMSET    2
+#define KEYB_NUM_SRC       3
+
+void keyboard_init();
+void keyboard_set(int src, const u32 *words);
+void keyboard_refresh();
+u16  keyboard_scan_count();
+u8   keyboard_frame_count();
+u32  keyboard_status();
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * BeebFPGA Application
+ *
+ * Fixed DDR buffers
+ *
+ * The App itself is linked at 0x00100000 (see lscript.ld), and the USB
+ * buffers are at 0x00300000-0x003FFFFF (see helloworld.c). Large buffers
+ * are placed at fixed addresses above these, in the same way.
+ */
+
+#ifndef __MEMMAP_H_
+#define __MEMMAP_H_
+
+// Event trace ring buffer (see trace.c)
+#define TRACE_BUFFER_ADDR  0x00400000
+#define TRACE_BUFFER_SIZE  0x00080000
+
+// Disk image cache, one 200KB side per drive (see disk.c)
+#define DISK_CACHE_ADDR    0x00480000
+#define DISK_CACHE_SIZE    0x000C8000
+
+// Save state: header, then a copy of the BBC's memory (see snapshot.c)
+#define SNAPSHOT_ADDR      0x00548000
+#define SNAPSHOT_MEM       0x00549000
+#define SNAPSHOT_SIZE      0x00081000
+
+// Rewind: a mirror of the BBC's memory, then the ring buffer of per-frame
+// records, whose size bounds the history (see rewind.c)
+#define REWIND_MIRROR_ADDR 0x00600000
+#define REWIND_MIRROR_SIZE 0x00080000
+#define REWIND_BUFFER_ADDR 0x00680000
+#define REWIND_BUFFER_SIZE 0x01000000
+
+// Boot timeline, left by the loader at handoff (see boottime.c)
+#define BOOT_TIMELINE_ADDR 0x01680000
+#define BOOT_TIMELINE_SIZE 0x00001000
+
+// ROM set staging, mirroring the ROM areas of the BBC's memory (see romset.c)
+#define ROMSET_BUFFER_ADDR 0x01681000
+#define ROMSET_BUFFER_SIZE 0x00060000
+
+// PL bitstream cache, one 4MB slot per bitstream (see plconfig.c)
+#define PL_CACHE_ADDR      0x01700000
+#define PL_CACHE_SLOT_SIZE 0x00400000
+#define PL_CACHE_SLOTS     4
+
+// The BBC's 512KB memory, as seen through the AXI BRAM Controller
+#define BEEB_MEM_ADDR      0x40000000
+#define BEEB_MAIN_RAM      (BEEB_MEM_ADDR + 0x60000)
+#define BEEB_JIM_RAM       (BEEB_MEM_ADDR + 0x74000)
+
+#endif
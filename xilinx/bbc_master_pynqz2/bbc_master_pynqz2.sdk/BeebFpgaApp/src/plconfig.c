@@ -0,0 +1,372 @@
+/*
+ * BeebFPGA Application
+ *
+ * PL Configuration
+ *
+ * The PCAP sequence is the same as the loader's (see FabricInit() and
+ * PcapLoadPartition() in BeebFpgaLoader's pcap.c): PROG_B is pulsed to
+ * clear the PL, then the bitstream is DMA'd from DDR, with the PS to PL
+ * level shifters off and the PL held in reset until DONE.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xstatus.h"
+#include "xil_io.h"
+#include "xil_exception.h"
+#include "xdevcfg.h"
+#include "xuartps_hw.h"
+#include "xtime_l.h"
+#include "memmap.h"
+#include "sdcard.h"
+#include "keyboard.h"
+#include "diskserv.h"
+#include "rewind.h"
+#include "plconfig.h"
+
+#define DCFG_DEVICE_ID     XPAR_XDCFG_0_DEVICE_ID
+
+// UART1, which is routed through the PL (EMIO) to the ICE Debugger
+#define UART1_BASEADDR     XPAR_XUARTPS_1_BASEADDR
+
+// SLCR registers
+#define SLCR_LOCK          (XPS_SYS_CTRL_BASEADDR + 0x004)
+#define SLCR_UNLOCK        (XPS_SYS_CTRL_BASEADDR + 0x008)
+#define SLCR_FPGA_RST_CTRL (XPS_SYS_CTRL_BASEADDR + 0x240)
+#define SLCR_LVL_SHFTR_EN  (XPS_SYS_CTRL_BASEADDR + 0x900)
+
+#define SLCR_LOCK_KEY      0x767B767B
+#define SLCR_UNLOCK_KEY    0xDF0DDF0D
+#define FPGA_RST_ALL       0x0000000F
+#define LVL_PS_PL          0x0000000A
+#define LVL_PL_PS          0x0000000F
+
+// The sync word, as the PCAP must see it, and byte swapped (as in a .bit)
+#define PL_SYNC_WORD       0xAA995566
+#define PL_SYNC_SWAPPED    0x665599AA
+#define PL_SYNC_SEARCH     64
+
+#define PCAP_LAST_TRANSFER 1
+
+#define PCAP_ERROR_MASK    (XDCFG_IXR_AXI_WERR_MASK | XDCFG_IXR_AXI_RTO_MASK | \
+                            XDCFG_IXR_AXI_RERR_MASK | XDCFG_IXR_RX_FIFO_OV_MASK | \
+                            XDCFG_IXR_DMA_CMD_ERR_MASK | XDCFG_IXR_DMA_Q_OV_MASK | \
+                            XDCFG_IXR_P2D_LEN_ERR_MASK | XDCFG_IXR_PCFG_HMAC_ERR_MASK)
+
+// INIT should follow PROG_B within a few ms, and a 4MB bitstream takes
+// ~40ms at the PCAP's 100MB/s
+#define PL_INIT_TIMEOUT    (COUNTS_PER_SECOND / 10)
+#define PL_DONE_TIMEOUT    (COUNTS_PER_SECOND)
+
+typedef struct {
+	char path[PL_PATH_SIZE];
+	u32 words;     // length of the bitstream, 0 if the slot is free
+	u32 load_time; // us to read it from the SD card
+} slot_type;
+
+static XDcfg dcfg_inst;
+static int dcfg_ready;
+
+static slot_type slots[PL_CACHE_SLOTS];
+static int next_slot;
+
+static char current[PL_PATH_SIZE];
+static u32 num_programs;
+static u32 program_time;
+
+static u32 elapsed_us(XTime start) {
+	XTime now;
+	XTime_GetTime(&now);
+	return (u32) ((now - start) * 1000000 / COUNTS_PER_SECOND);
+}
+
+static u32 *slot_data(const slot_type *slot) {
+	return (u32 *) (PL_CACHE_ADDR + (slot - slots) * PL_CACHE_SLOT_SIZE);
+}
+
+static slot_type *find(const char *path) {
+	for (int i = 0; i < PL_CACHE_SLOTS; i++) {
+		if (slots[i].words && !strcmp(slots[i].path, path)) {
+			return &slots[i];
+		}
+	}
+	return NULL;
+}
+
+// A .bit file has a header of keyed fields before the configuration data,
+// the last of which ('e') has a 32 bit length. Returns the offset of the
+// data, or 0 if this isn't a .bit file.
+static u32 bit_data(const u8 *buf, u32 size, u32 *len) {
+	static const u8 magic[] = {
+		0x00, 0x09, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x0F, 0xF0, 0x00, 0x00, 0x01
+	};
+	u32 i = sizeof(magic);
+	if (size < i || memcmp(buf, magic, i)) {
+		return 0;
+	}
+	while (i + 3 <= size) {
+		u8 key = buf[i++];
+		if (key == 'e') {
+			if (i + 4 > size) {
+				return 0;
+			}
+			*len = (buf[i] << 24) | (buf[i + 1] << 16) | (buf[i + 2] << 8) | buf[i + 3];
+			i += 4;
+			return (*len <= size - i) ? i : 0;
+		}
+		i += 2 + ((buf[i] << 8) | buf[i + 1]);
+	}
+	return 0;
+}
+
+// Read a bitstream into a cache slot, leaving it as the PCAP wants it
+static int load(slot_type *slot, const char *path) {
+	u32 *data = slot_data(slot);
+	FIL fil;
+	UINT br = 0;
+	FRESULT rc;
+	u32 offset;
+	u32 len;
+	u32 words;
+	u32 i;
+	XTime start;
+	XTime_GetTime(&start);
+	slot->words = 0;
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	rc = f_open(&fil, path, FA_READ);
+	if (rc != FR_OK) {
+		printf("PL: unable to open %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	if (f_size(&fil) > PL_CACHE_SLOT_SIZE) {
+		printf("PL: %s is larger than %dKB\r\n", path, PL_CACHE_SLOT_SIZE / 1024);
+		f_close(&fil);
+		return XST_FAILURE;
+	}
+	rc = f_read(&fil, data, PL_CACHE_SLOT_SIZE, &br);
+	f_close(&fil);
+	if (rc != FR_OK || br == 0) {
+		printf("PL: read error on %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	len = br;
+	offset = bit_data((const u8 *) data, br, &len);
+	if (offset) {
+		memmove(data, (u8 *) data + offset, len);
+	}
+	words = len / 4;
+	// The .bit (and Vivado's .bin) data is big endian, bootgen's is not
+	for (i = 0; i < words && i < PL_SYNC_SEARCH; i++) {
+		if (data[i] == PL_SYNC_WORD) {
+			break;
+		}
+		if (data[i] == PL_SYNC_SWAPPED) {
+			for (u32 j = 0; j < words; j++) {
+				data[j] = Xil_EndianSwap32(data[j]);
+			}
+			break;
+		}
+	}
+	if (i == words || i == PL_SYNC_SEARCH) {
+		printf("PL: %s is not a bitstream (no sync word)\r\n", path);
+		return XST_FAILURE;
+	}
+	strcpy(slot->path, path);
+	slot->words = words;
+	slot->load_time = elapsed_us(start);
+	return XST_SUCCESS;
+}
+
+static int pcap_wait(u32 mask, XTime timeout) {
+	XTime start;
+	XTime now;
+	u32 status;
+	XTime_GetTime(&start);
+	while (((status = XDcfg_IntrGetStatus(&dcfg_inst)) & mask) != mask) {
+		if (status & PCAP_ERROR_MASK) {
+			printf("PL: PCAP error (%08lx)\r\n", status);
+			return XST_FAILURE;
+		}
+		XTime_GetTime(&now);
+		if (now - start > timeout) {
+			printf("PL: PCAP timed out (%08lx)\r\n", status);
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+static int init_wait(u32 level) {
+	XTime start;
+	XTime now;
+	XTime_GetTime(&start);
+	while ((XDcfg_GetStatusRegister(&dcfg_inst) & XDCFG_STATUS_PCFG_INIT_MASK) != level) {
+		XTime_GetTime(&now);
+		if (now - start > PL_INIT_TIMEOUT) {
+			printf("PL: INIT %s timed out\r\n", level ? "set" : "clear");
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+// Clear the PL, and DMA the bitstream into it
+static int configure(const slot_type *slot) {
+	u32 ctrl = XDcfg_GetControlRegister(&dcfg_inst);
+	XDcfg_WriteReg(dcfg_inst.Config.BaseAddr, XDCFG_CTRL_OFFSET, ctrl | XDCFG_CTRL_PCFG_PROG_B_MASK);
+	XDcfg_WriteReg(dcfg_inst.Config.BaseAddr, XDCFG_CTRL_OFFSET, ctrl & ~XDCFG_CTRL_PCFG_PROG_B_MASK);
+	if (init_wait(0) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XDcfg_WriteReg(dcfg_inst.Config.BaseAddr, XDCFG_CTRL_OFFSET, ctrl | XDCFG_CTRL_PCFG_PROG_B_MASK);
+	if (init_wait(XDCFG_STATUS_PCFG_INIT_MASK) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XDcfg_IntrClear(&dcfg_inst, 0xFFFFFFFF);
+	if (XDcfg_Transfer(&dcfg_inst, (u8 *) ((u32) slot_data(slot) | PCAP_LAST_TRANSFER), slot->words,
+			(u8 *) XDCFG_DMA_INVALID_ADDRESS, 0, XDCFG_NON_SECURE_PCAP_WRITE) != XST_SUCCESS) {
+		printf("PL: unable to start the PCAP transfer\r\n");
+		return XST_FAILURE;
+	}
+	if (pcap_wait(XDCFG_IXR_DMA_DONE_MASK, PL_DONE_TIMEOUT) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	return pcap_wait(XDCFG_IXR_PCFG_DONE_MASK, PL_DONE_TIMEOUT);
+}
+
+int plconfig_init() {
+	XDcfg_Config *config = XDcfg_LookupConfig(DCFG_DEVICE_ID);
+	current[0] = 0;
+	num_programs = 0;
+	if (config == NULL || XDcfg_CfgInitialize(&dcfg_inst, config, config->BaseAddr) != XST_SUCCESS) {
+		printf("PL: PCAP initialization failed\r\n");
+		return XST_FAILURE;
+	}
+	// Full reconfiguration through the PCAP, rather than the ICAP
+	XDcfg_EnablePCAP(&dcfg_inst);
+	XDcfg_SetControlRegister(&dcfg_inst, XDCFG_CTRL_PCAP_PR_MASK);
+	XDcfg_SetMiscControlRegister(&dcfg_inst,
+			XDcfg_GetMiscControlRegister(&dcfg_inst) & ~XDCFG_MCTRL_PCAP_LPBK_MASK);
+	dcfg_ready = 1;
+	return XST_SUCCESS;
+}
+
+// Make sure a bitstream is in the cache, replacing the oldest if need be
+int plconfig_cache(const char *path) {
+	slot_type *slot;
+	if (strlen(path) >= PL_PATH_SIZE) {
+		printf("PL: path too long: %s\r\n", path);
+		return XST_FAILURE;
+	}
+	if (find(path)) {
+		return XST_SUCCESS;
+	}
+	slot = &slots[next_slot];
+	next_slot = (next_slot + 1) % PL_CACHE_SLOTS;
+	return load(slot, path);
+}
+
+int plconfig_program(const char *path) {
+	slot_type *slot;
+	u32 cpsr;
+	int ret;
+	XTime start;
+	if (!dcfg_ready) {
+		printf("PL: PCAP not initialized\r\n");
+		return XST_FAILURE;
+	}
+	if (plconfig_cache(path) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	slot = find(path);
+	XTime_GetTime(&start);
+
+	// Nothing may touch the PL while it's being configured, including the
+	// USB interrupt handler, which writes the keyboard matrix
+	cpsr = mfcpsr();
+	Xil_ExceptionDisable();
+	Xil_Out32(SLCR_UNLOCK, SLCR_UNLOCK_KEY);
+	Xil_Out32(SLCR_FPGA_RST_CTRL, FPGA_RST_ALL);
+	Xil_Out32(SLCR_LVL_SHFTR_EN, LVL_PS_PL);
+	ret = configure(slot);
+	if (ret == XST_SUCCESS) {
+		Xil_Out32(SLCR_LVL_SHFTR_EN, LVL_PL_PS);
+		Xil_Out32(SLCR_FPGA_RST_CTRL, 0);
+	}
+	Xil_Out32(SLCR_LOCK, SLCR_LOCK_KEY);
+	if (ret != XST_SUCCESS) {
+		// The App can't run without the PL, so there's no way back
+		printf("PL: configuration from %s failed, the board must be reset\r\n", path);
+		current[0] = 0;
+		return XST_FAILURE;
+	}
+
+	// Re-arm what was lost with the old PL: the keyboard matrix, anything
+	// UART1 received while its pins were floating, and the disk server's
+	// mailbox in JIM RAM
+	keyboard_refresh();
+	Xil_Out32(UART1_BASEADDR + XUARTPS_CR_OFFSET,
+			Xil_In32(UART1_BASEADDR + XUARTPS_CR_OFFSET) | XUARTPS_CR_TXRST | XUARTPS_CR_RXRST);
+	if (!(cpsr & XIL_EXCEPTION_IRQ)) {
+		Xil_ExceptionEnable();
+	}
+	diskserv_init();
+	// The BBC's memory was reloaded from the bitstream, so start a new history
+	if (rewind_enabled()) {
+		rewind_enable(1);
+	}
+
+	strcpy(current, path);
+	num_programs++;
+	program_time = elapsed_us(start);
+	return XST_SUCCESS;
+}
+
+// The bitstream last programmed, or "" if the one loaded at boot is unknown
+const char *plconfig_current() {
+	return current;
+}
+
+// Record which bitstream the PL loaded at boot was built from, without
+// reprogramming it
+void plconfig_set_current(const char *path) {
+	if (strlen(path) < PL_PATH_SIZE) {
+		strcpy(current, path);
+	}
+}
+
+// Number of times the PL has been reconfigured since boot
+u32 plconfig_count() {
+	return num_programs;
+}
+
+void plconfig_list() {
+	int n = 0;
+	for (int i = 0; i < PL_CACHE_SLOTS; i++) {
+		if (slots[i].words) {
+			printf("  %-32s %5luKB, read in %lu ms%s\r\n", slots[i].path,
+					slots[i].words / 256, slots[i].load_time / 1000,
+					!strcmp(slots[i].path, current) ? " (current)" : "");
+			n++;
+		}
+	}
+	if (!n) {
+		printf("  no bitstreams cached\r\n");
+	}
+}
+
+void plconfig_print_status() {
+	if (!num_programs) {
+		if (current[0]) {
+			printf("PL: %s, as loaded at boot\r\n", current);
+		} else {
+			printf("PL: as loaded at boot\r\n");
+		}
+		return;
+	}
+	printf("PL: %s, reconfigured %lu times, last in %lu us\r\n", current,
+			num_programs, program_time);
+}
@@ -0,0 +1,34 @@
+/*
+ * BeebFPGA Application
+ *
+ * PL Configuration
+ *
+ * Reprograms the PL at runtime through the PCAP, e.g. to switch between
+ * Model B and Master builds without rebooting. Bitstreams are read from
+ * the SD card once, into a cache in DDR, so a switch only costs the PCAP
+ * transfer. Both the Vivado .bit and .bin formats are accepted.
+ *
+ * The PS keeps running throughout: the USB keyboard (which is in the PS)
+ * stays enumerated, and once the new PL is up the keyboard matrix is
+ * rewritten and UART1 (routed through the PL to the ICE Debugger) has its
+ * FIFOs reset. The new build must have the same block design, so the AXI
+ * peripherals are where the App expects them.
+ */
+
+#ifndef __PLCONFIG_H_
+#define __PLCONFIG_H_
+
+#include "xil_types.h"
+
+#define PL_PATH_SIZE 64
+
+int  plconfig_init();
+int  plconfig_cache(const char *path);
+int  plconfig_program(const char *path);
+const char *plconfig_current();
+void plconfig_set_current(const char *path);
+u32  plconfig_count();
+void plconfig_list();
+void plconfig_print_status();
+
+#endif
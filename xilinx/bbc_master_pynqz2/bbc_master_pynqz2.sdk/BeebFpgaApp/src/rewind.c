@@ -0,0 +1,409 @@
+/*
+ * BeebFPGA Application
+ *
+ * Rewind
+ *
+ * The history is an undo log. A mirror of the BBC's memory is kept as it
+ * was at the last frame, and at the start of each frame (while the core is
+ * briefly frozen):
+ * - the CPU registers are captured (see snapshot.c)
+ * - each page in the dirty page map is compared with the mirror, and the
+ *   bytes that differ are appended to a record in the ring buffer, holding
+ *   their old values, along with the CPU registers from the previous frame
+ * - the mirror is updated, and the dirty page map is cleared
+ *
+ * Stepping back applies the newest records to the mirror, then writes back
+ * just the pages they (or the current frame) touched, and reloads the CPU
+ * and device registers. When the ring buffer is full the oldest records
+ * are dropped, so its size bounds the memory used.
+ *
+ * Record format: rewind_record_type, then for each page the page number
+ * (two bytes, little endian) followed by runs of (offset, length, old
+ * bytes), ending with a zero length.
+ *
+ * The dirty page map is set by writes from the core and from the PS
+ * through the AXI BRAM Controller (e.g. the disk server's *LOADs). Not
+ * rewound: the Co Processor's memory, and JIM RAM (the disk server's
+ * mailbox) and the snapshot buffers that follow it.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "memmap.h"
+#include "keyboard.h"
+#include "snapshot.h"
+#include "dma.h"
+#include "rewind.h"
+
+typedef struct {
+	snapshot_header_type cpu;
+	u32 size;
+	u32 pages;
+} rewind_record_type;
+
+#define REWIND_MIRROR     ((u8 *) REWIND_MIRROR_ADDR)
+#define REWIND_BUFFER     ((u8 *) REWIND_BUFFER_ADDR)
+
+#define MAP_WORDS         (REWIND_NUM_PAGES / 32)
+
+// Untracked pages (see above)
+#define COPRO_PAGE        0x400
+#define COPRO_PAGES       0x100
+#define JIM_RAM_PAGE      ((BEEB_JIM_RAM - BEEB_MEM_ADDR) / REWIND_PAGE_SIZE)
+#define SHADOW_PAGE       (SNAP_SHADOW / REWIND_PAGE_SIZE)
+
+// A gap of this many unchanged bytes is cheaper to include in a run than
+// to start a new run for the bytes after it
+#define RUN_GAP           2
+
+// Worst case encoded page: page number, two runs and the terminator
+#define PAGE_MAX          (2 + REWIND_PAGE_SIZE + 3 * 2)
+
+static int rw_enable;
+
+// CPU registers at the last frame, which the mirror matches
+static snapshot_header_type rw_cpu;
+
+// Offsets of the records in the ring buffer, oldest first
+static u32 rec_offset[REWIND_MAX_FRAMES];
+static int rec_first;
+static int rec_count;
+static u32 rw_head;
+static u32 rw_used;
+
+static u8 last_frame;
+static u32 map[MAP_WORDS];
+static u32 page_buf[REWIND_PAGE_SIZE / 4];
+
+static u32 total_frames;
+static u32 total_pages;
+static u32 total_bytes;
+static u32 missed_frames;
+static u32 last_time;
+static u32 max_time;
+
+static u32 elapsed_us(XTime start) {
+	XTime now;
+	XTime_GetTime(&now);
+	return (u32) ((now - start) * 1000000 / COUNTS_PER_SECOND);
+}
+
+static int page_tracked(int page) {
+	if (page >= COPRO_PAGE && page < COPRO_PAGE + COPRO_PAGES) {
+		return 0;
+	}
+	// JIM RAM is immediately followed by the snapshot buffers
+	if (page >= JIM_RAM_PAGE && page < SHADOW_PAGE) {
+		return 0;
+	}
+	return 1;
+}
+
+// ============================================================
+// Dirty page map
+// ============================================================
+
+static void read_map() {
+	for (int i = 0; i < MAP_WORDS; i++) {
+		Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE | (i << SNAP_CTRL_DIRTY_SHIFT));
+		// The index is resynchronised to the core's clock, so the first
+		// read may still return the previous word
+		Xil_In32(GPIO_DIRTY_MAP);
+		map[i] = Xil_In32(GPIO_DIRTY_MAP);
+	}
+}
+
+// Only safe while frozen, as a write at the same time would be lost
+static void clear_map() {
+	Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE | SNAP_CTRL_DIRTY_CLEAR);
+	Xil_In32(GPIO_DIRTY_MAP);
+	Xil_In32(GPIO_DIRTY_MAP);
+	Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE);
+}
+
+static int page_dirty(const u32 *m, int page) {
+	return (m[page >> 5] >> (page & 31)) & 1;
+}
+
+// ============================================================
+// Ring buffer
+// ============================================================
+
+static rewind_record_type *record(int i) {
+	return (rewind_record_type *) (REWIND_BUFFER + rec_offset[(rec_first + i) % REWIND_MAX_FRAMES]);
+}
+
+static void drop_oldest() {
+	rw_used -= record(0)->size;
+	rec_first = (rec_first + 1) % REWIND_MAX_FRAMES;
+	rec_count--;
+}
+
+static void drop_newest() {
+	rewind_record_type *rec = record(rec_count - 1);
+	rw_head = (u8 *) rec - REWIND_BUFFER;
+	rw_used -= rec->size;
+	rec_count--;
+}
+
+// Make room for a record of up to size bytes at the head
+static rewind_record_type *reserve(u32 size) {
+	if (rec_count == REWIND_MAX_FRAMES) {
+		drop_oldest();
+	}
+	// Records between the head and the end of the buffer are the oldest,
+	// so have to go before wrapping around
+	if (rw_head + size > REWIND_BUFFER_SIZE) {
+		while (rec_count > 0 && rec_offset[rec_first] >= rw_head) {
+			drop_oldest();
+		}
+		rw_head = 0;
+	}
+	while (rec_count > 0 && rec_offset[rec_first] >= rw_head && rec_offset[rec_first] < rw_head + size) {
+		drop_oldest();
+	}
+	return (rewind_record_type *) (REWIND_BUFFER + rw_head);
+}
+
+static void push(rewind_record_type *rec) {
+	rec_offset[(rec_first + rec_count) % REWIND_MAX_FRAMES] = rw_head;
+	rec_count++;
+	rw_head += rec->size;
+	rw_used += rec->size;
+}
+
+// ============================================================
+// Delta encoding
+// ============================================================
+
+// Append the old values of the bytes that have changed in a page, and
+// update the mirror. Returns dst unchanged if nothing has changed.
+static u8 *encode_page(u8 *dst, int page) {
+	u8 *mirror = REWIND_MIRROR + page * REWIND_PAGE_SIZE;
+	u8 *live = (u8 *) page_buf;
+	u32 addr = BEEB_MEM_ADDR + page * REWIND_PAGE_SIZE;
+	u8 *p = dst + 2;
+	int i = 0;
+	for (int w = 0; w < REWIND_PAGE_SIZE / 4; w++) {
+		page_buf[w] = Xil_In32(addr + w * 4);
+	}
+	while (i < REWIND_PAGE_SIZE) {
+		int start = i;
+		int last = i;
+		if (mirror[i] == live[i]) {
+			i++;
+			continue;
+		}
+		for (int j = i + 1; j < REWIND_PAGE_SIZE && j - start < 255 && j - last <= RUN_GAP; j++) {
+			if (mirror[j] != live[j]) {
+				last = j;
+			}
+		}
+		*p++ = start;
+		*p++ = last - start + 1;
+		memcpy(p, mirror + start, last - start + 1);
+		memcpy(mirror + start, live + start, last - start + 1);
+		p += last - start + 1;
+		i = last + 1;
+	}
+	if (p == dst + 2) {
+		return dst;
+	}
+	dst[0] = page & 0xFF;
+	dst[1] = page >> 8;
+	*p++ = 0;
+	*p++ = 0;
+	return p;
+}
+
+// Put the old values back into the mirror, marking the pages as touched
+static void undo_record(rewind_record_type *rec, u32 *touched) {
+	u8 *src = (u8 *) (rec + 1);
+	for (u32 i = 0; i < rec->pages; i++) {
+		int page = src[0] | (src[1] << 8);
+		u8 *mirror = REWIND_MIRROR + page * REWIND_PAGE_SIZE;
+		touched[page >> 5] |= 1 << (page & 31);
+		src += 2;
+		while (src[1]) {
+			memcpy(mirror + src[0], src + 2, src[1]);
+			src += 2 + src[1];
+		}
+		src += 2;
+	}
+}
+
+// ============================================================
+// Capture
+// ============================================================
+
+static int capture() {
+	rewind_record_type *rec;
+	snapshot_header_type cpu;
+	XTime start;
+	u8 *dst;
+	int n = 0;
+	int ret;
+	if (snapshot_freeze() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&start);
+	ret = snapshot_capture(&cpu);
+	if (ret == XST_SUCCESS) {
+		read_map();
+		for (int page = 0; page < REWIND_NUM_PAGES; page++) {
+			if (page_dirty(map, page) && page_tracked(page)) {
+				n++;
+			}
+		}
+		rec = reserve(sizeof(rewind_record_type) + n * PAGE_MAX);
+		rec->cpu = rw_cpu;
+		rec->pages = 0;
+		dst = (u8 *) (rec + 1);
+		for (int page = 0; page < REWIND_NUM_PAGES; page++) {
+			if (page_dirty(map, page) && page_tracked(page)) {
+				u8 *next = encode_page(dst, page);
+				if (next != dst) {
+					rec->pages++;
+					dst = next;
+				}
+			}
+		}
+		// Keep the records word aligned
+		rec->size = ((dst - (u8 *) rec) + 3) & ~3;
+		push(rec);
+		rw_cpu = cpu;
+		clear_map();
+		total_frames++;
+		total_pages += rec->pages;
+		total_bytes += rec->size;
+	}
+	last_time = elapsed_us(start);
+	if (last_time > max_time) {
+		max_time = last_time;
+	}
+	snapshot_resume();
+	return ret;
+}
+
+// ============================================================
+// Public interface
+// ============================================================
+
+void rewind_init() {
+	rw_enable = 0;
+	rec_first = 0;
+	rec_count = 0;
+	rw_head = 0;
+	rw_used = 0;
+}
+
+int rewind_enable(int enable) {
+	int ret;
+	rw_enable = 0;
+	if (!enable) {
+		return XST_SUCCESS;
+	}
+	rewind_init();
+	total_frames = 0;
+	total_pages = 0;
+	total_bytes = 0;
+	missed_frames = 0;
+	max_time = 0;
+	// Start the history with a full copy of the memory
+	if (snapshot_freeze() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	ret = snapshot_capture(&rw_cpu);
+	if (ret == XST_SUCCESS) {
+		ret = dma_copy(REWIND_MIRROR_ADDR, BEEB_MEM_ADDR, SNAP_MEM_SIZE);
+	}
+	clear_map();
+	last_frame = keyboard_frame_count();
+	snapshot_resume();
+	rw_enable = (ret == XST_SUCCESS);
+	return ret;
+}
+
+int rewind_enabled() {
+	return rw_enable;
+}
+
+// Called from the main loop, capturing once per frame
+void rewind_poll() {
+	u8 frame;
+	if (!rw_enable) {
+		return;
+	}
+	frame = keyboard_frame_count();
+	if (frame == last_frame) {
+		return;
+	}
+	missed_frames += (u8) (frame - last_frame - 1);
+	last_frame = frame;
+	if (capture() != XST_SUCCESS) {
+		printf("Rewind: capture failed, disabled\r\n");
+		rw_enable = 0;
+	}
+}
+
+int rewind_back(int frames) {
+	u32 touched[MAP_WORDS];
+	int ret;
+	if (!rw_enable) {
+		printf("Rewind: not enabled\r\n");
+		return XST_FAILURE;
+	}
+	if (frames > rec_count) {
+		frames = rec_count;
+	}
+	if (frames <= 0) {
+		printf("Rewind: no history\r\n");
+		return XST_FAILURE;
+	}
+	if (snapshot_freeze() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	// Pages written since the last frame also have to be put back
+	read_map();
+	memcpy(touched, map, sizeof(touched));
+	for (int i = 0; i < frames; i++) {
+		rewind_record_type *rec = record(rec_count - 1);
+		undo_record(rec, touched);
+		rw_cpu = rec->cpu;
+		drop_newest();
+	}
+	for (int page = 0; page < REWIND_NUM_PAGES; page++) {
+		if (page_dirty(touched, page) && page_tracked(page)) {
+			u32 *src = (u32 *) (REWIND_MIRROR + page * REWIND_PAGE_SIZE);
+			u32 addr = BEEB_MEM_ADDR + page * REWIND_PAGE_SIZE;
+			for (int w = 0; w < REWIND_PAGE_SIZE / 4; w++) {
+				Xil_Out32(addr + w * 4, src[w]);
+			}
+		}
+	}
+	ret = snapshot_load(&rw_cpu, REWIND_MIRROR + SNAP_SHADOW);
+	clear_map();
+	last_frame = keyboard_frame_count();
+	snapshot_resume();
+	if (ret != XST_SUCCESS) {
+		printf("Rewind: restore failed, disabled\r\n");
+		rw_enable = 0;
+	}
+	return ret;
+}
+
+void rewind_print_status() {
+	if (!rw_enable) {
+		printf("Rewind: off\r\n");
+		return;
+	}
+	printf("Rewind: %d frames, %lu of %lu bytes used\r\n", rec_count, rw_used, (u32) REWIND_BUFFER_SIZE);
+	if (total_frames) {
+		printf("  average %lu pages, %lu bytes per frame\r\n",
+				total_pages / total_frames, total_bytes / total_frames);
+	}
+	printf("  last capture %lu us, max %lu us, %lu frames missed\r\n", last_time, max_time, missed_frames);
+}
@@ -0,0 +1,37 @@
+/*
+ * BeebFPGA Application
+ *
+ * Rewind
+ *
+ * Keeps a rolling history of the machine's state, one entry per video
+ * frame, so it can be stepped back a number of frames. Only the 256 byte
+ * pages written since the previous frame are stored, using the dirty page
+ * map in bbc_micro_pynqz2.vhd, and then only the bytes that changed.
+ */
+
+#ifndef __REWIND_H_
+#define __REWIND_H_
+
+#include "xil_types.h"
+
+// AXI Register (axi_gpio_3) that returns one word of the dirty page map
+#define GPIO_DIRTY_MAP        0x41230000
+
+// Dirty page map control, in the snapshot control register
+#define SNAP_CTRL_DIRTY_CLEAR (1 << 2)
+#define SNAP_CTRL_DIRTY_SHIFT 16
+
+#define REWIND_PAGE_SIZE      256
+#define REWIND_NUM_PAGES      (0x80000 / REWIND_PAGE_SIZE)
+
+// Upper limit on the history (one minute at 50Hz)
+#define REWIND_MAX_FRAMES     3000
+
+void rewind_init();
+int  rewind_enable(int enable);
+int  rewind_enabled();
+void rewind_poll();
+int  rewind_back(int frames);
+void rewind_print_status();
+
+#endif
@@ -0,0 +1,447 @@
+/*
+ * BeebFPGA Application
+ *
+ * ROM Sets
+ *
+ * The ROM images of a profile are assembled in a DDR staging buffer that
+ * mirrors the ROM areas of the BBC's memory, so nothing is changed if any
+ * of them can't be loaded. The areas are then DMA'd into the BBC's memory
+ * with CTRL-BREAK held in the emulated keyboard matrix, which keeps the
+ * CPU in reset while the ROMs change, and then makes the MOS do a hard
+ * reset, rebuilding its ROM table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "memmap.h"
+#include "sdcard.h"
+#include "dma.h"
+#include "keyboard.h"
+#include "rewind.h"
+#include "plconfig.h"
+#include "romset.h"
+
+#define ROMSET_MANIFEST_SIZE 0x2000
+#define ROMSET_MAX_LINES     256
+#define ROMSET_NAME_SIZE     32
+
+// Where the ROM slots are in the BBC's memory (see bbc_micro_core.vhd)
+#define ROMSET_SLOT0_OFFSET  0x00000
+#define ROMSET_MOS_OFFSET    0x10000
+#define ROMSET_SLOT8_OFFSET  0x20000
+#define ROMSET_SLOT4_OFFSET  0x50000
+
+// BREAK is held for a while before the ROMs are written, and CTRL for a
+// while after BREAK is released, for the MOS to see it during the reset
+#define ROMSET_BREAK_MS      20
+#define ROMSET_CTRL_MS       250
+
+#define ROMSET_STAGE         ((u8 *) ROMSET_BUFFER_ADDR)
+
+typedef struct {
+	u32 offset;
+	u32 size;
+} region_type;
+
+// Areas of the BBC's memory that hold ROM slots, each copied as a whole
+static const region_type regions[] = {
+	{ROMSET_SLOT0_OFFSET, 5 * ROMSET_BANK_SIZE}, // slots 0-3, then the MOS
+	{ROMSET_SLOT8_OFFSET, 8 * ROMSET_BANK_SIZE}, // slots 8-15
+	{ROMSET_SLOT4_OFFSET, 4 * ROMSET_BANK_SIZE}  // slots 4-7 (sideways RAM)
+};
+
+#define NUM_REGIONS (sizeof(regions) / sizeof(regions[0]))
+
+typedef struct {
+	char *text;
+	int profile;
+} line_type;
+
+static char manifest[ROMSET_MANIFEST_SIZE];
+static line_type lines[ROMSET_MAX_LINES];
+static int num_lines;
+
+static char current[ROMSET_NAME_SIZE];
+static int num_roms;
+static u32 load_time;
+static u32 pl_count;
+
+static void wait_ms(u32 ms) {
+	XTime start;
+	XTime now;
+	XTime_GetTime(&start);
+	do {
+		XTime_GetTime(&now);
+	} while (now - start < (XTime) ms * (COUNTS_PER_SECOND / 1000));
+}
+
+static u32 elapsed_us(XTime start) {
+	XTime now;
+	XTime_GetTime(&now);
+	return (u32) ((now - start) * 1000000 / COUNTS_PER_SECOND);
+}
+
+// Return the next line, without any comment or surrounding space, or NULL
+// at the end of the manifest
+static char *next_line(char **p) {
+	char *line = *p;
+	char *end;
+	if (!*line) {
+		return NULL;
+	}
+	end = strchr(line, '\n');
+	if (end) {
+		*end = 0;
+		*p = end + 1;
+	} else {
+		*p = line + strlen(line);
+	}
+	end = strchr(line, '#');
+	if (end) {
+		*end = 0;
+	}
+	while (isspace((int) *line)) {
+		line++;
+	}
+	end = line + strlen(line);
+	while (end > line && isspace((int) end[-1])) {
+		*--end = 0;
+	}
+	return line;
+}
+
+// Split off the first word of a line, returning the remainder
+static char *split(char *line) {
+	while (*line && !isspace((int) *line)) {
+		line++;
+	}
+	if (*line) {
+		*line++ = 0;
+	}
+	while (isspace((int) *line)) {
+		line++;
+	}
+	return line;
+}
+
+// Read the manifest, and split it into non-blank lines
+static int read_manifest(int quiet) {
+	FIL fil;
+	UINT br = 0;
+	FRESULT rc;
+	char *p = manifest;
+	char *line;
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	rc = f_open(&fil, ROMSET_DEFAULT_FILE, FA_READ);
+	if (rc != FR_OK) {
+		if (!quiet) {
+			printf("ROM set: unable to open %s (%d)\r\n", ROMSET_DEFAULT_FILE, rc);
+		}
+		return XST_FAILURE;
+	}
+	rc = f_read(&fil, manifest, ROMSET_MANIFEST_SIZE - 1, &br);
+	f_close(&fil);
+	if (rc != FR_OK) {
+		printf("ROM set: read error on %s (%d)\r\n", ROMSET_DEFAULT_FILE, rc);
+		return XST_FAILURE;
+	}
+	manifest[br] = 0;
+	num_lines = 0;
+	while ((line = next_line(&p)) != NULL) {
+		int len = strlen(line);
+		if (!len) {
+			continue;
+		}
+		if (num_lines == ROMSET_MAX_LINES) {
+			printf("ROM set: too many lines in %s\r\n", ROMSET_DEFAULT_FILE);
+			return XST_FAILURE;
+		}
+		lines[num_lines].profile = (line[0] == '[' && line[len - 1] == ']');
+		if (lines[num_lines].profile) {
+			line[len - 1] = 0;
+			line++;
+		}
+		lines[num_lines++].text = line;
+	}
+	return XST_SUCCESS;
+}
+
+// The profile named by the default line, else the first one
+static const char *default_profile() {
+	const char *first = NULL;
+	for (int i = 0; i < num_lines; i++) {
+		if (lines[i].profile) {
+			if (!first) {
+				first = lines[i].text;
+			}
+		} else if (!strncmp(lines[i].text, "default", 7) && isspace((int) lines[i].text[7])) {
+			return lines[i].text + 8 + strspn(lines[i].text + 8, " \t");
+		}
+	}
+	return first;
+}
+
+// The argument of a "<name> <arg>" line, or NULL if it's not one
+static const char *directive(const char *text, const char *name) {
+	int len = strlen(name);
+	if (strncmp(text, name, len) || !isspace((int) text[len])) {
+		return NULL;
+	}
+	return text + len + strspn(text + len, " \t");
+}
+
+// Read every bitstream the manifest names into the cache, so switching
+// profiles later doesn't wait for the SD card
+static void cache_bitstreams() {
+	const char *path;
+	for (int i = 0; i < num_lines; i++) {
+		if (!lines[i].profile && (path = directive(lines[i].text, "bitstream")) != NULL) {
+			plconfig_cache(path);
+		}
+	}
+}
+
+static u32 slot_offset(int slot) {
+	if (slot == ROMSET_MOS) {
+		return ROMSET_MOS_OFFSET;
+	} else if (slot < 4) {
+		return ROMSET_SLOT0_OFFSET + slot * ROMSET_BANK_SIZE;
+	} else if (slot < 8) {
+		return ROMSET_SLOT4_OFFSET + (slot - 4) * ROMSET_BANK_SIZE;
+	} else {
+		return ROMSET_SLOT8_OFFSET + (slot - 8) * ROMSET_BANK_SIZE;
+	}
+}
+
+// A sideways ROM has a pointer at offset 7 to "\0(C)"
+static int rom_header_ok(const u8 *rom) {
+	u8 copyright = rom[7];
+	return rom[copyright] == 0 && !memcmp(rom + copyright + 1, "(C)", 3);
+}
+
+static int load_rom(int slot, const char *path) {
+	u8 *rom = ROMSET_STAGE + slot_offset(slot);
+	FIL fil;
+	UINT br = 0;
+	FRESULT rc;
+	rc = f_open(&fil, path, FA_READ);
+	if (rc != FR_OK) {
+		printf("ROM set: unable to open %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	if (f_size(&fil) > ROMSET_BANK_SIZE) {
+		printf("ROM set: %s is larger than 16KB\r\n", path);
+		f_close(&fil);
+		return XST_FAILURE;
+	}
+	rc = f_read(&fil, rom, ROMSET_BANK_SIZE, &br);
+	f_close(&fil);
+	if (rc != FR_OK || br == 0) {
+		printf("ROM set: read error on %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	// An 8KB ROM appears twice, as it would in a 16KB socket
+	if (br == ROMSET_BANK_SIZE / 2) {
+		memcpy(rom + br, rom, br);
+	}
+	if (slot != ROMSET_MOS && !rom_header_ok(rom)) {
+		printf("ROM set: warning, %s has no ROM header\r\n", path);
+	}
+	return XST_SUCCESS;
+}
+
+// Copy the staging buffer into the BBC's memory, and reset the BBC
+static int install() {
+	u32 words[4] = {0, 0, 0, 0};
+	int ret = XST_SUCCESS;
+	words[0] |= 1 << BBC_KEY_CTRL;
+	words[BBC_KEY_BREAK >> 5] |= 1 << (BBC_KEY_BREAK & 0x1F);
+	keyboard_set(KEYB_SRC_ROMSET, words);
+	wait_ms(ROMSET_BREAK_MS);
+	for (int i = 0; i < NUM_REGIONS && ret == XST_SUCCESS; i++) {
+		ret = dma_copy(BEEB_MEM_ADDR + regions[i].offset,
+				ROMSET_BUFFER_ADDR + regions[i].offset, regions[i].size);
+	}
+	words[BBC_KEY_BREAK >> 5] = 0;
+	keyboard_set(KEYB_SRC_ROMSET, words);
+	wait_ms(ROMSET_CTRL_MS);
+	words[0] = 0;
+	keyboard_set(KEYB_SRC_ROMSET, words);
+	// The ROMs changed behind the dirty page map, so start a new history
+	if (rewind_enabled()) {
+		rewind_enable(1);
+	}
+	return ret;
+}
+
+static int load_profile(const char *profile, int at_boot) {
+	u32 loaded = 0;
+	int in_profile = 0;
+	int found = 0;
+	int n = 0;
+	int master = 1;
+	const char *bitstream = NULL;
+	XTime start;
+	XTime_GetTime(&start);
+	for (int i = 0; i < NUM_REGIONS; i++) {
+		memset(ROMSET_STAGE + regions[i].offset, 0, regions[i].size);
+	}
+	for (int i = 0; i < num_lines; i++) {
+		char *word = lines[i].text;
+		char *path;
+		char *end;
+		int slot;
+		if (lines[i].profile) {
+			in_profile = !strcmp(word, profile);
+			found |= in_profile;
+			continue;
+		}
+		if (!in_profile) {
+			continue;
+		}
+		path = split(word);
+		if (!strcmp(word, "bitstream")) {
+			if (!*path) {
+				printf("ROM set: no file for the bitstream in profile %s\r\n", profile);
+				return XST_FAILURE;
+			}
+			bitstream = path;
+			continue;
+		}
+		if (!strcmp(word, "model")) {
+			if (!strcmp(path, "master")) {
+				master = 1;
+			} else if (!strcmp(path, "b")) {
+				master = 0;
+			} else {
+				printf("ROM set: bad model %s in profile %s\r\n", path, profile);
+				return XST_FAILURE;
+			}
+			continue;
+		}
+		if (!strcmp(word, "mos")) {
+			slot = ROMSET_MOS;
+		} else {
+			slot = strtoul(word, &end, 0);
+			if (!isdigit((int) *word) || *end || slot >= ROMSET_NUM_SLOTS) {
+				printf("ROM set: bad slot %s in profile %s\r\n", word, profile);
+				return XST_FAILURE;
+			}
+		}
+		if (!*path) {
+			printf("ROM set: no file for slot %s in profile %s\r\n", word, profile);
+			return XST_FAILURE;
+		}
+		if (loaded & (1 << slot)) {
+			printf("ROM set: slot %s used twice in profile %s\r\n", word, profile);
+			return XST_FAILURE;
+		}
+		if (load_rom(slot, path) != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		loaded |= 1 << slot;
+		n++;
+	}
+	if (!found) {
+		printf("ROM set: no profile %s in %s\r\n", profile, ROMSET_DEFAULT_FILE);
+		return XST_FAILURE;
+	}
+	if (!(loaded & (1 << ROMSET_MOS))) {
+		printf("ROM set: profile %s has no MOS\r\n", profile);
+		return XST_FAILURE;
+	}
+	// Reconfigure the PL first, as that reloads the BBC's memory. At boot
+	// the PL was just loaded from BOOT.BIN, so it's taken to be the default
+	// profile's bitstream. A bitstream that can't be read leaves the PL as
+	// it is, rather than losing the ROMs as well.
+	if (bitstream && strcmp(bitstream, plconfig_current())) {
+		if (at_boot) {
+			plconfig_set_current(bitstream);
+		} else if (plconfig_cache(bitstream) != XST_SUCCESS) {
+			printf("ROM set: keeping the current PL, as %s can't be read\r\n", bitstream);
+		} else if (plconfig_program(bitstream) != XST_SUCCESS) {
+			current[0] = 0;
+			return XST_FAILURE;
+		}
+	}
+	// The MOS can't run on the wrong machine, so don't reset into it
+	if (!master != !(keyboard_status() & KEYB_STATUS_MASTER)) {
+		printf("ROM set: profile %s is for the %s, but the PL is a %s build\r\n", profile,
+				master ? "Master" : "Model B", master ? "Model B" : "Master");
+		return XST_FAILURE;
+	}
+	if (install() != XST_SUCCESS) {
+		printf("ROM set: unable to copy the ROMs into the BBC's memory\r\n");
+		current[0] = 0;
+		return XST_FAILURE;
+	}
+	strncpy(current, profile, ROMSET_NAME_SIZE - 1);
+	current[ROMSET_NAME_SIZE - 1] = 0;
+	num_roms = n;
+	pl_count = plconfig_count();
+	load_time = elapsed_us(start);
+	return XST_SUCCESS;
+}
+
+// Load the default profile, if there's a manifest on the SD card
+void romset_init() {
+	const char *profile;
+	current[0] = 0;
+	num_roms = 0;
+	if (read_manifest(1) != XST_SUCCESS) {
+		return;
+	}
+	cache_bitstreams();
+	profile = default_profile();
+	if (profile && load_profile(profile, 1) == XST_SUCCESS) {
+		romset_print_status();
+	}
+}
+
+// Load a profile (the default if NULL), re-reading the manifest first
+int romset_load(const char *profile) {
+	if (read_manifest(0) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	if (!profile) {
+		profile = default_profile();
+		if (!profile) {
+			printf("ROM set: no profiles in %s\r\n", ROMSET_DEFAULT_FILE);
+			return XST_FAILURE;
+		}
+	}
+	return load_profile(profile, 0);
+}
+
+void romset_list() {
+	const char *def;
+	if (read_manifest(0) != XST_SUCCESS) {
+		return;
+	}
+	def = default_profile();
+	for (int i = 0; i < num_lines; i++) {
+		if (lines[i].profile) {
+			printf("  %-16s%s%s\r\n", lines[i].text,
+					(def && !strcmp(lines[i].text, def)) ? " (default)" : "",
+					!strcmp(lines[i].text, current) ? " (loaded)" : "");
+		}
+	}
+}
+
+void romset_print_status() {
+	// Reconfiguring the PL from the console brings back its own ROMs
+	if (current[0] && pl_count != plconfig_count()) {
+		current[0] = 0;
+	}
+	if (!current[0]) {
+		printf("ROM set: as built into the bitstream\r\n");
+		return;
+	}
+	printf("ROM set: %s, %d ROMs loaded in %lu us\r\n", current, num_roms, load_time);
+}
@@ -0,0 +1,45 @@
+/*
+ * BeebFPGA Application
+ *
+ * ROM Sets
+ *
+ * The ROMs are normally part of the bitstream (see make_rom_image_pynqz2.sh
+ * in roms). A manifest on the SD card can instead name a set of ROM images
+ * for each of a number of profiles, which are loaded into the BBC's memory
+ * at boot, or on request from the console, without rebuilding anything.
+ * A profile can also name a bitstream, so switching profile can switch
+ * between Model B and Master builds (see plconfig.h).
+ *
+ * Manifest format (see roms/romset_pynqz2.txt for an example):
+ *
+ *   # comment
+ *   default <profile>        profile loaded at boot (else the first)
+ *   [<profile>]              starts a profile
+ *   bitstream <path>         PL bitstream (.bit or .bin), else left as is
+ *   model b|master           the machine the ROMs are for (default master)
+ *   mos <path>               the MOS
+ *   <slot> <path>            sideways ROM slot 0-15 (4-7 are sideways RAM)
+ *
+ * Slots not named by the profile are cleared. A profile whose model doesn't
+ * match the PL (once its bitstream, if any, is loaded) is refused, as e.g.
+ * OS 1.2 hangs on a Master build (IncludeMaster). The bitstreams named
+ * anywhere in the manifest are cached at boot.
+ */
+
+#ifndef __ROMSET_H_
+#define __ROMSET_H_
+
+#include "xil_types.h"
+
+#define ROMSET_DEFAULT_FILE "0:/ROMSET.TXT"
+
+#define ROMSET_BANK_SIZE    0x4000
+#define ROMSET_NUM_SLOTS    16
+#define ROMSET_MOS          ROMSET_NUM_SLOTS
+
+void romset_init();
+int  romset_load(const char *profile);
+void romset_list();
+void romset_print_status();
+
+#endif
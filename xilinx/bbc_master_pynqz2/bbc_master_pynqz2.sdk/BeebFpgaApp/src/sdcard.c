@@ -0,0 +1,29 @@
+/*
+ * BeebFPGA Application
+ *
+ * SD Card (FatFs) access
+ *
+ * The card is mounted on first use, so the App still boots (and the
+ * keyboard still works) when booted from QSPI with no card present.
+ */
+
+#include <stdio.h>
+#include "xstatus.h"
+#include "sdcard.h"
+
+static FATFS fatfs;
+static int mounted = 0;
+
+int sd_mount() {
+	FRESULT rc;
+	if (!mounted) {
+		rc = f_mount(&fatfs, "0:/", 1);
+		if (rc != FR_OK) {
+			printf("SD: mount failed (%d)\r\n", rc);
+			return XST_FAILURE;
+		}
+		mounted = 1;
+	}
+	return XST_SUCCESS;
+}
+
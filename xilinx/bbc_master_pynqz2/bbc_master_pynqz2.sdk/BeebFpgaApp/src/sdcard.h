@@ -0,0 +1,14 @@
+/*
+ * BeebFPGA Application
+ *
+ * SD Card (FatFs) access
+ */
+
+#ifndef __SDCARD_H_
+#define __SDCARD_H_
+
+#include "ff.h"
+
+int sd_mount();
+
+#endif
@@ -0,0 +1,479 @@
+/*
+ * BeebFPGA Application
+ *
+ * Save States
+ *
+ * Saving:
+ * - freeze the core at an instruction boundary
+ * - inject a program that pushes the CPU registers (and reads the VIA
+ *   interrupt enables) into the capture buffer
+ * - inject a program that puts the CPU registers back
+ * - DMA the whole 512KB memory into DDR
+ *
+ * Restoring:
+ * - freeze the core, and DMA the memory back
+ * - inject a program that rewrites the device registers from the shadow
+ *   copies, then reloads the CPU registers and jumps to the saved PC
+ *
+ * The injected programs are fed to the CPU one byte per read cycle, so
+ * every dummy read has to be accounted for. Only instructions with the
+ * same bus cycles on the 6502 and 65C02 are used.
+ *
+ * A snapshot records the machine (Model B or Master) it was taken on, and
+ * is only restored onto the same one, as the memory map and the device
+ * registers differ.
+ *
+ * Not captured: the VIA timer counters (restarted from their latches),
+ * pending VIA interrupt flags, the shift registers, Video NuLA's extended
+ * registers and the Co Processor.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "xil_io.h"
+#include "xstatus.h"
+#include "xtime_l.h"
+#include "memmap.h"
+#include "keyboard.h"
+#include "sdcard.h"
+#include "dma.h"
+#include "snapshot.h"
+
+#define SNAPSHOT_MAGIC     "BEEBSNAP"
+#define SNAPSHOT_VERSION   2
+
+// Freezing waits for the current instruction, so is normally immediate
+#define SNAP_TIMEOUT       (COUNTS_PER_SECOND / 10)
+
+#define SNAPSHOT_HEADER    ((snapshot_header_type *) SNAPSHOT_ADDR)
+#define SNAPSHOT_SHADOW    ((u8 *) (SNAPSHOT_MEM + SNAP_SHADOW))
+
+// 6502 opcodes
+#define OP_JSR             0x20
+#define OP_PHP             0x08
+#define OP_PLP             0x28
+#define OP_JMP             0x4C
+#define OP_STA             0x8D
+#define OP_STX             0x8E
+#define OP_STY             0x8C
+#define OP_LDA_ABS         0xAD
+#define OP_LDA_IMM         0xA9
+#define OP_LDX_IMM         0xA2
+#define OP_LDY_IMM         0xA0
+#define OP_TSX             0xBA
+#define OP_TXS             0x9A
+
+// Device registers
+#define CRTC_ADDR          0xFE00
+#define CRTC_DATA          0xFE01
+#define ULA_CTRL           0xFE20
+#define ULA_PALETTE        0xFE21
+#define ROMSEL             0xFE30
+#define ACCCON             0xFE34
+#define SYS_VIA            0xFE40
+#define USER_VIA           0xFE60
+#define JIM_PAGE           0xFCFF
+
+#define VIA_ORB            0x0
+#define VIA_DDRB           0x2
+#define VIA_DDRA           0x3
+#define VIA_T1CL           0x4
+#define VIA_T1CH           0x5
+#define VIA_T2CL           0x8
+#define VIA_T2CH           0x9
+#define VIA_ACR            0xB
+#define VIA_PCR            0xC
+#define VIA_IFR            0xD
+#define VIA_IER            0xE
+#define VIA_ORA_NH         0xF
+
+#define IER_T2             0x20
+
+static u8 prog[SNAP_INJECT_SIZE];
+static int prog_len;
+
+static int snap_valid;
+static u32 save_time;
+static u32 restore_time;
+
+static const char *model_names[] = { "Model B", "Master" };
+
+// The machine the PL was built as
+static u8 current_model() {
+	return (keyboard_status() & KEYB_STATUS_MASTER) ? SNAP_MODEL_MASTER : SNAP_MODEL_B;
+}
+
+static u32 elapsed_us(XTime start) {
+	XTime now;
+	XTime_GetTime(&now);
+	return (u32) ((now - start) * 1000000 / COUNTS_PER_SECOND);
+}
+
+static int wait_status(u32 mask, u32 value) {
+	XTime start;
+	XTime now;
+	XTime_GetTime(&start);
+	while ((keyboard_status() & mask) != value) {
+		XTime_GetTime(&now);
+		if (now - start > SNAP_TIMEOUT) {
+			return XST_FAILURE;
+		}
+	}
+	return XST_SUCCESS;
+}
+
+// ============================================================
+// Injected program generation
+// ============================================================
+
+// Every byte is one CPU read cycle
+static void emit(u8 b) {
+	if (prog_len < SNAP_INJECT_SIZE) {
+		prog[prog_len] = b;
+	}
+	prog_len++;
+}
+
+// Absolute addressing: three reads, then the access itself, which only
+// uses a byte if it's a read outside of the IO region
+static void emit_abs(u8 op, u16 addr) {
+	emit(op);
+	emit(addr & 0xFF);
+	emit(addr >> 8);
+}
+
+// Implied addressing: a dummy read follows the opcode
+static void emit_implied(u8 op) {
+	emit(op);
+	emit(0);
+}
+
+static void emit_write(u16 addr, u8 value) {
+	emit(OP_LDA_IMM);
+	emit(value);
+	emit_abs(OP_STA, addr);
+}
+
+static void emit_cpu(snapshot_header_type *hdr) {
+	// PLP pulls from S + 1, so start one lower
+	emit(OP_LDX_IMM);
+	emit(hdr->s - 1);
+	emit_implied(OP_TXS);
+	emit(OP_LDA_IMM);
+	emit(hdr->a);
+	emit(OP_LDX_IMM);
+	emit(hdr->x);
+	emit(OP_LDY_IMM);
+	emit(hdr->y);
+	// PLP: dummy read, dummy stack read, then the pull
+	emit_implied(OP_PLP);
+	emit(0);
+	emit(hdr->p);
+	emit_abs(OP_JMP, hdr->pc);
+}
+
+static void emit_via(u16 base, const u8 *sh, u8 ier) {
+	emit_write(base + VIA_DDRA, sh[VIA_DDRA]);
+	emit_write(base + VIA_ORA_NH, sh[1]);
+	emit_write(base + VIA_DDRB, sh[VIA_DDRB]);
+	if (base != SYS_VIA) {
+		// The System VIA's port B is restored through IC32
+		emit_write(base + VIA_ORB, sh[VIA_ORB]);
+	}
+	emit_write(base + VIA_ACR, sh[VIA_ACR]);
+	emit_write(base + VIA_PCR, sh[VIA_PCR]);
+	// Restart T1 from its latch (writing T1CH loads the counter)
+	emit_write(base + VIA_T1CL, sh[VIA_T1CL]);
+	emit_write(base + VIA_T1CH, sh[VIA_T1CH]);
+	// T2 is one shot, so only restart it if its interrupt is in use
+	emit_write(base + VIA_T2CL, sh[VIA_T2CL]);
+	if (ier & IER_T2) {
+		emit_write(base + VIA_T2CH, sh[VIA_T2CH]);
+	}
+	emit_write(base + VIA_IFR, 0x7F);
+	emit_write(base + VIA_IER, 0x7F);
+	emit_write(base + VIA_IER, 0x80 | ier);
+}
+
+// The sound chip is written through the slow data bus, with the write
+// enable in IC32 bit 0 (the System VIA's DDRA is restored afterwards)
+static void emit_sound(u8 value) {
+	emit_write(SYS_VIA + VIA_ORA_NH, value);
+	emit_write(SYS_VIA + VIA_ORB, 0x00);
+	emit_write(SYS_VIA + VIA_ORB, 0x08);
+}
+
+static void emit_devices(snapshot_header_type *hdr, const u8 *sh) {
+	// ACCCON first, as on a Model B &FE34 is another copy of ROMSEL
+	emit_write(ACCCON, sh[SH_ACCCON]);
+	emit_write(ROMSEL, sh[SH_ROMSEL]);
+	emit_write(JIM_PAGE, sh[SH_JIM_PAGE]);
+	// CRTC (R16/R17 are the read only light pen registers)
+	for (int r = 0; r < 16; r++) {
+		emit_write(CRTC_ADDR, r);
+		emit_write(CRTC_DATA, sh[SH_CRTC + r]);
+	}
+	emit_write(CRTC_ADDR, sh[SH_CRTC_ADDR]);
+	// ULA, skipping palette entries that have never been written
+	emit_write(ULA_CTRL, sh[SH_ULA_CTRL]);
+	for (int i = 0; i < 16; i++) {
+		u8 entry = sh[SH_PALETTE + i];
+		if ((entry >> 4) == i) {
+			emit_write(ULA_PALETTE, entry);
+		}
+	}
+	// Sound chip: a latch byte per register, plus the high bits of the tones
+	emit_write(SYS_VIA + VIA_DDRA, 0xFF);
+	emit_write(SYS_VIA + VIA_DDRB, 0x0F);
+	for (int r = 0; r < 8; r++) {
+		u8 latch = sh[SH_SOUND_LATCH + r];
+		u8 data = sh[SH_SOUND_DATA + r];
+		if ((latch & 0xF0) != (0x80 | (r << 4))) {
+			continue;
+		}
+		emit_sound(latch);
+		if (r < 6 && !(r & 1) && !(data & 0x80)) {
+			emit_sound(data);
+		}
+	}
+	// IC32 addressable latch, one bit per write to port B
+	for (int b = 0; b < 8; b++) {
+		u8 value = sh[SH_IC32 + b];
+		if ((value & 0x07) != b) {
+			// Default to sound and keyboard disabled
+			value = b | 0x08;
+		}
+		emit_write(SYS_VIA + VIA_ORB, value);
+	}
+	emit_via(SYS_VIA, sh + SH_SYS_VIA, hdr->ier[0]);
+	emit_via(USER_VIA, sh + SH_USER_VIA, hdr->ier[1]);
+}
+
+// ============================================================
+// Freezing and injection
+// ============================================================
+
+int snapshot_freeze() {
+	Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE);
+	if (wait_status(SNAP_STATUS_FROZEN, SNAP_STATUS_FROZEN) != XST_SUCCESS) {
+		printf("Snapshot: unable to freeze the CPU\r\n");
+		snapshot_resume();
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+void snapshot_resume() {
+	Xil_Out32(GPIO_SNAP_CTRL, 0);
+	wait_status(SNAP_STATUS_FROZEN, 0);
+}
+
+// Run the program in prog[] on the frozen CPU, leaving it frozen again
+static int inject() {
+	int ret;
+	if (prog_len > SNAP_INJECT_SIZE) {
+		printf("Snapshot: injected program too long (%d bytes)\r\n", prog_len);
+		return XST_FAILURE;
+	}
+	for (int i = 0; i < prog_len; i++) {
+		Xil_Out8(BEEB_MEM_ADDR + SNAP_INJECT_BUF + i, prog[i]);
+	}
+	Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE | SNAP_CTRL_INJECT | (prog_len << SNAP_CTRL_LEN_SHIFT));
+	ret = wait_status(SNAP_STATUS_DONE, SNAP_STATUS_DONE);
+	Xil_Out32(GPIO_SNAP_CTRL, SNAP_CTRL_FREEZE);
+	if (wait_status(SNAP_STATUS_DONE, 0) != XST_SUCCESS) {
+		ret = XST_FAILURE;
+	}
+	if (ret != XST_SUCCESS) {
+		printf("Snapshot: injection failed\r\n");
+	}
+	return ret;
+}
+
+static u8 captured(int i) {
+	return Xil_In8(BEEB_MEM_ADDR + SNAP_CAPTURE_BUF + i);
+}
+
+// Capture the CPU registers. This leaves them corrupted, so must be
+// followed by restoring them.
+static int capture_cpu(snapshot_header_type *hdr) {
+	prog_len = 0;
+	// JSR pushes PCH, PCL (the address of its last byte), after a dummy
+	// stack read, then reads the high byte of the target
+	emit(OP_JSR);
+	emit(0);
+	emit(0);
+	emit(0);
+	emit_abs(OP_STA, 0);
+	emit_abs(OP_STX, 0);
+	emit_abs(OP_STY, 0);
+	emit_implied(OP_PHP);
+	emit_implied(OP_TSX);
+	emit_abs(OP_STX, 0);
+	emit_abs(OP_LDA_ABS, SYS_VIA + VIA_IER);
+	emit_abs(OP_STA, 0);
+	emit_abs(OP_LDA_ABS, USER_VIA + VIA_IER);
+	emit_abs(OP_STA, 0);
+	if (inject() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	hdr->pc = ((captured(0) << 8) | captured(1)) - 2;
+	hdr->a = captured(2);
+	hdr->x = captured(3);
+	hdr->y = captured(4);
+	hdr->p = captured(5);
+	// TSX was after the two bytes pushed by JSR and one by PHP
+	hdr->s = captured(6) + 3;
+	hdr->ier[0] = captured(7) & 0x7F;
+	hdr->ier[1] = captured(8) & 0x7F;
+	return XST_SUCCESS;
+}
+
+// ============================================================
+// Public interface
+// ============================================================
+
+// Capture the registers of the frozen CPU, then put them back
+int snapshot_capture(snapshot_header_type *hdr) {
+	if (capture_cpu(hdr) != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	prog_len = 0;
+	emit_cpu(hdr);
+	return inject();
+}
+
+// Rewrite the device registers of the frozen core from the shadow copies,
+// then reload the CPU registers. The memory must already be in place.
+int snapshot_load(snapshot_header_type *hdr, const u8 *shadow) {
+	prog_len = 0;
+	emit_devices(hdr, shadow);
+	emit_cpu(hdr);
+	return inject();
+}
+
+int snapshot_save() {
+	snapshot_header_type *hdr = SNAPSHOT_HEADER;
+	XTime start;
+	int ret;
+	if (snapshot_freeze() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&start);
+	snap_valid = 0;
+	ret = snapshot_capture(hdr);
+	if (ret == XST_SUCCESS) {
+		ret = dma_copy(SNAPSHOT_MEM, BEEB_MEM_ADDR, SNAP_MEM_SIZE);
+	}
+	save_time = elapsed_us(start);
+	snapshot_resume();
+	if (ret != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	memcpy(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic));
+	hdr->version = SNAPSHOT_VERSION;
+	hdr->mem_size = SNAP_MEM_SIZE;
+	hdr->model = current_model();
+	snap_valid = 1;
+	return XST_SUCCESS;
+}
+
+int snapshot_restore() {
+	snapshot_header_type *hdr = SNAPSHOT_HEADER;
+	XTime start;
+	int ret;
+	if (!snap_valid) {
+		printf("Snapshot: nothing to restore\r\n");
+		return XST_FAILURE;
+	}
+	if (hdr->model != current_model()) {
+		printf("Snapshot: taken on a %s, but this is a %s\r\n",
+				hdr->model == SNAP_MODEL_MASTER ? model_names[1] : model_names[0],
+				model_names[current_model()]);
+		return XST_FAILURE;
+	}
+	if (snapshot_freeze() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&start);
+	ret = dma_copy(BEEB_MEM_ADDR, SNAPSHOT_MEM, SNAP_MEM_SIZE);
+	if (ret == XST_SUCCESS) {
+		ret = snapshot_load(hdr, SNAPSHOT_SHADOW);
+	}
+	restore_time = elapsed_us(start);
+	snapshot_resume();
+	return ret;
+}
+
+int snapshot_write(const char *path) {
+	FIL fil;
+	UINT bw = 0;
+	UINT bw2 = 0;
+	FRESULT rc;
+	if (!snap_valid) {
+		printf("Snapshot: nothing to write\r\n");
+		return XST_FAILURE;
+	}
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	rc = f_open(&fil, path, FA_WRITE | FA_CREATE_ALWAYS);
+	if (rc != FR_OK) {
+		printf("Snapshot: unable to create %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	rc = f_write(&fil, SNAPSHOT_HEADER, sizeof(snapshot_header_type), &bw);
+	if (rc == FR_OK) {
+		rc = f_write(&fil, (void *) SNAPSHOT_MEM, SNAP_MEM_SIZE, &bw2);
+	}
+	f_close(&fil);
+	if (rc != FR_OK || bw + bw2 != sizeof(snapshot_header_type) + SNAP_MEM_SIZE) {
+		printf("Snapshot: write error on %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	return XST_SUCCESS;
+}
+
+int snapshot_read(const char *path) {
+	snapshot_header_type *hdr = SNAPSHOT_HEADER;
+	FIL fil;
+	UINT br = 0;
+	FRESULT rc;
+	if (sd_mount() != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	rc = f_open(&fil, path, FA_READ);
+	if (rc != FR_OK) {
+		printf("Snapshot: unable to open %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	snap_valid = 0;
+	rc = f_read(&fil, hdr, sizeof(snapshot_header_type), &br);
+	if (rc != FR_OK || br != sizeof(snapshot_header_type) ||
+			memcmp(hdr->magic, SNAPSHOT_MAGIC, sizeof(hdr->magic)) ||
+			hdr->version != SNAPSHOT_VERSION || hdr->mem_size != SNAP_MEM_SIZE) {
+		printf("Snapshot: %s is not a version %d snapshot\r\n", path, SNAPSHOT_VERSION);
+		f_close(&fil);
+		return XST_FAILURE;
+	}
+	rc = f_read(&fil, (void *) SNAPSHOT_MEM, SNAP_MEM_SIZE, &br);
+	f_close(&fil);
+	if (rc != FR_OK || br != SNAP_MEM_SIZE) {
+		printf("Snapshot: read error on %s (%d)\r\n", path, rc);
+		return XST_FAILURE;
+	}
+	snap_valid = 1;
+	return XST_SUCCESS;
+}
+
+void snapshot_print_status() {
+	snapshot_header_type *hdr = SNAPSHOT_HEADER;
+	if (!snap_valid) {
+		printf("Snapshot: none\r\n");
+		return;
+	}
+	printf("Snapshot: %s, PC=%04x A=%02x X=%02x Y=%02x P=%02x S=%02x IER=%02x/%02x\r\n",
+			hdr->model == SNAP_MODEL_MASTER ? model_names[1] : model_names[0],
+			hdr->pc, hdr->a, hdr->x, hdr->y, hdr->p, hdr->s, hdr->ier[0], hdr->ier[1]);
+	printf("  last save %lu us, last restore %lu us\r\n", save_time, restore_time);
+}
@@ -0,0 +1,80 @@
+/*
+ * BeebFPGA Application
+ *
+ * Save States
+ *
+ * A snapshot is the whole of the BBC's 512KB memory, plus the CPU registers
+ * and the VIA interrupt enables, which are captured by injecting
+ * instructions into the frozen CPU. The memory includes the core's shadow
+ * copies of the write-only registers (CRTC, ULA, sound, etc). See "Save
+ * States" in bbc_micro_core.vhd.
+ */
+
+#ifndef __SNAPSHOT_H_
+#define __SNAPSHOT_H_
+
+#include "xil_types.h"
+
+// AXI Register (axi_gpio_2 channel 2) that controls freezing and injection
+#define GPIO_SNAP_CTRL       0x41220008
+
+#define SNAP_CTRL_FREEZE     (1 << 0)
+#define SNAP_CTRL_INJECT     (1 << 1)
+#define SNAP_CTRL_LEN_SHIFT  4
+
+// Snapshot status bits, in the keyboard status register
+#define SNAP_STATUS_FROZEN   (1 << 19)
+#define SNAP_STATUS_DONE     (1 << 20)
+
+// Snapshot buffers, at the top of the BBC's memory
+#define SNAP_MEM_SIZE        0x80000
+#define SNAP_INJECT_BUF      0x77000
+#define SNAP_INJECT_SIZE     0x800
+#define SNAP_CAPTURE_BUF     0x77800
+#define SNAP_SHADOW          0x77F00
+
+// Shadow register offsets
+#define SH_CRTC              0x00
+#define SH_ULA_CTRL          0x20
+#define SH_ROMSEL            0x30
+#define SH_ACCCON            0x34
+#define SH_SYS_VIA           0x40
+#define SH_USER_VIA          0x60
+#define SH_PALETTE           0x80
+#define SH_SOUND_LATCH       0x90
+#define SH_SOUND_DATA        0x98
+#define SH_CRTC_ADDR         0xA0
+#define SH_JIM_PAGE          0xA1
+#define SH_IC32              0xB0
+
+#define SNAPSHOT_DEFAULT_FILE "0:/BEEB.SNP"
+
+#define SNAP_MODEL_B         0
+#define SNAP_MODEL_MASTER    1
+
+typedef struct {
+	char magic[8];
+	u32 version;
+	u32 mem_size;
+	u16 pc;
+	u8 a;
+	u8 x;
+	u8 y;
+	u8 p;
+	u8 s;
+	u8 ier[2];
+	u8 model;
+	u8 reserved[22];
+} snapshot_header_type;
+
+int  snapshot_freeze();
+void snapshot_resume();
+int  snapshot_capture(snapshot_header_type *hdr);
+int  snapshot_load(snapshot_header_type *hdr, const u8 *shadow);
+int  snapshot_save();
+int  snapshot_restore();
+int  snapshot_write(const char *path);
+int  snapshot_read(const char *path);
+void snapshot_print_status();
+
+#endif
@@ -0,0 +1,196 @@
+/*
+ * BeebFPGA Application
+ *
+ * Event Trace
+ *
+ * Events are logged from both the USB interrupt handler and the main loop,
+ * so a slot is claimed with an atomic increment of the head index (ldrex /
+ * strex) rather than by disabling interrupts. Each entry's sequence number
+ * is written last, so the dump can skip any entry that was being written
+ * (or has since been overwritten) while it was being read.
+ *
+ * Timestamps come from the ARM global timer.
+ */
+
+#include <stdio.h>
+#include "xtime_l.h"
+#include "memmap.h"
+#include "trace.h"
+
+typedef struct {
+	XTime time;
+	u32 seq;
+	u16 type;
+	u16 arg0;
+	u32 arg[4];
+} trace_entry_type;
+
+#define TRACE_BUFFER       ((trace_entry_type *) TRACE_BUFFER_ADDR)
+#define TRACE_NUM_ENTRIES  (TRACE_BUFFER_SIZE / sizeof(trace_entry_type))
+
+// Must be a power of two
+#define TRACE_MASK         (TRACE_NUM_ENTRIES - 1)
+
+#define TRACE_DEFAULT_DUMP 100
+
+static const char *type_names[] = {
+	"irq",
+	"state",
+	"timer",
+	"xfer",
+	"done",
+	"retry",
+	"matrix"
+};
+
+static const char *src_names[] = {
+	"usb",
+	"autotype",
+	"romset"
+};
+
+static u32 tr_head;
+static u32 tr_start;
+static u32 tr_mask = TR_MASK_ALL;
+static int tr_enable = 1;
+
+void trace_init() {
+	for (u32 i = 0; i < TRACE_NUM_ENTRIES; i++) {
+		TRACE_BUFFER[i].seq = 0;
+	}
+	tr_head = 0;
+	tr_start = 0;
+}
+
+void trace_event(int type, u16 arg0, u32 arg1, u32 arg2, u32 arg3, u32 arg4) {
+	trace_entry_type *e;
+	u32 seq;
+	if (!tr_enable || !(tr_mask & (1 << type))) {
+		return;
+	}
+	seq = __atomic_fetch_add(&tr_head, 1, __ATOMIC_RELAXED);
+	e = TRACE_BUFFER + (seq & TRACE_MASK);
+	__atomic_store_n(&e->seq, 0, __ATOMIC_RELEASE);
+	XTime_GetTime(&e->time);
+	e->type = type;
+	e->arg0 = arg0;
+	e->arg[0] = arg1;
+	e->arg[1] = arg2;
+	e->arg[2] = arg3;
+	e->arg[3] = arg4;
+	// Sequence numbers start at 1, so zero always means invalid
+	__atomic_store_n(&e->seq, seq + 1, __ATOMIC_RELEASE);
+}
+
+void trace_set_enable(int enable) {
+	tr_enable = enable;
+}
+
+void trace_set_mask(u32 mask) {
+	tr_mask = mask & TR_MASK_ALL;
+}
+
+void trace_clear() {
+	tr_start = tr_head;
+}
+
+// Print a time interval in global timer ticks as seconds
+static void print_time(XTime ticks) {
+	u32 secs = (u32) (ticks / COUNTS_PER_SECOND);
+	u32 usecs = (u32) ((ticks % COUNTS_PER_SECOND) / (COUNTS_PER_SECOND / 1000000));
+	printf("%4lu.%06lu", secs, usecs);
+}
+
+static void print_entry(trace_entry_type *e) {
+	switch (e->type) {
+	case TR_IRQ:
+		printf("state=%s isr=%08lx", usb_state_name(e->arg0), e->arg[0]);
+		break;
+	case TR_STATE:
+		printf("%s -> %s", usb_state_name(e->arg[0]), usb_state_name(e->arg0));
+		break;
+	case TR_TIMER:
+		printf("%lu us", e->arg[0]);
+		break;
+	case TR_XFER:
+		printf("setup=%d dir=%s size=%lu", e->arg0, e->arg[0] ? "in" : "out", e->arg[1]);
+		break;
+	case TR_DONE:
+		printf("token=%08lx data=%08lx %08lx", e->arg[0], e->arg[1], e->arg[2]);
+		// qTD status: halted, buffer error, babble, transaction error
+		if (e->arg[0] & 0x78) {
+			printf(" ERROR%s%s%s%s",
+					(e->arg[0] & 0x40) ? " halted" : "",
+					(e->arg[0] & 0x20) ? " buffer" : "",
+					(e->arg[0] & 0x10) ? " babble" : "",
+					(e->arg[0] & 0x08) ? " xact" : "");
+		}
+		break;
+	case TR_RETRY:
+		printf("token=%08lx", e->arg[0]);
+		break;
+	case TR_MATRIX:
+		printf("%-8s %08lx %08lx %08lx %08lx",
+				e->arg0 < sizeof(src_names) / sizeof(src_names[0]) ? src_names[e->arg0] : "?",
+				e->arg[0], e->arg[1], e->arg[2], e->arg[3]);
+		break;
+	}
+}
+
+// Dump the most recent n events, oldest first
+void trace_dump(u32 n) {
+	trace_entry_type e;
+	u32 head = tr_head;
+	u32 count = head - tr_start;
+	u32 skipped = 0;
+	XTime first = 0;
+	XTime last = 0;
+	if (n == 0) {
+		n = TRACE_DEFAULT_DUMP;
+	}
+	if (count > TRACE_NUM_ENTRIES) {
+		count = TRACE_NUM_ENTRIES;
+	}
+	if (count > n) {
+		count = n;
+	}
+	printf("      time    delta  event\r\n");
+	for (u32 seq = head - count; seq != head; seq++) {
+		trace_entry_type *p = TRACE_BUFFER + (seq & TRACE_MASK);
+		if (__atomic_load_n(&p->seq, __ATOMIC_ACQUIRE) != seq + 1) {
+			skipped++;
+			continue;
+		}
+		e = *p;
+		if (__atomic_load_n(&p->seq, __ATOMIC_ACQUIRE) != seq + 1) {
+			skipped++;
+			continue;
+		}
+		if (first == 0) {
+			first = e.time;
+			last = e.time;
+		}
+		print_time(e.time - first);
+		printf(" %8lu  %-6s ", (u32) ((e.time - last) / (COUNTS_PER_SECOND / 1000000)),
+				e.type < TR_NUM_TYPES ? type_names[e.type] : "?");
+		print_entry(&e);
+		printf("\r\n");
+		last = e.time;
+	}
+	if (skipped) {
+		printf("(%lu entries overwritten while dumping)\r\n", skipped);
+	}
+}
+
+void trace_print_status() {
+	u32 count = tr_head - tr_start;
+	printf("Trace: %s, mask %02lx, %lu events", tr_enable ? "on" : "off", tr_mask, count);
+	if (count > TRACE_NUM_ENTRIES) {
+		printf(" (%lu kept)", (u32) TRACE_NUM_ENTRIES);
+	}
+	printf("\r\n  types:");
+	for (int i = 0; i < TR_NUM_TYPES; i++) {
+		printf(" %s=%02x", type_names[i], 1 << i);
+	}
+	printf("\r\n");
+}
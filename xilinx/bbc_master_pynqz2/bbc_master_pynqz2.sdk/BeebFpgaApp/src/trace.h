@@ -0,0 +1,39 @@
+/*
+ * BeebFPGA Application
+ *
+ * Event Trace
+ *
+ * A timestamped ring buffer of USB and keyboard events, which can be dumped
+ * from the console (trace dump) to diagnose enumeration problems and latency
+ * on particular keyboards.
+ */
+
+#ifndef __TRACE_H_
+#define __TRACE_H_
+
+#include "xil_types.h"
+
+// Event types
+#define TR_IRQ      0 // arg0 = state, arg[0] = USB0_ISR
+#define TR_STATE    1 // arg0 = new state, arg[0] = old state
+#define TR_TIMER    2 // arg[0] = usec
+#define TR_XFER     3 // arg0 = setup, arg[0] = direction, arg[1] = size
+#define TR_DONE     4 // arg[0] = qTD token, arg[1..2] = data
+#define TR_RETRY    5 // arg[0] = qTD token (still active)
+#define TR_MATRIX   6 // arg0 = source, arg[0..3] = combined matrix
+#define TR_NUM_TYPES 7
+
+#define TR_MASK_ALL ((1 << TR_NUM_TYPES) - 1)
+
+void trace_init();
+void trace_event(int type, u16 arg0, u32 arg1, u32 arg2, u32 arg3, u32 arg4);
+void trace_set_enable(int enable);
+void trace_set_mask(u32 mask);
+void trace_clear();
+void trace_dump(u32 n);
+void trace_print_status();
+
+// Provided by the USB code
+const char *usb_state_name(int state);
+
+#endif
@@ -0,0 +1,305 @@
+/*
+ * Bitstream Packer
+ *
+ * Compresses a PL bitstream into a packed partition for BeebFpgaLoader
+ * (see unpack.h), which decompresses it on the way to PCAP, so much less
+ * has to be read from the SD card. Zynq bitstreams are mostly empty
+ * frames, so compress very well.
+ *
+ * The input is either a .bit file, or a .bin already in PCAP byte order
+ * (e.g. from bootgen -process_bitstream bin). The output goes in the BIF
+ * in place of the .bit, as a PL partition:
+ *
+ *   [destination_device = pl] bbc_micro_pynqz2.pack
+ *
+ * Each block is checked by decompressing it with the loader's own
+ * unpack.c. The summary compares the bytes read from SD with and without
+ * packing, and estimates the read time at a given SD card speed; the
+ * actual times are in the boot timeline (the App's boot command).
+ *
+ * Usage: bitpack [-b <block KB>] [-r <SD MB/s>] <input.bit|input.bin> <output>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "xstatus.h"
+#include "unpack.h"
+
+// Must be no more than STREAM_CHUNK_SIZE in image_mover.c
+#define DEFAULT_BLOCK_KB   256
+#define MAX_BLOCK_KB       256
+
+#define DEFAULT_SD_MBPS    20
+
+// LZ4 block format limits
+#define MIN_MATCH          4
+#define MAX_OFFSET         65535
+#define MF_LIMIT           12
+#define LAST_LITERALS      5
+#define RUN_MASK           15
+
+#define HASH_BITS          16
+
+static int hash_table[1 << HASH_BITS];
+
+static u32 get32(const u8 *p) {
+	u32 v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+static void put32(u8 *p, u32 v) {
+	p[0] = v;
+	p[1] = v >> 8;
+	p[2] = v >> 16;
+	p[3] = v >> 24;
+}
+
+static u32 hash4(const u8 *p) {
+	return (get32(p) * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static u8 *put_length(u8 *op, u32 n) {
+	while (n >= 255) {
+		*op++ = 255;
+		n -= 255;
+	}
+	*op++ = n;
+	return op;
+}
+
+static u8 *put_sequence(u8 *op, const u8 *lit, u32 lit_len, u32 offset, u32 match_len) {
+	u8 *token = op++;
+	*token = (lit_len < RUN_MASK ? lit_len : RUN_MASK) << 4;
+	if (lit_len >= RUN_MASK) {
+		op = put_length(op, lit_len - RUN_MASK);
+	}
+	memcpy(op, lit, lit_len);
+	op += lit_len;
+	if (match_len) {
+		match_len -= MIN_MATCH;
+		*token |= match_len < RUN_MASK ? match_len : RUN_MASK;
+		*op++ = offset;
+		*op++ = offset >> 8;
+		if (match_len >= RUN_MASK) {
+			op = put_length(op, match_len - RUN_MASK);
+		}
+	}
+	return op;
+}
+
+// Greedy LZ4 block compressor; dst must hold len + len / 255 + 16 bytes
+static u32 compress_block(const u8 *src, u32 len, u8 *dst) {
+	u32 ip = 0;
+	u32 anchor = 0;
+	u8 *op = dst;
+	memset(hash_table, 0xFF, sizeof(hash_table));
+	while (ip + MF_LIMIT <= len) {
+		u32 h = hash4(src + ip);
+		int ref = hash_table[h];
+		hash_table[h] = ip;
+		if (ref >= 0 && ip - ref <= MAX_OFFSET && get32(src + ref) == get32(src + ip)) {
+			u32 limit = len - LAST_LITERALS;
+			u32 match_len = MIN_MATCH;
+			while (ip + match_len < limit && src[ref + match_len] == src[ip + match_len]) {
+				match_len++;
+			}
+			op = put_sequence(op, src + anchor, ip - anchor, ip - ref, match_len);
+			ip += match_len;
+			anchor = ip;
+		} else {
+			ip++;
+		}
+	}
+	op = put_sequence(op, src + anchor, len - anchor, 0, 0);
+	return op - dst;
+}
+
+// Read a .bit file, returning the configuration data byte swapped into
+// PCAP order, or a .bin as it is
+static u8 *read_bitstream(const char *path, u32 *len) {
+	FILE *f = fopen(path, "rb");
+	const char *ext = strrchr(path, '.');
+	u8 *buf;
+	long end;
+	size_t size;
+	u32 start = 0;
+	if (!f) {
+		perror(path);
+		return NULL;
+	}
+	fseek(f, 0, SEEK_END);
+	end = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if (end < 0) {
+		printf("%s: read error\n", path);
+		fclose(f);
+		return NULL;
+	}
+	size = end;
+	buf = malloc(size + 4);
+	if (!buf || fread(buf, 1, size, f) != size) {
+		printf("%s: read error\n", path);
+		fclose(f);
+		return NULL;
+	}
+	fclose(f);
+	if (ext && !strcmp(ext, ".bit")) {
+		// Header: 13 bytes, then fields 'a'-'d' with a 16-bit length, then
+		// 'e' with a 32-bit length followed by the configuration data
+		u32 p = 13;
+		while (p + 3 <= size && buf[p] >= 'a' && buf[p] <= 'd') {
+			p += 3 + ((buf[p + 1] << 8) | buf[p + 2]);
+		}
+		if (p + 5 > size || buf[p] != 'e') {
+			printf("%s: not a .bit file\n", path);
+			return NULL;
+		}
+		*len = (buf[p + 1] << 24) | (buf[p + 2] << 16) | (buf[p + 3] << 8) | buf[p + 4];
+		start = p + 5;
+		if (start + *len > size) {
+			printf("%s: truncated\n", path);
+			return NULL;
+		}
+		memmove(buf, buf + start, *len);
+		for (u32 i = 0; i + 4 <= *len; i += 4) {
+			u8 t = buf[i];
+			buf[i] = buf[i + 3];
+			buf[i + 3] = t;
+			t = buf[i + 1];
+			buf[i + 1] = buf[i + 2];
+			buf[i + 2] = t;
+		}
+	} else {
+		*len = size;
+	}
+	// PCAP transfers whole words
+	while (*len & 3) {
+		buf[(*len)++] = 0;
+	}
+	return buf;
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void usage() {
+	printf("Usage: bitpack [-b <block KB>] [-r <SD MB/s>] <input.bit|input.bin> <output>\n");
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+	u32 block_size = DEFAULT_BLOCK_KB * 1024;
+	double sd_mbps = DEFAULT_SD_MBPS;
+	u32 len;
+	u32 num_blocks;
+	u32 out_len;
+	u32 *lengths;
+	u8 *in;
+	u8 *out;
+	u8 *op;
+	u8 *check;
+	double t_pack = 0;
+	double t_unpack = 0;
+	FILE *f;
+	int opt = 1;
+
+	while (opt < argc && argv[opt][0] == '-') {
+		if (!strcmp(argv[opt], "-b") && opt + 1 < argc) {
+			u32 kb = atoi(argv[opt + 1]);
+			if (kb == 0 || kb > MAX_BLOCK_KB) {
+				printf("Block size must be 1-%d KB\n", MAX_BLOCK_KB);
+				return 1;
+			}
+			block_size = kb * 1024;
+		} else if (!strcmp(argv[opt], "-r") && opt + 1 < argc) {
+			sd_mbps = atof(argv[opt + 1]);
+			if (sd_mbps <= 0) {
+				usage();
+			}
+		} else {
+			usage();
+		}
+		opt += 2;
+	}
+	if (argc - opt != 2) {
+		usage();
+	}
+
+	in = read_bitstream(argv[opt], &len);
+	if (!in) {
+		return 1;
+	}
+	num_blocks = (len + block_size - 1) / block_size;
+	if (num_blocks == 0 || num_blocks > PACK_MAX_BLOCKS) {
+		printf("%s: %u bytes needs 1-%d blocks\n", argv[opt], len, PACK_MAX_BLOCKS);
+		return 1;
+	}
+
+	out = malloc(sizeof(PackHeader) + num_blocks * 4 + len + num_blocks * (block_size / 255 + 20));
+	check = malloc(block_size);
+	lengths = malloc(num_blocks * sizeof(u32));
+	op = out + sizeof(PackHeader) + num_blocks * 4;
+
+	for (u32 b = 0; b < num_blocks; b++) {
+		const u8 *src = in + b * block_size;
+		u32 n = (b == num_blocks - 1) ? len - b * block_size : block_size;
+		u32 clen;
+		u32 unpacked = 0;
+		double t = now();
+		clen = compress_block(src, n, op);
+		t_pack += now() - t;
+		if (clen >= n) {
+			// Doesn't compress, so store it
+			memcpy(op, src, n);
+			lengths[b] = PACK_BLOCK_STORED | n;
+			op += n;
+			continue;
+		}
+		t = now();
+		if (UnpackBlock(op, clen, check, n, &unpacked) != XST_SUCCESS ||
+				unpacked != n || memcmp(check, src, n)) {
+			printf("Block %u: does not unpack correctly\n", b);
+			return 1;
+		}
+		t_unpack += now() - t;
+		lengths[b] = clen;
+		op += clen;
+		while ((op - out) & 3) {
+			*op++ = 0;
+		}
+	}
+	out_len = op - out;
+
+	put32(out, PACK_MAGIC);
+	put32(out + 4, len);
+	put32(out + 8, block_size);
+	put32(out + 12, num_blocks);
+	for (u32 b = 0; b < num_blocks; b++) {
+		put32(out + sizeof(PackHeader) + b * 4, lengths[b]);
+	}
+
+	f = fopen(argv[opt + 1], "wb");
+	if (!f || fwrite(out, 1, out_len, f) != out_len) {
+		perror(argv[opt + 1]);
+		return 1;
+	}
+	fclose(f);
+
+	printf("Bitstream:     %8u bytes\n", len);
+	printf("Packed:        %8u bytes (%.1f%%), %u blocks of %u KB\n",
+			out_len, 100.0 * out_len / len, num_blocks, block_size / 1024);
+	printf("Pack:          %8.1f MB/s (host)\n", len / t_pack / 1e6);
+	if (t_unpack > 0) {
+		printf("Unpack:        %8.1f MB/s (host)\n", len / t_unpack / 1e6);
+	}
+	printf("SD read at %.0f MB/s: %.1f ms unpacked, %.1f ms packed\n",
+			sd_mbps, len / sd_mbps / 1e3, out_len / sd_mbps / 1e3);
+	return 0;
+}
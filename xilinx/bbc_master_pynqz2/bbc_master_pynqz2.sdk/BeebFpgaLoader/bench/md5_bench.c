@@ -0,0 +1,135 @@
+/*
+ * Loader MD5 benchmark
+ *
+ * Checks md5.c against the RFC 1321 test vectors, then times it over a
+ * buffer the size of a typical partition, both in one call and fed in
+ * chunks the way the loader does while copying. The unaligned run takes
+ * the copying path in MD5Update.
+ *
+ * Usage: md5_bench [megabytes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "md5.h"
+
+#define CHUNK_SIZE 0x40000
+
+static const struct {
+	const char *input;
+	const char *digest;
+} vectors[] = {
+	{ "",
+	  "d41d8cd98f00b204e9800998ecf8427e" },
+	{ "a",
+	  "0cc175b9c0f1b6a831c399e269772661" },
+	{ "abc",
+	  "900150983cd24fb0d6963f7d28e17f72" },
+	{ "message digest",
+	  "f96b697d7cb7938d525a2f31aaf161d0" },
+	{ "abcdefghijklmnopqrstuvwxyz",
+	  "c3fcd3d76192e4007dfb496cca67e13b" },
+	{ "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+	  "d174ab98d277d9f5a5611c2c9f419d9f" },
+	{ "12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+	  "57edf4a22be3c955ac49da2e2107b67a" }
+};
+
+static void to_hex(const u8 *digest, char *hex) {
+	int i;
+	for (i = 0; i < 16; i++) {
+		sprintf(hex + i * 2, "%02x", digest[i]);
+	}
+}
+
+static int check_vectors() {
+	u8 buf[128];
+	u8 digest[16];
+	char hex[33];
+	int fail = 0;
+	int i;
+	for (i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+		u32 len = strlen(vectors[i].input);
+		// Hash from both an aligned and an unaligned copy
+		memcpy(buf, vectors[i].input, len);
+		md5(buf, len, digest, 0);
+		to_hex(digest, hex);
+		if (strcmp(hex, vectors[i].digest)) {
+			printf("FAIL: \"%s\" gave %s\n", vectors[i].input, hex);
+			fail = 1;
+		}
+		memcpy(buf + 1, vectors[i].input, len);
+		md5(buf + 1, len, digest, 0);
+		to_hex(digest, hex);
+		if (strcmp(hex, vectors[i].digest)) {
+			printf("FAIL: \"%s\" (unaligned) gave %s\n", vectors[i].input, hex);
+			fail = 1;
+		}
+	}
+	return fail;
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void bench(const char *name, u8 *data, u32 len, u32 chunk, u8 *digest) {
+	MD5Context context;
+	u32 offset;
+	u32 n;
+	double t = now();
+	MD5Init(&context);
+	for (offset = 0; offset < len; offset += n) {
+		n = len - offset;
+		if (n > chunk) {
+			n = chunk;
+		}
+		MD5Update(&context, data + offset, n, 0);
+	}
+	MD5Final(&context, digest, 0);
+	t = now() - t;
+	printf("%-20s %8.1f MB/s\n", name, len / t / 1e6);
+}
+
+int main(int argc, char **argv) {
+	u32 mb = argc > 1 ? atoi(argv[1]) : 64;
+	u32 len = mb << 20;
+	u8 digest[4][16];
+	u8 *data;
+	u32 i;
+
+	if (check_vectors()) {
+		return 1;
+	}
+	printf("Test vectors OK\n");
+
+	data = malloc(len + 4);
+	if (!data) {
+		printf("Unable to allocate %lu MB\n", (unsigned long)mb);
+		return 1;
+	}
+	srand(1);
+	for (i = 0; i < len + 4; i++) {
+		data[i] = rand();
+	}
+
+	printf("Hashing %lu MB\n", (unsigned long)mb);
+	bench("single call",       data,     len, len,        digest[0]);
+	bench("chunked",           data,     len, CHUNK_SIZE, digest[1]);
+	bench("chunked, odd size", data,     len, 4093,       digest[2]);
+	memmove(data + 1, data, len);
+	bench("unaligned",         data + 1, len, CHUNK_SIZE, digest[3]);
+
+	for (i = 1; i < 4; i++) {
+		if (memcmp(digest[0], digest[i], 16)) {
+			printf("FAIL: digests differ\n");
+			return 1;
+		}
+	}
+	return 0;
+}
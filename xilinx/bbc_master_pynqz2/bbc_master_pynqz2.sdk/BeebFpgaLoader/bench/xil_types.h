@@ -0,0 +1,23 @@
+/*
+ * Host stand-in for the BSP's xil_types.h, enough to build md5.c
+ */
+
+#ifndef XIL_TYPES_H
+#define XIL_TYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t  u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+#ifndef TRUE
+#define TRUE  1U
+#endif
+
+#ifndef FALSE
+#define FALSE 0U
+#endif
+
+#endif
@@ -0,0 +1,11 @@
+/*
+ * Host stand-in for the BSP's xstatus.h, enough to build unpack.c
+ */
+
+#ifndef XSTATUS_H
+#define XSTATUS_H
+
+#define XST_SUCCESS 0L
+#define XST_FAILURE 1L
+
+#endif
@@ -0,0 +1,356 @@
+/*****************************************************************************
+*
+* @file cpu1.c
+*
+* Partition validation on CPU1, see cpu1.h
+*
+******************************************************************************/
+
+#include <string.h>
+#include "fsbl.h"
+
+#ifdef FSBL_CPU1_VALIDATION
+
+#include "xstatus.h"
+#include "xreg_cortexa9.h"
+#include "md5.h"
+#include "cpu1.h"
+
+#ifdef RSA_SUPPORT
+#include "rsa.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+#define SCTLR_M			0x00000001
+#define SCTLR_C			0x00000004
+#define SCTLR_Z			0x00000800
+#define SCTLR_I			0x00001000
+
+#define CPACR_VFP		0x00F00000
+#define FPEXC_EN		0x40000000
+
+/*
+ * Translation table walk attributes in TTBR0
+ */
+#define TTBR_ATTR_MASK	0x0000007F
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+#define sev()	__asm__ __volatile__ ("sev" : : : "memory")
+#define wfe()	__asm__ __volatile__ ("wfe" : : : "memory")
+
+/************************** Function Prototypes ******************************/
+
+void Cpu1Entry(void) __attribute__ ((naked));
+void Cpu1Main(void) __attribute__ ((noreturn));
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Shared with CPU1, which has its data cache off, so every access goes to
+ * OCM. Head is only written by CPU0 and Tail only by CPU1.
+ */
+static Cpu1Job Cpu1Queue[CPU1_MAX_JOBS];
+static volatile u32 Cpu1Head;
+static volatile u32 Cpu1Tail;
+static volatile u32 Cpu1StopFlag;
+static volatile u32 Cpu1ParkedFlag;
+static volatile u32 Cpu1FailedPartition;
+static volatile u32 Cpu1FailedFlags;
+static volatile u32 Cpu1Ttbr0;
+static volatile u32 Cpu1Dacr;
+static u8 Cpu1StartedFlag;
+
+u32 Cpu1Stack[CPU1_STACK_SIZE / 4] __attribute__ ((aligned (8)));
+
+/******************************************************************************
+*
+* This function is where CPU1 starts, with the MMU and caches off. It
+* only sets up a stack.
+*
+* @param	None
+*
+* @return	None
+*
+****************************************************************************/
+void Cpu1Entry(void)
+{
+	__asm__ __volatile__ (
+		"ldr	sp, =Cpu1Stack + %c0\n"
+		"b		Cpu1Main\n"
+		: : "i" (CPU1_STACK_SIZE));
+}
+
+/******************************************************************************
+*
+* This function runs one job on CPU1
+*
+* @param	Job to run
+*
+* @return	CPU1_JOB_ flags of the checks that failed
+*
+****************************************************************************/
+static u32 Cpu1RunJob(Cpu1Job *Job)
+{
+	u8 Checksum[CPU1_CHECKSUM_SIZE];
+	u32 FailedFlags = 0;
+
+	if (Job->Flags & CPU1_JOB_CHECKSUM) {
+		md5((u8 *)Job->StartAddr, Job->Length, Checksum, 0);
+		if (memcmp(Checksum, Job->Checksum, CPU1_CHECKSUM_SIZE) != 0) {
+			FailedFlags |= CPU1_JOB_CHECKSUM;
+		}
+	}
+
+	/*
+	 * Not worth authenticating a corrupt partition
+	 */
+	if ((Job->Flags & CPU1_JOB_AUTH) && (FailedFlags == 0)) {
+#ifdef RSA_SUPPORT
+		if (AuthenticatePartition((u8 *)Job->StartAddr, Job->Length)
+				!= XST_SUCCESS) {
+			FailedFlags |= CPU1_JOB_AUTH;
+		}
+#else
+		FailedFlags |= CPU1_JOB_AUTH;
+#endif
+	}
+
+	return FailedFlags;
+}
+
+/******************************************************************************
+*
+* This function is CPU1's main loop. It turns the MMU and instruction
+* cache on, using CPU0's translation table, then runs jobs until CPU0
+* asks it to stop, when it goes back to the BootROM's wait loop.
+*
+* @param	None
+*
+* @return	Does not return
+*
+* @note		The data cache stays off, so there is nothing to keep
+*		coherent with CPU0, which also runs with its data cache off
+*		except while it checksums or authenticates partitions itself
+*
+****************************************************************************/
+void Cpu1Main(void)
+{
+	Cpu1Job *Job;
+	u32 Reg;
+
+	mtcp(XREG_CP15_INVAL_UTLB_UNLOCKED, 0);
+	mtcp(XREG_CP15_INVAL_IC_POU, 0);
+	mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0);
+	dsb();
+	isb();
+
+	mtcp(XREG_CP15_DOMAIN_ACCESS_CTRL, Cpu1Dacr);
+	mtcp(XREG_CP15_TTBR0, Cpu1Ttbr0 & ~TTBR_ATTR_MASK);
+	isb();
+
+	/*
+	 * The code may be built to use VFP registers
+	 */
+	mfcp(XREG_CP15_COPROC_ACCESS_CTRL, Reg);
+	mtcp(XREG_CP15_COPROC_ACCESS_CTRL, Reg | CPACR_VFP);
+	isb();
+	__asm__ __volatile__ ("vmsr fpexc, %0" : : "r" (FPEXC_EN));
+
+	mfcp(XREG_CP15_SYS_CONTROL, Reg);
+	Reg &= ~SCTLR_C;
+	Reg |= SCTLR_M | SCTLR_Z | SCTLR_I;
+	mtcp(XREG_CP15_SYS_CONTROL, Reg);
+	isb();
+
+	while (!Cpu1StopFlag || (Cpu1Tail != Cpu1Head)) {
+		if (Cpu1Tail == Cpu1Head) {
+			wfe();
+			continue;
+		}
+
+		/*
+		 * Read the job only after seeing it in the queue
+		 */
+		dmb();
+		Job = &Cpu1Queue[Cpu1Tail % CPU1_MAX_JOBS];
+		Job->FailedFlags = Cpu1RunJob(Job);
+		if (Job->FailedFlags && !Cpu1FailedFlags) {
+			Cpu1FailedPartition = Job->PartitionNum;
+			Cpu1FailedFlags = Job->FailedFlags;
+		}
+		dmb();
+		Cpu1Tail = Cpu1Tail + 1;
+		dsb();
+		sev();
+	}
+
+	/*
+	 * Park in the BootROM's wait loop
+	 */
+	Xil_Out32(CPU1_START_ADDR_REG, 0);
+	Cpu1ParkedFlag = 1;
+	dsb();
+	sev();
+
+	mfcp(XREG_CP15_SYS_CONTROL, Reg);
+	Reg &= ~(SCTLR_M | SCTLR_Z | SCTLR_I);
+	mtcp(XREG_CP15_SYS_CONTROL, Reg);
+	mtcp(XREG_CP15_INVAL_IC_POU, 0);
+	mtcp(XREG_CP15_INVAL_BRANCH_ARRAY, 0);
+	dsb();
+	isb();
+
+	((void (*)(void))CPU1_WAIT_LOOP_ADDR)();
+
+	while (1);
+}
+
+/******************************************************************************
+*
+* This function wakes CPU1 from the BootROM's wait loop
+*
+* @param	None
+*
+* @return	None
+*
+****************************************************************************/
+static void Cpu1Start(void)
+{
+	u32 Reg;
+
+	Cpu1Head = 0;
+	Cpu1Tail = 0;
+	Cpu1StopFlag = 0;
+	Cpu1ParkedFlag = 0;
+	Cpu1FailedPartition = 0;
+	Cpu1FailedFlags = 0;
+
+	mfcp(XREG_CP15_TTBR0, Reg);
+	Cpu1Ttbr0 = Reg;
+	mfcp(XREG_CP15_DOMAIN_ACCESS_CTRL, Reg);
+	Cpu1Dacr = Reg;
+
+	Xil_Out32(CPU1_START_ADDR_REG, (u32)Cpu1Entry);
+	dsb();
+	sev();
+
+	Cpu1StartedFlag = 1;
+
+	fsbl_printf(DEBUG_INFO, "CPU1 started\r\n");
+}
+
+/******************************************************************************
+*
+* This function queues a partition to be checked by CPU1, waking CPU1
+* for the first one. It waits if the queue is full.
+*
+* @param	PartitionNum is the partition number, for reporting failures
+* @param	StartAddr is the address of the partition in memory
+* @param	Length is its length in bytes
+* @param	Flags are the CPU1_JOB_ checks to make
+* @param	Checksum is the expected checksum, for CPU1_JOB_CHECKSUM
+*
+* @return	XST_SUCCESS
+*
+* @note		The partition must not be overwritten until Cpu1Wait()
+*
+****************************************************************************/
+u32 Cpu1Submit(u32 PartitionNum, u32 StartAddr, u32 Length, u32 Flags,
+		u8 *Checksum)
+{
+	Cpu1Job *Job;
+
+	if (!Cpu1StartedFlag) {
+		Cpu1Start();
+	}
+
+	while ((Cpu1Head - Cpu1Tail) >= CPU1_MAX_JOBS) {
+		wfe();
+	}
+
+	Job = &Cpu1Queue[Cpu1Head % CPU1_MAX_JOBS];
+	Job->PartitionNum = PartitionNum;
+	Job->StartAddr = StartAddr;
+	Job->Length = Length;
+	Job->Flags = Flags;
+	Job->FailedFlags = 0;
+	if (Flags & CPU1_JOB_CHECKSUM) {
+		memcpy(Job->Checksum, Checksum, CPU1_CHECKSUM_SIZE);
+	}
+
+	dmb();
+	Cpu1Head = Cpu1Head + 1;
+	dsb();
+	sev();
+
+	fsbl_printf(DEBUG_INFO, "Partition %lu queued for CPU1\r\n",
+			PartitionNum);
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************
+*
+* This function waits for CPU1 to finish the jobs in the queue
+*
+* @param	PartitionNum returns the first partition that failed
+* @param	FailedFlags returns the CPU1_JOB_ checks that it failed
+*
+* @return
+*		- XST_SUCCESS if every partition passed
+*		- XST_FAILURE if one failed
+*
+****************************************************************************/
+u32 Cpu1Wait(u32 *PartitionNum, u32 *FailedFlags)
+{
+	if (!Cpu1StartedFlag) {
+		return XST_SUCCESS;
+	}
+
+	while (Cpu1Tail != Cpu1Head) {
+		wfe();
+	}
+	dmb();
+
+	if (Cpu1FailedFlags) {
+		*PartitionNum = Cpu1FailedPartition;
+		*FailedFlags = Cpu1FailedFlags;
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************
+*
+* This function parks CPU1 back in the BootROM's wait loop, once it has
+* finished the jobs in the queue
+*
+* @param	None
+*
+* @return	None
+*
+****************************************************************************/
+void Cpu1Stop(void)
+{
+	if (!Cpu1StartedFlag) {
+		return;
+	}
+
+	Cpu1StopFlag = 1;
+	dsb();
+	sev();
+
+	while (!Cpu1ParkedFlag) {
+		wfe();
+	}
+
+	Cpu1StartedFlag = 0;
+
+	fsbl_printf(DEBUG_INFO, "CPU1 parked\r\n");
+}
+
+#endif /* FSBL_CPU1_VALIDATION */
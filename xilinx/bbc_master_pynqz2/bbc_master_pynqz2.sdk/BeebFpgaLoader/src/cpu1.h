@@ -0,0 +1,70 @@
+/*****************************************************************************/
+/**
+*
+* @file cpu1.h
+*
+* Partition validation on CPU1. The checksum and signature of a PS
+* partition are checked by CPU1 from a small queue of jobs, while CPU0
+* goes on to read the next partition from the boot device. CPU0 waits
+* for the queue to drain before handoff.
+*
+* CPU1 is woken from the BootROM's wait loop in high OCM, and runs with
+* CPU0's translation table but with its data cache off, so it shares no
+* cache lines with CPU0. Once the queue has drained it is parked back in
+* the wait loop, where the application can wake it again.
+*
+* Only built when FSBL_CPU1_VALIDATION is defined, see fsbl.h
+*
+******************************************************************************/
+#ifndef CPU1_H_
+#define CPU1_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Job flags
+ */
+#define CPU1_JOB_CHECKSUM	0x1
+#define CPU1_JOB_AUTH		0x2
+
+#define CPU1_MAX_JOBS		8
+#define CPU1_STACK_SIZE		0x2000
+
+/*
+ * CPU1 polls this address in the BootROM's wait loop
+ */
+#define CPU1_WAIT_LOOP_ADDR	0xFFFFFE00
+#define CPU1_START_ADDR_REG	0xFFFFFFF0
+
+#define CPU1_CHECKSUM_SIZE	16
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 PartitionNum;
+	u32 StartAddr;
+	u32 Length;
+	u32 Flags;
+	u8 Checksum[CPU1_CHECKSUM_SIZE];	/* Expected checksum */
+	u32 FailedFlags;					/* Set by CPU1 */
+} Cpu1Job;
+
+/************************** Function Prototypes ******************************/
+
+u32 Cpu1Submit(u32 PartitionNum, u32 StartAddr, u32 Length, u32 Flags,
+		u8 *Checksum);
+u32 Cpu1Wait(u32 *PartitionNum, u32 *FailedFlags);
+void Cpu1Stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU1_H_ */
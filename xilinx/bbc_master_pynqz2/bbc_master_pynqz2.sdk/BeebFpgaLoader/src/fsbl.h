@@ -308,6 +308,20 @@
 * Note : Changing the default behaviour is not recommended from
 * Security perspective.
 *
+* FSBL_SD_BENCHMARK
+* Defining this flag makes FSBL measure the SD card's read throughput,
+* reading the whole boot file a few different ways, after opening it.
+*
+* FSBL_QSPI_BENCHMARK
+* Defining this flag makes FSBL time the polled I/O and linear QSPI read
+* paths against each other, after initialising the QSPI, on a flash too
+* large for linear boot.
+*
+* FSBL_CPU1_VALIDATION
+* Defining this flag makes FSBL check the checksums and signatures of
+* unencrypted PS partitions on CPU1, while CPU0 reads the next partition
+* (see cpu1.h).
+*
 *******************************************************************************/
 #ifndef XIL_FSBL_H
 #define XIL_FSBL_H
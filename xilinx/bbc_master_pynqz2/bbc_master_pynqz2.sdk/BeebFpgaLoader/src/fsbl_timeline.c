@@ -0,0 +1,86 @@
+/*****************************************************************************
+*
+* @file fsbl_timeline.c
+*
+* Records the boot timeline, see fsbl_timeline.h
+*
+******************************************************************************/
+
+#include "fsbl.h"
+#include "xtime_l.h"
+#include "fsbl_timeline.h"
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Built in OCM, as DDR is not available for the first stages
+ */
+static Timeline BootTimeline;
+
+/******************************************************************************
+*
+* This function records the start of a stage
+*
+* @param	Stage is one of the TIMELINE_ stages
+* @param	Arg is the partition number, or zero
+*
+* @return	Index of the entry, to pass to TimelineEnd()
+*
+* @note		Stages beyond the size of the table are not recorded
+*
+****************************************************************************/
+u32 TimelineStart(u32 Stage, u32 Arg)
+{
+	u32 Index = BootTimeline.Count;
+	XTime Now;
+
+	if (Index >= TIMELINE_MAX_ENTRIES) {
+		return TIMELINE_MAX_ENTRIES;
+	}
+
+	XTime_GetTime(&Now);
+	BootTimeline.Entry[Index].Stage = Stage;
+	BootTimeline.Entry[Index].Arg = Arg;
+	BootTimeline.Entry[Index].Start = Now;
+	BootTimeline.Entry[Index].End = Now;
+	BootTimeline.Count++;
+
+	return Index;
+}
+
+/******************************************************************************
+*
+* This function records the end of a stage
+*
+* @param	Index returned by TimelineStart()
+*
+* @return	None
+*
+****************************************************************************/
+void TimelineEnd(u32 Index)
+{
+	XTime Now;
+
+	if (Index >= TIMELINE_MAX_ENTRIES) {
+		return;
+	}
+
+	XTime_GetTime(&Now);
+	BootTimeline.Entry[Index].End = Now;
+}
+
+/******************************************************************************
+*
+* This function copies the timeline to DDR, just before handoff
+*
+* @param	None
+*
+* @return	None
+*
+****************************************************************************/
+void TimelinePublish(void)
+{
+	BootTimeline.Magic = TIMELINE_MAGIC;
+	BootTimeline.CountsPerSecond = COUNTS_PER_SECOND;
+	memcpy_rom((void *)TIMELINE_DDR_ADDR, &BootTimeline, sizeof(BootTimeline));
+}
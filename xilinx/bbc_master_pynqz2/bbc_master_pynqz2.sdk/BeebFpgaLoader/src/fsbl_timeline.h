@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/**
+*
+* @file fsbl_timeline.h
+*
+* Boot timeline: the start and end of each stage of the boot, in global
+* timer ticks. The table is built in OCM and copied to a fixed address in
+* DDR at handoff, where BeebFpgaApp can print it (see boottime.c).
+*
+* The global timer is reset by the FSBL's boot code, so times are from
+* the start of the FSBL. ps7_init changes the CPU clock, so the duration
+* of the PS7_INIT stage is only approximate.
+*
+******************************************************************************/
+#ifndef FSBL_TIMELINE_H_
+#define FSBL_TIMELINE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Must match BOOT_TIMELINE_ADDR in BeebFpgaApp's memmap.h
+ */
+#define TIMELINE_DDR_ADDR		0x01680000
+#define TIMELINE_MAGIC			0x4C544F42	/* "BOTL" */
+#define TIMELINE_MAX_ENTRIES	32
+
+/*
+ * Stages, Arg is the partition number for the partition stages. f_mount()
+ * is deferred, so the card is initialised during SD_OPEN.
+ */
+#define TIMELINE_PS7_INIT		0
+#define TIMELINE_DDR_CHECK		1
+#define TIMELINE_PCAP_INIT		2
+#define TIMELINE_SD_MOUNT		3
+#define TIMELINE_SD_OPEN		4
+#define TIMELINE_HEADERS		5
+#define TIMELINE_PART_READ		6
+#define TIMELINE_PART_CHECKSUM	7
+#define TIMELINE_PART_PCAP		8
+#define TIMELINE_PART_STREAM	9
+#define TIMELINE_HANDOFF		10
+#define TIMELINE_CPU1_WAIT		11
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Stage;
+	u32 Arg;
+	u64 Start;
+	u64 End;
+} TimelineEntry;
+
+typedef struct {
+	u32 Magic;
+	u32 Count;
+	u32 CountsPerSecond;
+	u32 Reserved;
+	TimelineEntry Entry[TIMELINE_MAX_ENTRIES];
+} Timeline;
+
+/************************** Function Prototypes ******************************/
+
+u32 TimelineStart(u32 Stage, u32 Arg);
+void TimelineEnd(u32 Index);
+void TimelinePublish(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* end of protection macro */
@@ -86,7 +86,11 @@
 #include "xreg_cortexa9.h"
 #include "pcap.h"
 #include "fsbl_hooks.h"
+#include "fsbl_timeline.h"
 #include "md5.h"
+#include "unpack.h"
+#include "cpu1.h"
+#include "xil_cache.h"
 
 #ifdef XPAR_XWDTPS_0_BASEADDR
 #include "xwdtps.h"
@@ -94,7 +98,6 @@
 
 #ifdef RSA_SUPPORT
 #include "rsa.h"
-#include "xil_cache.h"
 #endif
 /************************** Constant Definitions *****************************/
 
@@ -102,6 +105,27 @@
 #define MAXIMUM_IMAGE_WORD_LEN 0x40000000
 #define MD5_CHECKSUM_SIZE   16
 
+/*
+ * Unencrypted, unsigned PL partitions on non-linear boot devices are
+ * streamed to PCAP through a double buffer in the DDR temporary area, so
+ * reading each chunk overlaps the PCAP DMA of the previous one
+ */
+#define STREAM_CHUNK_SIZE	0x40000
+#define STREAM_BUFFER_0		DDR_TEMP_START_ADDR
+#define STREAM_BUFFER_1		(DDR_TEMP_START_ADDR + STREAM_CHUNK_SIZE)
+
+/*
+ * Packed PL partitions (see unpack.h) are read a block at a time into
+ * this buffer, and decompressed into the stream buffers
+ */
+#define PACK_READ_BUFFER	(DDR_TEMP_START_ADDR + 2 * STREAM_CHUNK_SIZE)
+
+/*
+ * Checksum enabled partitions on non-linear boot devices are copied in
+ * chunks of this size, each checksummed as soon as it is read
+ */
+#define CHECKSUM_CHUNK_SIZE	0x40000
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
@@ -110,6 +134,17 @@
 u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset);
 u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum);
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum);
+u32 CheckPartitionChecksum(u8 *CalcChecksum, u32 ChecksumOffset);
+u32 HeaderRead(u32 SourceAddr, u32 DestAddr, u32 Length);
+#ifdef FSBL_CPU1_VALIDATION
+u32 QueuePartitionValidation(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset);
+#endif
+u32 PartitionStream(u32 SourceAddr, PartHeader *Header);
+u32 PartitionStreamPacked(u32 SourceAddr, PartHeader *Header,
+		PackHeader *Pack);
+u32 PartitionCopy(u32 SourceAddr, u32 LoadAddr, u32 Length);
+void ChecksumUpdate(MD5Context *Context, u32 Addr, u32 Length);
 
 /************************** Variable Definitions *****************************/
 /*
@@ -122,6 +157,29 @@ u8 SignedPartitionFlag;
 u8 PartitionChecksumFlag;
 u8 BitstreamFlag;
 u8 ApplicationFlag;
+u8 PartitionStreamedFlag;
+u8 PartitionChecksumDoneFlag;
+
+/*
+ * Checksum calculated while streaming or copying a partition
+ */
+static u8 MoveChecksum[MD5_CHECKSUM_SIZE];
+
+/*
+ * Block lengths of a packed partition
+ */
+static u32 PackBlockLength[PACK_MAX_BLOCKS];
+
+/*
+ * Partition being loaded, for the boot timeline
+ */
+static u32 CurrentPartitionNum;
+
+/*
+ * Part of the image held in the header window, see image_mover.h
+ */
+static u32 HeaderWindowBase;
+static u32 HeaderWindowLength;
 
 u32 ExecutionAddress;
 ImageMoverType MoveImage;
@@ -172,6 +230,11 @@ u32 LoadBootImage(void)
 	u32 PartitionChecksumOffset;
 	u8 ExecAddrFlag = 0 ;
 	u32 Status;
+	u32 Stage;
+	u32 QueuedFlags;
+#ifdef FSBL_CPU1_VALIDATION
+	u32 FailedFlags;
+#endif
 	PartHeader *HeaderPtr;
 	u32 EfuseStatusRegValue;
 #ifdef RSA_SUPPORT
@@ -228,7 +291,9 @@ u32 LoadBootImage(void)
 	/*
 	 * Get partitions header information
 	 */
+	Stage = TimelineStart(TIMELINE_HEADERS, 0);
 	Status = GetPartitionHeaderInfo(ImageStartAddress);
+	TimelineEnd(Stage);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL, "Partition Header Load Failed\r\n");
 		OutputStatus(GET_HEADER_INFO_FAIL);
@@ -298,10 +363,17 @@ u32 LoadBootImage(void)
 	PartitionNum = 1;
 #endif
 
+	/*
+	 * Partitions may be loaded over the header window
+	 */
+	HeaderWindowLength = 0;
+
 	while (PartitionNum < PartitionCount) {
 
 		fsbl_printf(DEBUG_INFO, "Partition Number: %lu\r\n", PartitionNum);
 
+		CurrentPartitionNum = PartitionNum;
+
 		HeaderPtr = &PartitionHeader[PartitionNum];
 
 		/*
@@ -468,7 +540,24 @@ u32 LoadBootImage(void)
 			FsblFallback();
 		}
 
-		if ((SignedPartitionFlag) || (PartitionChecksumFlag)) {
+		if (PartitionStreamedFlag) {
+			/*
+			 * The checksum was calculated while streaming, so the
+			 * bitstream is already loaded and can only be checked
+			 */
+			if (PartitionChecksumFlag) {
+				Status = CheckPartitionChecksum(MoveChecksum,
+						ImageStartAddress  +
+						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+				if (Status != XST_SUCCESS) {
+					fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
+					OutputStatus(PARTITION_CHECKSUM_FAIL);
+					FsblFallback();
+				}
+
+				fsbl_printf(DEBUG_INFO, "Partition Validation Done\r\n");
+			}
+		} else if ((SignedPartitionFlag) || (PartitionChecksumFlag)) {
 			if(PLPartitionFlag) {
 				/*
 				 * PL partition loaded in to DDR temporary address
@@ -479,14 +568,42 @@ u32 LoadBootImage(void)
 				PartitionStartAddr = PartitionLoadAddr;
 			}
 
-			if (PartitionChecksumFlag) {
-				/*
-				 * Validate the partition data with checksum
-				 */
-				Status = ValidateParition(PartitionStartAddr,
+			QueuedFlags = 0;
+#ifdef FSBL_CPU1_VALIDATION
+			/*
+			 * Unencrypted PS partitions are checked by CPU1 while the
+			 * next partition is read. PL partitions have to be checked
+			 * before they are loaded in the fabric.
+			 */
+			if (PSPartitionFlag && !EncryptedPartitionFlag) {
+				QueuedFlags = QueuePartitionValidation(PartitionNum,
+						PartitionStartAddr,
 						(PartitionTotalSize << WORD_LENGTH_SHIFT),
 						ImageStartAddress  +
 						(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+			}
+#endif
+
+			if (PartitionChecksumFlag &&
+					!(QueuedFlags & CPU1_JOB_CHECKSUM)) {
+				/*
+				 * Validate the partition data with checksum
+				 */
+				Stage = TimelineStart(TIMELINE_PART_CHECKSUM, PartitionNum);
+				if (PartitionChecksumDoneFlag) {
+					/*
+					 * Already calculated while the partition was copied
+					 */
+					Status = CheckPartitionChecksum(MoveChecksum,
+							ImageStartAddress  +
+							(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+				} else {
+					Status = ValidateParition(PartitionStartAddr,
+							(PartitionTotalSize << WORD_LENGTH_SHIFT),
+							ImageStartAddress  +
+							(PartitionChecksumOffset << WORD_LENGTH_SHIFT));
+				}
+				TimelineEnd(Stage);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
 					OutputStatus(PARTITION_CHECKSUM_FAIL);
@@ -499,7 +616,8 @@ u32 LoadBootImage(void)
 			/*
 			 * Authentication Partition
 			 */
-			if (SignedPartitionFlag == 1 ) {
+			if ((SignedPartitionFlag == 1) &&
+					!(QueuedFlags & CPU1_JOB_AUTH)) {
 #ifdef RSA_SUPPORT
 				Xil_DCacheEnable();
 				Status = AuthenticatePartition((u8*)PartitionStartAddr,
@@ -542,11 +660,13 @@ u32 LoadBootImage(void)
 			 * Load Signed PL partition in Fabric
 			 */
 			if (PLPartitionFlag) {
+				Stage = TimelineStart(TIMELINE_PART_PCAP, PartitionNum);
 				Status = PcapLoadPartition((u32*)PartitionStartAddr,
 						(u32*)PartitionLoadAddr,
 						PartitionImageLength,
 						PartitionDataLength,
 						EncryptedPartitionFlag);
+				TimelineEnd(Stage);
 				if (Status != XST_SUCCESS) {
 					fsbl_printf(DEBUG_GENERAL,"BITSTREAM_DOWNLOAD_FAIL\r\n");
 					OutputStatus(BITSTREAM_DOWNLOAD_FAIL);
@@ -573,6 +693,28 @@ u32 LoadBootImage(void)
 		PartitionNum++;
 	}
 
+#ifdef FSBL_CPU1_VALIDATION
+	/*
+	 * Wait for CPU1 to finish checking the PS partitions
+	 */
+	Stage = TimelineStart(TIMELINE_CPU1_WAIT, 0);
+	Status = Cpu1Wait(&PartitionNum, &FailedFlags);
+	TimelineEnd(Stage);
+	Cpu1Stop();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Partition %lu failed on CPU1\r\n",
+				PartitionNum);
+		if (FailedFlags & CPU1_JOB_CHECKSUM) {
+			fsbl_printf(DEBUG_GENERAL,"PARTITION_CHECKSUM_FAIL\r\n");
+			OutputStatus(PARTITION_CHECKSUM_FAIL);
+		} else {
+			fsbl_printf(DEBUG_GENERAL,"AUTHENTICATION_FAIL\r\n");
+			OutputStatus(AUTHENTICATION_FAIL);
+		}
+		FsblFallback();
+	}
+#endif
+
 	return ExecAddress;
 }
 
@@ -594,6 +736,18 @@ u32 GetPartitionHeaderInfo(u32 ImageBaseAddress)
     u32 PartitionHeaderOffset;
     u32 Status;
 
+    /*
+     * Read the header structures in one go, rather than a field at a time
+     */
+    Status = MoveImage(ImageBaseAddress, HEADER_WINDOW_ADDR,
+    				HEADER_WINDOW_SIZE);
+    if (Status == XST_SUCCESS) {
+    	HeaderWindowBase = ImageBaseAddress;
+    	HeaderWindowLength = HEADER_WINDOW_SIZE;
+    } else {
+    	fsbl_printf(DEBUG_INFO, "Header window read failed\r\n");
+    	HeaderWindowLength = 0;
+    }
 
     /*
      * Get the length of the FSBL from BootHeader
@@ -675,7 +829,7 @@ u32 GetPartitionHeaderStartAddr(u32 ImageAddress, u32 *Offset)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_PHDR_OFFSET, (u32)Offset, 4);
+	Status = HeaderRead(ImageAddress + IMAGE_PHDR_OFFSET, (u32)Offset, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -703,7 +857,7 @@ u32 GetImageHeaderStartAddr(u32 ImageAddress, u32 *Offset)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_HDR_OFFSET, (u32)Offset, 4);
+	Status = HeaderRead(ImageAddress + IMAGE_HDR_OFFSET, (u32)Offset, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -730,7 +884,7 @@ u32 GetFsblLength(u32 ImageAddress, u32 *FsblLength)
 {
 	u32 Status;
 
-	Status = MoveImage(ImageAddress + IMAGE_TOT_BYTE_LEN_OFFSET,
+	Status = HeaderRead(ImageAddress + IMAGE_TOT_BYTE_LEN_OFFSET,
 							(u32)FsblLength, 4);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed reading FsblLength\r\n");
@@ -772,7 +926,7 @@ u32 GetImageHeaderAndSignature(u32 ImageBaseAddress, u32 *Offset)
 		return XST_FAILURE;
 	}
 
-	Status = MoveImage(ImageBaseAddress+ImageHeaderOffset, (u32)Offset,
+	Status = HeaderRead(ImageBaseAddress+ImageHeaderOffset, (u32)Offset,
 							TOTAL_HEADER_SIZE + RSA_SIGNATURE_SIZE);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
@@ -802,7 +956,7 @@ u32 LoadPartitionsHeaderInfo(u32 PartHeaderOffset,  PartHeader *Header)
 {
 	u32 Status;
 
-	Status = MoveImage(PartHeaderOffset, (u32)Header, sizeof(PartHeader)*MAX_PARTITION_NUMBER);
+	Status = HeaderRead(PartHeaderOffset, (u32)Header, sizeof(PartHeader)*MAX_PARTITION_NUMBER);
 	if (Status != XST_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"Move Image failed\r\n");
 		return XST_FAILURE;
@@ -812,6 +966,38 @@ u32 LoadPartitionsHeaderInfo(u32 PartHeaderOffset,  PartHeader *Header)
 }
 
 
+/*****************************************************************************/
+/**
+*
+* This function reads part of the image's header structures, from the
+* header window if it holds them, or else from the boot device
+*
+* @param	SourceAddr is the address in the boot device
+* @param	DestAddr is where to copy to
+* @param	Length is the length in bytes
+*
+* @return	- XST_SUCCESS if the read is successful
+*			- XST_FAILURE if the read failed
+*
+* @note		None
+*
+****************************************************************************/
+u32 HeaderRead(u32 SourceAddr, u32 DestAddr, u32 Length)
+{
+	if ((HeaderWindowLength != 0) &&
+			(SourceAddr >= HeaderWindowBase) &&
+			(Length <= HeaderWindowLength) &&
+			(SourceAddr - HeaderWindowBase <= HeaderWindowLength - Length)) {
+		memcpy_rom((void *)DestAddr,
+				(void *)(HEADER_WINDOW_ADDR + SourceAddr - HeaderWindowBase),
+				Length);
+		return XST_SUCCESS;
+	}
+
+	return MoveImage(SourceAddr, DestAddr, Length);
+}
+
+
 /*****************************************************************************/
 /**
 *
@@ -1062,12 +1248,15 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
     u32 LoadAddr;
     u32 ImageWordLen;
     u32 DataWordLen;
+    u32 Stage;
 
 	SourceAddr = ImageBaseAddress;
 	SourceAddr += Header->PartitionStart<<WORD_LENGTH_SHIFT;
 	LoadAddr = Header->LoadAddr;
 	ImageWordLen = Header->ImageWordLen;
 	DataWordLen = Header->DataWordLen;
+	PartitionStreamedFlag = 0;
+	PartitionChecksumDoneFlag = 0;
 
 	/*
 	 * Add flash base address for linear boot devices
@@ -1076,6 +1265,24 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		SourceAddr += FlashReadBaseAddress;
 	}
 
+	/*
+	 * Stream PL partitions from non-linear boot devices straight to PCAP,
+	 * unless they have to be authenticated or decrypted first
+	 */
+	if ((!LinearBootDeviceFlag) && PLPartitionFlag &&
+			(!SignedPartitionFlag) && (!EncryptedPartitionFlag)) {
+		Stage = TimelineStart(TIMELINE_PART_STREAM, CurrentPartitionNum);
+		Status = PartitionStream(SourceAddr, Header);
+		TimelineEnd(Stage);
+		if(Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Stream Failed\r\n");
+			return XST_FAILURE;
+		}
+		PartitionStreamedFlag = 1;
+		PartitionChecksumDoneFlag = PartitionChecksumFlag;
+		return XST_SUCCESS;
+	}
+
 	/*
 	 * Partition encrypted
 	 */
@@ -1114,9 +1321,22 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 			LoadAddr = DDR_TEMP_START_ADDR;
 		}
 
-		Status = MoveImage(SourceAddr,
+		Stage = TimelineStart(TIMELINE_PART_READ, CurrentPartitionNum);
+		if (PartitionChecksumFlag) {
+			/*
+			 * Checksum the partition on the way in, rather than
+			 * making a second pass over it once it is in DDR
+			 */
+			Status = PartitionCopy(SourceAddr,
 						LoadAddr,
 						(ImageWordLen << WORD_LENGTH_SHIFT));
+			PartitionChecksumDoneFlag = (Status == XST_SUCCESS);
+		} else {
+			Status = MoveImage(SourceAddr,
+						LoadAddr,
+						(ImageWordLen << WORD_LENGTH_SHIFT));
+		}
+		TimelineEnd(Stage);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
 			return XST_FAILURE;
@@ -1144,11 +1364,13 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 		/*
 		 * Data transfer using PCAP
 		 */
+		Stage = TimelineStart(TIMELINE_PART_PCAP, CurrentPartitionNum);
 		Status = PcapDataTransfer((u32*)SourceAddr,
 						(u32*)LoadAddr,
 						ImageWordLen,
 						DataWordLen,
 						SecureTransferFlag);
+		TimelineEnd(Stage);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "PCAP Data Transfer Failed\r\n");
 			return XST_FAILURE;
@@ -1165,11 +1387,13 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 	 * if checksum and authentication bits are not set
 	 */
 	if (PLPartitionFlag && (!(SignedPartitionFlag || PartitionChecksumFlag))) {
+		Stage = TimelineStart(TIMELINE_PART_PCAP, CurrentPartitionNum);
 		Status = PcapLoadPartition((u32*)SourceAddr,
 					(u32*)Header->LoadAddr,
 					Header->ImageWordLen,
 					Header->DataWordLen,
 					EncryptedPartitionFlag);
+		TimelineEnd(Stage);
 		if(Status != XST_SUCCESS) {
 			fsbl_printf(DEBUG_GENERAL, "PCAP Bitstream Download Failed\r\n");
 			return XST_FAILURE;
@@ -1180,6 +1404,356 @@ u32 PartitionMove(u32 ImageBaseAddress, PartHeader *Header)
 }
 
 
+/******************************************************************************/
+/**
+*
+* This function streams a PL partition from the boot device to PCAP in
+* chunks, alternating between two buffers. The checksum, if enabled, is
+* calculated over the whole partition on the same pass. Packed partitions
+* are passed to PartitionStreamPacked().
+*
+* @param	SourceAddr Partition address on the boot device
+* @param	Header Partition header pointer
+*
+* @return
+*		- XST_SUCCESS if the bitstream was loaded
+*		- XST_FAILURE if reading or loading failed
+*
+* @note		The checksum is left in MoveChecksum
+*
+*******************************************************************************/
+u32 PartitionStream(u32 SourceAddr, PartHeader *Header)
+{
+	MD5Context Context;
+	u32 Buffer;
+	u32 Offset;
+	u32 ChunkLen;
+	u32 PcapLen;
+	u32 PcapBytes;
+	u32 TotalBytes;
+	u32 Status;
+	u32 Chunk = 0;
+	PackHeader Pack;
+
+	/*
+	 * Look for a packed partition
+	 */
+	Status = MoveImage(SourceAddr, (u32)&Pack, sizeof(Pack));
+	if(Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+	if (Pack.Magic == PACK_MAGIC) {
+		return PartitionStreamPacked(SourceAddr, Header, &Pack);
+	}
+
+	PcapBytes = Header->ImageWordLen << WORD_LENGTH_SHIFT;
+	TotalBytes = PcapBytes;
+
+	/*
+	 * The checksum covers the whole partition
+	 */
+	if (PartitionChecksumFlag) {
+		TotalBytes = Header->PartitionWordLen << WORD_LENGTH_SHIFT;
+		MD5Init(&Context);
+	}
+
+	Status = PcapStartStream();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (Offset = 0; Offset < TotalBytes; Offset += ChunkLen) {
+		ChunkLen = TotalBytes - Offset;
+		if (ChunkLen > STREAM_CHUNK_SIZE) {
+			ChunkLen = STREAM_CHUNK_SIZE;
+		}
+		Buffer = (Chunk++ & 1) ? STREAM_BUFFER_1 : STREAM_BUFFER_0;
+
+		/*
+		 * The PCAP DMA of the previous chunk, from the other buffer,
+		 * continues while this chunk is read
+		 */
+		Status = MoveImage(SourceAddr + Offset, Buffer, ChunkLen);
+		if(Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+			return XST_FAILURE;
+		}
+
+		if (PartitionChecksumFlag) {
+			ChecksumUpdate(&Context, Buffer, ChunkLen);
+		}
+
+		if (Offset < PcapBytes) {
+			PcapLen = PcapBytes - Offset;
+			if (PcapLen > ChunkLen) {
+				PcapLen = ChunkLen;
+			}
+			Status = PcapStreamChunk((u32 *)Buffer,
+					PcapLen >> WORD_LENGTH_SHIFT,
+					(Offset + PcapLen) == PcapBytes);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+		}
+	}
+
+	Status = PcapStreamDone();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if (PartitionChecksumFlag) {
+		MD5Final(&Context, MoveChecksum, 0);
+	}
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function streams a packed PL partition to PCAP. Each block is read
+* and decompressed into one of the two stream buffers while PCAP loads
+* the previous block from the other. Stored blocks are read straight into
+* the stream buffer.
+*
+* @param	SourceAddr Partition address on the boot device
+* @param	Header Partition header pointer
+* @param	Pack Packed partition header, already read
+*
+* @return
+*		- XST_SUCCESS if the bitstream was loaded
+*		- XST_FAILURE if reading, decompressing or loading failed
+*
+* @note		The checksum, over the packed partition, is left in
+*		MoveChecksum
+*
+*******************************************************************************/
+u32 PartitionStreamPacked(u32 SourceAddr, PartHeader *Header,
+		PackHeader *Pack)
+{
+	MD5Context Context;
+	u32 Buffer;
+	u32 Block;
+	u32 Offset;
+	u32 ReadLen;
+	u32 OutLen;
+	u32 Unpacked;
+	u32 ChunkLen;
+	u32 TotalBytes;
+	u32 Status;
+
+	TotalBytes = Header->PartitionWordLen << WORD_LENGTH_SHIFT;
+
+	if ((Pack->NumBlocks == 0) || (Pack->NumBlocks > PACK_MAX_BLOCKS) ||
+			(Pack->BlockSize == 0) ||
+			(Pack->BlockSize > STREAM_CHUNK_SIZE) ||
+			(Pack->BlockSize & 3) || (Pack->DataLength & 3) ||
+			(Pack->DataLength > Pack->NumBlocks * Pack->BlockSize) ||
+			(Pack->DataLength <= (Pack->NumBlocks - 1) * Pack->BlockSize)) {
+		fsbl_printf(DEBUG_GENERAL, "Invalid Packed Partition\r\n");
+		return XST_FAILURE;
+	}
+
+	Offset = sizeof(PackHeader);
+	ReadLen = Pack->NumBlocks * sizeof(u32);
+	Status = MoveImage(SourceAddr + Offset, (u32)PackBlockLength, ReadLen);
+	if(Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+		return XST_FAILURE;
+	}
+	Offset += ReadLen;
+
+	if (PartitionChecksumFlag) {
+		MD5Init(&Context);
+		MD5Update(&Context, (u8 *)Pack, sizeof(PackHeader), 0);
+		MD5Update(&Context, (u8 *)PackBlockLength, ReadLen, 0);
+	}
+
+	Status = PcapStartStream();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (Block = 0; Block < Pack->NumBlocks; Block++) {
+		Buffer = (Block & 1) ? STREAM_BUFFER_1 : STREAM_BUFFER_0;
+		OutLen = Pack->BlockSize;
+		if (Block == Pack->NumBlocks - 1) {
+			OutLen = Pack->DataLength - Block * Pack->BlockSize;
+		}
+
+		ReadLen = (PackBlockLength[Block] & PACK_LENGTH_MASK);
+		if (PackBlockLength[Block] & PACK_BLOCK_STORED) {
+			if (ReadLen != OutLen) {
+				fsbl_printf(DEBUG_GENERAL, "Invalid Packed Block\r\n");
+				return XST_FAILURE;
+			}
+			Status = MoveImage(SourceAddr + Offset, Buffer, ReadLen);
+			if(Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+				return XST_FAILURE;
+			}
+			if (PartitionChecksumFlag) {
+				ChecksumUpdate(&Context, Buffer, ReadLen);
+			}
+		} else {
+			ReadLen = (ReadLen + 3) & ~3;
+			if (ReadLen > Pack->BlockSize) {
+				fsbl_printf(DEBUG_GENERAL, "Invalid Packed Block\r\n");
+				return XST_FAILURE;
+			}
+			Status = MoveImage(SourceAddr + Offset, PACK_READ_BUFFER,
+					ReadLen);
+			if(Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+				return XST_FAILURE;
+			}
+
+			/*
+			 * Decompress with the data cache enabled, as for the
+			 * checksum, and flush the output for the PCAP DMA
+			 */
+			Xil_DCacheEnable();
+			if (PartitionChecksumFlag) {
+				MD5Update(&Context, (u8 *)PACK_READ_BUFFER, ReadLen, 0);
+			}
+			Status = UnpackBlock((u8 *)PACK_READ_BUFFER,
+					PackBlockLength[Block] & PACK_LENGTH_MASK,
+					(u8 *)Buffer, OutLen, &Unpacked);
+			Xil_DCacheFlush();
+			Xil_DCacheDisable();
+			if ((Status != XST_SUCCESS) || (Unpacked != OutLen)) {
+				fsbl_printf(DEBUG_GENERAL, "Unpack Block %lu Failed\r\n",
+						Block);
+				return XST_FAILURE;
+			}
+		}
+		Offset += ReadLen;
+
+		Status = PcapStreamChunk((u32 *)Buffer,
+				OutLen >> WORD_LENGTH_SHIFT,
+				Block == Pack->NumBlocks - 1);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	Status = PcapStreamDone();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO, "Unpacked %lu bytes from %lu\r\n",
+			Pack->DataLength, Offset);
+
+	if (PartitionChecksumFlag) {
+		/*
+		 * The checksum also covers any padding after the blocks
+		 */
+		for (; Offset < TotalBytes; Offset += ChunkLen) {
+			ChunkLen = TotalBytes - Offset;
+			if (ChunkLen > STREAM_CHUNK_SIZE) {
+				ChunkLen = STREAM_CHUNK_SIZE;
+			}
+			Status = MoveImage(SourceAddr + Offset, PACK_READ_BUFFER,
+					ChunkLen);
+			if(Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_GENERAL, "Move Image Failed\r\n");
+				return XST_FAILURE;
+			}
+			ChecksumUpdate(&Context, PACK_READ_BUFFER, ChunkLen);
+		}
+		MD5Final(&Context, MoveChecksum, 0);
+	}
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function copies a partition from a non-linear boot device in chunks,
+* calculating its checksum as each chunk arrives
+*
+* @param	SourceAddr Partition address on the boot device
+* @param	LoadAddr Destination address in DDR
+* @param	Length Partition length in bytes
+*
+* @return
+*		- XST_SUCCESS if the partition was copied
+*		- XST_FAILURE if reading failed
+*
+* @note		The checksum is left in MoveChecksum
+*
+*******************************************************************************/
+u32 PartitionCopy(u32 SourceAddr, u32 LoadAddr, u32 Length)
+{
+	MD5Context Context;
+	u32 Offset;
+	u32 ChunkLen;
+	u32 Status;
+
+	MD5Init(&Context);
+
+	for (Offset = 0; Offset < Length; Offset += ChunkLen) {
+		ChunkLen = Length - Offset;
+		if (ChunkLen > CHECKSUM_CHUNK_SIZE) {
+			ChunkLen = CHECKSUM_CHUNK_SIZE;
+		}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+		/*
+		 * Prevent WDT reset
+		 */
+		XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+		Status = MoveImage(SourceAddr + Offset, LoadAddr + Offset, ChunkLen);
+		if(Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		ChecksumUpdate(&Context, LoadAddr + Offset, ChunkLen);
+	}
+
+	MD5Final(&Context, MoveChecksum, 0);
+
+	return XST_SUCCESS;
+}
+
+
+/******************************************************************************/
+/**
+*
+* This function adds a block of DDR to a running checksum. The FSBL runs
+* with the data cache off, so it is enabled for the duration, letting the
+* MD5 transform read whole cache lines rather than single uncached words.
+*
+* @param	Context MD5 context
+* @param	Addr Start address of the data
+* @param	Length Data length in bytes
+*
+* @return	None
+*
+* @note		Enabling the cache invalidates it first, so data just written
+*		to DDR by DMA (SD, PCAP) is read correctly. Nothing here writes
+*		to the data, so disabling it again only cleans the stack.
+*
+*******************************************************************************/
+void ChecksumUpdate(MD5Context *Context, u32 Addr, u32 Length)
+{
+	Xil_DCacheEnable();
+
+	MD5Update(Context, (u8 *)Addr, Length, 0);
+
+	Xil_DCacheFlush();
+	Xil_DCacheDisable();
+}
+
+
 /******************************************************************************/
 /**
 *
@@ -1233,10 +1807,8 @@ u32 DecryptPartition(u32 StartAddr, u32 DataLength, u32 ImageLength)
 *******************************************************************************/
 u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset)
 {
-    u8  Checksum[MD5_CHECKSUM_SIZE];
     u8  CalcChecksum[MD5_CHECKSUM_SIZE];
     u32 Status;
-    u32 Index;
 
 #ifdef	XPAR_XWDTPS_0_BASEADDR
 	/*
@@ -1245,6 +1817,85 @@ u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset)
 	XWdtPs_RestartWdt(&Watchdog);
 #endif
 
+    /*
+     * Calculate checksum for the partition
+     */
+    Status = CalcPartitionChecksum(StartAddr, Length, &CalcChecksum[0]);
+	if(Status != XST_SUCCESS) {
+        return XST_FAILURE;
+    }
+
+    return CheckPartitionChecksum(&CalcChecksum[0], ChecksumOffset);
+}
+
+
+#ifdef FSBL_CPU1_VALIDATION
+/******************************************************************************/
+/**
+*
+* This function queues a PS partition to be checked by CPU1. The expected
+* checksum is read here, as only CPU0 uses the boot device.
+*
+* @param	Partition number
+* @param	Start address of the partition in memory
+* @param	Length of the partition in bytes
+* @param	Partition check sum offset
+* @return	CPU1_JOB_ flags of the checks queued, the rest are left to
+*		CPU0
+*
+* @note		A checksum already calculated while the partition was copied
+*		is left to CPU0, which only has to compare it
+*
+*******************************************************************************/
+u32 QueuePartitionValidation(u32 PartitionNum, u32 StartAddr, u32 Length,
+		u32 ChecksumOffset)
+{
+	u8  Checksum[MD5_CHECKSUM_SIZE];
+	u32 Flags = 0;
+	u32 Status;
+
+	if (PartitionChecksumFlag && !PartitionChecksumDoneFlag) {
+		Status = GetPartitionChecksum(ChecksumOffset, &Checksum[0]);
+		if (Status == XST_SUCCESS) {
+			Flags |= CPU1_JOB_CHECKSUM;
+		}
+	}
+
+#ifdef RSA_SUPPORT
+	if (SignedPartitionFlag) {
+		Flags |= CPU1_JOB_AUTH;
+	}
+#endif
+
+	if (Flags) {
+		Cpu1Submit(PartitionNum, StartAddr, Length, Flags, &Checksum[0]);
+	}
+
+	return Flags;
+}
+#endif
+
+
+/******************************************************************************/
+/**
+*
+* This function compares a calculated checksum with the one in the image
+*
+* @param	Calculated checksum pointer
+* @param	Partition check sum offset
+* @return
+*		- XST_SUCCESS if partition data is ok
+*		- XST_FAILURE if partition data is corrupted
+*
+* @note		None
+*
+*******************************************************************************/
+u32 CheckPartitionChecksum(u8 *CalcChecksum, u32 ChecksumOffset)
+{
+    u8  Checksum[MD5_CHECKSUM_SIZE];
+    u32 Status;
+    u32 Index;
+
     /*
      * Get checksum from flash
      */
@@ -1261,14 +1912,6 @@ u32 ValidateParition(u32 StartAddr, u32 Length, u32 ChecksumOffset)
 
     fsbl_printf(DEBUG_INFO, "\r\n");
 
-    /*
-     * Calculate checksum for the partition
-     */
-    Status = CalcPartitionChecksum(StartAddr, Length, &CalcChecksum[0]);
-	if(Status != XST_SUCCESS) {
-        return XST_FAILURE;
-    }
-
     fsbl_printf(DEBUG_INFO, "Calculated checksum\r\n");
 
     for (Index = 0; Index < MD5_CHECKSUM_SIZE; Index++) {
@@ -1338,10 +1981,14 @@ u32 GetPartitionChecksum(u32 ChecksumOffset, u8 *Checksum)
 *******************************************************************************/
 u32 CalcPartitionChecksum(u32 SourceAddr, u32 DataLength, u8 *Checksum)
 {
+	MD5Context Context;
+
 	/*
 	 * Calculate checksum using MD5 algorithm
 	 */
-	md5((u8*)SourceAddr, DataLength, Checksum, 0 );
+	MD5Init(&Context);
+	ChecksumUpdate(&Context, SourceAddr, DataLength);
+	MD5Final(&Context, Checksum, 0);
 
     return XST_SUCCESS;
 }
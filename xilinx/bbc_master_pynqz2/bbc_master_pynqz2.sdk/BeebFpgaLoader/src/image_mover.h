@@ -86,6 +86,13 @@ extern "C" {
 #define PARTITION_HDR_WORD_COUNT		0x10	/* Header word len */
 #define PARTITION_HDR_TOTAL_LEN			0x40	/* One partition hdr length*/
 
+/*
+ * The header structures are read in one go into this window in DDR, and
+ * parsed from there. Anything outside it is read from the boot device.
+ */
+#define HEADER_WINDOW_ADDR		(DDR_TEMP_START_ADDR + 0x10000)
+#define HEADER_WINDOW_SIZE		0x2000
+
 /* Attribute word defines */
 #define ATTRIBUTE_IMAGE_TYPE_MASK		0xF0	/* Destination Device type */
 #define ATTRIBUTE_PS_IMAGE_MASK			0x10	/* Code partition */
@@ -134,6 +134,7 @@
 #include "xil_exception.h"
 #include "xstatus.h"
 #include "fsbl_hooks.h"
+#include "fsbl_timeline.h"
 #include "xtime_l.h"
 
 #ifdef XPAR_XWDTPS_0_BASEADDR
@@ -239,10 +240,13 @@ int main(void)
 	u32 HandoffAddress = 0;
 	u32 Status = XST_SUCCESS;
 	u32 RegVal;
+	u32 Stage;
 	/*
 	 * PCW initialization for MIO,PLL,CLK and DDR
 	 */
+	Stage = TimelineStart(TIMELINE_PS7_INIT, 0);
 	Status = ps7_init();
+	TimelineEnd(Stage);
 	if (Status != FSBL_PS7_INIT_SUCCESS) {
 		fsbl_printf(DEBUG_GENERAL,"PS7_INIT_FAIL : %s\r\n",
 						getPS7MessageInfo(Status));
@@ -298,7 +302,9 @@ int main(void)
     /*
      * DDR Read/write test 
      */
+	Stage = TimelineStart(TIMELINE_DDR_CHECK, 0);
 	Status = DDRInitCheck();
+	TimelineEnd(Stage);
 	if (Status == XST_FAILURE) {
 		fsbl_printf(DEBUG_GENERAL,"DDR_INIT_FAIL \r\n");
 		/* Error Handling here */
@@ -314,7 +320,9 @@ int main(void)
 	/*
 	 * PCAP initialization
 	 */
+	Stage = TimelineStart(TIMELINE_PCAP_INIT, 0);
 	Status = InitPcap();
+	TimelineEnd(Stage);
 	if (Status == XST_FAILURE) {
 		fsbl_printf(DEBUG_GENERAL,"PCAP_INIT_FAIL \n\r");
 		OutputStatus(PCAP_INIT_FAIL);
@@ -729,6 +737,9 @@ void FsblFallback(void)
 void FsblHandoff(u32 FsblStartAddr)
 {
 	u32 Status;
+	u32 Stage;
+
+	Stage = TimelineStart(TIMELINE_HANDOFF, 0);
 
 	/*
 	 * Enable level shifter
@@ -799,6 +810,11 @@ void FsblHandoff(u32 FsblStartAddr)
 	} else {
 		fsbl_printf(DEBUG_GENERAL,"SUCCESSFUL_HANDOFF\r\n");
 		OutputStatus(SUCCESSFUL_HANDOFF);
+		/*
+		 * Leave the boot timeline in DDR for the application
+		 */
+		TimelineEnd(Stage);
+		TimelinePublish();
 		FsblHandoffExit(FsblStartAddr);
 	}
 
@@ -127,6 +127,22 @@ inline void * MD5Memcpy( void *dest, const void *src,
 	register char * src8 = (char*)src;
 	
 	if( doByteSwap == FALSE ) {
+		/*
+		 * Copy whole words when both ends are aligned
+		 */
+		if( ( ( (u32)dst8 | (u32)src8 ) & 3 ) == 0 ) {
+			register u32 * dst32 = (u32 *)dst8;
+			register u32 * src32 = (u32 *)src8;
+
+			while( count >= sizeof( u32 ) ) {
+				*dst32++ = *src32++;
+				count -= sizeof( u32 );
+			}
+
+			dst8 = (char *)dst32;
+			src8 = (char *)src32;
+		}
+
 		while( count-- )
 			*dst8++ = *src8++;
 	} else {
@@ -162,11 +178,13 @@ inline void * MD5Memcpy( void *dest, const void *src,
 *
 * Following number is the per-round shift amount.
 *
-* @param	dest
+* The sixteen words of the block are loaded once, up front. Each is used
+* by all four rounds, and the block may be in uncached DDR, straight from
+* the boot device.
 *
-* @param	ch
+* @param	buffer is the MD5 state
 *
-* @param	count
+* @param	intermediate is the 64 byte block, word aligned
 *
 * @return	None
 *
@@ -176,79 +194,84 @@ inline void * MD5Memcpy( void *dest, const void *src,
 void MD5Transform( u32 *buffer, u32 *intermediate )
 {
 	register u32 a, b, c, d;
-	
+	u32 x[ 16 ];
+	u32 i;
+
+	for( i = 0; i < 16; i++ )
+		x[ i ] = intermediate[ i ];
+
 	a = buffer[ 0 ];
 	b = buffer[ 1 ];
 	c = buffer[ 2 ];
 	d = buffer[ 3 ];
 
-	MD5_STEP( F1, a, b, c, d, intermediate[  0 ] + 0xd76aa478,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  1 ] + 0xe8c7b756, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[  2 ] + 0x242070db, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[  3 ] + 0xc1bdceee, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[  4 ] + 0xf57c0faf,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  5 ] + 0x4787c62a, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[  6 ] + 0xa8304613, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[  7 ] + 0xfd469501, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[  8 ] + 0x698098d8,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[  9 ] + 0x8b44f7af, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[ 10 ] + 0xffff5bb1, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[ 11 ] + 0x895cd7be, 22 );
-	MD5_STEP( F1, a, b, c, d, intermediate[ 12 ] + 0x6b901122,  7 );
-	MD5_STEP( F1, d, a, b, c, intermediate[ 13 ] + 0xfd987193, 12 );
-	MD5_STEP( F1, c, d, a, b, intermediate[ 14 ] + 0xa679438e, 17 );
-	MD5_STEP( F1, b, c, d, a, intermediate[ 15 ] + 0x49b40821, 22 );
+	MD5_STEP( F1, a, b, c, d, x[  0 ] + 0xd76aa478,  7 );
+	MD5_STEP( F1, d, a, b, c, x[  1 ] + 0xe8c7b756, 12 );
+	MD5_STEP( F1, c, d, a, b, x[  2 ] + 0x242070db, 17 );
+	MD5_STEP( F1, b, c, d, a, x[  3 ] + 0xc1bdceee, 22 );
+	MD5_STEP( F1, a, b, c, d, x[  4 ] + 0xf57c0faf,  7 );
+	MD5_STEP( F1, d, a, b, c, x[  5 ] + 0x4787c62a, 12 );
+	MD5_STEP( F1, c, d, a, b, x[  6 ] + 0xa8304613, 17 );
+	MD5_STEP( F1, b, c, d, a, x[  7 ] + 0xfd469501, 22 );
+	MD5_STEP( F1, a, b, c, d, x[  8 ] + 0x698098d8,  7 );
+	MD5_STEP( F1, d, a, b, c, x[  9 ] + 0x8b44f7af, 12 );
+	MD5_STEP( F1, c, d, a, b, x[ 10 ] + 0xffff5bb1, 17 );
+	MD5_STEP( F1, b, c, d, a, x[ 11 ] + 0x895cd7be, 22 );
+	MD5_STEP( F1, a, b, c, d, x[ 12 ] + 0x6b901122,  7 );
+	MD5_STEP( F1, d, a, b, c, x[ 13 ] + 0xfd987193, 12 );
+	MD5_STEP( F1, c, d, a, b, x[ 14 ] + 0xa679438e, 17 );
+	MD5_STEP( F1, b, c, d, a, x[ 15 ] + 0x49b40821, 22 );
 	
-	MD5_STEP( F2, a, b, c, d, intermediate[  1 ] + 0xf61e2562,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[  6 ] + 0xc040b340,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[ 11 ] + 0x265e5a51, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  0 ] + 0xe9b6c7aa, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[  5 ] + 0xd62f105d,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[ 10 ] + 0x02441453,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[ 15 ] + 0xd8a1e681, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  4 ] + 0xe7d3fbc8, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[  9 ] + 0x21e1cde6,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[ 14 ] + 0xc33707d6,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[  3 ] + 0xf4d50d87, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[  8 ] + 0x455a14ed, 20 );
-	MD5_STEP( F2, a, b, c, d, intermediate[ 13 ] + 0xa9e3e905,  5 );
-	MD5_STEP( F2, d, a, b, c, intermediate[  2 ] + 0xfcefa3f8,  9 );
-	MD5_STEP( F2, c, d, a, b, intermediate[  7 ] + 0x676f02d9, 14 );
-	MD5_STEP( F2, b, c, d, a, intermediate[ 12 ] + 0x8d2a4c8a, 20 );
+	MD5_STEP( F2, a, b, c, d, x[  1 ] + 0xf61e2562,  5 );
+	MD5_STEP( F2, d, a, b, c, x[  6 ] + 0xc040b340,  9 );
+	MD5_STEP( F2, c, d, a, b, x[ 11 ] + 0x265e5a51, 14 );
+	MD5_STEP( F2, b, c, d, a, x[  0 ] + 0xe9b6c7aa, 20 );
+	MD5_STEP( F2, a, b, c, d, x[  5 ] + 0xd62f105d,  5 );
+	MD5_STEP( F2, d, a, b, c, x[ 10 ] + 0x02441453,  9 );
+	MD5_STEP( F2, c, d, a, b, x[ 15 ] + 0xd8a1e681, 14 );
+	MD5_STEP( F2, b, c, d, a, x[  4 ] + 0xe7d3fbc8, 20 );
+	MD5_STEP( F2, a, b, c, d, x[  9 ] + 0x21e1cde6,  5 );
+	MD5_STEP( F2, d, a, b, c, x[ 14 ] + 0xc33707d6,  9 );
+	MD5_STEP( F2, c, d, a, b, x[  3 ] + 0xf4d50d87, 14 );
+	MD5_STEP( F2, b, c, d, a, x[  8 ] + 0x455a14ed, 20 );
+	MD5_STEP( F2, a, b, c, d, x[ 13 ] + 0xa9e3e905,  5 );
+	MD5_STEP( F2, d, a, b, c, x[  2 ] + 0xfcefa3f8,  9 );
+	MD5_STEP( F2, c, d, a, b, x[  7 ] + 0x676f02d9, 14 );
+	MD5_STEP( F2, b, c, d, a, x[ 12 ] + 0x8d2a4c8a, 20 );
 	
-	MD5_STEP( F3, a, b, c, d, intermediate[  5 ] + 0xfffa3942,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  8 ] + 0x8771f681, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[ 11 ] + 0x6d9d6122, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[ 14 ] + 0xfde5380c, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[  1 ] + 0xa4beea44,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  4 ] + 0x4bdecfa9, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[  7 ] + 0xf6bb4b60, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[ 10 ] + 0xbebfbc70, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[ 13 ] + 0x289b7ec6,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[  0 ] + 0xeaa127fa, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[  3 ] + 0xd4ef3085, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[  6 ] + 0x04881d05, 23 );
-	MD5_STEP( F3, a, b, c, d, intermediate[  9 ] + 0xd9d4d039,  4 );
-	MD5_STEP( F3, d, a, b, c, intermediate[ 12 ] + 0xe6db99e5, 11 );
-	MD5_STEP( F3, c, d, a, b, intermediate[ 15 ] + 0x1fa27cf8, 16 );
-	MD5_STEP( F3, b, c, d, a, intermediate[  2 ] + 0xc4ac5665, 23 );
+	MD5_STEP( F3, a, b, c, d, x[  5 ] + 0xfffa3942,  4 );
+	MD5_STEP( F3, d, a, b, c, x[  8 ] + 0x8771f681, 11 );
+	MD5_STEP( F3, c, d, a, b, x[ 11 ] + 0x6d9d6122, 16 );
+	MD5_STEP( F3, b, c, d, a, x[ 14 ] + 0xfde5380c, 23 );
+	MD5_STEP( F3, a, b, c, d, x[  1 ] + 0xa4beea44,  4 );
+	MD5_STEP( F3, d, a, b, c, x[  4 ] + 0x4bdecfa9, 11 );
+	MD5_STEP( F3, c, d, a, b, x[  7 ] + 0xf6bb4b60, 16 );
+	MD5_STEP( F3, b, c, d, a, x[ 10 ] + 0xbebfbc70, 23 );
+	MD5_STEP( F3, a, b, c, d, x[ 13 ] + 0x289b7ec6,  4 );
+	MD5_STEP( F3, d, a, b, c, x[  0 ] + 0xeaa127fa, 11 );
+	MD5_STEP( F3, c, d, a, b, x[  3 ] + 0xd4ef3085, 16 );
+	MD5_STEP( F3, b, c, d, a, x[  6 ] + 0x04881d05, 23 );
+	MD5_STEP( F3, a, b, c, d, x[  9 ] + 0xd9d4d039,  4 );
+	MD5_STEP( F3, d, a, b, c, x[ 12 ] + 0xe6db99e5, 11 );
+	MD5_STEP( F3, c, d, a, b, x[ 15 ] + 0x1fa27cf8, 16 );
+	MD5_STEP( F3, b, c, d, a, x[  2 ] + 0xc4ac5665, 23 );
 	
-	MD5_STEP( F4, a, b, c, d, intermediate[  0 ] + 0xf4292244,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[  7 ] + 0x432aff97, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[ 14 ] + 0xab9423a7, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  5 ] + 0xfc93a039, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[ 12 ] + 0x655b59c3,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[  3 ] + 0x8f0ccc92, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[ 10 ] + 0xffeff47d, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  1 ] + 0x85845dd1, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[  8 ] + 0x6fa87e4f,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[ 15 ] + 0xfe2ce6e0, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[  6 ] + 0xa3014314, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[ 13 ] + 0x4e0811a1, 21 );
-	MD5_STEP( F4, a, b, c, d, intermediate[  4 ] + 0xf7537e82,  6 );
-	MD5_STEP( F4, d, a, b, c, intermediate[ 11 ] + 0xbd3af235, 10 );
-	MD5_STEP( F4, c, d, a, b, intermediate[  2 ] + 0x2ad7d2bb, 15 );
-	MD5_STEP( F4, b, c, d, a, intermediate[  9 ] + 0xeb86d391, 21 );
+	MD5_STEP( F4, a, b, c, d, x[  0 ] + 0xf4292244,  6 );
+	MD5_STEP( F4, d, a, b, c, x[  7 ] + 0x432aff97, 10 );
+	MD5_STEP( F4, c, d, a, b, x[ 14 ] + 0xab9423a7, 15 );
+	MD5_STEP( F4, b, c, d, a, x[  5 ] + 0xfc93a039, 21 );
+	MD5_STEP( F4, a, b, c, d, x[ 12 ] + 0x655b59c3,  6 );
+	MD5_STEP( F4, d, a, b, c, x[  3 ] + 0x8f0ccc92, 10 );
+	MD5_STEP( F4, c, d, a, b, x[ 10 ] + 0xffeff47d, 15 );
+	MD5_STEP( F4, b, c, d, a, x[  1 ] + 0x85845dd1, 21 );
+	MD5_STEP( F4, a, b, c, d, x[  8 ] + 0x6fa87e4f,  6 );
+	MD5_STEP( F4, d, a, b, c, x[ 15 ] + 0xfe2ce6e0, 10 );
+	MD5_STEP( F4, c, d, a, b, x[  6 ] + 0xa3014314, 15 );
+	MD5_STEP( F4, b, c, d, a, x[ 13 ] + 0x4e0811a1, 21 );
+	MD5_STEP( F4, a, b, c, d, x[  4 ] + 0xf7537e82,  6 );
+	MD5_STEP( F4, d, a, b, c, x[ 11 ] + 0xbd3af235, 10 );
+	MD5_STEP( F4, c, d, a, b, x[  2 ] + 0x2ad7d2bb, 15 );
+	MD5_STEP( F4, b, c, d, a, x[  9 ] + 0xeb86d391, 21 );
 
 	buffer[ 0 ] += a;
 	buffer[ 1 ] += b;
@@ -354,9 +377,19 @@ inline void MD5Update( MD5Context *context, u8 *buffer,
 	}
 		
 	/*
-	 * Process data in 64-byte, 512 bit, chunks
+	 * Process data in 64-byte, 512 bit, chunks. Aligned data that does
+	 * not need swapping is transformed in place, without a copy
 	 */
 
+	if( ( doByteSwap == FALSE ) && ( ( (u32)buffer & 3 ) == 0 ) ) {
+		while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
+			MD5Transform( context->buffer, (u32 *)buffer );
+
+			buffer += MD5_SIGNATURE_BYTE_SIZE;
+			len    -= MD5_SIGNATURE_BYTE_SIZE;
+		}
+	}
+
 	while( len >= MD5_SIGNATURE_BYTE_SIZE ) {
 		MD5Memcpy( context->intermediate, buffer, MD5_SIGNATURE_BYTE_SIZE,
 				 doByteSwap );
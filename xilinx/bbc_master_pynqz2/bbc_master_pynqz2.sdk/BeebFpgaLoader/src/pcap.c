@@ -122,6 +122,8 @@ extern int XDcfgPollDone(u32 MaskValue, u32 MaxCount);
 /* Devcfg driver instance */
 static XDcfg DcfgInstance;
 XDcfg *DcfgInstPtr;
+/* Set while a chunk of a streamed bitstream is being transferred */
+static u8 StreamPendingFlag;
 extern u32 Silicon_Version;
 #ifdef XPAR_XWDTPS_0_BASEADDR
 extern XWdtPs Watchdog;	/* Instance of WatchDog Timer	*/
@@ -373,6 +375,158 @@ u32 PcapLoadPartition(u32 *SourceDataPtr, u32 *DestinationDataPtr,
 	return XST_SUCCESS;
 }
 
+/******************************************************************************/
+/**
+*
+* This function starts loading a PL partition using PCAP in a number of
+* chunks, see PcapStreamChunk()
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the fabric is ready for the bitstream
+*		- XST_FAILURE if the fabric initialization fails
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapStartStream(void)
+{
+	u32 Status;
+
+	StreamPendingFlag = 0;
+
+	/*
+	 * Clear the PCAP status registers
+	 */
+	Status = ClearPcapStatus();
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_CLEAR_STATUS_FAIL \r\n");
+		return XST_FAILURE;
+	}
+
+	/*
+	 * New Bitstream download initialization sequence
+	 */
+	return FabricInit();
+}
+
+/******************************************************************************/
+/**
+*
+* This function queues the next chunk of a PL partition to PCAP. It only
+* waits for the previous chunk's DMA, so the caller can fill another buffer
+* while this chunk is transferred.
+*
+* @param 	SourceDataPtr is a pointer to the chunk
+* @param 	WordLength is the length of the chunk in words
+* @param 	LastChunk is set for the final chunk of the partition
+*
+* @return
+*		- XST_SUCCESS if the transfer was started
+*		- XST_FAILURE if the previous transfer or this one failed
+*
+* @note		 The buffer of the previous chunk is free on return
+*
+****************************************************************************/
+u32 PcapStreamChunk(u32 *SourceDataPtr, u32 WordLength, u32 LastChunk)
+{
+	u32 Status;
+
+	/*
+	 * Wait for the DMA of the previous chunk
+	 */
+	if (StreamPendingFlag) {
+		Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
+			return XST_FAILURE;
+		}
+		StreamPendingFlag = 0;
+	}
+
+#ifdef	XPAR_XWDTPS_0_BASEADDR
+	/*
+	 * Prevent WDT reset
+	 */
+	XWdtPs_RestartWdt(&Watchdog);
+#endif
+
+	/*
+	 * Only the final DMA of the bitstream is marked as the last transfer
+	 */
+	if (LastChunk) {
+		SourceDataPtr = (u32*)((u32)SourceDataPtr | PCAP_LAST_TRANSFER);
+	}
+
+	Status = XDcfg_Transfer(DcfgInstPtr, (u8 *)SourceDataPtr,
+					WordLength,
+					(u8 *)XDCFG_DMA_INVALID_ADDRESS,
+					0, XDCFG_NON_SECURE_PCAP_WRITE);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"Status of XDcfg_Transfer = %lu \r \n",Status);
+		return XST_FAILURE;
+	}
+
+	StreamPendingFlag = 1;
+
+	return XST_SUCCESS;
+}
+
+/******************************************************************************/
+/**
+*
+* This function completes loading a PL partition in chunks, waiting for
+* the last DMA and the FPGA done
+*
+* @param	None
+*
+* @return
+*		- XST_SUCCESS if the bitstream was loaded
+*		- XST_FAILURE if the transfer or configuration failed
+*
+* @note		 None
+*
+****************************************************************************/
+u32 PcapStreamDone(void)
+{
+	u32 Status;
+	u32 IntrStsReg;
+
+	if (StreamPendingFlag) {
+		Status = XDcfgPollDone(XDCFG_IXR_DMA_DONE_MASK, MAX_COUNT);
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO,"PCAP_DMA_DONE_FAIL \r\n");
+			return XST_FAILURE;
+		}
+		StreamPendingFlag = 0;
+	}
+
+	fsbl_printf(DEBUG_INFO,"DMA Done ! \n\r");
+
+	/*
+	 * Poll for FPGA Done
+	 */
+	Status = XDcfgPollDone(XDCFG_IXR_PCFG_DONE_MASK, MAX_COUNT);
+	if (Status != XST_SUCCESS) {
+		fsbl_printf(DEBUG_INFO,"PCAP_FPGA_DONE_FAIL\r\n");
+		return XST_FAILURE;
+	}
+
+	fsbl_printf(DEBUG_INFO,"FPGA Done ! \n\r");
+
+	/*
+	 * Check for errors
+	 */
+	IntrStsReg = XDcfg_IntrGetStatus(DcfgInstPtr);
+	if (IntrStsReg & FSBL_XDCFG_IXR_ERROR_FLAGS_MASK) {
+		fsbl_printf(DEBUG_INFO,"Errors in PCAP \r\n");
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
 /******************************************************************************/
 /**
 *
@@ -94,6 +94,9 @@ u32 PcapLoadPartition(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
 		 	u32 DestinationLength, u32 Flags);
 u32 PcapDataTransfer(u32 *SourceData, u32 *DestinationData, u32 SourceLength,
  			u32 DestinationLength, u32 Flags);
+u32 PcapStartStream(void);
+u32 PcapStreamChunk(u32 *SourceData, u32 WordLength, u32 LastChunk);
+u32 PcapStreamDone(void);
 /************************** Variable Definitions *****************************/
 #ifdef __cplusplus
 }
@@ -73,6 +73,9 @@
 #ifdef XPAR_PS7_QSPI_LINEAR_0_S_AXI_BASEADDR
 #include "xqspips_hw.h"
 #include "xqspips.h"
+#ifdef FSBL_QSPI_BENCHMARK
+#include "xtime_l.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -180,12 +183,29 @@
 #define QSPI_BUSWIDTH_TWO	1U
 #define QSPI_BUSWIDTH_FOUR	2U
 
+/*
+ * Offset within the 16MB window of a bank, which is also the window the
+ * linear address space sees of a single flash
+ */
+#define BANK_OFFSET_MASK	(FLASH_SIZE_16MB - 1)
+
+#ifdef FSBL_QSPI_BENCHMARK
+#define QSPI_BENCH_SIZE		0x200000
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+static void QspiLinearMode(u8 Enable);
+static u32 QspiLinearRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes);
+#ifdef FSBL_QSPI_BENCHMARK
+static void QspiBenchmark(void);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 XQspiPs QspiInstance;
@@ -195,6 +215,14 @@ u32 QspiFlashMake;
 extern u32 FlashReadBaseAddress;
 extern u8 LinearBootDeviceFlag;
 
+/*
+ * Flash too large for linear boot, but read through the linear window a
+ * bank at a time, switching to I/O mode only to change bank
+ */
+static u8 QspiLinearReadFlag;
+static u32 QspiLinearConfig;
+static u32 QspiIoConfig;
+
 /*
  * The following variables are used to read and write to the eeprom and they
  * are global to avoid having large buffers on the stack
@@ -349,6 +377,14 @@ u32 InitQspi(void)
 			 * Enable the controller
 			 */
 			XQspiPs_Enable(QspiInstancePtr);
+
+			/*
+			 * Reads within a bank can still use the linear window,
+			 * with the same fast read command
+			 */
+			QspiIoConfig = ConfigCmd;
+			QspiLinearConfig = ConfigCmd | XQSPIPS_LQSPI_CR_LINEAR_MASK;
+			QspiLinearReadFlag = 1;
 		}
 	}
 
@@ -437,6 +473,10 @@ u32 InitQspi(void)
 		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, ConfigCmd);
 	}
 
+#ifdef FSBL_QSPI_BENCHMARK
+	QspiBenchmark();
+#endif
+
 	return XST_SUCCESS;
 }
 
@@ -615,6 +655,12 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 		memcpy((void*)DestinationAddress,
 		      (const void*)(SourceAddress + FlashReadBaseAddress),
 		      (size_t)LengthBytes);
+	} else if (QspiLinearReadFlag == 1) {
+		/*
+		 * Non Linear boot, but linear reads within each bank
+		 */
+		return QspiLinearRead(SourceAddress, DestinationAddress,
+				LengthBytes);
 	} else {
 		/*
 		 * Non Linear access
@@ -771,6 +817,181 @@ u32 QspiAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 	return XST_SUCCESS;
 }
 
+/******************************************************************************/
+/**
+*
+* This function switches the controller between linear mode, for reading
+* through the linear window, and I/O mode, for sending commands.
+*
+* @param	Enable is 1 for linear mode, 0 for I/O mode
+*
+* @return	None.
+*
+* @note		Only used when QspiLinearReadFlag is set
+*
+****************************************************************************/
+static void QspiLinearMode(u8 Enable)
+{
+	XQspiPs_Disable(QspiInstancePtr);
+
+	if (Enable) {
+		XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_LQSPI_MODE_OPTION |
+				XQSPIPS_HOLD_B_DRIVE_OPTION);
+		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, QspiLinearConfig);
+	} else {
+		XQspiPs_SetOptions(QspiInstancePtr, XQSPIPS_FORCE_SSELECT_OPTION |
+				XQSPIPS_HOLD_B_DRIVE_OPTION);
+		XQspiPs_SetLqspiConfigReg(QspiInstancePtr, QspiIoConfig);
+		XQspiPs_SetSlaveSelect(QspiInstancePtr);
+	}
+
+	XQspiPs_Enable(QspiInstancePtr);
+}
+
+/******************************************************************************/
+/**
+*
+* This function reads a single flash larger than 16MB through the linear
+* window. The controller issues the fast (quad) read commands itself and
+* the data is copied straight to the destination in one go per bank, so
+* only a bank switch splits the request, rather than every 4KB.
+*
+* @param	SourceAddress is address in FLASH data space
+* @param	DestinationAddress is address in DDR data space
+* @param	LengthBytes is the length of the data in Bytes
+*
+* @return
+*		- XST_SUCCESS if the read completes correctly
+*		- XST_FAILURE if a bank selection fails
+*
+* @note		Leaves the controller in I/O mode with bank 0 selected, as
+*		InitQspi did.
+*
+****************************************************************************/
+static u32 QspiLinearRead(u32 SourceAddress, u32 DestinationAddress,
+		u32 LengthBytes)
+{
+	u32 Length;
+	u32 BankSel = 0;
+	u32 Status = XST_SUCCESS;
+
+	while (LengthBytes > 0) {
+		/*
+		 * Select bank, in I/O mode
+		 */
+		if ((SourceAddress / FLASH_SIZE_16MB) != BankSel) {
+			BankSel = SourceAddress / FLASH_SIZE_16MB;
+
+			fsbl_printf(DEBUG_INFO, "Bank Selection %lu\n\r", BankSel);
+
+			Status = SendBankSelect(BankSel);
+			if (Status != XST_SUCCESS) {
+				fsbl_printf(DEBUG_INFO, "Bank Selection Failed\n\r");
+				break;
+			}
+		}
+
+		/*
+		 * Read up to the end of the bank
+		 */
+		Length = FLASH_SIZE_16MB - (SourceAddress & BANK_OFFSET_MASK);
+		if (Length > LengthBytes) {
+			Length = LengthBytes;
+		}
+
+		QspiLinearMode(1);
+
+		memcpy((void*)DestinationAddress,
+		      (const void*)(FlashReadBaseAddress +
+				      (SourceAddress & BANK_OFFSET_MASK)),
+		      (size_t)Length);
+
+		QspiLinearMode(0);
+
+		LengthBytes -= Length;
+		SourceAddress += Length;
+		DestinationAddress += Length;
+	}
+
+	/*
+	 * Reset Bank selection to zero
+	 */
+	if (BankSel != 0) {
+		if (SendBankSelect(0) != XST_SUCCESS) {
+			fsbl_printf(DEBUG_INFO, "Bank Selection Reset Failed\n\r");
+			Status = XST_FAILURE;
+		}
+	}
+
+	return Status;
+}
+
+#ifdef FSBL_QSPI_BENCHMARK
+/******************************************************************************/
+/**
+*
+* This function times reading the same span of flash through the polled
+* I/O path and the linear path, and checks they read the same data. On a
+* flash larger than 16MB the span crosses the first bank boundary. Enabled
+* by defining FSBL_QSPI_BENCHMARK.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Uses the DDR temporary area, before any partition is loaded
+*
+****************************************************************************/
+static void QspiBenchmark(void)
+{
+	static const char *Names[] = {"polled I/O, 4KB", "linear"};
+	u8 SavedFlag = QspiLinearReadFlag;
+	u32 Source = 0;
+	u32 Size = QSPI_BENCH_SIZE;
+	u32 Index;
+	u32 Status;
+	u32 Us;
+	XTime Start;
+	XTime End;
+
+	if (SavedFlag == 0) {
+		fsbl_printf(DEBUG_GENERAL,"QSPI benchmark: linear reads not "
+				"in use\r\n");
+		return;
+	}
+
+	if (QspiFlashSize > FLASH_SIZE_16MB) {
+		Source = FLASH_SIZE_16MB - Size / 2;
+	}
+
+	fsbl_printf(DEBUG_GENERAL,"QSPI benchmark: %lu bytes from 0x%lx\r\n",
+			Size, Source);
+
+	for (Index = 0; Index < 2; Index++) {
+		QspiLinearReadFlag = (u8)Index;
+		XTime_GetTime(&Start);
+		Status = QspiAccess(Source, DDR_TEMP_START_ADDR + Index * Size,
+				Size);
+		XTime_GetTime(&End);
+		Us = (u32)((End - Start) / (COUNTS_PER_SECOND / 1000000));
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"  %-18s failed\r\n", Names[Index]);
+		} else if (Us) {
+			fsbl_printf(DEBUG_GENERAL,"  %-18s %6lu us, %5lu KB/s\r\n",
+					Names[Index], Us,
+					(u32)((u64)Size * 1000000 / 1024 / Us));
+		}
+	}
+
+	QspiLinearReadFlag = SavedFlag;
+
+	if (memcmp((const void*)DDR_TEMP_START_ADDR,
+			(const void*)(DDR_TEMP_START_ADDR + Size), Size) != 0) {
+		fsbl_printf(DEBUG_GENERAL,"  Data mismatch\r\n");
+	}
+}
+#endif
+
 
 
 /******************************************************************************
@@ -60,16 +60,48 @@
 #include "xstatus.h"
 
 #include "ff.h"
+#include "diskio.h"
 #include "sd.h"
+#include "fsbl_timeline.h"
+#ifdef FSBL_SD_BENCHMARK
+#include "xtime_l.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
+#define SD_SECTOR_SIZE		512
+
+/*
+ * Cluster link map table for fast seek, in words. Two words per fragment
+ * of the file, plus two, so 31 fragments.
+ */
+#define SD_CLMT_SIZE		64
+
+/*
+ * Largest single read, within the limit of the SD driver's ADMA2
+ * descriptor table
+ */
+#define SD_MAX_READ_SECTORS	2048
+
+#ifdef FSBL_SD_BENCHMARK
+#define SD_BENCH_CHUNK		0x40000
+#define SD_BENCH_SMALL		0x1000
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+static u32 SDRead(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes);
+#if FF_USE_FASTSEEK
+static u32 SDMapSectors(u32 SourceAddress, u32 *Sector);
+#endif
+#ifdef FSBL_SD_BENCHMARK
+static void SDBenchmark(void);
+#endif
+
 /************************** Variable Definitions *****************************/
 
 extern u32 FlashReadBaseAddress;
@@ -80,6 +112,11 @@ static FATFS fatfs;
 static char buffer[32];
 static char *boot_file = buffer;
 
+#if FF_USE_FASTSEEK
+static DWORD Clmt[SD_CLMT_SIZE];	/* Cluster link map table */
+static u8 FastSeekFlag;
+#endif
+
 /******************************************************************************/
 /******************************************************************************/
 /**
@@ -100,9 +137,12 @@ u32 InitSD(const char *filename)
 
 	FRESULT rc;
 	TCHAR *path = "0:/"; /* Logical drive number is 0 */
+	u32 Stage;
 
 	/* Register volume work area, initialize device */
+	Stage = TimelineStart(TIMELINE_SD_MOUNT, 0);
 	rc = f_mount(&fatfs, path, 0);
+	TimelineEnd(Stage);
 	fsbl_printf(DEBUG_INFO,"SD: rc= %.8x\n\r", rc);
 
 	if (rc != FR_OK) {
@@ -113,12 +153,36 @@ u32 InitSD(const char *filename)
 	boot_file = (char *)buffer;
 	FlashReadBaseAddress = XPAR_PS7_SD_0_S_AXI_BASEADDR;
 
+	Stage = TimelineStart(TIMELINE_SD_OPEN, 0);
 	rc = f_open(&fil, boot_file, FA_READ);
+	TimelineEnd(Stage);
 	if (rc) {
 		fsbl_printf(DEBUG_GENERAL,"SD: Unable to open file %s: %d\n", boot_file, rc);
 		return XST_FAILURE;
 	}
 
+#if FF_USE_FASTSEEK
+	/*
+	 * Map the file's clusters once, so reads don't walk the FAT. A
+	 * badly fragmented file just falls back to f_read.
+	 */
+	Clmt[0] = SD_CLMT_SIZE;
+	fil.cltbl = Clmt;
+	rc = f_lseek(&fil, CREATE_LINKMAP);
+	if (rc == FR_OK) {
+		FastSeekFlag = 1;
+		fsbl_printf(DEBUG_INFO,"SD: %s in %lu fragments\r\n", boot_file,
+				(u32)(Clmt[0] - 2) / 2);
+	} else {
+		fil.cltbl = NULL;
+		fsbl_printf(DEBUG_INFO,"SD: No fast seek (%d)\r\n", rc);
+	}
+#endif
+
+#ifdef FSBL_SD_BENCHMARK
+	SDBenchmark();
+#endif
+
 	return XST_SUCCESS;
 
 }
@@ -137,12 +201,100 @@ u32 InitSD(const char *filename)
 *		- XST_SUCCESS if the write completes correctly
 *		- XST_FAILURE if the write fails to completes correctly
 *
-* @note		None.
+* @note		With fast seek, whole sectors are read with as few multi-block
+*		reads as the file's fragments allow, straight into the
+*		destination, and only a partial first or last sector goes
+*		through f_read. The destination must be word aligned for the
+*		SD controller's DMA, otherwise it all goes through f_read.
 *
 ****************************************************************************/
 u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 {
+#if FF_USE_FASTSEEK
+	u32 Head;
+	u32 Sector;
+	u32 Count;
+	u32 Status;
+
+	Head = (SD_SECTOR_SIZE - (SourceAddress % SD_SECTOR_SIZE)) % SD_SECTOR_SIZE;
+	if (Head > LengthBytes) {
+		Head = LengthBytes;
+	}
 
+	if (FastSeekFlag && (((DestinationAddress + Head) & 3) == 0)) {
+		/*
+		 * Partial first sector
+		 */
+		if (Head) {
+			Status = SDRead(SourceAddress, DestinationAddress, Head);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			SourceAddress += Head;
+			DestinationAddress += Head;
+			LengthBytes -= Head;
+		}
+
+		/*
+		 * Whole sectors, up to a fragment at a time
+		 */
+		while (LengthBytes >= SD_SECTOR_SIZE) {
+			Count = SDMapSectors(SourceAddress, &Sector);
+			if (Count == 0) {
+				/*
+				 * Beyond the end of the file
+				 */
+				break;
+			}
+			if (Count > LengthBytes / SD_SECTOR_SIZE) {
+				Count = LengthBytes / SD_SECTOR_SIZE;
+			}
+			if (Count > SD_MAX_READ_SECTORS) {
+				Count = SD_MAX_READ_SECTORS;
+			}
+			if (disk_read(fatfs.pdrv, (BYTE *)DestinationAddress,
+					Sector, Count) != RES_OK) {
+				fsbl_printf(DEBUG_GENERAL,"*** ERROR: disk_read failed "
+						"at sector %lx\r\n", Sector);
+				return XST_FAILURE;
+			}
+			SourceAddress += Count * SD_SECTOR_SIZE;
+			DestinationAddress += Count * SD_SECTOR_SIZE;
+			LengthBytes -= Count * SD_SECTOR_SIZE;
+		}
+
+		/*
+		 * Partial last sector
+		 */
+		if (LengthBytes == 0) {
+			return XST_SUCCESS;
+		}
+	}
+#endif
+
+	return SDRead(SourceAddress, DestinationAddress, LengthBytes);
+
+} /* End of SDAccess */
+
+
+/******************************************************************************/
+/**
+*
+* This function reads from the boot file through FatFs
+*
+* @param	SourceAddress is the offset in the file
+* @param	DestinationAddress is the destination address
+* @param	LengthBytes is the number of bytes to read
+*
+* @return
+*		- XST_SUCCESS if the read completes correctly
+*		- XST_FAILURE if the read fails
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SDRead(u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
+{
 	FRESULT rc;	 /* Result code */
 	UINT br;
 
@@ -156,11 +308,144 @@ u32 SDAccess( u32 SourceAddress, u32 DestinationAddress, u32 LengthBytes)
 
 	if (rc) {
 		fsbl_printf(DEBUG_GENERAL,"*** ERROR: f_read returned %d\r\n", rc);
+		return XST_FAILURE;
 	}
 
 	return XST_SUCCESS;
+}
 
-} /* End of SDAccess */
+
+#if FF_USE_FASTSEEK
+/******************************************************************************/
+/**
+*
+* This function maps an offset in the boot file to a sector on the card,
+* using the cluster link map table
+*
+* @param	SourceAddress is the offset in the file, sector aligned
+* @param	Sector returns the sector number
+*
+* @return	Number of contiguous sectors from Sector to the end of the
+*		fragment, or 0 if the offset is beyond the end of the file
+*
+* @note		None.
+*
+****************************************************************************/
+static u32 SDMapSectors(u32 SourceAddress, u32 *Sector)
+{
+	DWORD *Table = Clmt + 1;
+	u32 ClusterSectors = fatfs.csize;
+	u32 Cluster;
+	u32 Offset;
+	u32 Length;
+
+	if (SourceAddress >= f_size(&fil)) {
+		return 0;
+	}
+
+	Cluster = SourceAddress / SD_SECTOR_SIZE / ClusterSectors;
+	Offset = (SourceAddress / SD_SECTOR_SIZE) % ClusterSectors;
+
+	/*
+	 * Table is pairs of fragment length and first cluster, ending in 0
+	 */
+	while (1) {
+		Length = *Table++;
+		if (Length == 0) {
+			return 0;
+		}
+		if (Cluster < Length) {
+			break;
+		}
+		Cluster -= Length;
+		Table++;
+	}
+
+	*Sector = fatfs.database + (*Table + Cluster - 2) * ClusterSectors + Offset;
+
+	return (Length - Cluster) * ClusterSectors - Offset;
+}
+#endif
+
+
+#ifdef FSBL_SD_BENCHMARK
+/******************************************************************************/
+/**
+*
+* This function measures the read throughput of the card, by reading the
+* whole boot file into DDR in a few ways, for comparing cards and the
+* two read paths. Enabled by defining FSBL_SD_BENCHMARK.
+*
+* @param	None
+*
+* @return	None
+*
+* @note		Uses the DDR temporary area, before any partition is loaded
+*
+****************************************************************************/
+static void SDBenchmark(void)
+{
+	static const struct {
+		const char *Name;
+		u32 Chunk;
+		u8 FastSeek;
+	} Runs[] = {
+		{"f_read, 4KB", SD_BENCH_SMALL, 0},
+		{"f_read, 256KB", SD_BENCH_CHUNK, 0},
+		{"fast seek, 4KB", SD_BENCH_SMALL, 1},
+		{"fast seek, 256KB", SD_BENCH_CHUNK, 1}
+	};
+	u32 Size = f_size(&fil);
+	u32 Offset;
+	u32 Chunk;
+	u32 Index;
+	u32 Status = XST_SUCCESS;
+	u32 Us;
+	XTime Start;
+	XTime End;
+#if FF_USE_FASTSEEK
+	u8 SavedFlag = FastSeekFlag;
+#endif
+
+	fsbl_printf(DEBUG_GENERAL,"SD benchmark: %s, %lu bytes, "
+			"%lu byte clusters\r\n", boot_file, Size,
+			(u32)fatfs.csize * SD_SECTOR_SIZE);
+
+	for (Index = 0; Index < sizeof(Runs) / sizeof(Runs[0]); Index++) {
+#if FF_USE_FASTSEEK
+		FastSeekFlag = SavedFlag && Runs[Index].FastSeek;
+#else
+		if (Runs[Index].FastSeek) {
+			continue;
+		}
+#endif
+		XTime_GetTime(&Start);
+		for (Offset = 0; Offset < Size; Offset += Chunk) {
+			Chunk = Size - Offset;
+			if (Chunk > Runs[Index].Chunk) {
+				Chunk = Runs[Index].Chunk;
+			}
+			Status = SDAccess(Offset, DDR_TEMP_START_ADDR + Offset, Chunk);
+			if (Status != XST_SUCCESS) {
+				break;
+			}
+		}
+		XTime_GetTime(&End);
+		Us = (u32)((End - Start) / (COUNTS_PER_SECOND / 1000000));
+		if (Status != XST_SUCCESS) {
+			fsbl_printf(DEBUG_GENERAL,"  %-18s failed\r\n", Runs[Index].Name);
+		} else if (Us) {
+			fsbl_printf(DEBUG_GENERAL,"  %-18s %6lu us, %5lu KB/s\r\n",
+					Runs[Index].Name, Us,
+					(u32)((u64)Size * 1000000 / 1024 / Us));
+		}
+	}
+
+#if FF_USE_FASTSEEK
+	FastSeekFlag = SavedFlag;
+#endif
+}
+#endif
 
 
 /******************************************************************************/
@@ -0,0 +1,130 @@
+/*****************************************************************************
+*
+* @file unpack.c
+*
+* Decompresses the blocks of a packed PL partition, see unpack.h
+*
+******************************************************************************/
+
+#include <string.h>
+#include "xstatus.h"
+#include "unpack.h"
+
+/************************** Constant Definitions *****************************/
+
+#define LZ4_MIN_MATCH		4
+#define LZ4_RUN_MASK		15
+
+/******************************************************************************
+*
+* This function decompresses one LZ4 block. Every length and offset is
+* checked, so a corrupt block fails rather than writing outside Dst.
+*
+* @param	Src is the compressed block
+* @param	SrcLength is its length in bytes
+* @param	Dst is the output buffer
+* @param	DstLength is the size of the output buffer
+* @param	OutLength returns the decompressed length
+*
+* @return
+*		- XST_SUCCESS if the block was decompressed
+*		- XST_FAILURE if it is corrupt
+*
+* @note		Runs of a short repeating pattern (which is most of a
+*		bitstream) are copied in spans that double each time
+*
+****************************************************************************/
+u32 UnpackBlock(const u8 *Src, u32 SrcLength, u8 *Dst, u32 DstLength,
+		u32 *OutLength)
+{
+	const u8 *Ip = Src;
+	const u8 *IpEnd = Src + SrcLength;
+	u8 *Op = Dst;
+	u8 *OpEnd = Dst + DstLength;
+	const u8 *Match;
+	u32 Token;
+	u32 Length;
+	u32 Offset;
+	u32 Byte;
+	u32 Span;
+
+	while (1) {
+		if (Ip >= IpEnd) {
+			return XST_FAILURE;
+		}
+		Token = *Ip++;
+
+		/*
+		 * Literals
+		 */
+		Length = Token >> 4;
+		if (Length == LZ4_RUN_MASK) {
+			do {
+				if (Ip >= IpEnd) {
+					return XST_FAILURE;
+				}
+				Byte = *Ip++;
+				Length += Byte;
+			} while (Byte == 255);
+		}
+		if ((Length > (u32)(IpEnd - Ip)) || (Length > (u32)(OpEnd - Op))) {
+			return XST_FAILURE;
+		}
+		memcpy(Op, Ip, Length);
+		Op += Length;
+		Ip += Length;
+
+		/*
+		 * The last sequence is literals only
+		 */
+		if (Ip == IpEnd) {
+			break;
+		}
+
+		/*
+		 * Match
+		 */
+		if ((IpEnd - Ip) < 2) {
+			return XST_FAILURE;
+		}
+		Offset = Ip[0] | (Ip[1] << 8);
+		Ip += 2;
+		if ((Offset == 0) || (Offset > (u32)(Op - Dst))) {
+			return XST_FAILURE;
+		}
+
+		Length = Token & LZ4_RUN_MASK;
+		if (Length == LZ4_RUN_MASK) {
+			do {
+				if (Ip >= IpEnd) {
+					return XST_FAILURE;
+				}
+				Byte = *Ip++;
+				Length += Byte;
+			} while (Byte == 255);
+		}
+		Length += LZ4_MIN_MATCH;
+		if (Length > (u32)(OpEnd - Op)) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Where the match overlaps the output, the bytes from Match to
+		 * Op repeat, so each span can be twice the length of the last
+		 */
+		Match = Op - Offset;
+		while (Length) {
+			Span = Op - Match;
+			if (Span > Length) {
+				Span = Length;
+			}
+			memcpy(Op, Match, Span);
+			Op += Span;
+			Length -= Span;
+		}
+	}
+
+	*OutLength = Op - Dst;
+
+	return XST_SUCCESS;
+}
@@ -0,0 +1,57 @@
+/*****************************************************************************/
+/**
+*
+* @file unpack.h
+*
+* Packed (compressed) PL partitions, made by bitpack (see ../bench). The
+* bitstream is split into blocks of BlockSize bytes, each compressed
+* independently in the LZ4 block format, so each one can be decompressed
+* straight into a PCAP stream buffer.
+*
+* Layout, all words little endian:
+*
+*	PackHeader
+*	u32 BlockLength[NumBlocks]	compressed length, PACK_BLOCK_STORED if
+*					the block is stored uncompressed
+*	blocks, each padded to a multiple of four bytes
+*
+******************************************************************************/
+#ifndef UNPACK_H_
+#define UNPACK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Must match bitpack.c
+ */
+#define PACK_MAGIC			0x4B504642	/* "BFPK" */
+#define PACK_BLOCK_STORED	0x80000000
+#define PACK_LENGTH_MASK	0x7FFFFFFF
+#define PACK_MAX_BLOCKS		256
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Magic;
+	u32 DataLength;		/* Unpacked bitstream length in bytes */
+	u32 BlockSize;		/* Unpacked length of each block but the last */
+	u32 NumBlocks;
+} PackHeader;
+
+/************************** Function Prototypes ******************************/
+
+u32 UnpackBlock(const u8 *Src, u32 SrcLength, u8 *Dst, u32 DstLength,
+		u32 *OutLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNPACK_H_ */
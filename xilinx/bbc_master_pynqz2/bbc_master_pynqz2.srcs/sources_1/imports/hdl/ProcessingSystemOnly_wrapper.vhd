@@ -13,6 +13,13 @@ library UNISIM;
 use UNISIM.VCOMPONENTS.ALL;
 entity ProcessingSystemOnly_wrapper is
   port (
+    BRAM_PORTA_0_addr : out STD_LOGIC_VECTOR ( 18 downto 0 );
+    BRAM_PORTA_0_clk : out STD_LOGIC;
+    BRAM_PORTA_0_din : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    BRAM_PORTA_0_dout : in STD_LOGIC_VECTOR ( 31 downto 0 );
+    BRAM_PORTA_0_en : out STD_LOGIC;
+    BRAM_PORTA_0_rst : out STD_LOGIC;
+    BRAM_PORTA_0_we : out STD_LOGIC_VECTOR ( 3 downto 0 );
     DDR_addr : inout STD_LOGIC_VECTOR ( 14 downto 0 );
     DDR_ba : inout STD_LOGIC_VECTOR ( 2 downto 0 );
     DDR_cas_n : inout STD_LOGIC;
@@ -41,7 +48,10 @@ entity ProcessingSystemOnly_wrapper is
     gpio_io_o_0 : out STD_LOGIC_VECTOR ( 31 downto 0 );
     gpio_io_o_1 : out STD_LOGIC_VECTOR ( 31 downto 0 );
     gpio_io_o_2 : out STD_LOGIC_VECTOR ( 31 downto 0 );
-    gpio_io_o_3 : out STD_LOGIC_VECTOR ( 31 downto 0 )
+    gpio_io_i_0 : in STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_o_3 : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_o_4 : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_i_1 : in STD_LOGIC_VECTOR ( 31 downto 0 )
   );
 end ProcessingSystemOnly_wrapper;
 
@@ -56,6 +66,9 @@ architecture STRUCTURE of ProcessingSystemOnly_wrapper is
     gpio_io_o_1 : out STD_LOGIC_VECTOR ( 31 downto 0 );
     gpio_io_o_2 : out STD_LOGIC_VECTOR ( 31 downto 0 );
     gpio_io_o_3 : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_o_4 : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_i_0 : in STD_LOGIC_VECTOR ( 31 downto 0 );
+    gpio_io_i_1 : in STD_LOGIC_VECTOR ( 31 downto 0 );
     FIXED_IO_mio : inout STD_LOGIC_VECTOR ( 53 downto 0 );
     FIXED_IO_ddr_vrn : inout STD_LOGIC;
     FIXED_IO_ddr_vrp : inout STD_LOGIC;
@@ -76,12 +89,26 @@ architecture STRUCTURE of ProcessingSystemOnly_wrapper is
     DDR_dm : inout STD_LOGIC_VECTOR ( 3 downto 0 );
     DDR_dq : inout STD_LOGIC_VECTOR ( 31 downto 0 );
     DDR_dqs_n : inout STD_LOGIC_VECTOR ( 3 downto 0 );
-    DDR_dqs_p : inout STD_LOGIC_VECTOR ( 3 downto 0 )
+    DDR_dqs_p : inout STD_LOGIC_VECTOR ( 3 downto 0 );
+    BRAM_PORTA_0_addr : out STD_LOGIC_VECTOR ( 18 downto 0 );
+    BRAM_PORTA_0_clk : out STD_LOGIC;
+    BRAM_PORTA_0_din : out STD_LOGIC_VECTOR ( 31 downto 0 );
+    BRAM_PORTA_0_dout : in STD_LOGIC_VECTOR ( 31 downto 0 );
+    BRAM_PORTA_0_en : out STD_LOGIC;
+    BRAM_PORTA_0_rst : out STD_LOGIC;
+    BRAM_PORTA_0_we : out STD_LOGIC_VECTOR ( 3 downto 0 )
   );
   end component ProcessingSystemOnly;
 begin
 ProcessingSystemOnly_i: component ProcessingSystemOnly
      port map (
+      BRAM_PORTA_0_addr(18 downto 0) => BRAM_PORTA_0_addr(18 downto 0),
+      BRAM_PORTA_0_clk => BRAM_PORTA_0_clk,
+      BRAM_PORTA_0_din(31 downto 0) => BRAM_PORTA_0_din(31 downto 0),
+      BRAM_PORTA_0_dout(31 downto 0) => BRAM_PORTA_0_dout(31 downto 0),
+      BRAM_PORTA_0_en => BRAM_PORTA_0_en,
+      BRAM_PORTA_0_rst => BRAM_PORTA_0_rst,
+      BRAM_PORTA_0_we(3 downto 0) => BRAM_PORTA_0_we(3 downto 0),
       DDR_addr(14 downto 0) => DDR_addr(14 downto 0),
       DDR_ba(2 downto 0) => DDR_ba(2 downto 0),
       DDR_cas_n => DDR_cas_n,
@@ -107,9 +134,12 @@ ProcessingSystemOnly_i: component ProcessingSystemOnly
       FIXED_IO_ps_srstb => FIXED_IO_ps_srstb,
       UART1_RX_0 => UART1_RX_0,
       UART1_TX_0 => UART1_TX_0,
+      gpio_io_i_0(31 downto 0) => gpio_io_i_0(31 downto 0),
+      gpio_io_i_1(31 downto 0) => gpio_io_i_1(31 downto 0),
       gpio_io_o_0(31 downto 0) => gpio_io_o_0(31 downto 0),
       gpio_io_o_1(31 downto 0) => gpio_io_o_1(31 downto 0),
       gpio_io_o_2(31 downto 0) => gpio_io_o_2(31 downto 0),
-      gpio_io_o_3(31 downto 0) => gpio_io_o_3(31 downto 0)
+      gpio_io_o_3(31 downto 0) => gpio_io_o_3(31 downto 0),
+      gpio_io_o_4(31 downto 0) => gpio_io_o_4(31 downto 0)
     );
 end STRUCTURE;